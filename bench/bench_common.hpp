@@ -0,0 +1,373 @@
+// -------------------------------------------------------------------------------------------
+// priority queue benchmarks -- common helpers
+// -------------------------------------------------------------------------------------------
+// this file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+// Reference heaps with the same interface as the heaps under test, a cache miss counter,
+// random input and graph generators.
+// -------------------------------------------------------------------------------------------
+#ifndef BENCH_COMMON_9687E0DD_D406_474B_9534_94B7C1D81D33
+#define BENCH_COMMON_9687E0DD_D406_474B_9534_94B7C1D81D33
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+# include <linux/perf_event.h>
+# include <sys/ioctl.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif
+
+#ifndef PQ_BENCH_MAX_N
+# define PQ_BENCH_MAX_N 100000000
+#endif
+
+namespace bench {
+
+// -------------------------------------------------------------------------------------------
+// hardware cache miss counter for the calling thread.  Silently reports nothing if the
+// kernel does not let us have it (no PMU in a VM, perf_event_paranoid, ...).
+
+class CacheMissCounter {
+public:
+    CacheMissCounter() {
+#if defined(__linux__)
+        perf_event_attr attr{};
+        attr.type           = PERF_TYPE_HARDWARE;
+        attr.size           = sizeof(attr);
+        attr.config         = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled       = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        _m_fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        if (_m_fd >= 0) {
+            ioctl(_m_fd, PERF_EVENT_IOC_RESET, 0);
+        }
+#endif
+    }
+    ~CacheMissCounter() {
+#if defined(__linux__)
+        if (_m_fd >= 0) close(_m_fd);
+#endif
+    }
+    CacheMissCounter(const CacheMissCounter&) = delete;
+    CacheMissCounter& operator=(const CacheMissCounter&) = delete;
+
+    void resume() {
+#if defined(__linux__)
+        if (_m_fd >= 0) ioctl(_m_fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+    void pause() {
+#if defined(__linux__)
+        if (_m_fd >= 0) ioctl(_m_fd, PERF_EVENT_IOC_DISABLE, 0);
+#endif
+    }
+
+    bool valid() const { return _m_fd >= 0; }
+
+    std::uint64_t value() const {
+        std::uint64_t count{ 0 };
+#if defined(__linux__)
+        if (_m_fd >= 0 && sizeof(count) != read(_m_fd, &count, sizeof(count))) count = 0;
+#endif
+        return count;
+    }
+
+private:
+    int _m_fd{ -1 };
+};
+
+// -------------------------------------------------------------------------------------------
+// a benchmark loop scope: pauses/resumes timing and cache miss counting together, and
+// publishes 's/op' and 'miss/op' (if available) when it ends.  's/op' is an inverted rate:
+// the console shows it with an SI prefix ("25.6ns"), JSON and CSV output in seconds.
+
+class OpScope {
+public:
+    explicit OpScope(benchmark::State &state) : _m_state(state) { _m_cmc.resume(); }
+    ~OpScope() {
+        _m_cmc.pause();
+        _m_state.SetItemsProcessed(static_cast<std::int64_t>(_m_ops));
+        _m_state.counters["s/op"] = benchmark::Counter(double(_m_ops), benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+        if (_m_cmc.valid() && _m_ops) {
+            _m_state.counters["miss/op"] = double(_m_cmc.value()) / double(_m_ops);
+        }
+    }
+
+    void pause()  { _m_state.PauseTiming(); _m_cmc.pause(); }
+    void resume() { _m_cmc.resume(); _m_state.ResumeTiming(); }
+    void ops(std::uint64_t n) { _m_ops += n; }
+
+private:
+    benchmark::State &_m_state;
+    CacheMissCounter  _m_cmc;
+    std::uint64_t     _m_ops{ 0 };
+};
+
+// -------------------------------------------------------------------------------------------
+// reference heaps, dressed up with the interface of the library heaps
+
+/// std::priority_queue as min-heap with 'front()' and 'merge()'
+template<typename _Type, typename _Comp = std::less<_Type>>
+class StdHeap {
+    struct _Rev { bool operator()(const _Type &a, const _Type &b) const { return _Comp()(b, a); } };
+    std::priority_queue<_Type, std::vector<_Type>, _Rev> _m_q;
+
+public:
+    void push(const _Type &v) { _m_q.push(v); }
+    template<typename It>
+    void push(It first, It last) {
+        std::vector<_Type> all;
+        all.reserve(_m_q.size() + std::distance(first, last));
+        while (!_m_q.empty()) { all.push_back(_m_q.top()); _m_q.pop(); }
+        all.insert(all.end(), first, last);
+        _m_q = decltype(_m_q)(_Rev(), std::move(all));
+    }
+    const _Type &front() const { return _m_q.top(); }
+    void pop()                 { _m_q.pop(); }
+    bool empty() const         { return _m_q.empty(); }
+    void clear()               { _m_q = decltype(_m_q)(); }
+    void merge(StdHeap &rhs) {
+        while (!rhs._m_q.empty()) { _m_q.push(rhs._m_q.top()); rhs._m_q.pop(); }
+    }
+};
+
+/// implicit d-ary min-heap in a vector
+template<typename _Type, unsigned _D = 4, typename _Comp = std::less<_Type>>
+class DaryHeap {
+    std::vector<_Type> _m_v;
+
+    void _up(std::size_t i) {
+        _Type hold{ std::move(_m_v[i]) };
+        while (i > 0) {
+            std::size_t p{ (i - 1) / _D };
+            if (!_Comp()(hold, _m_v[p])) break;
+            _m_v[i] = std::move(_m_v[p]);
+            i = p;
+        }
+        _m_v[i] = std::move(hold);
+    }
+    void _down(std::size_t i) {
+        const std::size_t n{ _m_v.size() };
+        _Type hold{ std::move(_m_v[i]) };
+        for (;;) {
+            std::size_t c{ i * _D + 1 }, e{ std::min(c + _D, n) }, b{ c };
+            if (c >= n) break;
+            for (++c; c < e; ++c) if (_Comp()(_m_v[c], _m_v[b])) b = c;
+            if (!_Comp()(_m_v[b], hold)) break;
+            _m_v[i] = std::move(_m_v[b]);
+            i = b;
+        }
+        _m_v[i] = std::move(hold);
+    }
+
+public:
+    void push(const _Type &v) { _m_v.push_back(v); _up(_m_v.size() - 1); }
+    template<typename It>
+    void push(It first, It last) {
+        _m_v.insert(_m_v.end(), first, last);
+        for (std::size_t i{ _m_v.size() / _D + 1 }; i-- > 0; /*NOP*/)
+            if (i < _m_v.size()) _down(i);
+    }
+    const _Type &front() const { return _m_v.front(); }
+    void pop() {
+        _m_v.front() = std::move(_m_v.back());
+        _m_v.pop_back();
+        if (!_m_v.empty()) _down(0);
+    }
+    bool empty() const { return _m_v.empty(); }
+    void clear()       { _m_v.clear(); }
+    void merge(DaryHeap &rhs) {
+        push(rhs._m_v.begin(), rhs._m_v.end());
+        rhs._m_v.clear();
+    }
+};
+
+// -------------------------------------------------------------------------------------------
+// rank of popped keys among the keys still present, for relaxed priority queues.  Keys are
+// 0..n-1; a Fenwick tree over "still present" answers the rank in O(log n).
+
+class RankCounter {
+public:
+    explicit RankCounter(std::size_t n) : _m_tree(n + 1, 0) {
+        for (std::size_t i{ 1 }; i <= n; ++i) {
+            _m_tree[i] += 1;
+            std::size_t up{ i + (i & (0 - i)) };
+            if (up <= n) _m_tree[up] += _m_tree[i];
+        }
+    }
+
+    /// @brief remove key 'k'; returns the number of smaller keys still present (0 = exact)
+    std::size_t pop(std::size_t k) {
+        std::size_t rank{ 0 };
+        for (std::size_t i{ k }; i > 0; i &= i - 1) rank += _m_tree[i];
+        for (std::size_t i{ k + 1 }; i < _m_tree.size(); i += i & (0 - i)) _m_tree[i] -= 1;
+        return rank;
+    }
+
+private:
+    std::vector<std::uint32_t> _m_tree;
+};
+
+// -------------------------------------------------------------------------------------------
+// capabilities of the heaps under test
+
+template<typename H, typename = void>
+struct has_decrease : std::false_type {};
+template<typename H>
+struct has_decrease<H, std::void_t<decltype(std::declval<H&>().decrease(std::declval<typename H::iterator>()))>>
+    : std::true_type {};
+
+template<typename H, typename It, typename = void>
+struct has_bulk_push : std::false_type {};
+template<typename H, typename It>
+struct has_bulk_push<H, It, std::void_t<decltype(std::declval<H&>().push(std::declval<It>(), std::declval<It>()))>>
+    : std::true_type {};
+
+template<typename H, typename V, typename = void>
+struct has_replace_top : std::false_type {};
+template<typename H, typename V>
+struct has_replace_top<H, V, std::void_t<decltype(std::declval<H&>().replace_top(std::declval<V>()))>>
+    : std::true_type {};
+
+/// @brief replace the top element, by 'replace_top()' if the heap has it
+template<typename H, typename V>
+void replace_top(H &heap, V &&value) {
+    if constexpr (has_replace_top<H, V>::value) {
+        heap.replace_top(std::forward<V>(value));
+    } else {
+        heap.pop();
+        heap.push(std::forward<V>(value));
+    }
+}
+
+template<typename H, typename It, typename = void>
+struct has_drain : std::false_type {};
+template<typename H, typename It>
+struct has_drain<H, It, std::void_t<decltype(std::declval<H&>().drain(std::declval<It>()))>>
+    : std::true_type {};
+
+/// @brief move all elements out in order, by 'drain()' if the heap has it
+template<typename H, typename It>
+It drain_into(H &heap, It out) {
+    if constexpr (has_drain<H, It>::value) {
+        return heap.drain(out);
+    } else {
+        for (; !heap.empty(); heap.pop()) *out++ = heap.front();
+        return out;
+    }
+}
+
+template<typename H, typename It>
+void push_range(H &heap, It first, It last) {
+    if constexpr (has_bulk_push<H, It>::value) {
+        heap.push(first, last);
+    } else {
+        for (; first != last; ++first) heap.push(*first);
+    }
+}
+
+// -------------------------------------------------------------------------------------------
+// input data
+
+inline std::vector<std::uint64_t>
+random_keys(std::size_t n, std::uint64_t seed = 4711)
+{
+    std::mt19937_64 rng(seed);
+    std::vector<std::uint64_t> v(n);
+    for (auto &x : v) x = rng();
+    return v;
+}
+
+/// adjacency list in CSR form, edge weights in 1..1000
+struct Graph {
+    std::vector<std::uint32_t> first;   // 'first[v]..first[v+1]' are the edges of v
+    std::vector<std::uint32_t> target;
+    std::vector<std::uint32_t> weight;
+
+    std::size_t vertices() const { return first.size() - 1; }
+};
+
+inline Graph
+random_graph(std::size_t n, unsigned degree = 8, std::uint64_t seed = 4711)
+{
+    std::mt19937_64 rng(seed);
+    Graph g;
+    g.first.resize(n + 1);
+    g.target.resize(n * degree);
+    g.weight.resize(n * degree);
+    for (std::size_t v = 0; v <= n; ++v) g.first[v] = static_cast<std::uint32_t>(v * degree);
+    for (std::size_t e = 0; e < n * degree; ++e) {
+        g.target[e] = static_cast<std::uint32_t>(rng() % n);
+        g.weight[e] = static_cast<std::uint32_t>(rng() % 1000 + 1);
+    }
+    return g;
+}
+
+inline Graph
+grid_graph(std::size_t n, std::uint64_t seed = 4711)
+{
+    std::mt19937_64 rng(seed);
+    std::size_t side{ 1 };
+    while (side * side < n) ++side;
+    n = side * side;
+
+    Graph g;
+    g.first.reserve(n + 1);
+    g.target.reserve(n * 4);
+    g.weight.reserve(n * 4);
+    for (std::size_t v = 0; v < n; ++v) {
+        g.first.push_back(static_cast<std::uint32_t>(g.target.size()));
+        std::size_t r{ v / side }, c{ v % side };
+        auto edge = [&](std::size_t t) {
+            g.target.push_back(static_cast<std::uint32_t>(t));
+            g.weight.push_back(static_cast<std::uint32_t>(rng() % 1000 + 1));
+        };
+        if (r > 0)        edge(v - side);
+        if (r + 1 < side) edge(v + side);
+        if (c > 0)        edge(v - 1);
+        if (c + 1 < side) edge(v + 1);
+    }
+    g.first.push_back(static_cast<std::uint32_t>(g.target.size()));
+    return g;
+}
+
+// -------------------------------------------------------------------------------------------
+// problem sizes: 1e3 .. PQ_BENCH_MAX_N in decades; graph workloads stop at 1e7 vertices
+
+inline void
+heap_sizes(benchmark::internal::Benchmark *b)
+{
+    for (std::int64_t n = 1000; n <= std::int64_t(PQ_BENCH_MAX_N); n *= 10) b->Arg(n);
+}
+
+inline void
+graph_sizes(benchmark::internal::Benchmark *b)
+{
+    for (std::int64_t n = 1000; n <= std::min<std::int64_t>(PQ_BENCH_MAX_N, 10000000); n *= 10) b->Arg(n);
+}
+
+/// sizes for workloads with big payloads (200+ bytes per element)
+inline void
+fat_sizes(benchmark::internal::Benchmark *b)
+{
+    for (std::int64_t n = 1000; n <= std::min<std::int64_t>(PQ_BENCH_MAX_N, 1000000); n *= 10) b->Arg(n);
+}
+
+} // namespace bench
+
+#endif // BENCH_COMMON_9687E0DD_D406_474B_9534_94B7C1D81D33
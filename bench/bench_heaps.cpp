@@ -0,0 +1,827 @@
+// -------------------------------------------------------------------------------------------
+// priority queue benchmarks
+// -------------------------------------------------------------------------------------------
+// this file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+// Workloads:
+//  PushPop     push N random keys, then pop them all
+//  Drain       push N random keys, then 'drain()' them into a vector (pop loop if there's none)
+//  Hold        classic hold model: pop the minimum, push it back with a random increment,
+//              on a heap of N elements
+//  Dijkstra    single source shortest paths on a random (degree 8) and a grid graph with
+//              N vertices; heaps with iterators use 'decrease()', the others lazy deletion
+//  DijkstraIdx the same on the addressable heaps: 'push_or_decrease()' by vertex id, the
+//              vertex entries are preallocated in one array
+//  Merge       meld N/16 heaps of 16 elements pairwise until one is left
+//  Batch       'push(first, last)' of N keys into an empty heap
+//  Burst       N single pushes into an empty heap, then 16 pops
+//  FirstPop    the time of the one pop right after N pushes into an empty heap: the latency
+//              spike the bounded pairing avoids
+//  Restart     'load()' a MinDist Heap of N keys from a snapshot file, relinking the saved
+//              tree ('shape') or building a new one from the values ('rebuild')
+//  Tiny        4096 queues of K = 4..32 elements: fill each one, then empty it again
+//  TopK        keep the least 100 of N random keys in a heap with the reverse order;
+//              'replace_top()' where available, pop and push otherwise
+//  BatchPar    'push(first, last, HeapParallel{ P })' of N keys, P = 1, 2, 4, 8
+//  HoldFat     hold model with a 200 byte payload, with and without the key cached in the
+//              node header ('_KeyOf')
+//  MQRank      push a permutation of 0..N-1 into a MultiQueue, pop it all, and report the
+//              mean and max rank error of the pops ('rank_err', 'rank_max')
+//  MQHold      hold model on N=1e5 elements, shared by 1..8 threads: MultiQueue against a
+//              PairingHeap behind one mutex
+//  SoftRank    push a permutation of 0..N-1 into a SoftHeap with error rate eps (per mille),
+//              pop it all, and report the rank error as MQRank does; eps 0 is the exact
+//              PairingHeap for reference
+//  Expire      timer expiry on a MinDist Heap of N deadlines: every sweep expires the next K
+//              of them and schedules as many again; 'pop_while()' against a loop of pops
+//
+// The Radix Heap takes monotone integer keys only, so it runs PushPop, Drain, Hold, Dijkstra
+// and Burst.
+//
+// Every benchmark reports 's/op' (one push, pop, decrease or merge is an op) and, where
+// the kernel provides hardware counters, 'miss/op' for cache misses.
+// -------------------------------------------------------------------------------------------
+
+#include "bench_common.hpp"
+
+#include "phqueue2.hpp"
+#include "phqueue3.hpp"
+#include "lhqueue2.hpp"
+#include "mdqueue3.hpp"
+#include "multiqueue.hpp"
+#include "bounded.hpp"
+#include "compact.hpp"
+#include "indexed.hpp"
+#include "smallheap.hpp"
+#include "radixheap.hpp"
+#include "softheap.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <string>
+#include <mutex>
+
+namespace {
+
+// -------------------------------------------------------------------------------------------
+// heap families under test -- every workload picks its own value type and order
+
+struct Pairing      { template<typename V, typename C> using heap = PairingHeap<V, C>;      };
+struct PairingEasy  { template<typename V, typename C> using heap = PairingHeapEasy<V, C>;  };
+struct LeftistEasy  { template<typename V, typename C> using heap = LeftistHeapEasy<V, C>;  };
+struct MinDist      { template<typename V, typename C> using heap = MinDistHeap<V, C>;      };
+struct StdPQ        { template<typename V, typename C> using heap = bench::StdHeap<V, C>;   };
+struct Dary4        { template<typename V, typename C> using heap = bench::DaryHeap<V, 4, C>; };
+
+/// the tuning knobs switched on: inlined order and pooled nodes
+struct PairingTuned { template<typename V, typename C> using heap = PairingHeap<V, C, NodePoolAllocator<V>, true>; };
+struct MinDistTuned { template<typename V, typename C> using heap = MinDistHeap<V, C, NodePoolAllocator<V>, true>; };
+
+/// pairing strategies other than the classic two-pass
+struct PairingMulti   { template<typename V, typename C> using heap = PairingHeap<V, C, std::allocator<V>, false, NoHeapStats, PairingMultiPass>; };
+struct PairingAux     { template<typename V, typename C> using heap = PairingHeap<V, C, std::allocator<V>, false, NoHeapStats, PairingAuxTwoPass>; };
+struct PairingEasyAux { template<typename V, typename C> using heap = PairingHeapEasy<V, C, std::allocator<V>, false, NoHeapStats, PairingAuxTwoPass>; };
+struct PairingBounded { template<typename V, typename C> using heap = PairingHeap<V, C, std::allocator<V>, false, NoHeapStats, PairingBoundedPass>; };
+
+/// the first 16 nodes inline in the heap object
+struct SmallPairing { template<typename V, typename C> using heap = SmallPairingHeap<V, 16, C>; };
+
+/// nodes in one array with 32-bit index links
+struct Compact { template<typename V, typename C> using heap = CompactPairingHeap<V, C>; };
+
+/// lazy insertion: pushes are built into the tree on demand
+struct LeftistLazy { template<typename V, typename C> using heap = LeftistHeapEasy<V, C, std::allocator<V>, false, NoHeapStats, true>; };
+struct MinDistLazy { template<typename V, typename C> using heap = MinDistHeap<V, C, std::allocator<V>, false, NoHeapStats, true>; };
+
+using Key = std::uint64_t;
+using KeyLess = std::less<Key>;
+
+struct Fat {
+    Key           key;
+    std::uint8_t  payload[192];
+};
+struct FatLess { bool operator()(const Fat &a, const Fat &b) const { return a.key < b.key; } };
+struct FatKey  { Key  operator()(const Fat &f) const { return f.key; } };
+
+/// key cached in the node header; for 'Fat' only, ordered by 'KeyLess'
+struct PairingKeyed { template<typename V, typename C> using heap = PairingHeap<V, KeyLess, std::allocator<V>, false, NoHeapStats, PairingTwoPass, FatKey>; };
+struct LeftistKeyed { template<typename V, typename C> using heap = LeftistHeapEasy<V, KeyLess, std::allocator<V>, false, NoHeapStats, false, FatKey>; };
+struct MinDistKeyed { template<typename V, typename C> using heap = MinDistHeap<V, KeyLess, std::allocator<V>, false, NoHeapStats, false, FatKey>; };
+
+// -------------------------------------------------------------------------------------------
+
+template<typename F>
+void BM_PushPop(benchmark::State &state)
+{
+    using H = typename F::template heap<Key, KeyLess>;
+    const auto keys{ bench::random_keys(std::size_t(state.range(0))) };
+
+    H heap;
+    bench::OpScope scope(state);
+    for (auto _ : state) {
+        for (Key k : keys) {
+            heap.push(k);
+        }
+        Key sum{ 0 };
+        while (!heap.empty()) {
+            sum += heap.front();
+            heap.pop();
+        }
+        benchmark::DoNotOptimize(sum);
+        scope.ops(2 * keys.size());
+    }
+}
+
+template<typename F>
+void BM_Drain(benchmark::State &state)
+{
+    using H = typename F::template heap<Key, KeyLess>;
+    const auto keys{ bench::random_keys(std::size_t(state.range(0))) };
+    std::vector<Key> out(keys.size());
+
+    H heap;
+    bench::OpScope scope(state);
+    for (auto _ : state) {
+        for (Key k : keys) {
+            heap.push(k);
+        }
+        bench::drain_into(heap, out.begin());
+        benchmark::DoNotOptimize(out.data());
+        scope.ops(2 * keys.size());
+    }
+}
+
+template<typename F>
+void BM_Hold(benchmark::State &state)
+{
+    using H = typename F::template heap<Key, KeyLess>;
+    const auto keys{ bench::random_keys(std::size_t(state.range(0))) };
+    auto       incs{ bench::random_keys(4096, 815) };
+    for (auto &i : incs) {
+        i %= std::numeric_limits<std::uint32_t>::max();
+    }
+
+    H heap;
+    for (Key k : keys) {
+        heap.push(k >> 1);
+    }
+    // the first pop pays for building the tree from N pushes; keep it out of the timing
+    heap.push(heap.front());
+    heap.pop();
+
+    bench::OpScope scope(state);
+    std::size_t idx{ 0 };
+    for (auto _ : state) {
+        Key k{ heap.front() };
+        heap.pop();
+        heap.push(k + incs[idx++ & 4095]);
+        scope.ops(2);
+    }
+}
+
+// -------------------------------------------------------------------------------------------
+
+struct Entry {
+    std::uint64_t dist;
+    std::uint32_t vertex;
+};
+
+struct EntryLess {
+    bool operator()(const Entry &a, const Entry &b) const { return a.dist < b.dist; }
+};
+struct EntryDist { std::uint64_t operator()(const Entry &e) const { return e.dist; } };
+
+/// monotone integer keys only, so not in every workload; the order is always 'less'
+template<typename V> struct RadixKey        { using type = IdentityKey; };
+template<>           struct RadixKey<Entry> { using type = EntryDist;   };
+
+struct Radix { template<typename V, typename C> using heap = RadixHeap<V, typename RadixKey<V>::type>; };
+
+enum class GraphKind { Random, Grid };
+
+const bench::Graph&
+graph_for(GraphKind kind, std::size_t n)
+{
+    // keep the last graph only: the big ones take a lot of memory
+    static GraphKind    s_kind;
+    static std::size_t  s_size{ 0 };
+    static bench::Graph s_graph;
+    if (s_size != n || s_kind != kind) {
+        s_graph = (GraphKind::Random == kind) ? bench::random_graph(n) : bench::grid_graph(n);
+        s_kind  = kind;
+        s_size  = n;
+    }
+    return s_graph;
+}
+
+template<typename H>
+std::uint64_t
+dijkstra(const bench::Graph &g, std::vector<std::uint64_t> &dist)
+{
+    std::uint64_t ops{ 0 };
+    H heap;
+
+    if constexpr (bench::has_decrease<H>::value) {
+        // decrease-key: one heap entry per vertex at most
+        using iterator = typename H::iterator;
+        std::vector<iterator>     where(dist.size());
+        std::vector<std::uint8_t> state(dist.size(), 0);   // 0: unseen, 1: queued, 2: done
+
+        dist[0] = 0;
+        where[0] = heap.push(Entry{ 0, 0 });
+        state[0] = 1;
+        ++ops;
+        while (!heap.empty()) {
+            const Entry e{ heap.front() };
+            heap.pop();
+            state[e.vertex] = 2;
+            ++ops;
+            for (std::uint32_t i{ g.first[e.vertex] }; i < g.first[e.vertex + 1]; ++i) {
+                const std::uint32_t t{ g.target[i] };
+                const std::uint64_t d{ e.dist + g.weight[i] };
+                if (d >= dist[t]) {
+                    continue;
+                }
+                dist[t] = d;
+                if (0 == state[t]) {
+                    where[t] = heap.push(Entry{ d, t });
+                    state[t] = 1;
+                } else {
+                    where[t]->dist = d;
+                    where[t] = heap.decrease(where[t]);
+                }
+                ++ops;
+            }
+        }
+    } else {
+        // lazy deletion: push duplicates, drop stale entries on pop
+        dist[0] = 0;
+        heap.push(Entry{ 0, 0 });
+        ++ops;
+        while (!heap.empty()) {
+            const Entry e{ heap.front() };
+            heap.pop();
+            ++ops;
+            if (e.dist > dist[e.vertex]) {
+                continue;
+            }
+            for (std::uint32_t i{ g.first[e.vertex] }; i < g.first[e.vertex + 1]; ++i) {
+                const std::uint32_t t{ g.target[i] };
+                const std::uint64_t d{ e.dist + g.weight[i] };
+                if (d < dist[t]) {
+                    dist[t] = d;
+                    heap.push(Entry{ d, t });
+                    ++ops;
+                }
+            }
+        }
+    }
+    return ops;
+}
+
+template<typename F, GraphKind _Kind>
+void BM_Dijkstra(benchmark::State &state)
+{
+    using H = typename F::template heap<Entry, EntryLess>;
+    const bench::Graph &g{ graph_for(_Kind, std::size_t(state.range(0))) };
+    std::vector<std::uint64_t> dist(g.vertices());
+
+    bench::OpScope scope(state);
+    for (auto _ : state) {
+        scope.pause();
+        std::fill(dist.begin(), dist.end(), std::numeric_limits<std::uint64_t>::max());
+        scope.resume();
+        scope.ops(dijkstra<H>(g, dist));
+        benchmark::DoNotOptimize(dist.data());
+    }
+}
+
+/// Dijkstra on an addressable heap: the vertices are the ids, no handle table of its own
+template<typename H>
+std::uint64_t
+dijkstra_indexed(const bench::Graph &g, std::vector<std::uint64_t> &dist)
+{
+    std::uint64_t ops{ 0 };
+    H heap(dist.size());
+
+    dist[0] = 0;
+    heap.push_or_decrease(0, 0);
+    ++ops;
+    while (!heap.empty()) {
+        const auto [v, dv]{ heap.top() };
+        heap.pop();
+        ++ops;
+        for (std::uint32_t i{ g.first[v] }; i < g.first[v + 1]; ++i) {
+            const std::uint32_t t{ g.target[i] };
+            const std::uint64_t d{ dv + g.weight[i] };
+            if (d < dist[t]) {
+                dist[t] = d;
+                heap.push_or_decrease(t, d);
+                ++ops;
+            }
+        }
+    }
+    return ops;
+}
+
+template<typename H, GraphKind _Kind>
+void BM_DijkstraIdx(benchmark::State &state)
+{
+    const bench::Graph &g{ graph_for(_Kind, std::size_t(state.range(0))) };
+    std::vector<std::uint64_t> dist(g.vertices());
+
+    bench::OpScope scope(state);
+    for (auto _ : state) {
+        scope.pause();
+        std::fill(dist.begin(), dist.end(), std::numeric_limits<std::uint64_t>::max());
+        scope.resume();
+        scope.ops(dijkstra_indexed<H>(g, dist));
+        benchmark::DoNotOptimize(dist.data());
+    }
+}
+
+template<typename F> void BM_DijkstraRandom(benchmark::State &state) { BM_Dijkstra<F, GraphKind::Random>(state); }
+template<typename F> void BM_DijkstraGrid  (benchmark::State &state) { BM_Dijkstra<F, GraphKind::Grid  >(state); }
+
+// -------------------------------------------------------------------------------------------
+
+template<typename F>
+void BM_Merge(benchmark::State &state)
+{
+    using H = typename F::template heap<Key, KeyLess>;
+    constexpr std::size_t group{ 16 };
+    const auto keys{ bench::random_keys(std::size_t(state.range(0))) };
+
+    bench::OpScope scope(state);
+    for (auto _ : state) {
+        scope.pause();
+        std::vector<H> heaps((keys.size() + group - 1) / group);
+        for (std::size_t i{ 0 }; i < keys.size(); ++i) {
+            heaps[i / group].push(keys[i]);
+        }
+        scope.resume();
+
+        for (std::size_t step{ 1 }; step < heaps.size(); step *= 2) {
+            for (std::size_t i{ 0 }; i + step < heaps.size(); i += 2 * step) {
+                heaps[i].merge(heaps[i + step]);
+                scope.ops(1);
+            }
+        }
+        benchmark::DoNotOptimize(heaps.front().front());
+
+        scope.pause();
+        heaps.clear();
+        scope.resume();
+    }
+}
+
+template<typename F>
+void BM_Batch(benchmark::State &state)
+{
+    using H = typename F::template heap<Key, KeyLess>;
+    const auto keys{ bench::random_keys(std::size_t(state.range(0))) };
+
+    H heap;
+    bench::OpScope scope(state);
+    for (auto _ : state) {
+        bench::push_range(heap, keys.begin(), keys.end());
+        benchmark::DoNotOptimize(heap.front());
+        scope.ops(keys.size());
+
+        scope.pause();
+        heap.clear();
+        scope.resume();
+    }
+}
+
+/// warm restart: load N keys from a snapshot, relinking the saved tree or rebuilding it
+template<HeapLoad _How>
+void BM_Restart(benchmark::State &state)
+{
+    using H = MinDist::heap<Key, KeyLess>;
+    const auto        keys{ bench::random_keys(std::size_t(state.range(0))) };
+    const std::string path{ "pq_bench_restart.snap" };
+    {
+        H heap;
+        bench::push_range(heap, keys.begin(), keys.end());
+        heap.save(path);
+    }
+
+    H heap;
+    bench::OpScope scope(state);
+    for (auto _ : state) {
+        heap.load(path, _How);
+        benchmark::DoNotOptimize(heap.front());
+        scope.ops(keys.size());
+
+        scope.pause();
+        heap.clear();
+        scope.resume();
+    }
+    std::remove(path.c_str());
+}
+
+template<typename F>
+void BM_TopK(benchmark::State &state)
+{
+    using H = typename F::template heap<Key, ReverseOrder<KeyLess>>;
+    constexpr std::size_t K{ 100 };
+    const auto keys{ bench::random_keys(std::size_t(state.range(0))) };
+
+    bench::OpScope scope(state);
+    for (auto _ : state) {
+        H heap;
+        std::size_t held{ 0 };
+        for (Key k : keys) {
+            if (held < K) {
+                heap.push(k);
+                ++held;
+            } else if (k < heap.front()) {
+                bench::replace_top(heap, k);
+            }
+        }
+        benchmark::DoNotOptimize(heap.front());
+        scope.ops(keys.size());
+    }
+}
+
+template<typename F>
+void BM_BatchPar(benchmark::State &state)
+{
+    using H = typename F::template heap<Key, KeyLess>;
+    const auto         keys{ bench::random_keys(std::size_t(state.range(0))) };
+    const HeapParallel par{ unsigned(state.range(1)) };
+
+    H heap;
+    bench::OpScope scope(state);
+    for (auto _ : state) {
+        heap.push(keys.begin(), keys.end(), par);
+        benchmark::DoNotOptimize(heap.front());
+        scope.ops(keys.size());
+
+        scope.pause();
+        heap.clear();
+        scope.resume();
+    }
+}
+
+template<typename F>
+void BM_HoldFat(benchmark::State &state)
+{
+    using H = typename F::template heap<Fat, FatLess>;
+    const auto keys{ bench::random_keys(std::size_t(state.range(0))) };
+    auto       incs{ bench::random_keys(4096, 815) };
+    for (auto &i : incs) {
+        i %= std::numeric_limits<std::uint32_t>::max();
+    }
+
+    H heap;
+    for (Key k : keys) {
+        heap.push(Fat{ k >> 1, {} });
+    }
+    heap.push(heap.front());
+    heap.pop();
+
+    bench::OpScope scope(state);
+    std::size_t idx{ 0 };
+    for (auto _ : state) {
+        Fat f{ heap.front() };
+        heap.pop();
+        f.key += incs[idx++ & 4095];
+        heap.push(f);
+        scope.ops(2);
+    }
+}
+
+template<typename F>
+void BM_Burst(benchmark::State &state)
+{
+    using H = typename F::template heap<Key, KeyLess>;
+    const auto keys{ bench::random_keys(std::size_t(state.range(0))) };
+
+    H heap;
+    bench::OpScope scope(state);
+    for (auto _ : state) {
+        for (Key k : keys) {
+            heap.push(k);
+        }
+        Key sum{ 0 };
+        for (int i{ 0 }; i < 16 && !heap.empty(); ++i) {
+            sum += heap.front();
+            heap.pop();
+        }
+        benchmark::DoNotOptimize(sum);
+        scope.ops(keys.size() + 16);
+
+        scope.pause();
+        heap.clear();
+        scope.resume();
+    }
+}
+
+template<typename F>
+void BM_FirstPop(benchmark::State &state)
+{
+    using H = typename F::template heap<Key, KeyLess>;
+    const auto keys{ bench::random_keys(std::size_t(state.range(0))) };
+
+    H heap;
+    for (auto _ : state) {
+        heap.clear();
+        for (Key k : keys) {
+            heap.push(k);
+        }
+        const auto start{ std::chrono::steady_clock::now() };
+        heap.pop();
+        benchmark::DoNotOptimize(heap.front());
+        state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+}
+
+template<typename F>
+void BM_Tiny(benchmark::State &state)
+{
+    using H = typename F::template heap<Key, KeyLess>;
+    const std::size_t queues{ 4096 }, k{ std::size_t(state.range(0)) };
+    const auto keys{ bench::random_keys(queues * k) };
+
+    std::vector<H> heaps(queues);
+    bench::OpScope scope(state);
+    for (auto _ : state) {
+        Key sum{ 0 };
+        for (std::size_t q{ 0 }; q < queues; ++q) {
+            H &heap{ heaps[q] };
+            for (std::size_t i{ q * k }; i < (q + 1) * k; ++i) {
+                heap.push(keys[i]);
+            }
+            while (!heap.empty()) {
+                sum += heap.front();
+                heap.pop();
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+        scope.ops(2 * keys.size());
+    }
+}
+
+// -------------------------------------------------------------------------------------------
+// concurrent queues
+
+/// the baseline: one heap, one lock
+template<typename _Type>
+class LockedHeap {
+    std::mutex                 _m_lock;
+    PairingHeapEasy<_Type>     _m_heap;
+
+public:
+    explicit LockedHeap(std::size_t) {}
+    void push(const _Type &v) {
+        std::lock_guard<std::mutex> hold(_m_lock);
+        _m_heap.push(v);
+    }
+    bool try_pop(_Type &out) {
+        std::lock_guard<std::mutex> hold(_m_lock);
+        if (_m_heap.empty()) return false;
+        out = _m_heap.front();
+        _m_heap.pop();
+        return true;
+    }
+};
+
+void BM_MQRank(benchmark::State &state)
+{
+    const std::size_t n{ std::size_t(state.range(0)) };
+    std::vector<Key> keys(n);
+    for (std::size_t i{ 0 }; i < n; ++i) keys[i] = i;
+    std::shuffle(keys.begin(), keys.end(), std::mt19937_64(4711));
+
+    std::vector<Key> order;
+    order.reserve(n);
+    double        rank_sum{ 0 };
+    std::size_t   rank_max{ 0 }, pops{ 0 };
+    bench::OpScope scope(state);
+    for (auto _ : state) {
+        MultiQueue<Key> mq(std::size_t(state.range(1)));
+        for (Key k : keys) {
+            mq.push(k);
+        }
+        Key k{ 0 };
+        while (mq.try_pop(k)) {
+            order.push_back(k);
+        }
+        scope.ops(2 * n);
+
+        scope.pause();
+        bench::RankCounter ranks(n);
+        for (Key p : order) {
+            std::size_t r{ ranks.pop(p) };
+            rank_sum += double(r);
+            rank_max = std::max(rank_max, r);
+        }
+        pops += order.size();
+        order.clear();
+        scope.resume();
+    }
+    state.counters["rank_err"] = pops ? rank_sum / double(pops) : 0.0;
+    state.counters["rank_max"] = double(rank_max);
+}
+
+void BM_SoftRank(benchmark::State &state)
+{
+    const std::size_t n{ std::size_t(state.range(0)) };
+    const double      eps{ double(state.range(1)) / 1000.0 };
+    std::vector<Key> keys(n);
+    for (std::size_t i{ 0 }; i < n; ++i) keys[i] = i;
+    std::shuffle(keys.begin(), keys.end(), std::mt19937_64(4711));
+
+    std::vector<Key> order;
+    order.reserve(n);
+    double        rank_sum{ 0 };
+    std::size_t   rank_max{ 0 }, pops{ 0 };
+    bench::OpScope scope(state);
+    for (auto _ : state) {
+        if (0.0 == eps) {
+            PairingHeap<Key> heap;
+            for (Key k : keys) {
+                heap.push(k);
+            }
+            for (; !heap.empty(); heap.pop()) {
+                order.push_back(heap.front());
+            }
+        } else {
+            SoftHeap<Key> heap(eps);
+            for (Key k : keys) {
+                heap.push(k);
+            }
+            for (; !heap.empty(); heap.pop()) {
+                order.push_back(heap.front());
+            }
+        }
+        scope.ops(2 * n);
+
+        scope.pause();
+        bench::RankCounter ranks(n);
+        for (Key p : order) {
+            std::size_t r{ ranks.pop(p) };
+            rank_sum += double(r);
+            rank_max = std::max(rank_max, r);
+        }
+        pops += order.size();
+        order.clear();
+        scope.resume();
+    }
+    state.counters["rank_err"] = pops ? rank_sum / double(pops) : 0.0;
+    state.counters["rank_max"] = double(rank_max);
+}
+
+template<typename Q>
+void BM_MQHold(benchmark::State &state)
+{
+    static std::unique_ptr<Q> s_queue;
+    if (0 == state.thread_index()) {
+        s_queue.reset(new Q(2 * std::size_t(state.threads())));
+        for (Key k : bench::random_keys(std::size_t(state.range(0)))) {
+            s_queue->push(k >> 1);
+        }
+    }
+    const auto incs{ bench::random_keys(4096, 815 + state.thread_index()) };
+
+    bench::OpScope scope(state);
+    std::size_t idx{ 0 };
+    for (auto _ : state) {
+        Key k{ 0 };
+        if (s_queue->try_pop(k)) {
+            s_queue->push(k + (incs[idx++ & 4095] >> 32));
+        }
+        scope.ops(2);
+    }
+
+    if (0 == state.thread_index()) {
+        s_queue.reset();
+    }
+}
+
+/// timer expiry: N deadlines one 'step' apart on average, K of them due per sweep
+template<bool _Sweep>
+void BM_Expire(benchmark::State &state)
+{
+    const std::size_t n{ std::size_t(state.range(0)) }, k{ std::size_t(state.range(1)) };
+    constexpr Key     step{ 1024 };
+    std::vector<Key>  due;
+
+    MinDistHeap<Key, KeyLess, std::allocator<Key>, true> heap;
+    for (Key d : bench::random_keys(n)) {
+        heap.push(d % (n * step));
+    }
+    Key now{ 0 };
+
+    bench::OpScope scope(state);
+    for (auto _ : state) {
+        now += k * step;
+        if constexpr (_Sweep) {
+            heap.pop_while([now](Key d) { return d <= now; }, std::back_inserter(due));
+        } else {
+            while (!heap.empty() && heap.front() <= now) {
+                due.push_back(heap.front());
+                heap.pop();
+            }
+        }
+        for (Key d : due) {
+            heap.push(d + n * step);
+        }
+        scope.ops(2 * due.size());
+        due.clear();
+    }
+}
+
+} // namespace
+
+// -------------------------------------------------------------------------------------------
+
+#define PQ_BENCH_FAMILIES(fn, sizes, unit)                          \
+    BENCHMARK_TEMPLATE(fn, Pairing     )->Apply(sizes)->Unit(unit); \
+    BENCHMARK_TEMPLATE(fn, PairingTuned)->Apply(sizes)->Unit(unit); \
+    BENCHMARK_TEMPLATE(fn, PairingMulti)->Apply(sizes)->Unit(unit); \
+    BENCHMARK_TEMPLATE(fn, PairingAux  )->Apply(sizes)->Unit(unit); \
+    BENCHMARK_TEMPLATE(fn, PairingEasy )->Apply(sizes)->Unit(unit); \
+    BENCHMARK_TEMPLATE(fn, PairingEasyAux)->Apply(sizes)->Unit(unit); \
+    BENCHMARK_TEMPLATE(fn, Compact     )->Apply(sizes)->Unit(unit); \
+    BENCHMARK_TEMPLATE(fn, LeftistEasy )->Apply(sizes)->Unit(unit); \
+    BENCHMARK_TEMPLATE(fn, LeftistLazy )->Apply(sizes)->Unit(unit); \
+    BENCHMARK_TEMPLATE(fn, MinDist     )->Apply(sizes)->Unit(unit); \
+    BENCHMARK_TEMPLATE(fn, MinDistTuned)->Apply(sizes)->Unit(unit); \
+    BENCHMARK_TEMPLATE(fn, MinDistLazy )->Apply(sizes)->Unit(unit); \
+    BENCHMARK_TEMPLATE(fn, StdPQ       )->Apply(sizes)->Unit(unit); \
+    BENCHMARK_TEMPLATE(fn, Dary4       )->Apply(sizes)->Unit(unit)
+
+PQ_BENCH_FAMILIES(BM_PushPop,        bench::heap_sizes,  benchmark::kMillisecond);
+PQ_BENCH_FAMILIES(BM_Drain,          bench::heap_sizes,  benchmark::kMillisecond);
+PQ_BENCH_FAMILIES(BM_Hold,           bench::heap_sizes,  benchmark::kNanosecond);
+PQ_BENCH_FAMILIES(BM_DijkstraRandom, bench::graph_sizes, benchmark::kMillisecond);
+PQ_BENCH_FAMILIES(BM_DijkstraGrid,   bench::graph_sizes, benchmark::kMillisecond);
+PQ_BENCH_FAMILIES(BM_Merge,          bench::heap_sizes,  benchmark::kMillisecond);
+PQ_BENCH_FAMILIES(BM_Batch,          bench::heap_sizes,  benchmark::kMillisecond);
+PQ_BENCH_FAMILIES(BM_Burst,          bench::heap_sizes,  benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_DijkstraIdx, IndexedPairingHeap<Key>, GraphKind::Random)->Apply(bench::graph_sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_DijkstraIdx, IndexedPairingHeap<Key>, GraphKind::Grid  )->Apply(bench::graph_sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_DijkstraIdx, IndexedMinDistHeap<Key>, GraphKind::Random)->Apply(bench::graph_sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_DijkstraIdx, IndexedMinDistHeap<Key>, GraphKind::Grid  )->Apply(bench::graph_sizes)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_PushPop,        Radix)->Apply(bench::heap_sizes )->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Drain,          Radix)->Apply(bench::heap_sizes )->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Hold,           Radix)->Apply(bench::heap_sizes )->Unit(benchmark::kNanosecond);
+BENCHMARK_TEMPLATE(BM_DijkstraRandom, Radix)->Apply(bench::graph_sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_DijkstraGrid,   Radix)->Apply(bench::graph_sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Burst,          Radix)->Apply(bench::heap_sizes )->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_Restart, HeapLoad::shape  )->Apply(bench::heap_sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Restart, HeapLoad::rebuild)->Apply(bench::heap_sizes)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_HoldFat, Pairing     )->Apply(bench::fat_sizes)->Unit(benchmark::kNanosecond);
+BENCHMARK_TEMPLATE(BM_HoldFat, PairingKeyed)->Apply(bench::fat_sizes)->Unit(benchmark::kNanosecond);
+BENCHMARK_TEMPLATE(BM_HoldFat, LeftistEasy )->Apply(bench::fat_sizes)->Unit(benchmark::kNanosecond);
+BENCHMARK_TEMPLATE(BM_HoldFat, LeftistKeyed)->Apply(bench::fat_sizes)->Unit(benchmark::kNanosecond);
+BENCHMARK_TEMPLATE(BM_HoldFat, MinDist     )->Apply(bench::fat_sizes)->Unit(benchmark::kNanosecond);
+BENCHMARK_TEMPLATE(BM_HoldFat, MinDistKeyed)->Apply(bench::fat_sizes)->Unit(benchmark::kNanosecond);
+BENCHMARK_TEMPLATE(BM_HoldFat, StdPQ       )->Apply(bench::fat_sizes)->Unit(benchmark::kNanosecond);
+
+BENCHMARK_TEMPLATE(BM_PushPop,        PairingBounded)->Apply(bench::heap_sizes )->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Hold,           PairingBounded)->Apply(bench::heap_sizes )->Unit(benchmark::kNanosecond);
+BENCHMARK_TEMPLATE(BM_DijkstraRandom, PairingBounded)->Apply(bench::graph_sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Burst,          PairingBounded)->Apply(bench::heap_sizes )->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_FirstPop, Pairing       )->Apply(bench::heap_sizes)->Unit(benchmark::kMicrosecond)->UseManualTime()->Iterations(8);
+BENCHMARK_TEMPLATE(BM_FirstPop, PairingAux    )->Apply(bench::heap_sizes)->Unit(benchmark::kMicrosecond)->UseManualTime()->Iterations(8);
+BENCHMARK_TEMPLATE(BM_FirstPop, PairingBounded)->Apply(bench::heap_sizes)->Unit(benchmark::kMicrosecond)->UseManualTime()->Iterations(8);
+BENCHMARK_TEMPLATE(BM_FirstPop, MinDist       )->Apply(bench::heap_sizes)->Unit(benchmark::kMicrosecond)->UseManualTime()->Iterations(8);
+BENCHMARK_TEMPLATE(BM_FirstPop, Dary4         )->Apply(bench::heap_sizes)->Unit(benchmark::kMicrosecond)->UseManualTime()->Iterations(8);
+
+BENCHMARK_TEMPLATE(BM_Tiny, Pairing     )->RangeMultiplier(2)->Range(4, 32);
+BENCHMARK_TEMPLATE(BM_Tiny, PairingEasy )->RangeMultiplier(2)->Range(4, 32);
+BENCHMARK_TEMPLATE(BM_Tiny, SmallPairing)->RangeMultiplier(2)->Range(4, 32);
+BENCHMARK_TEMPLATE(BM_Tiny, StdPQ       )->RangeMultiplier(2)->Range(4, 32);
+
+BENCHMARK_TEMPLATE(BM_TopK, PairingEasy)->Apply(bench::heap_sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_TopK, Compact    )->Apply(bench::heap_sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_TopK, LeftistEasy)->Apply(bench::heap_sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_TopK, StdPQ      )->Apply(bench::heap_sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_TopK, Dary4      )->Apply(bench::heap_sizes)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_BatchPar, LeftistEasy)->ArgsProduct({ { 1000000, 10000000 }, { 1, 2, 4, 8 } })->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_BatchPar, MinDist    )->ArgsProduct({ { 1000000, 10000000 }, { 1, 2, 4, 8 } })->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK(BM_MQRank)->ArgsProduct({ { 10000, 100000 }, { 1, 4, 16, 64 } })->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SoftRank)->ArgsProduct({ { 100000, 1000000 }, { 0, 1, 10, 50, 100, 250, 500 } })->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_MQHold, MultiQueue<Key>)->Arg(100000)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MQHold, LockedHeap<Key>)->Arg(100000)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Expire, false)->ArgsProduct({ { 100000, 1000000 }, { 16, 256, 4096 } })->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_Expire, true )->ArgsProduct({ { 100000, 1000000 }, { 16, 256, 4096 } })->Unit(benchmark::kMicrosecond);
+
+// --*-- that's all folks --*--
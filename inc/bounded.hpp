@@ -0,0 +1,96 @@
+// -------------------------------------------------------------------------------------------
+// BoundedHeap: keep the best K values of a stream
+// -------------------------------------------------------------------------------------------
+// This file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+// 'BoundedHeap<T, K, Comp>' keeps the K least values (by 'Comp') offered to it.  Internally this
+// is a heap with the reverse order, so its front is the worst value kept:
+//
+//  - a value not better than the worst one is rejected with one comparison, the tree is not
+//    touched;
+//  - a better value takes the place of the worst one through 'replace_top()', which reuses
+//    the node: once K values are held, nothing is allocated or freed any more.
+//
+// The heap type defaults to a 'PairingHeapEasy'; a 'LeftistHeapEasy' (or any heap type with
+// 'replace_top()' and the usual interface) ordered by 'ReverseOrder<Comp>' works as well.
+// -------------------------------------------------------------------------------------------
+#ifndef BOUNDED_9687E0DD_D406_474B_9534_94B7C1D81D33
+#define BOUNDED_9687E0DD_D406_474B_9534_94B7C1D81D33
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "phqueue2.hpp"
+
+/// @brief stateless comparator turning another stateless comparator around
+template<typename _Comp>
+struct ReverseOrder {
+    template<typename _Lhs, typename _Rhs>
+    bool operator()(const _Lhs &lhs, const _Rhs &rhs) const { return _Comp()(rhs, lhs); }
+};
+
+template<typename _Type,
+         std::size_t _Cap,
+         typename _Comp = std::less<_Type>,
+         typename _Heap = PairingHeapEasy<_Type, ReverseOrder<_Comp>> >
+class BoundedHeap
+{
+    static_assert(_Cap > 0, "BoundedHeap needs room for at least one value");
+
+protected:
+    _Heap _m_heap;
+
+    template<typename _Arg>
+    bool _offer(_Arg &&value) {
+        if (_m_heap.size() < _Cap) {
+            _m_heap.push(std::forward<_Arg>(value));
+            return true;
+        }
+        if (_Comp()(value, _m_heap.front())) {
+            _m_heap.replace_top(std::forward<_Arg>(value));
+            return true;
+        }
+        return false;
+    }
+
+public:
+    static constexpr std::size_t capacity() { return _Cap; }
+
+    /// @brief pre-populate the node allocator for the full set of values
+    void reserve() { _m_heap.reserve(_Cap); }
+
+    /// @brief offer a value
+    /// @return @c true if it was kept (it's among the best @c K so far)
+    bool offer(const _Type &  value) { return _offer(value); }
+    bool offer(      _Type && value) { return _offer(std::move(value)); }
+
+    /// @brief the worst value kept, i.e. the one to beat once the heap is full
+    const _Type &worst() const { return _m_heap.front(); }
+
+    std::size_t size() const { return _m_heap.size(); }
+    bool        empty() const { return _m_heap.empty(); }
+    bool        full() const { return _m_heap.size() == _Cap; }
+    void        clear() { _m_heap.clear(); }
+
+    /// @brief move the values out, worst first (the order of the inner heap)
+    template<typename _OutIt>
+    _OutIt drain(_OutIt out) { return _m_heap.drain(out); }
+
+    /// @brief move the values out, best first
+    std::vector<_Type> sorted() {
+        std::vector<_Type> retv;
+        retv.reserve(_m_heap.size());
+        _m_heap.drain(std::back_inserter(retv));
+        std::reverse(retv.begin(), retv.end());
+        return retv;
+    }
+};
+
+#endif // BOUNDED_9687E0DD_D406_474B_9534_94B7C1D81D33
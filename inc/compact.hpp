@@ -0,0 +1,414 @@
+// -------------------------------------------------------------------------------------------
+// Compact Pairing Heap: nodes in one array, linked by 32-bit indices
+// -------------------------------------------------------------------------------------------
+// This file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+// The pointer based heaps pay two or three 8-byte links per node plus the allocator's header;
+// for small values that is several times the payload.  'CompactPairingHeap' keeps the nodes
+// of a forward-only Pairing Heap (see phqueue2.hpp) in one contiguous vector and links them by
+// index, with the index type a template parameter:
+//
+//   CompactPairingHeap<std::uint32_t>   12 bytes per node, PairingHeapEasy<std::uint32_t>
+//                                       24 bytes plus the allocator's overhead
+//
+// Nodes freed by 'pop()' go to a free list chained through the same links and are reused by
+// the next 'push()'.  Since no link is a pointer, the node array can be moved around as a
+// whole: it grows by reallocation, and 'merge()' appends the other heap's array and rebases
+// its links.
+//
+// The price: values must be trivially copyable, a heap holds at most 2^bits-1 nodes, and
+// there is neither iteration nor decrease-key (use the pointer based heaps for those).
+// -------------------------------------------------------------------------------------------
+#ifndef COMPACT_9687E0DD_D406_474B_9534_94B7C1D81D33
+#define COMPACT_9687E0DD_D406_474B_9534_94B7C1D81D33
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "pairpass.hpp"
+#include "prefetch.hpp"
+
+template<typename _Index = std::uint32_t>
+class CompactPairingHeapT {
+    static_assert(std::is_unsigned<_Index>::value, "index type must be an unsigned integer");
+
+public:
+    using index_type = _Index;
+
+    static constexpr _Index npos{ std::numeric_limits<_Index>::max() };
+
+    struct LinkT {
+        _Index _m_next { npos };
+        _Index _m_down { npos };
+    };
+
+    // The core algorithms take the node array besides the order policy; '_Node' is derived
+    // from 'LinkT', and the order policy compares two '_Node's.  Those working on the tree are
+    // constexpr, for a node array in a 'std::array' (see staticheap.hpp).
+    template<typename _Ord, typename _Node>                                  constexpr _Index _merge(const _Ord &ord, _Node *nodes, _Index h1, _Index h2) const;
+    template<typename _Pass = PairingTwoPass, typename _Ord, typename _Node> constexpr _Index _build(const _Ord &ord, _Node *nodes, _Index h) const;
+    template<typename _Ord, typename _Node>                                  constexpr void   _push(const _Ord &ord, _Node *nodes, _Index node);
+    template<typename _Pass = PairingTwoPass, typename _Ord, typename _Node> constexpr _Index _pop(const _Ord &ord, _Node *nodes);
+    template<typename _Node>                                                 constexpr void   _release(_Node *nodes, _Index node);
+    template<typename _Node> static                                          void   _rebase(_Node *nodes, std::size_t count, _Index offset);
+    template<typename _Ord, typename _Node>                                  void   _validate(const _Ord &ord, const _Node *nodes, std::size_t count) const;
+
+    // index links for the shared pairing pass (see pairpass.hpp)
+    template<typename _Ord, typename _Node>
+    struct _Links {
+        using link_type = _Index;
+        static constexpr _Index nil{ npos };
+        const CompactPairingHeapT *_m_heap;
+        const _Ord                *_m_ord;
+        _Node                     *_m_nodes;
+
+        constexpr _Index next(_Index n) const           { return _m_nodes[n]._m_next; }
+        constexpr void   next(_Index n, _Index s) const { _m_nodes[n]._m_next = s; }
+        constexpr _Index merge(_Index a, _Index b) const { return _m_heap->_merge(*_m_ord, _m_nodes, a, b); }
+        constexpr void   prefetch(_Index n) const       { if (npos != n) { heap_prefetch(_m_nodes + n); } }
+    };
+
+    _Index      _m_root { npos };
+    _Index      _m_free { npos };       // head of the free list, chained via '_m_next'
+    std::size_t _m_size { 0 };          // number of nodes in the tree
+};
+
+/// @brief merge two heaps. O(1) actual
+/// @param ord   order policy
+/// @param nodes node array
+/// @param h1    1st heap
+/// @param h2    2nd heap
+/// @return      root of combined heap
+template<typename _Index>
+template<typename _Ord, typename _Node>
+constexpr _Index
+CompactPairingHeapT<_Index>::_merge(
+    const _Ord &ord,
+    _Node      *nodes,
+    _Index      h1,
+    _Index      h2) const
+{
+    // h1 gets precedence unless that would violate the order constraint
+    if (npos == h1) {
+        return h2;
+    }
+    if (npos != h2) {
+        const bool   flip{ ord(nodes[h2], nodes[h1]) };
+        const _Index kid{ flip ? h1 : h2 };
+        h1 = flip ? h2 : h1;
+        nodes[kid]._m_next = nodes[h1]._m_down;
+        nodes[h1]._m_down = kid;
+    }
+    nodes[h1]._m_next = npos;
+    return h1;
+}
+
+/// @brief build a heap from a sibling list of sub-heaps
+/// @param ord   order policy
+/// @param nodes node array
+/// @param h     head of sibling list
+/// @return      root of combined heap
+///
+/// The same pairing passes as @c PairingHeapEasyT::_build(), on indices (see pairpass.hpp).
+template<typename _Index>
+template<typename _Pass, typename _Ord, typename _Node>
+constexpr _Index
+CompactPairingHeapT<_Index>::_build(
+    const _Ord &ord,
+    _Node      *nodes,
+    _Index      h) const
+{
+    static_assert(!_Pass::auxiliary, "CompactPairingHeap has no auxiliary pairing");
+
+    std::size_t roots{ 0 };
+    return heap_pairing_pass<_Pass>(_Links<_Ord, _Node>{ this, &ord, nodes }, h, roots);
+}
+
+/// @brief push a node into the heap
+/// @param ord   order policy
+/// @param nodes node array
+/// @param node  node to insert; its links must be clear
+template<typename _Index>
+template<typename _Ord, typename _Node>
+constexpr void
+CompactPairingHeapT<_Index>::_push(
+    const _Ord &ord,
+    _Node      *nodes,
+    _Index      node)
+{
+    _m_root = _merge(ord, nodes, _m_root, node);
+    ++_m_size;
+}
+
+/// @brief unlink the root and build a new heap from its children
+/// @param ord   order policy
+/// @param nodes node array
+/// @return      index of the former root or @c npos if empty
+///
+/// The node is not put on the free list yet: the caller may want its value first.
+template<typename _Index>
+template<typename _Pass, typename _Ord, typename _Node>
+constexpr _Index
+CompactPairingHeapT<_Index>::_pop(
+    const _Ord &ord,
+    _Node      *nodes)
+{
+    _Index retv{ _m_root };
+    if (npos != retv) {
+        _m_root = _build<_Pass>(ord, nodes, nodes[retv]._m_down);
+        nodes[retv]._m_down = nodes[retv]._m_next = npos;
+        --_m_size;
+    }
+    return retv;
+}
+
+/// @brief put an unlinked node on the free list
+template<typename _Index>
+template<typename _Node>
+constexpr void
+CompactPairingHeapT<_Index>::_release(
+    _Node  *nodes,
+    _Index  node)
+{
+    nodes[node]._m_down = npos;
+    nodes[node]._m_next = _m_free;
+    _m_free = node;
+}
+
+/// @brief shift all links of a node array, after it was appended to another one
+/// @param nodes  first node of the moved array
+/// @param count  number of nodes
+/// @param offset index of the first node in its new place
+template<typename _Index>
+template<typename _Node>
+void
+CompactPairingHeapT<_Index>::_rebase(
+    _Node       *nodes,
+    std::size_t  count,
+    _Index       offset)
+{
+    for (std::size_t idx{ 0 }; idx < count; ++idx) {
+        if (npos != nodes[idx]._m_next) {
+            nodes[idx]._m_next += offset;
+        }
+        if (npos != nodes[idx]._m_down) {
+            nodes[idx]._m_down += offset;
+        }
+    }
+}
+
+/// @brief check heap order, the node count and the free list
+/// @param ord   order policy
+/// @param nodes node array
+/// @param count number of nodes in the array
+/// @throws @c std::logic_error if the heap is broken
+template<typename _Index>
+template<typename _Ord, typename _Node>
+void
+CompactPairingHeapT<_Index>::_validate(
+    const _Ord  &ord,
+    const _Node *nodes,
+    std::size_t  count) const
+{
+    std::size_t seen{ 0 }, loose{ 0 };
+    std::vector<_Index> stack;
+
+    if (npos != _m_root) {
+        if (_m_root >= count || npos != nodes[_m_root]._m_next) {
+            throw std::logic_error("bad root");
+        }
+        stack.push_back(_m_root);
+    }
+    while (!stack.empty()) {
+        _Index node{ stack.back() };
+        stack.pop_back();
+        if (++seen > _m_size) {
+            throw std::logic_error("too many nodes (or a cycle)");
+        }
+        for (_Index kid{ nodes[node]._m_down }; npos != kid; kid = nodes[kid]._m_next) {
+            if (kid >= count) {
+                throw std::logic_error("index out of range");
+            }
+            if (ord(nodes[kid], nodes[node])) {
+                throw std::logic_error("heap order");
+            }
+            stack.push_back(kid);
+        }
+    }
+    if (seen != _m_size) {
+        throw std::logic_error("node count");
+    }
+    for (_Index node{ _m_free }; npos != node; node = nodes[node]._m_next) {
+        if (node >= count || ++loose > count - seen) {
+            throw std::logic_error("free list");
+        }
+    }
+    if (seen + loose != count) {
+        throw std::logic_error("lost nodes");
+    }
+}
+
+// -------------------------------------------------------------------------------------------
+
+template<typename _Type,
+         typename _Comp = std::less<_Type>,
+         typename _Index = std::uint32_t,
+         typename _Pass = PairingTwoPass >
+class CompactPairingHeap : protected CompactPairingHeapT<_Index>
+{
+    using _Base = CompactPairingHeapT<_Index>;
+    using typename _Base::LinkT;
+    using _Base::npos;
+
+    // --- value guard ---
+    static_assert(std::is_trivially_copyable<_Type>::value,
+        "CompactPairingHeap relocates its nodes and requires trivially copyable values");
+
+    // --- comparator guard ---
+    static_assert(std::is_empty<_Comp>::value,
+        "CompactPairingHeap requires a stateless comparator");
+
+protected:
+    struct _XNode : public LinkT {
+        _Type _m_value;
+    };
+
+    struct _XOrder {
+        bool operator()(const _XNode &n1, const _XNode &n2) const { return _Comp()(n1._m_value, n2._m_value); }
+    };
+
+    std::vector<_XNode> _m_nodes;
+
+    _Index _create_node(const _Type &value) {
+        _Index node{ this->_m_free };
+        if (npos != node) {
+            this->_m_free = _m_nodes[node]._m_next;
+            _m_nodes[node]._m_next = npos;
+        } else {
+            if (_m_nodes.size() >= std::size_t(npos)) {
+                throw std::length_error("CompactPairingHeap index space exhausted");
+            }
+            node = _Index(_m_nodes.size());
+            _m_nodes.emplace_back();
+        }
+        _m_nodes[node]._m_value = value;
+        return node;
+    }
+
+public:
+    using value_type = _Type;
+    using index_type = _Index;
+
+    /// size of one node in bytes
+    static constexpr std::size_t node_size = sizeof(_XNode);
+
+    CompactPairingHeap()
+    { /*NOP*/ }
+
+    /// @brief make room for @c n nodes in total, so pushing does not reallocate
+    void reserve(std::size_t n) { _m_nodes.reserve(n); }
+
+    /// @brief number of nodes allocated, in the tree or on the free list
+    std::size_t capacity() const { return _m_nodes.size(); }
+
+    /// @brief give unused array capacity back; an empty heap drops its free nodes, too
+    void shrink_to_fit() {
+        if (this->empty()) {
+            clear();
+        }
+        _m_nodes.shrink_to_fit();
+    }
+
+    void push(const _Type &value) {
+        _Index node{ _create_node(value) };
+        this->_push(_XOrder(), _m_nodes.data(), node);
+    }
+
+    const _Type &front() const {
+        if (npos == this->_m_root) {
+            throw std::invalid_argument("empty");
+        }
+        return _m_nodes[this->_m_root]._m_value;
+    }
+
+    void pop() {
+        _Index node{ this->template _pop<_Pass>(_XOrder(), _m_nodes.data()) };
+        if (npos == node) {
+            throw std::invalid_argument("empty");
+        }
+        this->_release(_m_nodes.data(), node);
+    }
+
+    /// @brief pop the least value, if any
+    /// @return @c false if the heap was empty
+    bool try_pop(_Type &out) {
+        _Index node{ this->template _pop<_Pass>(_XOrder(), _m_nodes.data()) };
+        if (npos == node) {
+            return false;
+        }
+        out = _m_nodes[node]._m_value;
+        this->_release(_m_nodes.data(), node);
+        return true;
+    }
+
+    bool        empty() const { return npos == this->_m_root; }
+    std::size_t size() const { return this->_m_size; }
+
+    /// @brief drop all values and nodes
+    void clear() {
+        _m_nodes.clear();
+        this->_m_root = this->_m_free = npos;
+        this->_m_size = 0;
+    }
+
+    /// @brief merge another heap into this one
+    /// @param rhs heap to absorb; empty afterwards
+    ///
+    /// The nodes of @c rhs are appended to this heap's array, so this is O(rhs.capacity()),
+    /// not O(1) as for the pointer based heaps; the free nodes of @c rhs are kept.
+    CompactPairingHeap &merge(CompactPairingHeap &rhs) {
+        if (this != &rhs && 0 != rhs._m_nodes.size()) {
+            if (_m_nodes.size() + rhs._m_nodes.size() > std::size_t(npos)) {
+                throw std::length_error("CompactPairingHeap index space exhausted");
+            }
+            // append first and rebase the copy: if the insert throws, neither heap changed
+            const _Index offset{ _Index(_m_nodes.size()) };
+            _m_nodes.insert(_m_nodes.end(), rhs._m_nodes.begin(), rhs._m_nodes.end());
+            _Base::_rebase(_m_nodes.data() + offset, rhs._m_nodes.size(), offset);
+
+            _XNode *nodes{ _m_nodes.data() };
+            if (npos != rhs._m_free) {
+                // hook our free list behind the one of rhs
+                const _Index head{ _Index(rhs._m_free + offset) };
+                _Index       tail{ head };
+                while (npos != nodes[tail]._m_next) {
+                    tail = nodes[tail]._m_next;
+                }
+                nodes[tail]._m_next = this->_m_free;
+                this->_m_free = head;
+            }
+            if (npos != rhs._m_root) {
+                this->_m_root = this->_merge(_XOrder(), nodes, this->_m_root, _Index(rhs._m_root + offset));
+            }
+            this->_m_size += rhs._m_size;
+            rhs.clear();
+        }
+        return *this;
+    }
+
+    void validate_tree() const {
+        this->_validate(_XOrder(), _m_nodes.data(), _m_nodes.size());
+    }
+};
+
+#endif // COMPACT_9687E0DD_D406_474B_9534_94B7C1D81D33
@@ -0,0 +1,211 @@
+// -------------------------------------------------------------------------------------------
+// Operation counters for the heap core algorithms
+// -------------------------------------------------------------------------------------------
+// This file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+// A heap's last template parameter selects a statistics policy.  The default 'NoHeapStats'
+// costs nothing: the core algorithms see the plain order policy, and all hooks below are
+// empty overloads the compiler throws away.
+//
+// Any other policy type is wrapped together with the order policy into a 'StatsOrderT', which
+// counts comparisons itself and routes the hooks to the policy object of the heap.  A policy
+// needs to provide these members (see 'HeapStats' for the obvious implementation):
+//
+//   void on_compare();                  // one invocation of the order predicate
+//   void on_link();                     // a node got (re-)linked below another one by a merge
+//   void on_pop();                      // the root was removed
+//   void on_build(std::size_t roots);   // pairing pass started over a list of 'roots' trees
+//
+// A policy may also take cycle counts (see 'HeapCycleStats'); '_build()' and '_merge()' of the
+// heaps report their run time then, read with 'rdtsc' on x86 and a steady clock elsewhere:
+//
+//   void on_cycles(HeapPhase phase, std::uint64_t cycles);
+//
+// Note: A heap with statistics always instantiates its own copy of the core algorithms, even
+// if it uses the virtual order predicate.
+//
+// Independent of the policy, 'shape_stats()' of a heap walks its tree once and reports the
+// shape in a 'HeapShape': depths, the spine or root list a pop has to work through, and the
+// leaf distances.  It neither throws nor allocates for the 3-way heaps, and is meant for
+// monitoring release builds, unlike 'validate_tree()'.  The 2-way heaps keep a stack as deep
+// as the tree for it, and may throw 'std::bad_alloc'.
+// -------------------------------------------------------------------------------------------
+#ifndef HEAPSTATS_9687E0DD_D406_474B_9534_94B7C1D81D33
+#define HEAPSTATS_9687E0DD_D406_474B_9534_94B7C1D81D33
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+# include <x86intrin.h>
+#endif
+
+/// @brief statistics policy: no statistics (the default)
+struct NoHeapStats {};
+
+/// @brief statistics policy: plain counters
+struct HeapStats {
+    std::uint64_t comparisons{ 0 };     // order predicate calls
+    std::uint64_t links{ 0 };           // nodes linked below another node by merging
+    std::uint64_t pops{ 0 };            // root removals
+    std::size_t   max_roots{ 0 };       // longest list of trees seen by a pairing pass
+
+    void on_compare()                   { ++comparisons; }
+    void on_link()                      { ++links;       }
+    void on_pop()                       { ++pops;        }
+    void on_build(std::size_t roots)    { max_roots = std::max(max_roots, roots); }
+};
+
+/// @brief the timed sections of the core algorithms
+enum class HeapPhase {
+    build,          ///< '_build()': a pairing pass, or making a heap from a list
+    merge           ///< '_merge()' of two Leftist / Min-Dist trees, the ones of builds included
+};
+
+/// @brief statistics policy: plain counters and the cycles spent in builds and merges
+struct HeapCycleStats : HeapStats {
+    std::uint64_t builds{ 0 };
+    std::uint64_t build_cycles{ 0 };
+    std::uint64_t merges{ 0 };
+    std::uint64_t merge_cycles{ 0 };
+
+    void on_cycles(HeapPhase phase, std::uint64_t cycles) {
+        if (HeapPhase::build == phase) {
+            ++builds;
+            build_cycles += cycles;
+        } else {
+            ++merges;
+            merge_cycles += cycles;
+        }
+    }
+};
+
+/// @brief tree shape as reported by @c shape_stats()
+struct HeapShape {
+    std::size_t nodes{ 0 };             // nodes in the tree, pending ones not included
+    std::size_t pending{ 0 };           // lazy insert: nodes waiting; aux twopass: trees behind the root
+    std::size_t max_depth{ 0 };         // deepest node, the root has depth 0
+    double      avg_depth{ 0.0 };       // mean depth of the nodes
+    std::size_t spine{ 0 };             // Leftist / Min-Dist: nodes on the right spine from the root
+    std::size_t roots{ 0 };             // Pairing: children of the root, the list the next pop pairs up
+    std::array<std::size_t, 32> dist{}; // Leftist / Min-Dist: nodes per leaf distance, the last bucket takes the rest
+
+    void _visit(std::size_t depth) {
+        ++nodes;
+        max_depth  = std::max(max_depth, depth);
+        avg_depth += double(depth);
+    }
+    void _ldist(short d) {
+        ++dist[std::min<std::size_t>(std::size_t(d < 0 ? 0 : d), dist.size() - 1)];
+    }
+    HeapShape &_done() {
+        avg_depth = nodes ? avg_depth / double(nodes) : 0.0;
+        return *this;
+    }
+};
+
+/// @brief a time stamp in cycles if the CPU offers a counter, else in nanoseconds
+inline std::uint64_t
+heap_cycles()
+{
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    return __rdtsc();
+#else
+    return std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/// @brief order policy with statistics: forwards to the embedded order, counts on the side
+template<typename _Ord, typename _Stats>
+struct StatsOrderT {
+    _Ord    _m_ord;
+    _Stats *_m_stats;
+
+    template<typename _Node>
+    bool operator()(const _Node &n1, const _Node &n2) const {
+        _m_stats->on_compare();
+        return _m_ord(n1, n2);
+    }
+};
+
+// -------------------------------------------------------------------------------------------
+// hooks for the core algorithms; the more specialised overloads win for 'StatsOrderT'
+
+template<typename _Ord> inline constexpr void heap_stats_link (const _Ord &)              { /*NOP*/ }
+template<typename _Ord> inline constexpr void heap_stats_pop  (const _Ord &)              { /*NOP*/ }
+template<typename _Ord> inline constexpr void heap_stats_build(const _Ord &, std::size_t) { /*NOP*/ }
+
+template<typename _Ord, typename _Stats>
+inline void heap_stats_link (const StatsOrderT<_Ord, _Stats> &ord)                    { ord._m_stats->on_link();  }
+template<typename _Ord, typename _Stats>
+inline void heap_stats_pop  (const StatsOrderT<_Ord, _Stats> &ord)                    { ord._m_stats->on_pop();   }
+template<typename _Ord, typename _Stats>
+inline void heap_stats_build(const StatsOrderT<_Ord, _Stats> &ord, std::size_t roots) { ord._m_stats->on_build(roots); }
+
+/// @brief policies taking cycle counts
+template<typename _Stats, typename = void>
+struct heap_stats_timed : std::false_type {};
+template<typename _Stats>
+struct heap_stats_timed<_Stats, std::void_t<decltype(std::declval<_Stats&>().on_cycles(HeapPhase::build, 0))>>
+    : std::true_type {};
+
+/// @brief scope guard reporting its lifetime to the policy
+template<typename _Stats>
+struct HeapCycleTimerT {
+    _Stats        *_m_stats;
+    HeapPhase      _m_phase;
+    std::uint64_t  _m_start{ heap_cycles() };
+
+    HeapCycleTimerT(_Stats *stats, HeapPhase phase) : _m_stats{ stats }, _m_phase{ phase } { /*NOP*/ }
+    HeapCycleTimerT(const HeapCycleTimerT &) = delete;
+    HeapCycleTimerT& operator=(const HeapCycleTimerT &) = delete;
+    ~HeapCycleTimerT() { _m_stats->on_cycles(_m_phase, heap_cycles() - _m_start); }
+};
+
+struct HeapNoTimer {};
+
+/// @brief time the enclosing scope, if the order carries a policy taking cycle counts
+template<typename _Ord>
+inline constexpr HeapNoTimer heap_stats_timer(const _Ord &, HeapPhase) { return {}; }
+
+template<typename _Ord, typename _Stats>
+inline auto
+heap_stats_timer(const StatsOrderT<_Ord, _Stats> &ord, HeapPhase phase)
+{
+    if constexpr (heap_stats_timed<_Stats>::value) {
+        return HeapCycleTimerT<_Stats>{ ord._m_stats, phase };
+    } else {
+        (void)ord;
+        (void)phase;
+        return HeapNoTimer{};
+    }
+}
+
+/// @brief the order policy without the statistics, for work on other threads
+template<typename _Ord> inline const _Ord &heap_stats_plain(const _Ord &ord)                    { return ord; }
+template<typename _Ord, typename _Stats>
+inline const _Ord &heap_stats_plain(const StatsOrderT<_Ord, _Stats> &ord)                       { return ord._m_ord; }
+
+/// @brief wrap an order policy for a statistics policy (or don't, for @c NoHeapStats )
+template<typename _Stats, typename _Ord>
+inline auto
+heap_stats_order(const _Ord &ord, _Stats &stats)
+{
+    if constexpr (std::is_same<_Stats, NoHeapStats>::value) {
+        (void)stats;
+        return ord;
+    } else {
+        return StatsOrderT<_Ord, _Stats>{ ord, &stats };
+    }
+}
+
+#endif // HEAPSTATS_9687E0DD_D406_474B_9534_94B7C1D81D33
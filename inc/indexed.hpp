@@ -0,0 +1,176 @@
+// -------------------------------------------------------------------------------------------
+// Addressable heaps keyed by a dense integer id
+// -------------------------------------------------------------------------------------------
+// This file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+// Graph searches want 'decrease-key by vertex', which with the iterator based heaps means a
+// side table vertex -> iterator.  Here the nodes themselves form an id-indexed array: entry
+// 'id' is an intrusive hook plus the priority, linked into an intrusive heap when the id is
+// queued.  The array is its own handle table -- the node of an id is found by indexing -- and
+// nothing is ever allocated after construction.
+//
+//   IndexedPairingHeap<unsigned> pq(vertices);
+//   pq.push_or_decrease(source, 0);
+//   while (!pq.empty()) {
+//       auto [v, d] = pq.top(); pq.pop();
+//       for (auto [w, len] : edges(v)) pq.push_or_decrease(w, d + len);
+//   }
+//
+// The set of ids is fixed when the heap is created, so entries never move while linked.
+// -------------------------------------------------------------------------------------------
+#ifndef INDEXED_9687E0DD_D406_474B_9534_94B7C1D81D33
+#define INDEXED_9687E0DD_D406_474B_9534_94B7C1D81D33
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "mdqueue3.hpp"
+#include "phqueue3.hpp"
+
+template<typename _Prio,
+         typename _Comp,
+         typename _Hook,
+         template<typename, typename, bool> class _Heap,
+         bool     _Inline = false,
+         typename _Id = std::size_t >
+class IndexedHeapT
+{
+    // --- comparator guard ---
+    static_assert(std::is_empty<_Comp>::value,
+        "IndexedHeap requires a stateless comparator");
+
+protected:
+    struct _XEntry : public _Hook {
+        _Prio _m_prio{};
+    };
+
+    struct _XLess {
+        bool operator()(const _XEntry &e1, const _XEntry &e2) const { return _Comp()(e1._m_prio, e2._m_prio); }
+    };
+
+    using heap_type = _Heap<_XEntry, _XLess, _Inline>;
+
+    std::vector<_XEntry> _m_entry;
+    heap_type            _m_heap;
+
+    _Id _index(const _XEntry &entry) const {
+        return _Id(&entry - _m_entry.data());
+    }
+
+public:
+    using id_type   = _Id;
+    using prio_type = _Prio;
+
+    /// @brief create an empty heap for the ids @c 0 .. @c ids-1
+    explicit IndexedHeapT(std::size_t ids)
+        : _m_entry(ids)
+    { /*NOP*/ }
+
+    IndexedHeapT(const IndexedHeapT &) = delete;
+    IndexedHeapT &operator=(const IndexedHeapT &) = delete;
+
+    ~IndexedHeapT() {
+        _m_heap.clear();
+    }
+
+    /// @brief number of ids the heap was created for
+    std::size_t ids() const { return _m_entry.size(); }
+
+    std::size_t size() const { return _m_heap.size(); }
+    bool        empty() const { return _m_heap.empty(); }
+
+    /// @brief check if an id is queued
+    bool contains(_Id id) const {
+        return heap_type::is_linked(_m_entry[id]);
+    }
+
+    /// @brief priority of a queued id (or of the last one it had)
+    const _Prio &prio(_Id id) const {
+        return _m_entry[id]._m_prio;
+    }
+
+    /// @brief queue an id, or lower the priority of a queued one
+    /// @param id   id to queue
+    /// @param prio priority
+    /// @return @c true if the id was queued or its priority lowered, @c false if it already
+    ///         had an equal or better priority
+    bool push_or_decrease(_Id id, const _Prio &prio) {
+        _XEntry &entry{ _m_entry[id] };
+        if (!heap_type::is_linked(entry)) {
+            entry._m_prio = prio;
+            _m_heap.push(entry);
+            return true;
+        }
+        if (_Comp()(prio, entry._m_prio)) {
+            entry._m_prio = prio;
+            _m_heap.decrease(entry);
+            return true;
+        }
+        return false;
+    }
+
+    /// @brief queue an id, or change the priority of a queued one in any direction
+    void push_or_update(_Id id, const _Prio &prio) {
+        _XEntry &entry{ _m_entry[id] };
+        entry._m_prio = prio;
+        if (heap_type::is_linked(entry)) {
+            _m_heap.readjust(entry);
+        } else {
+            _m_heap.push(entry);
+        }
+    }
+
+    /// @brief remove an id from the heap
+    /// @return @c false if the id was not queued
+    bool erase(_Id id) {
+        _XEntry &entry{ _m_entry[id] };
+        if (!heap_type::is_linked(entry)) {
+            return false;
+        }
+        _m_heap.remove(entry);
+        return true;
+    }
+
+    /// @brief the id with the least priority, and that priority
+    std::pair<_Id, _Prio> top() const {
+        const _XEntry &entry{ _m_heap.front() };
+        return { _index(entry), entry._m_prio };
+    }
+
+    /// @brief unqueue the id with the least priority
+    /// @return the former top id
+    _Id pop() {
+        _XEntry *entry{ _m_heap.pop() };
+        if (nullptr == entry) {
+            throw std::invalid_argument("empty");
+        }
+        return _index(*entry);
+    }
+
+    /// @brief unqueue all ids
+    void clear() {
+        _m_heap.clear();
+    }
+
+    void validate_tree() const {
+        _m_heap.validate_tree();
+    }
+};
+
+/// @brief addressable Pairing Heap: O(1) push, decrease-key O(1) amortized
+template<typename _Prio, typename _Comp = std::less<_Prio>, bool _Inline = false, typename _Id = std::size_t>
+using IndexedPairingHeap = IndexedHeapT<_Prio, _Comp, PairingHeapHook, IntrusivePairingHeap, _Inline, _Id>;
+
+/// @brief addressable Min-Dist Heap: all operations O(log N) actual
+template<typename _Prio, typename _Comp = std::less<_Prio>, bool _Inline = false, typename _Id = std::size_t>
+using IndexedMinDistHeap = IndexedHeapT<_Prio, _Comp, MinDistHeapHook, IntrusiveMinDistHeap, _Inline, _Id>;
+
+#endif // INDEXED_9687E0DD_D406_474B_9534_94B7C1D81D33
@@ -0,0 +1,59 @@
+// -------------------------------------------------------------------------------------------
+// Key extraction for the typed heaps: cache the compare key in the node header
+// -------------------------------------------------------------------------------------------
+// This file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+// A typed heap node is the link header of the base class followed by the value.  With a
+// big value, every comparison in a meld touches the value's cache line(s) as well as the
+// header's.  A key extractor '_KeyOf' (a stateless functor 'key_type operator()(const T&)')
+// makes the node cache the key right behind the links, so the core algorithms only ever touch
+// the header; the value follows as the cold payload.  The heap's comparator then orders keys,
+// not values.
+//
+// Layout: The link headers are not PODs, so the key goes into their tail padding where
+// possible.  E.g. a 32-bit key shares the last 8 bytes of a Min-Dist node header with
+// '_m_dist', keeping the header at 32 bytes on 64-bit targets.
+//
+// The key is loaded when the node is created, and again by the iterator based operations
+// 'decrease()' and 'readjust()', so changing the value through an iterator works just as
+// without a key cache.  The default 'IdentityKey' caches nothing and compares the values.
+// -------------------------------------------------------------------------------------------
+#ifndef KEYOF_9687E0DD_D406_474B_9534_94B7C1D81D33
+#define KEYOF_9687E0DD_D406_474B_9534_94B7C1D81D33
+
+#include <type_traits>
+
+/// @brief key extraction policy: no key, compare the values themselves (the default)
+struct IdentityKey {};
+
+/// @brief node mixin holding the cached key, to be placed right behind the link header
+template<typename _Type, typename _KeyOf>
+struct HeapKeyT {
+    static_assert(std::is_empty<_KeyOf>::value, "the key extractor must be stateless");
+
+    using key_type = typename std::decay<decltype(_KeyOf()(std::declval<const _Type&>()))>::type;
+
+    key_type _m_key{};
+
+    const key_type &_key(const _Type &) const { return _m_key; }
+    void            _load(const _Type &value) { _m_key = _KeyOf()(value); }
+
+    static key_type _extract(const _Type &value) { return _KeyOf()(value); }   // key of a value not in a node
+};
+
+/// @brief no key cache: empty (so it costs no space), and the value is the key
+template<typename _Type>
+struct HeapKeyT<_Type, IdentityKey> {
+    using key_type = _Type;
+
+    const _Type &_key(const _Type &value) const { return value; }
+    void         _load(const _Type &) { /*NOP*/ }
+
+    static const _Type &_extract(const _Type &value) { return value; }
+};
+
+#endif // KEYOF_9687E0DD_D406_474B_9534_94B7C1D81D33
@@ -13,11 +13,20 @@
 #ifndef LHQUEUE2_9687E0DD_D406_474B_9534_94B7C1D81D33
 #define LHQUEUE2_9687E0DD_D406_474B_9534_94B7C1D81D33
 
+#include <climits>
 #include <memory>
 #include <functional>
 #include <iterator>
 #include <stdexcept>
 #include <type_traits>
+#include <vector>
+
+#include "heapstats.hpp"
+#include "keyof.hpp"
+#include "listsort.hpp"
+#include "nodepool.hpp"
+#include "parbuild.hpp"
+#include "prefetch.hpp"
 
 class LeftistHeapEasyT
 {
@@ -29,23 +38,363 @@ public:
     };
 
     virtual bool        _pred(const BaseNodeT &n1, const BaseNodeT &n2) const = 0;
-    void                _push(BaseNodeT *node);
-    void                _push_list(BaseNodeT *node);
-    BaseNodeT          *_pop();
-    BaseNodeT          *_merge(BaseNodeT *h1, BaseNodeT *h2) const;
+
+    // order policy for the core algorithms calling back through the virtual '_pred()'
+    struct VirtualOrderT {
+        const LeftistHeapEasyT *_m_heap;
+        bool operator()(const BaseNodeT &n1, const BaseNodeT &n2) const { return _m_heap->_pred(n1, n2); }
+    };
+
+    // the core algorithms down to '_merge()' are constexpr, for nodes in a 'std::array' (see
+    // staticheap.hpp)
+    template<typename _Ord> constexpr void       _push(const _Ord &ord, BaseNodeT *node);
+    template<typename _Ord> constexpr void       _push_list(const _Ord &ord, BaseNodeT *node);
+    template<typename _Ord> constexpr BaseNodeT *_build(const _Ord &ord, BaseNodeT *head, std::size_t &count) const;
+    template<typename _Ord> constexpr BaseNodeT *_pop(const _Ord &ord);
+    template<typename _Ord> constexpr BaseNodeT *_merge(const _Ord &ord, BaseNodeT *h1, BaseNodeT *h2) const;
+    template<typename _Ord> void                 _push_lists(const _Ord &ord, BaseNodeT *const *heads, unsigned count);  // parallel build
+    template<typename _Ord> void                 _replace(const _Ord &ord);  // the root's key changed
+    template<typename _Ord> void                 _meld(const _Ord &ord, LeftistHeapEasyT &rhs);
+    template<typename _Ord> void                 _flush(const _Ord &ord);    // build the pending nodes into the tree
+    template<typename _Ord> BaseNodeT           *_drain(const _Ord &ord);    // yield all nodes, sorted
+
+    void                _defer(BaseNodeT *node);                    // lazy insert: add node to the pending list
+    BaseNodeT          *_yield();
+    void                _take(LeftistHeapEasyT &rhs);
 
     static BaseNodeT   *_shred_pop(BaseNodeT * &pref);
-    static BaseNodeT   *_singleton(BaseNodeT *node);
+    static constexpr BaseNodeT *_singleton(BaseNodeT *node);
     void                validate_tree(size_t nodes) const;
+    void                validate_tree() const { validate_tree(_m_size); }
+    HeapShape           shape_stats() const;
 
-    static BaseNodeT   *_cons(BaseNodeT *node, BaseNodeT *tail) { return node ? ((node->_m_rptr = tail), node) : tail; }
+    static constexpr BaseNodeT *_cons(BaseNodeT *node, BaseNodeT *tail) { return node ? ((node->_m_rptr = tail), node) : tail; }
 
-    BaseNodeT *_m_root{ nullptr };
+    BaseNodeT  *_m_root{ nullptr };
+    std::size_t _m_size{ 0 };           // number of nodes in the tree, pending nodes included
+    BaseNodeT  *_m_pend{ nullptr };     // lazy insert: pending nodes, chained via @c _m_rptr
+    std::size_t _m_npend{ 0 };          // lazy insert: length of the pending list
 };
 
+/// @brief reset a node to a clean singleton heap
+/// @param node node to reset (may be @c nullptr)
+/// @return     @c node
+inline constexpr LeftistHeapEasyT::BaseNodeT*
+LeftistHeapEasyT::_singleton(BaseNodeT* node)
+{
+    if (nullptr != node) {
+        node->_m_lptr = node->_m_rptr = nullptr;
+        node->_m_dist = 1;
+    }
+    return node;
+}
+
+/// @brief append a node to the pending list; it goes into the tree with the next @c _flush()
+/// @param node node to insert
+inline void
+LeftistHeapEasyT::_defer(
+    BaseNodeT *node)
+{
+    _m_pend = _cons(_singleton(node), _m_pend);
+    ++_m_npend;
+    ++_m_size;
+}
+
+/// @brief cut the whole tree from the heap
+/// @return the former root
+///
+/// Pending nodes come first, with the tree hung behind the last one.  That's no heap, but
+/// fine for shredding; a heap-ordered tree needs a @c _flush() before.
+inline LeftistHeapEasyT::BaseNodeT*
+LeftistHeapEasyT::_yield()
+{
+    BaseNodeT *hold{ nullptr };
+    std::swap(hold, _m_root);
+    if (nullptr != _m_pend) {
+        BaseNodeT *tail{ _m_pend };
+        while (nullptr != tail->_m_rptr) {
+            tail = tail->_m_rptr;
+        }
+        tail->_m_rptr = hold;
+        hold = _m_pend;
+        _m_pend = nullptr;
+        _m_npend = 0;
+    }
+    _m_size = 0;
+    return hold;
+}
+
+/// @brief move the tree and pending nodes of another heap into this (empty) heap
+/// @param rhs  heap to take the nodes from; empty afterwards
+inline void
+LeftistHeapEasyT::_take(
+    LeftistHeapEasyT &rhs)
+{
+    std::size_t size{ rhs._m_size }, npend{ rhs._m_npend };
+    BaseNodeT  *pend{ rhs._m_pend };
+    rhs._m_pend  = nullptr;
+    rhs._m_npend = 0;
+    _m_root  = rhs._yield();
+    _m_size  = size;
+    _m_pend  = pend;
+    _m_npend = npend;
+}
+
+// The core algorithms are templates on the order policy; the virtual predicate flavour is
+// instantiated once in the library.
+
+/// @brief merge two heaps. O(log(N)) actual
+/// @param ord  order policy
+/// @param h1   1st heap
+/// @param h2   2nd heap
+/// @return     root of combined heap
+///
+/// Two passes without recursion: walking down, the right spines are merged and the path
+/// is threaded backwards through the right pointers.  Walking back up the path, the right
+/// pointers are restored and the leftist property is fixed bottom-up.
+template<typename _Ord>
+constexpr LeftistHeapEasyT::BaseNodeT*
+LeftistHeapEasyT::_merge(
+    const _Ord &ord,
+    BaseNodeT  *h1,
+    BaseNodeT  *h2) const
+{
+    [[maybe_unused]] const auto timer{ heap_stats_timer(ord, HeapPhase::merge) };
+    BaseNodeT *path{ nullptr }, *node{ nullptr };
+
+    // Phase I: top-down along the right spines, reversing the links of the merge path
+    while ((nullptr != h1) && (nullptr != h2)) {
+        // whichever wins, its right child is compared next
+        heap_prefetch(h1->_m_rptr);
+        heap_prefetch(h2->_m_rptr);
+        const bool flip{ ord(*h2, *h1) };
+        node = flip ? h2 : h1;
+        h2   = flip ? h1 : h2;
+        h1 = node->_m_rptr;
+        node->_m_rptr = path;
+        path = node;
+        heap_stats_link(ord);
+    }
+    if (nullptr == h1) {
+        h1 = h2;
+    }
+
+    // Phase II: bottom-up, hang the merged tail back and fix distances
+    while (nullptr != (node = path)) {
+        path = node->_m_rptr;
+        node->_m_rptr = h1;
+        if ((nullptr == node->_m_lptr) || (h1->_m_dist > node->_m_lptr->_m_dist)) {
+            std::swap(node->_m_rptr, node->_m_lptr);
+        }
+        node->_m_dist = (node->_m_rptr ? node->_m_rptr->_m_dist : 0) + 1;
+        h1 = node;
+    }
+    return h1;
+}
+
+/// @brief push a node into the heap
+/// @param ord  order policy
+/// @param node node to insert
+template<typename _Ord>
+constexpr void
+LeftistHeapEasyT::_push(
+    const _Ord &ord,
+    BaseNodeT  *node)
+{
+    _m_root = _merge(ord, _m_root, _singleton(node));
+    ++_m_size;
+}
+
+/// @brief batch-building a heap from a list of nodes in O(N)
+/// @param ord      order policy
+/// @param head     head of a list chained via @c _m_rptr
+/// @param count    receives the number of nodes in the list
+/// @return         root of the new heap
+template<typename _Ord>
+constexpr LeftistHeapEasyT::BaseNodeT*
+LeftistHeapEasyT::_build(
+    const _Ord  &ord,
+    BaseNodeT   *head,
+    std::size_t &count) const
+{
+    [[maybe_unused]] const auto timer{ heap_stats_timer(ord, HeapPhase::build) };
+    constexpr unsigned limit{ sizeof(void*) * CHAR_BIT };
+    BaseNodeT* hedge[limit]{};
+    unsigned   hsize{ 0 }, hidx{ 0 };
+    BaseNodeT* node{ nullptr };
+    count = 0;
+
+    // Phase I: construct the hedge, bottom-up
+    while (nullptr != (node = head)) {  // more work to do?
+        head = node->_m_rptr;
+        ++count;
+
+        _singleton(node);
+        for (hidx = 0; (hidx < hsize) && (nullptr != hedge[hidx]); ++hidx) {
+            node = _merge(ord, hedge[hidx], node);
+            hedge[hidx] = nullptr;
+        }
+        if (hidx < hsize) {
+            hedge[hidx] = node;
+        } else if (hsize < limit) {
+            hedge[hsize++] = node;
+        } else {
+            hedge[limit - 1] = node;
+        }
+    }
+
+    // Phase II: combine all nodes in hedge
+    for (hidx = 0; hidx < hsize; ++hidx)
+        if (nullptr != hedge[hidx])
+            node = _merge(ord, hedge[hidx], node);
+    return node;
+}
+
+/// @brief batch-insert a list of nodes in O(N)
+/// @param ord  order policy
+/// @param head head of a list chained via @c _m_rptr
+template<typename _Ord>
+constexpr void
+LeftistHeapEasyT::_push_list(
+    const _Ord &ord,
+    BaseNodeT  *head)
+{
+    std::size_t count;
+    BaseNodeT  *node{ _build(ord, head, count) };
+
+    // merge the created heap with the existing heap!
+    _m_root = _merge(ord, _m_root, node);
+    _m_size += count;
+    heap_stats_build(ord, count);
+}
+
+/// @brief push several node lists into the heap, building them on one thread each
+/// @param ord      order policy
+/// @param heads    heads of lists chained via @c _m_rptr
+/// @param count    number of lists
+template<typename _Ord>
+void
+LeftistHeapEasyT::_push_lists(
+    const _Ord       &ord,
+    BaseNodeT *const *heads,
+    unsigned          count)
+{
+    std::vector<BaseNodeT*>   roots(count, nullptr);
+    std::vector<std::size_t>  sizes(count, 0);
+    heap_parallel_for(count, [&](unsigned idx) {
+        roots[idx] = _build(heap_stats_plain(ord), heads[idx], sizes[idx]);
+    });
+    for (unsigned idx{ 0 }; idx < count; ++idx) {
+        _m_root = _merge(ord, _m_root, roots[idx]);
+        _m_size += sizes[idx];
+        heap_stats_build(ord, sizes[idx]);
+    }
+}
+
+/// @brief build the pending nodes into the tree (in O(N), by @c _push_list())
+/// @param ord  order policy
+template<typename _Ord>
+void
+LeftistHeapEasyT::_flush(
+    const _Ord &ord)
+{
+    if (nullptr != _m_pend) {
+        BaseNodeT *head{ _m_pend };
+        _m_size -= _m_npend;
+        _m_pend  = nullptr;
+        _m_npend = 0;
+        _push_list(ord, head);
+    }
+}
+
+/// @brief pop the tip/root node from the heap and build a new heap from its children
+/// @param ord  order policy
+/// @return pointer to former root or @c nullptr if empty
+template<typename _Ord>
+constexpr LeftistHeapEasyT::BaseNodeT*
+LeftistHeapEasyT::_pop(
+    const _Ord &ord)
+{
+    BaseNodeT *retv { _m_root };
+    if (nullptr != retv) {
+        _m_root = _merge(ord, retv->_m_lptr, retv->_m_rptr);
+        --_m_size;
+        heap_stats_pop(ord);
+    }
+    return _singleton(retv);
+}
+
+/// @brief merge another heap into this one
+/// @param ord  order policy
+/// @param rhs  heap to absorb; empty afterwards
+template<typename _Ord>
+void
+LeftistHeapEasyT::_meld(
+    const _Ord       &ord,
+    LeftistHeapEasyT &rhs)
+{
+    if (this != &rhs) {
+        _flush(ord);
+        rhs._flush(ord);
+        std::size_t size{ _m_size + rhs._m_size };
+        _m_root = _merge(ord, _yield(), rhs._yield());
+        _m_size = size;
+    }
+}
+
+/// @brief restore the heap after the key of the root node changed (in any direction)
+/// @param ord  order policy
+///
+/// The root's children are merged, and the root is merged back as a singleton: the same
+/// work as 'pop()' followed by 'push()', without the node ever leaving the heap.
+template<typename _Ord>
+void
+LeftistHeapEasyT::_replace(
+    const _Ord &ord)
+{
+    BaseNodeT *root{ _m_root };
+    if (nullptr != root) {
+        BaseNodeT *kids{ _merge(ord, root->_m_lptr, root->_m_rptr) };
+        _m_root = _merge(ord, kids, _singleton(root));
+    }
+}
+
+/// @brief cut all nodes from the heap (pending ones included), in order
+/// @param ord  order policy
+/// @return     the nodes as a sorted list of singletons chained via @c _m_rptr
+template<typename _Ord>
+LeftistHeapEasyT::BaseNodeT*
+LeftistHeapEasyT::_drain(
+    const _Ord &ord)
+{
+    BaseNodeT *tree{ _yield() }, *list{ nullptr }, *node;
+    while (nullptr != (node = _shred_pop(tree))) {
+        list = _cons(node, list);
+    }
+    return heap_sort_list<BaseNodeT, &BaseNodeT::_m_rptr>(ord, list);
+}
+
+extern template void                         LeftistHeapEasyT::_push     (const VirtualOrderT&, BaseNodeT*);
+extern template void                         LeftistHeapEasyT::_push_list(const VirtualOrderT&, BaseNodeT*);
+extern template void                         LeftistHeapEasyT::_push_lists(const VirtualOrderT&, BaseNodeT* const*, unsigned);
+extern template LeftistHeapEasyT::BaseNodeT* LeftistHeapEasyT::_build    (const VirtualOrderT&, BaseNodeT*, std::size_t&) const;
+extern template LeftistHeapEasyT::BaseNodeT* LeftistHeapEasyT::_pop      (const VirtualOrderT&);
+extern template void                         LeftistHeapEasyT::_replace  (const VirtualOrderT&);
+extern template LeftistHeapEasyT::BaseNodeT* LeftistHeapEasyT::_merge    (const VirtualOrderT&, BaseNodeT*, BaseNodeT*) const;
+extern template void                         LeftistHeapEasyT::_meld     (const VirtualOrderT&, LeftistHeapEasyT&);
+extern template LeftistHeapEasyT::BaseNodeT* LeftistHeapEasyT::_drain    (const VirtualOrderT&);
+
+// With @c _Lazy set, 'push()' only appends to a list of pending nodes.  They are built into
+// the tree in O(N) by the next 'front()', 'pop()' or 'merge()', so a burst of pushes followed
+// by a few pops costs linear time instead of O(N log N).
+// @c _KeyOf caches the compare key in the node header (see keyof.hpp); @c _Comp orders keys then.
 template<typename _Type,
          typename _Comp = std::less<_Type>,
-         typename Alloc = std::allocator<_Type> >
+         typename Alloc = std::allocator<_Type>,
+         bool     _Inline = false,
+         typename _Stats = NoHeapStats,
+         bool     _Lazy = false,
+         typename _KeyOf = IdentityKey >
 class LeftistHeapEasy : protected LeftistHeapEasyT
 {
     // --- allocator guard ---
@@ -57,11 +406,13 @@ class LeftistHeapEasy : protected LeftistHeapEasyT
         "LeftistHeap merge, move, or assignment require a stateless comparator");
 
   protected:
-    struct _XNode : public BaseNodeT {
+    struct _XNode : public BaseNodeT, public HeapKeyT<_Type, _KeyOf> {
         _Type _m_value;
 
-        _XNode(const _Type &  rhs) : _m_value{ rhs            } { /*NOP*/ }
-        _XNode(      _Type && rhs) : _m_value{ std::move(rhs) } { /*NOP*/ }
+        _XNode(const _Type &  rhs) : _m_value{ rhs            } { this->_load(_m_value); }
+        _XNode(      _Type && rhs) : _m_value{ std::move(rhs) } { this->_load(_m_value); }
+
+        const auto &_cmp_key() const { return this->_key(_m_value); }
     };
 
     using value_allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<_Type>;
@@ -88,10 +439,24 @@ class LeftistHeapEasy : protected LeftistHeapEasyT
         }
     }
 
+    struct _XOrder {
+        bool operator()(const BaseNodeT &n1, const BaseNodeT &n2) const {
+            const auto & rn1{ static_cast<const _XNode&>(n1)._cmp_key() };
+            const auto & rn2{ static_cast<const _XNode&>(n2)._cmp_key() };
+            return _Comp()(rn1, rn2);
+        }
+    };
+
     bool _pred(const BaseNodeT &n1, const BaseNodeT &n2) const override {
-        const _Type & rn1{ static_cast<const _XNode&>(n1)._m_value };
-        const _Type & rn2{ static_cast<const _XNode&>(n2)._m_value };
-        return _Comp()(rn1, rn2);
+        return _XOrder()(n1, n2);
+    }
+
+    auto _order() const {
+        if constexpr (_Inline) {
+            return heap_stats_order<_Stats>(_XOrder(), _m_stats);
+        } else {
+            return heap_stats_order<_Stats>(VirtualOrderT{ this }, _m_stats);
+        }
     }
 
     void _clear(BaseNodeT *root) {
@@ -100,15 +465,33 @@ class LeftistHeapEasy : protected LeftistHeapEasyT
         }
     }
 
+    void _insert(BaseNodeT *node) {
+        if constexpr (_Lazy) {
+            _defer(node);
+        } else {
+            _push(_order(), node);
+        }
+    }
+
+    // building the pending nodes into the tree does not change the contents of the heap
+    void _settle() const {
+        if constexpr (_Lazy) {
+            const_cast<LeftistHeapEasy*>(this)->_flush(_order());
+        }
+    }
+
     node_allocator_type _m_alloc;
+    mutable _Stats      _m_stats;
 
   public:
 
+    using allocator_type = Alloc;
+
     LeftistHeapEasy()
     { /*NOP*/ }
 
-    LeftistHeapEasy(LeftistHeapEasy&& rhs) {
-        std::swap(_m_root, rhs._m_root);
+    LeftistHeapEasy(LeftistHeapEasy&& rhs) : _m_stats{ std::move(rhs._m_stats) } {
+        _take(rhs);
     }
     LeftistHeapEasy(const LeftistHeapEasy & rhs) = delete;
 
@@ -117,29 +500,40 @@ class LeftistHeapEasy : protected LeftistHeapEasyT
     }
 
     LeftistHeapEasy& operator=(LeftistHeapEasy&& rhs) {
-        BaseNodeT *hold { _m_root };
-        _m_root = rhs._m_root;
-        rhs._m_root = nullptr;
-        _clear(hold);
+        if (this != &rhs) {
+            _clear(_yield());
+            _take(rhs);
+            _m_stats = std::move(rhs._m_stats);
+        }
         return *this;
     }
     LeftistHeapEasy& operator=(const LeftistHeapEasy &) = delete;
 
     LeftistHeapEasy& merge(LeftistHeapEasy& rhs) {
-        BaseNodeT *hold{ nullptr };
-        std::swap(hold, rhs._m_root);
-        _m_root = _merge(_m_root, hold);
+        _meld(_order(), rhs);
         return *this;
     }
 
     void clear() {
-        BaseNodeT *hold{ nullptr };
-        std::swap(hold, _m_root);
-        _clear(hold);
+        // with nothing to destroy, a pool that holds no other nodes takes these back at once
+        const std::size_t size{ _m_size };
+        BaseNodeT * const root{ _yield() };
+        if constexpr (std::is_trivially_destructible<_XNode>::value) {
+            if (node_pool_traits<node_allocator_type>::recycle(_m_alloc, size)) {
+                return;
+            }
+        }
+        _clear(root);
     }
 
-    void push(const _Type &  rhs) { _push(_create_node(rhs           )); }
-    void push(      _Type && rhs) { _push(_create_node(std::move(rhs))); }
+    /// @brief pre-populate the node allocator, if it supports that ( @c NodePoolAllocator does)
+    /// @param n    number of nodes that can be pushed afterwards without allocating memory
+    void reserve(std::size_t n) {
+        node_pool_traits<node_allocator_type>::reserve(_m_alloc, n);
+    }
+
+    void push(const _Type &  rhs) { _insert(_create_node(rhs           )); }
+    void push(      _Type && rhs) { _insert(_create_node(std::move(rhs))); }
 
     template <typename It>
     void push(It first, It last) {
@@ -149,7 +543,44 @@ class LeftistHeapEasy : protected LeftistHeapEasyT
         for (; first != last; ++first) {
             head = _cons(_create_node(*first), head);
         }
-        _push_list(head);
+        _push_list(_order(), head);
+    }
+
+    /// @brief batch insert, built on several threads (see parbuild.hpp)
+    /// @param par  number of threads; chunks smaller than @c HeapParallel::grain are not split
+    ///
+    /// If creating a node throws, on whichever thread, the nodes made so far are destroyed and
+    /// the heap is left as it was.
+    template <typename It>
+    void push(It first, It last, HeapParallel par) {
+        using category = typename std::iterator_traits<It>::iterator_category;
+        static_assert(std::is_base_of<std::forward_iterator_tag, category>::value, "push() requires a forward iterator");
+        const std::size_t       total{ std::size_t(std::distance(first, last)) };
+        const unsigned          count{ par.chunks(total) };
+        std::vector<BaseNodeT*> heads(count, nullptr);
+        try {
+            if constexpr (std::is_base_of<std::random_access_iterator_tag, category>::value &&
+                          !node_pool_traits<node_allocator_type>::thread_affine) {
+                using diff = typename std::iterator_traits<It>::difference_type;
+                heap_parallel_for(count, [&](unsigned idx) {
+                    It scan{ first + diff(total * idx / count) }, stop{ first + diff(total * (idx + 1) / count) };
+                    for (; scan != stop; ++scan) {
+                        heads[idx] = _cons(_create_node(*scan), heads[idx]);
+                    }
+                });
+            } else {
+                for (std::size_t pos{ 0 }; first != last; ++first, ++pos) {
+                    heads[pos * count / total] = _cons(_create_node(*first), heads[pos * count / total]);
+                }
+            }
+        } catch (...) {
+            // the heap is untouched so far: drop the nodes made before the failure
+            for (BaseNodeT *head : heads) {
+                _clear(head);
+            }
+            throw;
+        }
+        _push_lists(_order(), heads.data(), count);
     }
 
     template <typename Range>
@@ -160,6 +591,7 @@ class LeftistHeapEasy : protected LeftistHeapEasyT
     }
 
     _Type &front() const {
+        _settle();
         if (nullptr == _m_root) {
             throw std::invalid_argument("empty");
         }
@@ -167,17 +599,112 @@ class LeftistHeapEasy : protected LeftistHeapEasyT
     }
 
     void pop() {
-        BaseNodeT *ptr { _pop() };
+        _settle();
+        BaseNodeT *ptr { _pop(_order()) };
         if (nullptr != ptr) {
             _destroy_node(ptr);
         }
     }
 
+    /// @brief move the @c k least values out, in order
+    /// @param k    number of values to pop; all of them if @c k >= @c size()
+    /// @param out  output iterator receiving the values
+    /// @return     @c out past the last value written
+    ///
+    /// Below @c size() this pops node by node: a pop is a single merge of the two subtrees
+    /// along their right spines, and there is no pass to share between pops.
+    template<typename _OutIt>
+    _OutIt pop_n(std::size_t k, _OutIt out) {
+        if (k >= _m_size) {
+            return drain(out);
+        }
+        _settle();
+        for (; k > 0; --k) {
+            _XNode *node{ static_cast<_XNode*>(_pop(_order())) };
+            try {
+                *out = std::move(node->_m_value);
+                ++out;
+            } catch (...) {
+                _destroy_node(node);
+                throw;
+            }
+            _destroy_node(node);
+        }
+        return out;
+    }
+
+    /// @brief move all values out, in order, leaving the heap empty
+    /// @param out  output iterator receiving the values
+    /// @return     @c out past the last value written
+    ///
+    /// This does not pop node by node, but sorts the nodes of the whole tree at once (see
+    /// listsort.hpp).  If writing a value throws, the values not yet written stay in the heap.
+    template<typename _OutIt>
+    _OutIt drain(_OutIt out) {
+        BaseNodeT *list{ _drain(_order()) };
+        try {
+            while (nullptr != list) {
+                *out = std::move(static_cast<_XNode*>(list)->_m_value);
+                ++out;
+                BaseNodeT *node{ list };
+                list = list->_m_rptr;
+                _destroy_node(node);
+            }
+        } catch (...) {
+            _push_list(_order(), list);
+            throw;
+        }
+        return out;
+    }
+
+    /// @brief pop the least value and push @c value, reusing the node
+    /// @param value    value to insert
+    /// @return         the former least value
+    ///
+    /// The root's two subtrees are merged, and the root goes back in as a singleton: two
+    /// merges along right spines, O(log N), and no allocation.  Throws
+    /// @c std::invalid_argument on an empty heap, like @c front().
+    _Type replace_top(_Type value) {
+        _settle();
+        if (nullptr == _m_root) {
+            throw std::invalid_argument("empty");
+        }
+        _XNode *node{ static_cast<_XNode*>(_m_root) };
+        std::swap(node->_m_value, value);
+        node->_load(node->_m_value);
+        _replace(_order());
+        return value;
+    }
+
+    /// @brief push @c value and pop the least value, reusing the node
+    /// @param value    value to insert
+    /// @return         the least value of the heap with @c value added
+    ///
+    /// If @c value is not greater than the least value in the heap, it is returned right away
+    /// and the heap is not touched at all.
+    _Type push_pop(_Type value) {
+        _settle();
+        if (nullptr == _m_root ||
+            !_Comp()(static_cast<const _XNode*>(_m_root)->_cmp_key(), _XNode::_extract(value))) {
+            return value;
+        }
+        return replace_top(std::move(value));
+    }
+
     bool empty() const {
-        return nullptr == _m_root;
+        return 0 == _m_size;
     }
 
+    std::size_t size() const {
+        return _m_size;
+    }
+
+    /// @brief operation counters of the statistics policy
+    const _Stats &stats() const { return _m_stats; }
+    void reset_stats() { _m_stats = _Stats(); }
+
     using LeftistHeapEasyT::validate_tree;
+    using LeftistHeapEasyT::shape_stats;
 };
 
 #endif // LHQUEUE2_9687E0DD_D406_474B_9534_94B7C1D81D33
@@ -0,0 +1,81 @@
+// -------------------------------------------------------------------------------------------
+// Sorting a singly linked node list, for the sorted export of whole heaps
+// -------------------------------------------------------------------------------------------
+// This file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+// 'drain()' on a heap does not pop node by node; that would rebuild an intermediate heap N
+// times.  Instead, the tree is shredded into a node list which is merge sorted bottom-up:
+// O(N log N) comparisons, no links to maintain, and a hedge of one sorted run per power of
+// two as the only auxiliary space -- the same trick as the batch build of the Leftist Heap.
+// -------------------------------------------------------------------------------------------
+#ifndef LISTSORT_9687E0DD_D406_474B_9534_94B7C1D81D33
+#define LISTSORT_9687E0DD_D406_474B_9534_94B7C1D81D33
+
+#include <climits>
+
+/// @brief merge two sorted node lists; on ties the nodes of @c a come first
+template<typename _Node, _Node *_Node::*_Link, typename _Ord>
+_Node*
+heap_merge_lists(const _Ord &ord, _Node *a, _Node *b)
+{
+    _Node *head{ nullptr }, **tail{ &head };
+    while (nullptr != a && nullptr != b) {
+        if (ord(*b, *a)) {
+            *tail = b;
+            tail  = &(b->*_Link);
+            b     = *tail;
+        } else {
+            *tail = a;
+            tail  = &(a->*_Link);
+            a     = *tail;
+        }
+    }
+    *tail = (nullptr != a) ? a : b;
+    return head;
+}
+
+/// @brief sort a node list chained via @c _Link (stable)
+/// @param ord  order policy
+/// @param head head of the list
+/// @return     head of the sorted list
+template<typename _Node, _Node *_Node::*_Link, typename _Ord>
+_Node*
+heap_sort_list(const _Ord &ord, _Node *head)
+{
+    static constexpr unsigned limit{ sizeof(void*) * CHAR_BIT };
+    _Node   *hedge[limit];
+    unsigned hsize{ 0 }, hidx;
+    _Node   *node;
+
+    // Phase I: every node is a sorted run of one; carry runs up like a binary counter
+    while (nullptr != (node = head)) {
+        head = node->*_Link;
+        node->*_Link = nullptr;
+        for (hidx = 0; (hidx < hsize) && (nullptr != hedge[hidx]); ++hidx) {
+            node = heap_merge_lists<_Node, _Link>(ord, hedge[hidx], node);
+            hedge[hidx] = nullptr;
+        }
+        if (hidx < hsize) {
+            hedge[hidx] = node;
+        } else if (hsize < limit) {
+            hedge[hsize++] = node;
+        } else {
+            hedge[limit - 1] = node;
+        }
+    }
+
+    // Phase II: combine the runs, the ones from earlier in the input first
+    node = nullptr;
+    for (hidx = 0; hidx < hsize; ++hidx) {
+        if (nullptr != hedge[hidx]) {
+            node = heap_merge_lists<_Node, _Link>(ord, hedge[hidx], node);
+        }
+    }
+    return node;
+}
+
+#endif // LISTSORT_9687E0DD_D406_474B_9534_94B7C1D81D33
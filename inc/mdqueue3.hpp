@@ -17,8 +17,26 @@
 #ifndef LDQUEUE3_9687E0DD_D406_474B_9534_94B7C1D81D33
 #define LDQUEUE3_9687E0DD_D406_474B_9534_94B7C1D81D33
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <stdexcept>
 #include <functional>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "heapstats.hpp"
+#include "keyof.hpp"
+#include "listsort.hpp"
+#include "nodepool.hpp"
+#include "parbuild.hpp"
+#include "prefetch.hpp"
+#include "snapshot.hpp"
 
 // -------------------------------------------------------------------------------------------
 // definition of the core functions of a DistanceHeap, meant for use in derived classes
@@ -41,21 +59,39 @@ public:
     // overload in template specializations built upon this base class
     virtual bool  _pred(const BaseNodeT &n1, const BaseNodeT &n2) const = 0;
 
+    // The core algorithms are templates on an order policy, so derived classes may choose
+    // between the virtual call through '_pred()' (the default, instantiated once in the
+    // library) and a stateless policy that lets the compiler inline the comparison.
+    struct VirtualOrderT {
+        const MinDistHeapT *_m_heap;
+        bool operator()(const BaseNodeT &n1, const BaseNodeT &n2) const { return _m_heap->_pred(n1, n2); }
+    };
 
-    void _push_list(BaseNodeT* head);
-    void _merge(BaseNodeT* root, BaseNodeT**link, BaseNodeT *h1, BaseNodeT *h2) const;
-
-    BaseNodeT* _push(BaseNodeT* node);
-    BaseNodeT* _pop();
-    BaseNodeT* _build(BaseNodeT* head) const;              // make raw heap from list
-    BaseNodeT* _ncut(BaseNodeT* h);                        // cut the node 'h' from heap
+    template<typename _Ord> void _push_list(const _Ord &ord, BaseNodeT* head);
+    template<typename _Ord> void _push_lists(const _Ord &ord, BaseNodeT* const *heads, unsigned count);  // parallel build
+    template<typename _Ord> void _merge(const _Ord &ord, BaseNodeT* root, BaseNodeT**link, BaseNodeT *h1, BaseNodeT *h2) const;
+
+    template<typename _Ord> BaseNodeT* _push(const _Ord &ord, BaseNodeT* node);
+    template<typename _Ord> BaseNodeT* _pop(const _Ord &ord);
+    template<typename _Ord> BaseNodeT* _build(const _Ord &ord, BaseNodeT* head) const;   // make raw heap from list
+    template<typename _Ord> BaseNodeT* _ncut(const _Ord &ord, BaseNodeT* h);             // cut the node 'h' from heap
+    template<typename _Ord> BaseNodeT* _decrease(const _Ord &ord, BaseNodeT* h);         // re-insert for strictly decreasing key of 'h'
+    template<typename _Ord> BaseNodeT* _reinsert(const _Ord &ord, BaseNodeT* h);         // adjust for arbitrary key change of 'h'
+    template<typename _Ord> void       _meld(const _Ord &ord, MinDistHeapT &rhs);        // absorb all nodes of 'rhs'
+    template<typename _Ord> void       _flush(const _Ord &ord);                          // build the pending nodes into the tree
+    template<typename _Ord> BaseNodeT* _drain(const _Ord &ord);                          // yield all nodes, sorted
+    template<typename _Ord, typename _Due>
+    BaseNodeT* _sweep(const _Ord &ord, _Due &&due);                                       // cut the nodes 'due' holds for, sorted
+
+    // snapshots (see snapshot.hpp): the tree in pre-order, and relinked from the records
+    template<typename _Emit> void        _preorder(_Emit &&emit) const;
+    template<typename _Make> static void _unflatten(const HeapSnapshotReader &snap, BaseNodeT* &tree, _Make &&make);
+    static bool                          _check_dists(const HeapSnapshotReader &snap);   // do the saved distances fit the shape?
+
+    void       _defer(BaseNodeT* h);                       // lazy insert: add node 'h' to the pending list
     BaseNodeT* _tcut(BaseNodeT* h);                        // cut branch (subtree) rooted at h from heap
-
-    BaseNodeT* _yield();                                  // cut the whole tree from the sentinel
-
-    BaseNodeT* _decrease(BaseNodeT* h);                    // re-insert for strictly decreasing key of 'h'
-    BaseNodeT* _reinsert(BaseNodeT* h);                    // adjust for arbitrary key change of 'h'
-    void       _dist_set(BaseNodeT* h);
+    BaseNodeT* _yield();                                   // cut the whole tree from the sentinel
+    void       _take(MinDistHeapT &rhs);                   // move the tree of 'rhs' to an empty heap
 
     static BaseNodeT* _lgraft(BaseNodeT* a, BaseNodeT* b); // connect b as left child of a
     static BaseNodeT* _rgraft(BaseNodeT* a, BaseNodeT* b); // connect b as right child of a
@@ -72,23 +108,541 @@ public:
 
     static bool _iter_same(const BaseNodeT* p1, const BaseNodeT* np2);
 
-    void validate_tree() const;
+    void        validate_tree() const;
+    void        validate_stream() const;                   // full check, O(1) extra memory
+    std::size_t validate_sample(std::size_t subtrees, std::size_t budget, std::uint64_t seed) const;
+    HeapShape   shape_stats() const;
 
-    BaseNodeT  _m_root { nullptr };                        // the root holder & end sentinel
+    void        _check_node(const BaseNodeT* node) const;  // validation: links, order and distance of the children
+    std::size_t _check_walk(const BaseNodeT* top, std::size_t budget) const;
+
+    BaseNodeT   _m_root { nullptr };                       // the root holder & end sentinel
+    std::size_t _m_size { 0 };                             // number of nodes in the tree, pending nodes included
+    BaseNodeT  *_m_pend { nullptr };                       // lazy insert: pending nodes, chained via '_m_pptr'
+    std::size_t _m_npend{ 0 };                             // lazy insert: length of the pending list
 };
 
+// -------------------------------------------------------------------------------------------
+// connecting nodes / primitives on node level
+
+inline MinDistHeapT::BaseNodeT*
+MinDistHeapT::_singleton(BaseNodeT* const node)
+{
+    if (node) {
+        node->_m_lptr = node->_m_rptr = node->_m_pptr = nullptr;
+        node->_m_dist = 1;
+    }
+    return node;
+}
+
+/// @brief make b the left child of a
+/// @param a    parent node
+/// @param b    new left child
+/// @return     a if not @c NULL, else b
+inline MinDistHeapT::BaseNodeT*
+MinDistHeapT::_lgraft(
+    BaseNodeT* a,
+    BaseNodeT* b)
+{
+    if (a) a->_m_lptr = b;
+    if (b) b->_m_pptr = a;
+    return a ? a : b;
+}
+
+/// @brief make b the right child of a
+/// @param a    parent node
+/// @param b    new right child
+/// @return     a if not @c NULL, else b
+inline MinDistHeapT::BaseNodeT*
+MinDistHeapT::_rgraft(
+    BaseNodeT* a,
+    BaseNodeT* b)
+{
+    if (a) a->_m_rptr = b;
+    if (b) b->_m_pptr = a;
+    return a ? a : b;
+}
+
+/// @brief unidirectional CONS operation via parent pointer
+/// @param a    new head of the list
+/// @param b    tail to attach to node
+/// @return     a if not @c NULL, else b
+inline MinDistHeapT::BaseNodeT*
+MinDistHeapT::_pcons(
+    BaseNodeT* a,
+    BaseNodeT* b)
+{
+    if (a) a->_m_pptr = b;
+    return a ? a : b;
+}
+
+// -------------------------------------------------------------------------------------------
+// core functions -- this makes a binary tree a LDB Heap
+//
+// These are templates on the order policy '_Ord'.  The instantiations for the virtual
+// predicate are compiled once into the library (see the 'extern template' list below), so
+// only heaps that opt into an inlined order pay for another copy of the algorithms.
+
+template<typename _Ord>
+void
+MinDistHeapT::_merge(
+    const _Ord &ord,
+    BaseNodeT  *root,
+    BaseNodeT **link,
+    BaseNodeT  *h1,
+    BaseNodeT  *h2) const
+{
+    [[maybe_unused]] const auto timer{ heap_stats_timer(ord, HeapPhase::merge) };
+    int steps{ 1 };
+
+    // Phase I: merge trees until at most one is surviving
+    while (h1 && h2) {
+        ++steps;
+        heap_stats_link(ord);
+        // the winner's children decide the descent: ask for those of both candidates early
+        heap_prefetch(h1->_m_lptr);
+        heap_prefetch(h1->_m_rptr);
+        heap_prefetch(h2->_m_lptr);
+        heap_prefetch(h2->_m_rptr);
+        // one path for both outcomes, selecting the winner rather than branching on it
+        BaseNodeT * &win{ ord(*h2, *h1) ? h2 : h1 };
+        (*link = win)->_m_pptr = root;
+        root = win;
+        if (!root->_m_lptr || (root->_m_rptr && root->_m_rptr->_m_dist > root->_m_lptr->_m_dist))
+            link = &root->_m_lptr;
+        else
+            link = &root->_m_rptr;
+        win = *link;
+    }
+
+    // Phase II: connect the survivor.
+    // Unless we entered this with two empty heaps, we have exactly one survivor here. Make sure
+    // the survivor is has a proper back/parent link.
+    if ((*link = (h1 ? h1 : h2)))
+        (*link)->_m_pptr = root;
+
+    // Phase III: update the leaf distances.
+    // We have to do AT LEAST as many steps as we had merging steps in Phase I.  If we continue
+    // after that, we do so until the node weight does not change any more.
+    //
+    // In a min-dist heap (and the leftist heap as a special form of that), each node stores
+    // the minimum null-path length of its children, which is logarithmically bounded by the
+    // subtree size. Any local structural modification can only affect this value while it
+    // remains below that bound.  Therefore, any upward propagation of distance updates,
+    // whether due to increase or decrease, terminates after at most O(log N) steps.
+
+    while (root) {
+        int lcw{ root->_m_lptr ? root->_m_lptr->_m_dist : 0 };
+        int rcw{ root->_m_rptr ? root->_m_rptr->_m_dist : 0 };
+        int nnw{ std::min(lcw, rcw) + 1 };
+        if ((--steps < 0) && (nnw == root->_m_dist))
+            break;
+        root->_m_dist = nnw;
+        root = root->_m_pptr;
+    }
+}
+
+/// @brief build a heap from a sibling list
+/// @param ord  order policy
+/// @param node start of list
+/// @return     root of created heap
+template<typename _Ord>
+MinDistHeapT::BaseNodeT*
+MinDistHeapT::_build(
+    const _Ord &ord,
+    BaseNodeT  *head) const
+{
+    [[maybe_unused]] const auto timer{ heap_stats_timer(ord, HeapPhase::build) };
+    BaseNodeT *h1, *h2;
+    while ((h1 = head) && (h2 = head->_m_pptr)) {
+        BaseNodeT *list{ nullptr };
+        do {
+            BaseNodeT *hold;
+            head = h2->_m_pptr;
+            _merge(ord, nullptr, &hold, h1, h2);
+            hold->_m_pptr = list;
+            list = hold;
+        } while ((h1 = head) && (h2 = head->_m_pptr));
+        if (head)
+            head->_m_pptr = list;
+        else
+            head = list;
+    }
+    return head;
+}
+
+/// @brief push a node into the heap
+/// @param ord  order policy
+/// @param node node to insert
+/// @return @c node
+template<typename _Ord>
+MinDistHeapT::BaseNodeT*
+MinDistHeapT::_push(
+    const _Ord &ord,
+    BaseNodeT  *node)
+{
+    _merge(ord, &_m_root, &_m_root._m_lptr, _m_root._m_lptr, _singleton(node));
+    ++_m_size;
+    return node;
+}
+
+/// @brief push a node list into the heap
+/// @param ord  order policy
+/// @param head head of a list chained via @c _m_pptr
+template<typename _Ord>
+void
+MinDistHeapT::_push_list(
+    const _Ord &ord,
+    BaseNodeT  *head)
+{
+    std::size_t count{ 0 };
+    for (BaseNodeT *node{ head }; nullptr != node; node = node->_m_pptr) {
+        ++count;
+    }
+    heap_stats_build(ord, count);
+    _merge(ord, &_m_root, &_m_root._m_lptr, _m_root._m_lptr, _build(ord, head));
+    _m_size += count;
+}
+
+/// @brief push several node lists into the heap, building them on one thread each
+/// @param ord      order policy
+/// @param heads    heads of lists chained via @c _m_pptr
+/// @param count    number of lists
+template<typename _Ord>
+void
+MinDistHeapT::_push_lists(
+    const _Ord       &ord,
+    BaseNodeT* const *heads,
+    unsigned          count)
+{
+    std::vector<BaseNodeT*>   roots(count, nullptr);
+    std::vector<std::size_t>  sizes(count, 0);
+    heap_parallel_for(count, [&](unsigned idx) {
+        for (BaseNodeT *node{ heads[idx] }; nullptr != node; node = node->_m_pptr) {
+            ++sizes[idx];
+        }
+        roots[idx] = _build(heap_stats_plain(ord), heads[idx]);
+    });
+    for (unsigned idx{ 0 }; idx < count; ++idx) {
+        heap_stats_build(ord, sizes[idx]);
+        _merge(ord, &_m_root, &_m_root._m_lptr, _m_root._m_lptr, roots[idx]);
+        _m_size += sizes[idx];
+    }
+}
+
+/// @brief pop the root element
+/// @param ord  order policy
+/// @return the old root or @c NULL on empty heap
+template<typename _Ord>
+MinDistHeapT::BaseNodeT*
+MinDistHeapT::_pop(
+    const _Ord &ord)
+{
+    BaseNodeT *retv{ _m_root._m_lptr };
+    if (nullptr != retv) {
+        _merge(ord, &_m_root, &_m_root._m_lptr, retv->_m_lptr, retv->_m_rptr);
+        retv->_m_lptr = retv->_m_rptr = retv->_m_pptr = nullptr;
+        retv->_m_dist = 0;
+        --_m_size;
+        heap_stats_pop(ord);
+    }
+    return retv;
+}
+
+/// @brief cut a node from the tree
+/// @param ord  order policy
+/// @param node node to cut from the tree
+/// @return @node as singleton heap
+///
+/// This replaces @c node by the heap created from its children. If there are none, the replacement
+/// has to be the next sibling of the node, of course.  This retains most of the order already
+/// achieved in the heap.
+template<typename _Ord>
+MinDistHeapT::BaseNodeT*
+MinDistHeapT::_ncut(
+    const _Ord      &ord,
+    BaseNodeT *const node)
+{
+    assert(node && node->_m_pptr);    // automagically breaks on sentinel!
+    BaseNodeT* root{ node->_m_pptr };
+    if (node == root->_m_lptr) {
+        _merge(ord, root, &root->_m_lptr, node->_m_lptr, node->_m_rptr);
+    } else {
+        _merge(ord, root, &root->_m_rptr, node->_m_lptr, node->_m_rptr);
+    }
+    node->_m_lptr = node->_m_rptr = node->_m_pptr = nullptr;
+    --_m_size;
+    return node;
+}
+
+/// @brief handle a decrease in the node's priority
+/// @param ord  order policy
+/// @param node node to reposition in heap
+/// @return     @c node
+///
+/// This an actual O(1) operation, as cutting a subtree from any position is O(1), and so
+/// is the following merge of the subtree with the remaining heap.  As decreasing the the
+/// node's weight does _not_ invalidate the subtree rooted at @c node, we can prune and
+/// graft the whole subtree here.  ( @c _reinsert() is more complicated, as we cannot
+/// assume the heap invariant between the node and its children is preserved.)
+template<typename _Ord>
+MinDistHeapT::BaseNodeT*
+MinDistHeapT::_decrease(
+    const _Ord &ord,
+    BaseNodeT  *node)
+{
+    assert(node && node->_m_pptr);
+    if (node != _m_root._m_lptr) {
+        _merge(ord, &_m_root, &_m_root._m_lptr, _m_root._m_lptr, _tcut(node));
+    }
+    return node;
+}
+
+/// @brief re-insert a node after an arbitrary priority change
+/// @param ord  order policy
+/// @param node node to reposition in heap
+/// @return     @c node
+///
+/// This cuts the node from the heap, effectively making it a singleton heap, and then
+/// merges it again with the heap.
+template<typename _Ord>
+MinDistHeapT::BaseNodeT*
+MinDistHeapT::_reinsert(
+    const _Ord &ord,
+    BaseNodeT  *node)
+{
+    assert(node && node->_m_pptr);
+    return _push(ord, _ncut(ord, node));
+}
+
+/// @brief append a node to the pending list; it goes into the tree with the next @c _flush()
+/// @param node node to insert
+inline void
+MinDistHeapT::_defer(
+    BaseNodeT *node)
+{
+    _m_pend = _pcons(_singleton(node), _m_pend);
+    ++_m_npend;
+    ++_m_size;
+}
+
+/// @brief build the pending nodes into the tree (in O(N), by @c _push_list())
+/// @param ord  order policy
+template<typename _Ord>
+void
+MinDistHeapT::_flush(
+    const _Ord &ord)
+{
+    if (nullptr != _m_pend) {
+        BaseNodeT *head{ _m_pend };
+        _m_size -= _m_npend;
+        _m_pend  = nullptr;
+        _m_npend = 0;
+        _push_list(ord, head);
+    }
+}
+
+/// @brief merge another heap into this one
+/// @param ord  order policy
+/// @param rhs  heap to absorb; empty afterwards
+template<typename _Ord>
+void
+MinDistHeapT::_meld(
+    const _Ord   &ord,
+    MinDistHeapT &rhs)
+{
+    if (this != &rhs) {
+        _flush(ord);
+        rhs._flush(ord);
+        std::size_t size{ _m_size + rhs._m_size };
+        _merge(ord, &_m_root, &_m_root._m_lptr, _m_root._m_lptr, rhs._yield());
+        _m_size = size;
+    }
+}
+
+/// @brief move the tree of another heap into this (empty) heap
+/// @param rhs  heap to take the nodes from; empty afterwards
+inline void
+MinDistHeapT::_take(
+    MinDistHeapT &rhs)
+{
+    assert(nullptr == _m_root._m_lptr);
+    std::size_t size{ rhs._m_size }, npend{ rhs._m_npend };
+    BaseNodeT  *pend{ rhs._m_pend };
+    rhs._m_pend  = nullptr;
+    rhs._m_npend = 0;
+    _lgraft(&_m_root, rhs._yield());
+    _m_size  = size;
+    _m_pend  = pend;
+    _m_npend = npend;
+}
+
+/// @brief cut all nodes from the heap (pending ones included), in order
+/// @param ord  order policy
+/// @return     the nodes as a sorted list of singletons chained via @c _m_pptr
+template<typename _Ord>
+MinDistHeapT::BaseNodeT*
+MinDistHeapT::_drain(
+    const _Ord &ord)
+{
+    BaseNodeT *tree{ _yield() }, *list{ nullptr }, *node;
+    while (nullptr != (node = _shred_pop(tree))) {
+        list = _pcons(_singleton(node), list);
+    }
+    return heap_sort_list<BaseNodeT, &BaseNodeT::_m_pptr>(ord, list);
+}
+
+/// @brief cut all nodes a predicate holds for from the tree, in order
+/// @param ord  order policy
+/// @param due  predicate on a @c const @c BaseNodeT&; whenever it holds for a node, it must
+///             hold for all nodes that go before that one
+/// @return     the nodes as a sorted list of singletons chained via @c _m_pptr
+///
+/// With that kind of predicate, the nodes it holds for make a connected region on top of the
+/// tree.  The region is searched from the root, and the subtrees hanging off its border are
+/// built into a heap once, in the way @c _build() does, instead of merging the children on
+/// every single pop.  Mostly small subtrees meet in that build, so its merges are short.
+template<typename _Ord, typename _Due>
+MinDistHeapT::BaseNodeT*
+MinDistHeapT::_sweep(
+    const _Ord &ord,
+    _Due      &&due)
+{
+    BaseNodeT *work{ _m_root._m_lptr }, *rest{ nullptr }, *list{ nullptr }, *node;
+    if ((nullptr == work) || !due(*work)) {
+        return nullptr;
+    }
+    _m_root._m_lptr = work->_m_pptr = nullptr;
+
+    // all three lists are chained via the parent pointer; the children of a node are taken
+    // before its own link gets reused
+    std::size_t count{ 0 };
+    while (nullptr != (node = work)) {
+        work = node->_m_pptr;
+        for (BaseNodeT *chld : { node->_m_lptr, node->_m_rptr }) {
+            if (nullptr == chld) {
+                continue;
+            } else if (due(*chld)) {
+                work = _pcons(chld, work);
+            } else {
+                rest = _pcons(chld, rest);
+            }
+        }
+        list = _pcons(_singleton(node), list);
+        heap_stats_pop(ord);
+        ++count;
+    }
+    _merge(ord, &_m_root, &_m_root._m_lptr, nullptr, _build(ord, rest));
+    _m_size -= count;
+    return heap_sort_list<BaseNodeT, &BaseNodeT::_m_pptr>(ord, list);
+}
+
+/// @brief visit all nodes of the tree in pre-order (node, left subtree, right subtree)
+/// @param emit callable taking a @c const @c BaseNodeT&
+template<typename _Emit>
+void
+MinDistHeapT::_preorder(
+    _Emit &&emit) const
+{
+    std::vector<const BaseNodeT*> stack;                   // right subtrees still to visit
+    for (const BaseNodeT *node{ _m_root._m_lptr }; nullptr != node; /*NOP*/) {
+        emit(*node);
+        if (nullptr != node->_m_lptr) {
+            if (nullptr != node->_m_rptr) {
+                stack.push_back(node->_m_rptr);
+            }
+            node = node->_m_lptr;
+        } else if (nullptr != node->_m_rptr) {
+            node = node->_m_rptr;
+        } else if (!stack.empty()) {
+            node = stack.back();
+            stack.pop_back();
+        } else {
+            node = nullptr;
+        }
+    }
+}
+
+/// @brief relink the tree saved in a snapshot, without comparisons
+/// @param snap snapshot whose records make a tree ( @c HeapSnapshotReader::is_tree() ) with
+///             the proper leaf distances ( @c _check_dists() )
+/// @param tree receives the root; if @c make throws, it holds the nodes made so far
+/// @param make callable creating a node from the bytes of a value
+///
+/// Every node is linked as soon as it exists, so an exception leaves a proper (if partial)
+/// tree for the caller to dispose of.
+template<typename _Make>
+void
+MinDistHeapT::_unflatten(
+    const HeapSnapshotReader  &snap,
+    BaseNodeT*                &tree,
+    _Make                    &&make)
+{
+    std::vector<BaseNodeT*> stack;                         // nodes with a right subtree to come
+    BaseNodeT              *up{ nullptr }, **slot{ &tree };
+    for (std::size_t idx{ 0 }; idx < snap.count(); ++idx) {
+        const unsigned char * const rec{ snap.record(idx) };
+        const unsigned              shape{ HeapSnapshotReader::shape(rec) };
+        BaseNodeT * const           node{ make(HeapSnapshotReader::value(rec)) };
+        node->_m_dist = HeapSnapshotReader::dist(rec);
+        node->_m_pptr = up;
+        *slot = node;
+        if (0 != (shape & HeapSnapshotHeader::left)) {
+            if (0 != (shape & HeapSnapshotHeader::right)) {
+                stack.push_back(node);
+            }
+            up   = node;
+            slot = &node->_m_lptr;
+        } else if (0 != (shape & HeapSnapshotHeader::right)) {
+            up   = node;
+            slot = &node->_m_rptr;
+        } else if (!stack.empty()) {
+            up   = stack.back();
+            slot = &up->_m_rptr;
+            stack.pop_back();
+        }
+    }
+}
+
+extern template void                     MinDistHeapT::_push_list(const VirtualOrderT&, BaseNodeT*);
+extern template void                     MinDistHeapT::_push_lists(const VirtualOrderT&, BaseNodeT* const*, unsigned);
+extern template void                     MinDistHeapT::_merge    (const VirtualOrderT&, BaseNodeT*, BaseNodeT**, BaseNodeT*, BaseNodeT*) const;
+extern template MinDistHeapT::BaseNodeT* MinDistHeapT::_push     (const VirtualOrderT&, BaseNodeT*);
+extern template MinDistHeapT::BaseNodeT* MinDistHeapT::_pop      (const VirtualOrderT&);
+extern template MinDistHeapT::BaseNodeT* MinDistHeapT::_build    (const VirtualOrderT&, BaseNodeT*) const;
+extern template MinDistHeapT::BaseNodeT* MinDistHeapT::_ncut     (const VirtualOrderT&, BaseNodeT*);
+extern template MinDistHeapT::BaseNodeT* MinDistHeapT::_decrease (const VirtualOrderT&, BaseNodeT*);
+extern template MinDistHeapT::BaseNodeT* MinDistHeapT::_reinsert (const VirtualOrderT&, BaseNodeT*);
+extern template void                     MinDistHeapT::_meld     (const VirtualOrderT&, MinDistHeapT&);
+extern template MinDistHeapT::BaseNodeT* MinDistHeapT::_drain    (const VirtualOrderT&);
+
 // -----------------------------------------------------------------------------------------------
 // template class for a typed MinDistHeap, derived from the basic heap class.  Supports iteration
 // and the value type, the compare predicate and the allocator can be specified.
 //
 // Since moving nodes assumes the same allocator and since merge requires the same order criterion
 // both are specified as classes and cannot be substituted by lambdas.
+//
+// With @c _Inline set, the core algorithms are instantiated for this heap with the comparator
+// compiled in, trading code size for avoiding the virtual predicate call on every comparison.
+// @c _Stats selects a statistics policy (see heapstats.hpp); the default counts nothing.
+// @c _KeyOf caches the compare key in the node header (see keyof.hpp); @c _Comp orders keys then.
+//
+// With @c _Lazy set, 'push()' only appends to a list of pending nodes.  They are built into the
+// tree in O(N) as soon as heap order or the tree structure is needed: by 'front()', 'pop()',
+// 'begin()', 'merge()' and the iterator based operations.  An iterator returned by 'push()' can
+// be dereferenced and handed to these operations at any time, but must not be stepped or
+// compared before the heap got settled that way.
 // -----------------------------------------------------------------------------------------------
 
 template<
     typename _Type,
     typename _Comp = std::less<_Type>,
-    typename Alloc = std::allocator<_Type> >
+    typename Alloc = std::allocator<_Type>,
+    bool     _Inline = false,
+    typename _Stats = NoHeapStats,
+    bool     _Lazy = false,
+    typename _KeyOf = IdentityKey >
 class MinDistHeap : protected MinDistHeapT
 {
     // --- allocator guard ---
@@ -101,11 +655,13 @@ class MinDistHeap : protected MinDistHeapT
 
 protected:
 
-    struct _XNode : public BaseNodeT {
+    struct _XNode : public BaseNodeT, public HeapKeyT<_Type, _KeyOf> {
         _Type _m_value;
 
-        _XNode(const _Type &  rhs) : _m_value{ rhs            } { /*NOP*/ }
-        _XNode(      _Type && rhs) : _m_value{ std::move(rhs) } { /*NOP*/ }
+        _XNode(const _Type &  rhs) : _m_value{ rhs            } { this->_load(_m_value); }
+        _XNode(      _Type && rhs) : _m_value{ std::move(rhs) } { this->_load(_m_value); }
+
+        const auto &_cmp_key() const { return this->_key(_m_value); }
     };
 
     using value_allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<_Type>;
@@ -132,10 +688,24 @@ protected:
         }
     }
 
+    struct _XOrder {
+        bool operator()(const BaseNodeT &n1, const BaseNodeT &n2) const {
+            const auto & rn1{ static_cast<const _XNode&>(n1)._cmp_key() };
+            const auto & rn2{ static_cast<const _XNode&>(n2)._cmp_key() };
+            return _Comp()(rn1, rn2);
+        }
+    };
+
     bool _pred(const BaseNodeT &n1, const BaseNodeT &n2) const override {
-        const _Type & rn1{ static_cast<const _XNode&>(n1)._m_value };
-        const _Type & rn2{ static_cast<const _XNode&>(n2)._m_value };
-        return _Comp()(rn1, rn2);
+        return _XOrder()(n1, n2);
+    }
+
+    auto _order() const {
+        if constexpr (_Inline) {
+            return heap_stats_order<_Stats>(_XOrder(), _m_stats);
+        } else {
+            return heap_stats_order<_Stats>(VirtualOrderT{ this }, _m_stats);
+        }
     }
 
     void _clear(BaseNodeT *root) {
@@ -144,10 +714,29 @@ protected:
         }
     }
 
+    BaseNodeT *_insert(BaseNodeT *node) {
+        if constexpr (_Lazy) {
+            _defer(node);
+            return node;
+        } else {
+            return _push(_order(), node);
+        }
+    }
+
+    // building the pending nodes into the tree does not change the contents of the heap
+    void _settle() const {
+        if constexpr (_Lazy) {
+            const_cast<MinDistHeap*>(this)->_flush(_order());
+        }
+    }
+
     node_allocator_type _m_alloc;
+    mutable _Stats      _m_stats;
 
   public:
 
+    using allocator_type = Alloc;
+
     struct iterator {
         using iterator_category = std::bidirectional_iterator_tag;
         using value_type        = _Type;
@@ -165,8 +754,8 @@ protected:
         iterator& operator--()    { _m_ipos = _iter_pred(_m_ipos); return *this;     }
         iterator  operator--(int) { return { _iter_pred(_m_ipos) }; }
 
-        friend bool operator==(const iterator& i1, const iterator& i2) { return  _iter_same(i1._m_ipos, i2._m_ipos); }
-        friend bool operator!=(const iterator& i1, const iterator& i2) { return !_iter_same(i1._m_ipos, i2._m_ipos); }
+        friend bool operator==(const iterator& i1, const iterator& i2) { return  ::MinDistHeapT::_iter_same(i1._m_ipos, i2._m_ipos); }
+        friend bool operator!=(const iterator& i1, const iterator& i2) { return !::MinDistHeapT::_iter_same(i1._m_ipos, i2._m_ipos); }
 
     protected:
         friend MinDistHeap;
@@ -176,7 +765,7 @@ protected:
         iterator(BaseNodeT* ipos) : _m_ipos{ ipos } { /*NOP*/ }
     };
 
-    iterator begin() { return { _iter_head() }; }
+    iterator begin() { _settle(); return { _iter_head() }; }
     iterator end()   { return { &_m_root       }; }
 
     struct const_iterator {
@@ -197,8 +786,8 @@ protected:
         const_iterator& operator--()    { _m_ipos = _iter_pred(_m_ipos); return *this; }
         const_iterator  operator--(int) { return { _iter_pred(_m_ipos) }; }
 
-        friend bool operator==(const const_iterator& i1, const const_iterator& i2) { return  _iter_same(i1._m_ipos, i2._m_ipos); }
-        friend bool operator!=(const const_iterator& i1, const const_iterator& i2) { return !_iter_same(i1._m_ipos, i2._m_ipos); }
+        friend bool operator==(const const_iterator& i1, const const_iterator& i2) { return  ::MinDistHeapT::_iter_same(i1._m_ipos, i2._m_ipos); }
+        friend bool operator!=(const const_iterator& i1, const const_iterator& i2) { return !::MinDistHeapT::_iter_same(i1._m_ipos, i2._m_ipos); }
 
     protected:
         friend MinDistHeap;
@@ -208,13 +797,13 @@ protected:
         const_iterator(BaseNodeT const *ipos): _m_ipos{ ipos } { /*NOP*/ }
     };
 
-    const_iterator begin() const { return { _iter_head() }; }
+    const_iterator begin() const { _settle(); return { _iter_head() }; }
     const_iterator end()   const { return { &_m_root       }; }
 
     MinDistHeap() { /*NOP*/ }
 
-    MinDistHeap(MinDistHeap&& rhs) {
-        _lgraft(&_m_root, rhs._yield());
+    MinDistHeap(MinDistHeap&& rhs) : _m_stats{ std::move(rhs._m_stats) } {
+        _take(rhs);
     }
     MinDistHeap(const MinDistHeap & rhs) = delete;
 
@@ -225,24 +814,38 @@ protected:
     MinDistHeap& operator=(MinDistHeap&& rhs) {
         if (this != &rhs) {
             _clear(_yield());
-            _lgraft(&_m_root, rhs._yield());
+            _take(rhs);
+            _m_stats = std::move(rhs._m_stats);
         }
         return *this;
     }
     MinDistHeap& operator=(const MinDistHeap &) = delete;
 
     MinDistHeap& merge(MinDistHeap& rhs) {
-        if (this != &rhs)
-            _merge(&_m_root, &_m_root._m_lptr, _m_root._m_lptr, rhs._yield());
+        _meld(_order(), rhs);
         return *this;
     }
 
     void clear() {
-        _clear(_yield());
+        // with nothing to destroy, a pool that holds no other nodes takes these back at once
+        const std::size_t size{ _m_size };
+        BaseNodeT * const root{ _yield() };
+        if constexpr (std::is_trivially_destructible<_XNode>::value) {
+            if (node_pool_traits<node_allocator_type>::recycle(_m_alloc, size)) {
+                return;
+            }
+        }
+        _clear(root);
     }
 
-    iterator push(const _Type &  rhs) {  return { _push(_create_node(rhs           ))}; }
-    iterator push(      _Type && rhs) {  return { _push(_create_node(std::move(rhs)))}; }
+    /// @brief pre-populate the node allocator, if it supports that ( @c NodePoolAllocator does)
+    /// @param n    number of nodes that can be pushed afterwards without allocating memory
+    void reserve(std::size_t n) {
+        node_pool_traits<node_allocator_type>::reserve(_m_alloc, n);
+    }
+
+    iterator push(const _Type &  rhs) {  return { _insert(_create_node(rhs           ))}; }
+    iterator push(      _Type && rhs) {  return { _insert(_create_node(std::move(rhs)))}; }
 
     template <typename It>
     void push(It first, It last) {
@@ -252,7 +855,44 @@ protected:
         for (; first != last; ++first) {
             head = _pcons(_create_node(*first), head);
         }
-        _push_list(head);
+        _push_list(_order(), head);
+    }
+
+    /// @brief batch insert, built on several threads (see parbuild.hpp)
+    /// @param par  number of threads; chunks smaller than @c HeapParallel::grain are not split
+    ///
+    /// If creating a node throws, on whichever thread, the nodes made so far are destroyed and
+    /// the heap is left as it was.
+    template <typename It>
+    void push(It first, It last, HeapParallel par) {
+        using category = typename std::iterator_traits<It>::iterator_category;
+        static_assert(std::is_base_of<std::forward_iterator_tag, category>::value, "push() requires a forward iterator");
+        const std::size_t       total{ std::size_t(std::distance(first, last)) };
+        const unsigned          count{ par.chunks(total) };
+        std::vector<BaseNodeT*> heads(count, nullptr);
+        try {
+            if constexpr (std::is_base_of<std::random_access_iterator_tag, category>::value &&
+                          !node_pool_traits<node_allocator_type>::thread_affine) {
+                using diff = typename std::iterator_traits<It>::difference_type;
+                heap_parallel_for(count, [&](unsigned idx) {
+                    It scan{ first + diff(total * idx / count) }, stop{ first + diff(total * (idx + 1) / count) };
+                    for (; scan != stop; ++scan) {
+                        heads[idx] = _pcons(_create_node(*scan), heads[idx]);
+                    }
+                });
+            } else {
+                for (std::size_t pos{ 0 }; first != last; ++first, ++pos) {
+                    heads[pos * count / total] = _pcons(_create_node(*first), heads[pos * count / total]);
+                }
+            }
+        } catch (...) {
+            // the heap is untouched so far: drop the nodes made before the failure
+            for (BaseNodeT *head : heads) {
+                _clear(head);
+            }
+            throw;
+        }
+        _push_lists(_order(), heads.data(), count);
     }
 
     template <typename Range>
@@ -263,9 +903,10 @@ protected:
     }
 
     template<typename... Args>
-    iterator emplace(Args&&... args) { return { _push(_create_node(std::forward<Args>(args)...)) }; }
+    iterator emplace(Args&&... args) { return { _insert(_create_node(std::forward<Args>(args)...)) }; }
 
     _Type &front() const {
+        _settle();
         if (nullptr == _m_root._m_lptr) {
             throw std::invalid_argument("empty");
         }
@@ -273,21 +914,112 @@ protected:
     }
 
     void pop() {
-        _destroy_node(_pop());
+        _settle();
+        _destroy_node(_pop(_order()));
+    }
+
+    /// @brief move the @c k least values out, in order
+    /// @param k    number of values to pop; all of them if @c k >= @c size()
+    /// @param out  output iterator receiving the values
+    /// @return     @c out past the last value written
+    ///
+    /// Below @c size() this pops node by node: a pop is a single merge of the two subtrees
+    /// along their right spines, and there is no pass to share between pops.
+    template<typename _OutIt>
+    _OutIt pop_n(std::size_t k, _OutIt out) {
+        if (k >= _m_size) {
+            return drain(out);
+        }
+        _settle();
+        for (; k > 0; --k) {
+            _XNode *node{ static_cast<_XNode*>(_pop(_order())) };
+            try {
+                *out = std::move(node->_m_value);
+                ++out;
+            } catch (...) {
+                _destroy_node(node);
+                throw;
+            }
+            _destroy_node(node);
+        }
+        return out;
+    }
+
+    /// @brief move all values out, in order, leaving the heap empty
+    /// @param out  output iterator receiving the values
+    /// @return     @c out past the last value written
+    ///
+    /// This does not pop node by node, but sorts the nodes of the whole tree at once (see
+    /// listsort.hpp).  If writing a value throws, the values not yet written stay in the heap.
+    template<typename _OutIt>
+    _OutIt drain(_OutIt out) {
+        BaseNodeT *list{ _drain(_order()) };
+        try {
+            while (nullptr != list) {
+                *out = std::move(static_cast<_XNode*>(list)->_m_value);
+                ++out;
+                BaseNodeT *node{ list };
+                list = list->_m_pptr;
+                _destroy_node(node);
+            }
+        } catch (...) {
+            _push_list(_order(), list);
+            throw;
+        }
+        return out;
+    }
+
+    /// @brief move out all values a predicate holds for, in order
+    /// @param pred predicate on a @c const @c _Type&; whenever it holds for a value, it must
+    ///             hold for all values that go before that one (like @c due <= @c now does)
+    /// @param out  output iterator receiving the values
+    /// @return     @c out past the last value written
+    ///
+    /// The values are cut from the tree in one sweep, and what remains below them is built
+    /// into a heap once (see @c _sweep()), rather than being merged again on each pop.  If
+    /// writing a value throws, the values not yet written go back into the heap.
+    template<typename _Pred, typename _OutIt>
+    _OutIt pop_while(_Pred pred, _OutIt out) {
+        _settle();
+        BaseNodeT *list{ _sweep(_order(), [&pred](const BaseNodeT &node) {
+            return bool(pred(static_cast<const _XNode&>(node)._m_value));
+        }) };
+        try {
+            while (nullptr != list) {
+                *out = std::move(static_cast<_XNode*>(list)->_m_value);
+                ++out;
+                BaseNodeT *node{ list };
+                list = list->_m_pptr;
+                _destroy_node(node);
+            }
+        } catch (...) {
+            _push_list(_order(), list);
+            throw;
+        }
+        return out;
     }
 
     bool empty() const {
-        return nullptr == _m_root._m_lptr;
+        return 0 == _m_size;
+    }
+
+    std::size_t size() const {
+        return _m_size;
     }
 
+    /// @brief operation counters of the statistics policy
+    const _Stats &stats() const { return _m_stats; }
+    void reset_stats() { _m_stats = _Stats(); }
+
     /// @brief remove the node the iterator references
     /// @param itpos node to remove
     /// @return iterator to successor of @c itpos
     /// @note This invalidates all other iterators to the same position and distorts all other
     ///       active iterators for this heap!
     iterator remove(const iterator &itpos) {
+        _settle();
         BaseNodeT*succ{ _iter_succ(itpos._m_ipos) };
-        _destroy_node(_ncut(itpos._m_ipos));
+        _destroy_node(_ncut(_order(), itpos._m_ipos));
         return { succ };
     }
 
@@ -296,7 +1028,9 @@ protected:
     /// @return         @c itpos for convenience
     /// @note This will distort all active iterators for this heap!
     iterator decrease(const iterator &itpos) {
-        return { _decrease(itpos._m_ipos) };
+        _settle();
+        static_cast<_XNode*>(itpos._m_ipos)->_load(*itpos);
+        return { _decrease(_order(), itpos._m_ipos) };
     }
 
     /// @brief fully restore heap invariants after key/prio at @c *itpos was changed
@@ -304,10 +1038,254 @@ protected:
     /// @return         @c itpos for convenience
     /// @note This will distort all active iterators for this heap!
     iterator readjust(const iterator &itpos) {
-        return { _reinsert(itpos._m_ipos) };
+        _settle();
+        static_cast<_XNode*>(itpos._m_ipos)->_load(*itpos);
+        return { _reinsert(_order(), itpos._m_ipos) };
+    }
+
+    /// @brief write the heap to a snapshot file (see snapshot.hpp)
+    /// @param path file to write; an existing one is replaced atomically
+    /// @throw std::runtime_error if the file cannot be written
+    void save(const std::string &path) const {
+        static_assert(std::is_trivially_copyable<_Type>::value, "heap snapshots require a trivially copyable value type");
+        _settle();
+        HeapSnapshotWriter out(path.c_str(), sizeof(_Type), _m_size);
+        _preorder([&out](const BaseNodeT &node) {
+            const unsigned shape{ (node._m_lptr ? HeapSnapshotHeader::left  : 0u) |
+                                  (node._m_rptr ? HeapSnapshotHeader::right : 0u) };
+            out.record(shape, node._m_dist, &static_cast<const _XNode&>(node)._m_value);
+        });
+        out.commit();
+    }
+
+    /// @brief add the values of a snapshot file to the heap
+    /// @param path file written by @c save() of a heap with this value type
+    /// @param how  @c HeapLoad::shape relinks the saved tree as is, @c HeapLoad::rebuild
+    ///             builds one from the values
+    /// @throw std::runtime_error if the file cannot be read or is no snapshot for this type
+    ///
+    /// Relinking takes the order of the tree on trust and compares nothing, so the saving heap
+    /// must have had the same order; otherwise ask for a rebuild.  If the records do not make a
+    /// tree, or a saved leaf distance does not fit the subtrees below it, the values are rebuilt
+    /// anyway.  Into a non-empty heap, the loaded tree gets merged.
+    void load(const std::string &path, HeapLoad how = HeapLoad::shape) {
+        static_assert(std::is_trivially_copyable<_Type>::value, "heap snapshots require a trivially copyable value type");
+        HeapSnapshotReader snap(path.c_str(), sizeof(_Type));
+        auto make = [this](const unsigned char *raw) {
+            alignas(_Type) unsigned char buf[sizeof(_Type)];
+            std::memcpy(buf, raw, sizeof(_Type));
+            return _create_node(*std::launder(reinterpret_cast<const _Type*>(buf)));
+        };
+        BaseNodeT *nodes{ nullptr };
+        if (HeapLoad::shape == how && snap.is_tree() && _check_dists(snap)) {
+            try {
+                _unflatten(snap, nodes, make);
+            } catch (...) {
+                _clear(nodes);
+                throw;
+            }
+            _merge(_order(), &_m_root, &_m_root._m_lptr, _m_root._m_lptr, nodes);
+            _m_size += snap.count();
+        } else {
+            try {
+                for (std::size_t idx{ 0 }; idx < snap.count(); ++idx) {
+                    nodes = _pcons(make(HeapSnapshotReader::value(snap.record(idx))), nodes);
+                }
+            } catch (...) {
+                _clear(nodes);
+                throw;
+            }
+            _push_list(_order(), nodes);
+        }
+    }
+
+    using MinDistHeapT::validate_tree;
+    using MinDistHeapT::validate_stream;
+    using MinDistHeapT::validate_sample;
+    using MinDistHeapT::shape_stats;
+};
+
+// -----------------------------------------------------------------------------------------------
+// intrusive MinDistHeap: the elements carry the links themselves, by deriving (publicly) from
+// the hook type @c MinDistHeapT::BaseNodeT.  The heap never allocates, copies or destroys an
+// element; it only links and unlinks them.  An element can be in at most one heap at a time,
+// and it must not be destroyed while it is linked.
+// -----------------------------------------------------------------------------------------------
+
+using MinDistHeapHook = MinDistHeapT::BaseNodeT;
+
+template<
+    typename _Type,
+    typename _Comp = std::less<_Type>,
+    bool     _Inline = false >
+class IntrusiveMinDistHeap : protected MinDistHeapT
+{
+    // --- hook guard ---
+    static_assert(std::is_base_of<MinDistHeapHook, _Type>::value,
+        "IntrusiveMinDistHeap requires the value type to derive from MinDistHeapHook");
+
+    // --- comparator guard ---
+    static_assert(std::is_empty<_Comp>::value,
+        "IntrusiveMinDistHeap merge, move, or assignment require a stateless comparator");
+
+protected:
+    struct _XOrder {
+        bool operator()(const BaseNodeT &n1, const BaseNodeT &n2) const {
+            return _Comp()(static_cast<const _Type&>(n1), static_cast<const _Type&>(n2));
+        }
+    };
+
+    bool _pred(const BaseNodeT &n1, const BaseNodeT &n2) const override {
+        return _XOrder()(n1, n2);
+    }
+
+    auto _order() const {
+        if constexpr (_Inline) {
+            return _XOrder();
+        } else {
+            return VirtualOrderT{ this };
+        }
+    }
+
+    void _clear(BaseNodeT *root) {
+        while (nullptr != root) {
+            _singleton(_shred_pop(root));
+        }
+    }
+
+  public:
+
+    struct iterator {
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type        = _Type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = _Type*;
+        using reference         = _Type&;
+
+        iterator() = default;
+
+        reference operator*()  const { return  static_cast<_Type&>(*_m_ipos); }
+        pointer   operator->() const { return &static_cast<_Type&>(*_m_ipos); }
+
+        iterator& operator++()    { _m_ipos = _iter_succ(_m_ipos); return *this; }
+        iterator  operator++(int) { return { _iter_succ(_m_ipos) }; }
+        iterator& operator--()    { _m_ipos = _iter_pred(_m_ipos); return *this;     }
+        iterator  operator--(int) { return { _iter_pred(_m_ipos) }; }
+
+        friend bool operator==(const iterator& i1, const iterator& i2) { return  ::MinDistHeapT::_iter_same(i1._m_ipos, i2._m_ipos); }
+        friend bool operator!=(const iterator& i1, const iterator& i2) { return !::MinDistHeapT::_iter_same(i1._m_ipos, i2._m_ipos); }
+
+    protected:
+        friend IntrusiveMinDistHeap;
+
+        BaseNodeT *_m_ipos{ nullptr };
+
+        iterator(BaseNodeT* ipos) : _m_ipos{ ipos } { /*NOP*/ }
+    };
+
+    iterator begin() { return { _iter_head() }; }
+    iterator end()   { return { &_m_root       }; }
+
+    IntrusiveMinDistHeap() { /*NOP*/ }
+
+    IntrusiveMinDistHeap(IntrusiveMinDistHeap&& rhs) {
+        _take(rhs);
+    }
+    IntrusiveMinDistHeap(const IntrusiveMinDistHeap & rhs) = delete;
+
+    ~IntrusiveMinDistHeap() {
+        _clear(_yield());
+    }
+
+    IntrusiveMinDistHeap& operator=(IntrusiveMinDistHeap&& rhs) {
+        if (this != &rhs) {
+            _clear(_yield());
+            _take(rhs);
+        }
+        return *this;
+    }
+    IntrusiveMinDistHeap& operator=(const IntrusiveMinDistHeap &) = delete;
+
+    IntrusiveMinDistHeap& merge(IntrusiveMinDistHeap& rhs) {
+        _meld(_order(), rhs);
+        return *this;
+    }
+
+    /// @brief unlink all elements (the elements themselves are not touched otherwise)
+    void clear() {
+        _clear(_yield());
+    }
+
+    /// @brief link an element into the heap
+    /// @param item element to insert; must not be linked into any heap
+    /// @return iterator to @c item
+    iterator push(_Type &item) {
+        assert(!is_linked(item));
+        return { _push(_order(), &item) };
+    }
+
+    _Type &front() const {
+        if (nullptr == _m_root._m_lptr) {
+            throw std::invalid_argument("empty");
+        }
+        return static_cast<_Type&>(*_m_root._m_lptr);
+    }
+
+    /// @brief unlink the top element
+    /// @return the former top element or @c nullptr if the heap was empty
+    _Type *pop() {
+        return static_cast<_Type*>(_singleton(_pop(_order())));
+    }
+
+    bool empty() const {
+        return nullptr == _m_root._m_lptr;
+    }
+
+    std::size_t size() const {
+        return _m_size;
+    }
+
+    /// @brief check if an element is linked into some heap
+    static bool is_linked(const _Type &item) {
+        return nullptr != item._m_pptr;
+    }
+
+    /// @brief get an iterator to a linked element
+    iterator iterator_to(_Type &item) {
+        return { &item };
+    }
+
+    /// @brief unlink an element from the heap
+    /// @param item element to remove, must be linked into this heap
+    void remove(_Type &item) {
+        _singleton(_ncut(_order(), &item));
+    }
+
+    /// @brief unlink the element the iterator references
+    /// @param itpos element to remove
+    /// @return iterator to successor of @c itpos
+    iterator remove(const iterator &itpos) {
+        BaseNodeT*succ{ _iter_succ(itpos._m_ipos) };
+        _singleton(_ncut(_order(), itpos._m_ipos));
+        return { succ };
+    }
+
+    /// @brief quickly restore heap invariants after key/prio of @c item was reduced
+    /// @param item element that should go closer to the root
+    void decrease(_Type &item) {
+        _decrease(_order(), &item);
+    }
+
+    /// @brief fully restore heap invariants after key/prio of @c item was changed
+    /// @param item element that should be re-evaluated for position in heap
+    void readjust(_Type &item) {
+        _reinsert(_order(), &item);
     }
 
     using MinDistHeapT::validate_tree;
+    using MinDistHeapT::validate_stream;
+    using MinDistHeapT::validate_sample;
+    using MinDistHeapT::shape_stats;
 };
 
 #endif // LDQUEUE3_9687E0DD_D406_474B_9534_94B7C1D81D33
\ No newline at end of file
@@ -0,0 +1,313 @@
+// -------------------------------------------------------------------------------------------
+// MinMaxHeap: a double-ended priority queue of twin MinDist Heaps sharing their nodes
+// -------------------------------------------------------------------------------------------
+// This file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+// Every node carries two sets of links, one for a MinDist Heap in the given order and one for
+// a MinDist Heap in the reverse order, and the value once.  Each value is in both trees, so:
+//
+//  - 'front()' is the root of the first tree, 'back()' the root of the second one;
+//  - 'pop_min()' pops the first tree and cuts the node from the second one, 'pop_max()' the
+//    other way round, 'remove()' cuts it from both -- O(log N) each;
+//  - 'decrease()' takes the fast path in the first tree and re-inserts in the second, and
+//    'increase()' does it the other way round; 'readjust()' re-inserts in both.
+//
+// Iteration walks the first tree, exactly like a 'MinDistHeap' does, and the iterators have
+// the same contract: 'remove()' hands out the successor, and any structural change may disturb
+// the other iterators, but never invalidates them unless their node goes.
+// -------------------------------------------------------------------------------------------
+#ifndef MINMAX_9687E0DD_D406_474B_9534_94B7C1D81D33
+#define MINMAX_9687E0DD_D406_474B_9534_94B7C1D81D33
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "mdqueue3.hpp"
+#include "nodepool.hpp"
+
+template<
+    typename _Type,
+    typename _Comp = std::less<_Type>,
+    typename Alloc = std::allocator<_Type>,
+    bool     _Inline = false >
+class MinMaxHeap
+{
+    // --- allocator guard ---
+    static_assert(std::allocator_traits<Alloc>::is_always_equal::value,
+         "MinMaxHeap requires an allocator with is_always_equal == true");
+
+    // --- comparator guard ---
+    static_assert(std::is_empty<_Comp>::value,
+        "MinMaxHeap merge, move, or assignment require a stateless comparator");
+
+protected:
+    using BaseNodeT = MinDistHeapT::BaseNodeT;
+
+    // the two sets of links are distinct base classes, so each one finds its way to the node
+    struct _XLow  : public BaseNodeT { };
+    struct _XHigh : public BaseNodeT { };
+
+    struct _XNode : public _XLow, public _XHigh {
+        _Type _m_value;
+
+        _XNode(const _Type &  rhs) : _m_value{ rhs            } { /*NOP*/ }
+        _XNode(      _Type && rhs) : _m_value{ std::move(rhs) } { /*NOP*/ }
+    };
+
+    template<typename _Hook> static       _XNode *_node(      BaseNodeT *h) { return static_cast<      _XNode*>(static_cast<      _Hook*>(h)); }
+    template<typename _Hook> static const _XNode *_node(const BaseNodeT *h) { return static_cast<const _XNode*>(static_cast<const _Hook*>(h)); }
+
+    /// @brief order of one tree: @c _Comp on the low links, reversed on the high ones
+    template<typename _Hook>
+    struct _XOrder {
+        bool operator()(const BaseNodeT &n1, const BaseNodeT &n2) const {
+            const _Type &v1{ _node<_Hook>(&n1)->_m_value };
+            const _Type &v2{ _node<_Hook>(&n2)->_m_value };
+            return std::is_same<_Hook, _XLow>::value ? _Comp()(v1, v2) : _Comp()(v2, v1);
+        }
+    };
+
+    template<typename _Hook>
+    struct _XSide : public MinDistHeapT {
+        bool _pred(const BaseNodeT &n1, const BaseNodeT &n2) const override {
+            return _XOrder<_Hook>()(n1, n2);
+        }
+
+        auto _order() const {
+            if constexpr (_Inline) {
+                return _XOrder<_Hook>();
+            } else {
+                return VirtualOrderT{ this };
+            }
+        }
+    };
+
+    using node_allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<_XNode>;
+    using node_alloc_traits = std::allocator_traits<node_allocator_type>;
+
+    template<typename... Args>
+    _XNode* _create_node(Args&&... args) {
+        _XNode* p = node_alloc_traits::allocate(_m_alloc, 1);
+        try {
+            node_alloc_traits::construct(_m_alloc, p, std::forward<Args>(args)...);
+        } catch (...) {
+            node_alloc_traits::deallocate(_m_alloc, p, 1);
+            throw;
+        }
+        return p;
+    }
+
+    void _destroy_node(_XNode* p) {
+        if (p) {
+            node_alloc_traits::destroy(_m_alloc, p);
+            node_alloc_traits::deallocate(_m_alloc, p, 1);
+        }
+    }
+
+    void _clear() {
+        _m_high._yield();
+        for (BaseNodeT *root{ _m_low._yield() }; nullptr != root; /*NOP*/) {
+            _destroy_node(_node<_XLow>(MinDistHeapT::_shred_pop(root)));
+        }
+    }
+
+    BaseNodeT *_insert(_XNode *node) {
+        _m_high._push(_m_high._order(), static_cast<_XHigh*>(node));
+        return _m_low._push(_m_low._order(), static_cast<_XLow*>(node));
+    }
+
+    _XSide<_XLow>       _m_low;     // the tree in '_Comp' order, iteration runs here
+    _XSide<_XHigh>      _m_high;    // the tree in reverse order
+    node_allocator_type _m_alloc;
+
+  public:
+
+    using allocator_type = Alloc;
+
+    struct iterator {
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type        = _Type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = _Type*;
+        using reference         = _Type&;
+
+        iterator() = default;
+
+        reference operator*()  const { return  _node<_XLow>(_m_ipos)->_m_value; }
+        pointer   operator->() const { return &_node<_XLow>(_m_ipos)->_m_value; }
+
+        iterator& operator++()    { _m_ipos = MinDistHeapT::_iter_succ(_m_ipos); return *this; }
+        iterator  operator++(int) { return { MinDistHeapT::_iter_succ(_m_ipos) }; }
+        iterator& operator--()    { _m_ipos = MinDistHeapT::_iter_pred(_m_ipos); return *this; }
+        iterator  operator--(int) { return { MinDistHeapT::_iter_pred(_m_ipos) }; }
+
+        friend bool operator==(const iterator& i1, const iterator& i2) { return  MinDistHeapT::_iter_same(i1._m_ipos, i2._m_ipos); }
+        friend bool operator!=(const iterator& i1, const iterator& i2) { return !MinDistHeapT::_iter_same(i1._m_ipos, i2._m_ipos); }
+
+    protected:
+        friend MinMaxHeap;
+
+        BaseNodeT *_m_ipos{ nullptr };
+
+        iterator(BaseNodeT* ipos) : _m_ipos{ ipos } { /*NOP*/ }
+    };
+
+    iterator begin() { return { _m_low._iter_head() }; }
+    iterator end()   { return { &_m_low._m_root      }; }
+
+    MinMaxHeap() { /*NOP*/ }
+
+    MinMaxHeap(MinMaxHeap&& rhs) {
+        _m_low._take(rhs._m_low);
+        _m_high._take(rhs._m_high);
+    }
+    MinMaxHeap(const MinMaxHeap & rhs) = delete;
+
+    ~MinMaxHeap() {
+        _clear();
+    }
+
+    MinMaxHeap& operator=(MinMaxHeap&& rhs) {
+        if (this != &rhs) {
+            _clear();
+            _m_low._take(rhs._m_low);
+            _m_high._take(rhs._m_high);
+        }
+        return *this;
+    }
+    MinMaxHeap& operator=(const MinMaxHeap &) = delete;
+
+    MinMaxHeap& merge(MinMaxHeap& rhs) {
+        _m_low._meld(_m_low._order(), rhs._m_low);
+        _m_high._meld(_m_high._order(), rhs._m_high);
+        return *this;
+    }
+
+    void clear() {
+        _clear();
+    }
+
+    /// @brief pre-populate the node allocator, if it supports that ( @c NodePoolAllocator does)
+    /// @param n    number of nodes that can be pushed afterwards without allocating memory
+    void reserve(std::size_t n) {
+        node_pool_traits<node_allocator_type>::reserve(_m_alloc, n);
+    }
+
+    iterator push(const _Type &  rhs) { return { _insert(_create_node(rhs           )) }; }
+    iterator push(      _Type && rhs) { return { _insert(_create_node(std::move(rhs))) }; }
+
+    template<typename... Args>
+    iterator emplace(Args&&... args) { return { _insert(_create_node(std::forward<Args>(args)...)) }; }
+
+    /// @brief the least value
+    _Type &front() const {
+        if (nullptr == _m_low._m_root._m_lptr) {
+            throw std::invalid_argument("empty");
+        }
+        return _node<_XLow>(_m_low._m_root._m_lptr)->_m_value;
+    }
+
+    /// @brief the greatest value
+    _Type &back() const {
+        if (nullptr == _m_high._m_root._m_lptr) {
+            throw std::invalid_argument("empty");
+        }
+        return _node<_XHigh>(_m_high._m_root._m_lptr)->_m_value;
+    }
+
+    /// @brief remove the least value
+    void pop_min() {
+        BaseNodeT *low{ _m_low._pop(_m_low._order()) };
+        if (nullptr != low) {
+            _XNode *node{ _node<_XLow>(low) };
+            _m_high._ncut(_m_high._order(), static_cast<_XHigh*>(node));
+            _destroy_node(node);
+        }
+    }
+
+    /// @brief remove the greatest value
+    void pop_max() {
+        BaseNodeT *high{ _m_high._pop(_m_high._order()) };
+        if (nullptr != high) {
+            _XNode *node{ _node<_XHigh>(high) };
+            _m_low._ncut(_m_low._order(), static_cast<_XLow*>(node));
+            _destroy_node(node);
+        }
+    }
+
+    bool empty() const {
+        return 0 == _m_low._m_size;
+    }
+
+    std::size_t size() const {
+        return _m_low._m_size;
+    }
+
+    /// @brief remove the node the iterator references
+    /// @param itpos node to remove
+    /// @return iterator to successor of @c itpos
+    /// @note This invalidates all other iterators to the same position and distorts all other
+    ///       active iterators for this heap!
+    iterator remove(const iterator &itpos) {
+        BaseNodeT *succ{ MinDistHeapT::_iter_succ(itpos._m_ipos) };
+        _XNode    *node{ _node<_XLow>(itpos._m_ipos) };
+        _m_low._ncut(_m_low._order(), static_cast<_XLow*>(node));
+        _m_high._ncut(_m_high._order(), static_cast<_XHigh*>(node));
+        _destroy_node(node);
+        return { succ };
+    }
+
+    /// @brief restore heap invariants after the value at @c *itpos was reduced
+    /// @param itpos    node that should go closer to the front
+    /// @return         @c itpos for convenience
+    /// @note This will distort all active iterators for this heap!
+    iterator decrease(const iterator &itpos) {
+        _XNode *node{ _node<_XLow>(itpos._m_ipos) };
+        _m_low._decrease(_m_low._order(), static_cast<_XLow*>(node));
+        _m_high._reinsert(_m_high._order(), static_cast<_XHigh*>(node));
+        return itpos;
+    }
+
+    /// @brief restore heap invariants after the value at @c *itpos was raised
+    /// @param itpos    node that should go closer to the back
+    /// @return         @c itpos for convenience
+    /// @note This will distort all active iterators for this heap!
+    iterator increase(const iterator &itpos) {
+        _XNode *node{ _node<_XLow>(itpos._m_ipos) };
+        _m_high._decrease(_m_high._order(), static_cast<_XHigh*>(node));
+        _m_low._reinsert(_m_low._order(), static_cast<_XLow*>(node));
+        return itpos;
+    }
+
+    /// @brief fully restore heap invariants after the value at @c *itpos was changed
+    /// @param itpos    node that should be re-evaluated for position in heap
+    /// @return         @c itpos for convenience
+    /// @note This will distort all active iterators for this heap!
+    iterator readjust(const iterator &itpos) {
+        _XNode *node{ _node<_XLow>(itpos._m_ipos) };
+        _m_low._reinsert(_m_low._order(), static_cast<_XLow*>(node));
+        _m_high._reinsert(_m_high._order(), static_cast<_XHigh*>(node));
+        return itpos;
+    }
+
+    /// @brief validate both trees, and that they hold the same number of nodes
+    /// @throw std::logic_error on the first violation found
+    void validate_tree() const {
+        _m_low.validate_tree();
+        _m_high.validate_tree();
+        if (_m_low._m_size != _m_high._m_size) {
+            throw std::logic_error("_m_low._m_size == _m_high._m_size");
+        }
+    }
+};
+
+#endif // MINMAX_9687E0DD_D406_474B_9534_94B7C1D81D33
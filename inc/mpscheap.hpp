@@ -0,0 +1,152 @@
+// -------------------------------------------------------------------------------------------
+// Pairing Heap with a lock-free multi-producer / single-consumer insertion front-end
+// -------------------------------------------------------------------------------------------
+// This file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+// A 2-way Pairing Heap node is a singly linked list node already.  Producers push their
+// nodes onto an atomic Treiber stack with one CAS, never taking a lock.  The consumer grabs
+// the whole stack with one exchange and builds it into the heap with a single pairing pass
+// -- O(k) for a batch of k nodes -- whenever it looks at the heap.
+//
+// Thread safety:
+//  - 'push()' may be called from any number of threads, concurrently with everything else.
+//  - All other operations belong to the one consumer thread.
+//
+// The nodes are allocated by the producers and freed by the consumer, so the allocator must
+// support that; the thread-affine 'NodePoolAllocator' does not, and is rejected.
+// -------------------------------------------------------------------------------------------
+#ifndef MPSCHEAP_9687E0DD_D406_474B_9534_94B7C1D81D33
+#define MPSCHEAP_9687E0DD_D406_474B_9534_94B7C1D81D33
+
+#include <atomic>
+
+#include "phqueue2.hpp"
+
+template<typename _Type,
+         typename _Comp = std::less<_Type>,
+         typename Alloc = std::allocator<_Type>,
+         bool     _Inline = false,
+         typename _Stats = NoHeapStats,
+         typename _Pass = PairingTwoPass,
+         typename _KeyOf = IdentityKey >
+class MpscPairingHeap : protected PairingHeapEasy<_Type, _Comp, Alloc, _Inline, _Stats, _Pass, _KeyOf>
+{
+    using _Base = PairingHeapEasy<_Type, _Comp, Alloc, _Inline, _Stats, _Pass, _KeyOf>;
+    using typename _Base::PairingNodeT;
+
+    // --- allocator guard ---
+    static_assert(!node_pool_traits<Alloc>::thread_affine,
+        "MpscPairingHeap frees nodes on the consumer that the producers allocated, a thread-affine pool cannot do that");
+
+protected:
+    std::atomic<PairingNodeT*> _m_inbox{ nullptr };
+
+    /// @brief producer side: push a node onto the inbox stack
+    void _post(PairingNodeT *node) {
+        PairingNodeT *head{ _m_inbox.load(std::memory_order_relaxed) };
+        do {
+            node->_m_next = head;
+        } while (!_m_inbox.compare_exchange_weak(head, node,
+                                                 std::memory_order_release,
+                                                 std::memory_order_relaxed));
+    }
+
+    /// @brief consumer side: build all posted nodes into the heap
+    void _collect() {
+        if (nullptr != _m_inbox.load(std::memory_order_relaxed)) {
+            this->template _push_list<_Pass>(this->_order(),
+                                             _m_inbox.exchange(nullptr, std::memory_order_acquire));
+        }
+    }
+
+public:
+    using allocator_type = Alloc;
+
+    MpscPairingHeap()
+    { /*NOP*/ }
+
+    MpscPairingHeap(const MpscPairingHeap &) = delete;
+    MpscPairingHeap &operator=(const MpscPairingHeap &) = delete;
+
+    ~MpscPairingHeap() {
+        this->_clear(_m_inbox.exchange(nullptr, std::memory_order_acquire));
+    }
+
+    /// @brief insert a value; lock-free, callable from any thread
+    void push(const _Type &  rhs) { _post(this->_create_node(rhs           )); }
+    void push(      _Type && rhs) { _post(this->_create_node(std::move(rhs))); }
+
+    // --- consumer thread only ---
+
+    _Type &front() {
+        _collect();
+        return _Base::front();
+    }
+
+    void pop() {
+        _collect();
+        _Base::pop();
+    }
+
+    /// @brief pop the least element, if any
+    /// @return @c false if the heap (including the inbox) was empty
+    bool try_pop(_Type &out) {
+        _collect();
+        if (_Base::empty()) {
+            return false;
+        }
+        out = std::move(_Base::front());
+        _Base::pop();
+        return true;
+    }
+
+    /// @brief move the @c k least values out, in order (see @c PairingHeapEasy::pop_n() )
+    template<typename _OutIt>
+    _OutIt pop_n(std::size_t k, _OutIt out) {
+        _collect();
+        return _Base::pop_n(k, out);
+    }
+
+    /// @brief move all values posted so far out, in order (see @c PairingHeapEasy::drain() )
+    template<typename _OutIt>
+    _OutIt drain(_OutIt out) {
+        _collect();
+        return _Base::drain(out);
+    }
+
+    bool empty() {
+        _collect();
+        return _Base::empty();
+    }
+
+    /// @brief number of elements, including all nodes posted so far
+    std::size_t size() {
+        _collect();
+        return _Base::size();
+    }
+
+    /// @brief merge a (single-threaded) heap into this one
+    MpscPairingHeap &merge(_Base &rhs) {
+        _Base::merge(rhs);
+        return *this;
+    }
+
+    void clear() {
+        _collect();
+        _Base::clear();
+    }
+
+    using _Base::stats;
+    using _Base::reset_stats;
+
+    void validate_tree() {
+        _collect();
+        _Base::validate_tree();
+    }
+};
+
+#endif // MPSCHEAP_9687E0DD_D406_474B_9534_94B7C1D81D33
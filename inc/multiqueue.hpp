@@ -0,0 +1,192 @@
+// -------------------------------------------------------------------------------------------
+// MultiQueue: a relaxed concurrent priority queue made of sharded heaps
+// -------------------------------------------------------------------------------------------
+// This file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+// The MultiQueue design (Rihani, Sanders, Dementiev): c*P sequential heaps, each behind its
+// own lock.  'push()' goes to a random shard; 'try_pop()' looks at two random shards and
+// pops the better of their tops.  Threads never wait for a lock -- if a shard is busy, they
+// simply roll the dice again.
+//
+// The price is relaxation: the popped element is not necessarily the global minimum, but its
+// rank is O(c*P) expected.  With a single thread and a single shard this is an exact
+// priority queue.
+//
+// Any heap of this library can be a shard, as long as its order on the values is '_Comp' and
+// its nodes do not come from a thread-affine 'NodePoolAllocator': all threads use all shards.
+// The O(1) meld of the Pairing Heaps makes 'merge_into()' (collect all shards into one heap)
+// cost O(shards).
+// -------------------------------------------------------------------------------------------
+#ifndef MULTIQUEUE_9687E0DD_D406_474B_9534_94B7C1D81D33
+#define MULTIQUEUE_9687E0DD_D406_474B_9534_94B7C1D81D33
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "nodepool.hpp"
+#include "phqueue2.hpp"
+
+template<
+    typename _Type,
+    typename _Comp = std::less<_Type>,
+    typename _Heap = PairingHeapEasy<_Type, _Comp> >
+class MultiQueue
+{
+    // --- comparator guard ---
+    static_assert(std::is_empty<_Comp>::value,
+        "MultiQueue requires a stateless comparator");
+
+    // --- allocator guard ---
+    static_assert(!heap_thread_affine<_Heap>::value,
+        "MultiQueue shards are used by all threads, they cannot allocate from a thread-affine pool");
+
+protected:
+    // one shard per cache line (at least), so the locks do not share lines
+    struct alignas(64) _XShard {
+        std::mutex  _m_lock;
+        _Heap       _m_heap;
+    };
+
+    std::unique_ptr<_XShard[]>  _m_shard;
+    std::size_t                 _m_count;
+    std::atomic<std::size_t>    _m_size{ 0 };
+
+    /// @brief thread-local xorshift; good enough for picking shards, and cheap
+    static std::uint64_t _random() {
+        thread_local std::uint64_t s_state{
+            std::hash<std::thread::id>()(std::this_thread::get_id()) | 1u };
+        s_state ^= s_state << 13;
+        s_state ^= s_state >> 7;
+        s_state ^= s_state << 17;
+        return s_state;
+    }
+
+    _XShard &_pick() {
+        return _m_shard[_random() % _m_count];
+    }
+
+    /// @brief pop from the better of two locked shards
+    /// @return @c false if both shards are empty
+    static bool _pop_better(_XShard &a, _XShard &b, _Type &out) {
+        _Heap *best{ nullptr };
+        if (!a._m_heap.empty()) {
+            best = &a._m_heap;
+        }
+        if (!b._m_heap.empty() && (!best || _Comp()(b._m_heap.front(), best->front()))) {
+            best = &b._m_heap;
+        }
+        if (nullptr != best) {
+            out = std::move(best->front());
+            best->pop();
+        }
+        return nullptr != best;
+    }
+
+public:
+    /// @brief create a MultiQueue
+    /// @param shards   number of shards; the default is 2 per hardware thread
+    explicit MultiQueue(std::size_t shards = 0)
+        : _m_shard{ nullptr }
+        , _m_count{ shards ? shards : 2 * std::max(1u, std::thread::hardware_concurrency()) }
+    {
+        _m_shard.reset(new _XShard[_m_count]);
+    }
+
+    MultiQueue(const MultiQueue &) = delete;
+    MultiQueue &operator=(const MultiQueue &) = delete;
+
+    std::size_t shards() const {
+        return _m_count;
+    }
+
+    /// @brief number of elements; exact only if no other thread is active
+    std::size_t size() const {
+        return _m_size.load(std::memory_order_relaxed);
+    }
+
+    bool empty() const {
+        return 0 == size();
+    }
+
+    /// @brief insert an element into a random shard
+    template<typename _Arg>
+    void push(_Arg &&value) {
+        for (;;) {
+            _XShard &shard{ _pick() };
+            if (shard._m_lock.try_lock()) {
+                std::lock_guard<std::mutex> hold(shard._m_lock, std::adopt_lock);
+                shard._m_heap.push(std::forward<_Arg>(value));
+                _m_size.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
+
+    /// @brief remove an element close to the minimum
+    /// @param out  receives the popped element
+    /// @return @c false if the queue was found empty
+    ///
+    /// If two random shards keep turning out empty, all shards are scanned in turn, so this
+    /// returns @c false only if every shard was empty when visited.
+    bool try_pop(_Type &out) {
+        for (std::size_t tries{ 0 }; tries < 2 * _m_count; /*NOP*/) {
+            if (empty()) {
+                return false;
+            }
+            _XShard &a{ _pick() }, &b{ _pick() };
+            if (!a._m_lock.try_lock()) {
+                continue;
+            }
+            std::lock_guard<std::mutex> hold_a(a._m_lock, std::adopt_lock);
+            if (&a == &b) {
+                if (_pop_better(a, a, out)) {
+                    _m_size.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            } else if (b._m_lock.try_lock()) {
+                std::lock_guard<std::mutex> hold_b(b._m_lock, std::adopt_lock);
+                if (_pop_better(a, b, out)) {
+                    _m_size.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            } else {
+                continue;       // contended; that's not an empty pick
+            }
+            ++tries;
+        }
+
+        // few elements in many shards: go looking
+        for (std::size_t idx{ 0 }; idx < _m_count; ++idx) {
+            std::lock_guard<std::mutex> hold(_m_shard[idx]._m_lock);
+            if (_pop_better(_m_shard[idx], _m_shard[idx], out)) {
+                _m_size.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief move all elements into a heap, by melding the shards into it
+    /// @param dst  heap to receive the elements
+    void merge_into(_Heap &dst) {
+        for (std::size_t idx{ 0 }; idx < _m_count; ++idx) {
+            std::lock_guard<std::mutex> hold(_m_shard[idx]._m_lock);
+            _m_size.fetch_sub(_m_shard[idx]._m_heap.size(), std::memory_order_relaxed);
+            dst.merge(_m_shard[idx]._m_heap);
+        }
+    }
+};
+
+#endif // MULTIQUEUE_9687E0DD_D406_474B_9534_94B7C1D81D33
@@ -0,0 +1,190 @@
+// -------------------------------------------------------------------------------------------
+// Slab-style node pool allocator for heap nodes
+// -------------------------------------------------------------------------------------------
+// This file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+// All heaps allocate their nodes one at a time.  Under heavy push/pop churn the general
+// purpose allocator becomes the bottleneck, so here's a pool that carves nodes from large
+// chunks and recycles them through a free list.
+//
+// The pool is thread-local and shared by all heaps with the same node type and the same tag.
+// That keeps the allocator stateless, which the heaps require for moving and melding nodes
+// (is_always_equal == true), but it also means:
+//
+//  - nodes must be released by the thread that allocated them, and heaps using the pool
+//    must not outlive the thread.  (The chunks are returned to the system on thread exit.)
+//  - a single heap cannot drop "its" chunks: they are shared with other heaps of the same
+//    node type.  'release()' returns all chunks of a tag's pools that have no node in use
+//    any more; a distinct tag type gives a heap (or group of heaps) pools of their own.
+//  - a heap holding all live nodes of its pool can hand them back at once ('recycle()'):
+//    'clear()' does so for trivially destructible values, without walking the tree.  The
+//    chunks stay with the pool and are threaded into the free list again as needed.
+// -------------------------------------------------------------------------------------------
+#ifndef NODEPOOL_9687E0DD_D406_474B_9534_94B7C1D81D33
+#define NODEPOOL_9687E0DD_D406_474B_9534_94B7C1D81D33
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// -------------------------------------------------------------------------------------------
+// untyped pool for fixed-size blocks
+// -------------------------------------------------------------------------------------------
+
+class NodePoolT
+{
+public:
+    NodePoolT(std::size_t size, std::size_t align, NodePoolT *&chain);
+    ~NodePoolT();
+
+    NodePoolT(const NodePoolT&) = delete;
+    NodePoolT& operator=(const NodePoolT&) = delete;
+
+    void *allocate() {
+        _FreeT *retv{ _m_free };
+        if (nullptr == retv) {
+            retv = _grow();
+        }
+        _m_free = retv->_m_next;
+        ++_m_live;
+        return retv;
+    }
+
+    void deallocate(void *p) {
+        _FreeT *node{ static_cast<_FreeT*>(p) };
+        node->_m_next = _m_free;
+        _m_free = node;
+        --_m_live;
+    }
+
+    void        reserve(std::size_t n);         // make sure 'n' blocks can be handed out without allocation
+    bool        recycle(std::size_t n);         // take back all blocks at once if exactly 'n' are live
+    bool        release();                      // drop all chunks if no block is live
+
+    static bool release_chain(NodePoolT *pool); // 'release()' for a pool and all linked pools
+
+    std::size_t live()     const { return _m_live;  }
+    std::size_t capacity() const { return _m_total; }
+
+protected:
+    struct _FreeT  { _FreeT  *_m_next; };
+    struct _ChunkT { _ChunkT *_m_next; };
+
+    _FreeT *_grow();                            // add another chunk, return the free list head
+
+    std::size_t _m_size;                        // block size, rounded to alignment
+    std::size_t _m_align;                       // block alignment
+    std::size_t _m_head;                        // offset of the first block in a chunk
+    std::size_t _m_live { 0 };                  // blocks currently handed out
+    std::size_t _m_total{ 0 };                  // blocks in all chunks
+    _FreeT     *_m_free { nullptr };            // free list
+    _ChunkT    *_m_chunk{ nullptr };            // chunk list
+    _ChunkT    *_m_spare{ nullptr };            // chunks taken back by 'recycle()', not threaded yet
+    NodePoolT  *_m_link { nullptr };            // next pool with the same tag
+    NodePoolT **_m_chain;                       // head of the pool chain for the tag
+};
+
+// -----------------------------------------------------------------------------------------------
+// typed allocator on top of a thread-local pool
+//
+// Only single-object allocations go to the pool; anything else is forwarded to the global
+// operator new.  There is one pool per thread, allocated type and tag; all pools of a tag
+// are chained, so rebound allocators can be released together.
+// -----------------------------------------------------------------------------------------------
+
+template<typename _Tag>
+NodePoolT *&node_pool_chain()
+{
+    thread_local NodePoolT *_s_chain{ nullptr };
+    return _s_chain;
+}
+
+template<typename _Type, typename _Tag = void>
+class NodePoolAllocator
+{
+public:
+    using value_type      = _Type;
+    using is_always_equal = std::true_type;
+
+    template<typename _Other>
+    struct rebind { using other = NodePoolAllocator<_Other, _Tag>; };
+
+    NodePoolAllocator() noexcept = default;
+
+    template<typename _Other>
+    NodePoolAllocator(const NodePoolAllocator<_Other, _Tag>&) noexcept { /*NOP*/ }
+
+    _Type *allocate(std::size_t n) {
+        if (1 == n) {
+            return static_cast<_Type*>(pool().allocate());
+        }
+        return static_cast<_Type*>(::operator new(n * sizeof(_Type), std::align_val_t{ alignof(_Type) }));
+    }
+
+    void deallocate(_Type *p, std::size_t n) noexcept {
+        if (1 == n) {
+            pool().deallocate(p);
+        } else {
+            ::operator delete(p, std::align_val_t{ alignof(_Type) });
+        }
+    }
+
+    /// @brief pre-populate the pool of the calling thread
+    /// @param n    number of objects that can be allocated afterwards without touching the system
+    static void reserve(std::size_t n) { pool().reserve(n); }
+
+    /// @brief take back all objects of the calling thread's pool at once, without destroying them
+    /// @param n    number of objects the caller holds
+    /// @return @c true if these were all live objects of the pool, which are free now
+    static bool recycle(std::size_t n) { return pool().recycle(n); }
+
+    /// @brief return the chunks of all idle pools with this tag (in the calling thread) to the system
+    /// @return @c true if all pools were idle and have been emptied
+    static bool release() { return NodePoolT::release_chain(node_pool_chain<_Tag>()); }
+
+    static NodePoolT &pool() {
+        thread_local NodePoolT _s_pool(sizeof(_Type), alignof(_Type), node_pool_chain<_Tag>());
+        return _s_pool;
+    }
+
+    template<typename _Other>
+    friend bool operator==(const NodePoolAllocator&, const NodePoolAllocator<_Other, _Tag>&) { return true;  }
+    template<typename _Other>
+    friend bool operator!=(const NodePoolAllocator&, const NodePoolAllocator<_Other, _Tag>&) { return false; }
+};
+
+// -----------------------------------------------------------------------------------------------
+// glue for the heap templates: 'reserve()' and 'recycle()' are forwarded to allocators that
+// know about them, and silently ignored for all others.  Such allocators are pools, and pools
+// are thread-affine.
+// -----------------------------------------------------------------------------------------------
+
+template<typename _Alloc, typename = void>
+struct node_pool_traits {
+    static constexpr bool thread_affine = false;
+    static void reserve(_Alloc &, std::size_t) { /*NOP*/ }
+    static bool recycle(_Alloc &, std::size_t) { return false; }
+};
+
+template<typename _Alloc>
+struct node_pool_traits<_Alloc, std::void_t<decltype(std::declval<_Alloc&>().reserve(std::size_t()))>> {
+    static constexpr bool thread_affine = true;
+    static void reserve(_Alloc &a, std::size_t n) { a.reserve(n); }
+    static bool recycle(_Alloc &a, std::size_t n) { return a.recycle(n); }
+};
+
+// a heap whose 'allocator_type' is such a pool must not hand its nodes to other threads
+template<typename _Heap, typename = void>
+struct heap_thread_affine : std::false_type {};
+
+template<typename _Heap>
+struct heap_thread_affine<_Heap, std::void_t<typename _Heap::allocator_type>>
+    : std::bool_constant<node_pool_traits<typename _Heap::allocator_type>::thread_affine> {};
+
+#endif // NODEPOOL_9687E0DD_D406_474B_9534_94B7C1D81D33
@@ -0,0 +1,118 @@
+// -------------------------------------------------------------------------------------------
+// Pairing strategies for the Pairing Heaps
+// -------------------------------------------------------------------------------------------
+// This file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+// The pairing pass decides how a list of trees is combined into one: when the root is popped
+// and its children must be joined, or when a node is cut and its children take its place.
+//
+//  - PairingTwoPass:    the classic: merge pairs left to right, then fold the results right
+//                       to left into one tree.
+//  - PairingMultiPass:  merge pairs over and over again until only one tree remains.
+//  - PairingAuxTwoPass: Stasko/Vitter auxiliary twopass.  Pushed nodes (and subtrees cut by
+//                       decrease-key) are not merged with the root, but collected in a list
+//                       of pending trees behind it, keeping track of the smallest one.  On
+//                       'pop()' the pending trees are combined by multipass and merged with
+//                       the root once; after that children are combined by two-pass.
+//                       'front()' stays O(1), with no structural change.
+//  - PairingBoundedPass: the root list of the auxiliary variant, kept like a binary counter:
+//                       at most one tree per rank (the degree its root got by linking), in
+//                       ascending order.  A push links equal ranks as a carry does, a pop folds
+//                       the remaining trees and the children of the old root the same way.
+//                       Each costs O(log N) links at worst, never the O(N) pass the first pop
+//                       after N pushes does otherwise; 'front()' is the least root list member.
+//                       'PairingHeap' and 'SmallPairingHeap' only, which have the parent
+//                       links to find a node's place.
+//
+// Pushing right before popping -- a timer queue, for instance -- profits most from the
+// auxiliary variant, as the fresh nodes never pile up in the root's child list.
+//
+// 'heap_pairing_pass()' is the two-pass and multipass combination for the forward-only heaps,
+// whatever their links are.  A link accessor tells it how to follow and set them:
+//
+//   using link_type = ...;                      // node pointer or index
+//   static constexpr link_type nil;             // end of list
+//   link_type next(link_type n) const;          // n's sibling
+//   void      next(link_type n, link_type s);   // set n's sibling
+//   link_type merge(link_type a, link_type b);  // merge two trees, winner's sibling cleared
+//   void      prefetch(link_type n) const;      // hint: n is merged next (n may be nil)
+// -------------------------------------------------------------------------------------------
+#ifndef PAIRPASS_9687E0DD_D406_474B_9534_94B7C1D81D33
+#define PAIRPASS_9687E0DD_D406_474B_9534_94B7C1D81D33
+
+#include <cstddef>
+
+struct PairingTwoPass     { static constexpr bool multipass = false; static constexpr bool auxiliary = false; static constexpr bool bounded = false; };
+struct PairingMultiPass   { static constexpr bool multipass = true;  static constexpr bool auxiliary = false; static constexpr bool bounded = false; };
+struct PairingAuxTwoPass  { static constexpr bool multipass = false; static constexpr bool auxiliary = true;  static constexpr bool bounded = false; };
+struct PairingBoundedPass { static constexpr bool multipass = false; static constexpr bool auxiliary = true;  static constexpr bool bounded = true;  };
+
+/// @brief combine a sibling list of sub-heaps into one heap
+/// @param links link accessor
+/// @param h     head of sibling list
+/// @param roots receives the length of the sibling list
+/// @return      root of combined heap
+///
+/// Merge pairs of nodes from left to right, and then combine all these heaps into one from
+/// right to left.  The merged pairs go on an internal @e stack, so the reversal comes with no
+/// cost.  @c PairingMultiPass repeats the pairing step on the merged pairs instead, until one
+/// heap is left; the auxiliary variants combine children by two-pass.
+template<typename _Pass, typename _Links>
+constexpr typename _Links::link_type
+heap_pairing_pass(
+    const _Links                &links,
+    typename _Links::link_type   h,
+    std::size_t                 &roots)
+{
+    using link_type = typename _Links::link_type;
+    constexpr link_type nil{ _Links::nil };
+
+    link_type q{ nil }, a{ nil }, b{ nil };
+    // Combine pairs of sub-heaps. Might leave a single heap in original list, but that's ok
+    // as this is the target of the merges anyway.
+    roots = 0;
+    while (nil != (a = h) && nil != (b = links.next(a))) {
+        h = links.next(b);
+        links.prefetch(h);              // the next pair, while this one is merged
+        a = links.merge(a, b);
+        links.next(a, q);
+        q = a;
+        roots += 2;
+    }
+    roots += (nil != h);
+
+    if constexpr (_Pass::multipass) {
+        // put the odd one out back and go again, until a singleton list remains
+        for (;;) {
+            if (nil != h) {
+                links.next(h, q);
+            } else {
+                h = q;
+            }
+            if (nil == h || nil == links.next(h)) {
+                return h;
+            }
+            q = nil;
+            while (nil != (a = h) && nil != (b = links.next(a))) {
+                h = links.next(b);
+                a = links.merge(a, b);
+                links.next(a, q);
+                q = a;
+            }
+        }
+    }
+
+    // Merge all the heaps from step above into a single heap.
+    while (nil != (a = q)) {
+        q = links.next(q);
+        h = links.merge(a, h);
+    }
+    // And that's it. Really.
+    return h;
+}
+
+#endif // PAIRPASS_9687E0DD_D406_474B_9534_94B7C1D81D33
@@ -0,0 +1,74 @@
+// -------------------------------------------------------------------------------------------
+// Parallel bulk construction for the Leftist and Min-Dist Heaps
+// -------------------------------------------------------------------------------------------
+// This file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+// 'push(first, last, HeapParallel{ threads })' splits the input into one chunk per thread.
+// Every thread builds its chunk into a heap in O(N/P) with the usual constant auxiliary
+// space, and the calling thread melds the P results into the tree in O(P log N).
+//
+// Where the allocator permits it (i.e. not the thread-affine 'NodePoolAllocator') and the
+// input is random access, the nodes are created on the worker threads, too.
+//
+// The statistics policy of a heap is not thread-safe, so the workers run with the plain order
+// policy: a parallel build counts its pairing passes, but not its comparisons and links.
+//
+// This is a hand-rolled fan-out on purpose: the standard execution policies would drag a TBB
+// link dependency into every translation unit using the heaps.
+// -------------------------------------------------------------------------------------------
+#ifndef PARBUILD_9687E0DD_D406_474B_9534_94B7C1D81D33
+#define PARBUILD_9687E0DD_D406_474B_9534_94B7C1D81D33
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+/// @brief execution tag for the bulk inserters
+struct HeapParallel {
+    unsigned threads{ 0 };              // number of threads, 0: one per hardware thread
+
+    /// smallest chunk worth a thread of its own
+    static constexpr std::size_t grain{ 16384 };
+
+    /// @brief number of chunks to use for @c total items
+    unsigned chunks(std::size_t total) const {
+        unsigned want{ threads ? threads : std::max(1u, std::thread::hardware_concurrency()) };
+        return unsigned(std::max<std::size_t>(1, std::min<std::size_t>(want, total / grain)));
+    }
+};
+
+/// @brief run @c fn(0) .. @c fn(n-1) on @c n threads, @c fn(0) on the calling one
+///
+/// An exception thrown by any of the calls is rethrown once all threads are joined.
+template<typename _Fn>
+void
+heap_parallel_for(unsigned n, _Fn &&fn)
+{
+    std::vector<std::exception_ptr> error(n);
+    std::vector<std::thread>        pool;
+    pool.reserve(n ? n - 1 : 0);
+    for (unsigned idx{ 1 }; idx < n; ++idx) {
+        pool.emplace_back([&fn, &error, idx]() {
+            try { fn(idx); } catch (...) { error[idx] = std::current_exception(); }
+        });
+    }
+    if (0 != n) {
+        try { fn(0u); } catch (...) { error[0] = std::current_exception(); }
+    }
+    for (auto &th : pool) {
+        th.join();
+    }
+    for (auto &ep : error) {
+        if (ep) {
+            std::rethrow_exception(ep);
+        }
+    }
+}
+
+#endif // PARBUILD_9687E0DD_D406_474B_9534_94B7C1D81D33
@@ -14,7 +14,17 @@
 #define PHQUEUE2_9687E0DD_D406_474B_9534_94B7C1D81D33
 
 #include <functional>
+#include <memory>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "heapstats.hpp"
+#include "keyof.hpp"
+#include "listsort.hpp"
+#include "nodepool.hpp"
+#include "pairpass.hpp"
+#include "prefetch.hpp"
 
 class PairingHeapEasyT {
 public:
@@ -25,24 +35,336 @@ public:
 
     virtual bool  _pred(const PairingNodeT &n1, const PairingNodeT &n2) const = 0;
 
-    void          _push(PairingNodeT *node);
+    // order policy for the core algorithms calling back through the virtual '_pred()'
+    struct VirtualOrderT {
+        const PairingHeapEasyT *_m_heap;
+        bool operator()(const PairingNodeT &n1, const PairingNodeT &n2) const { return _m_heap->_pred(n1, n2); }
+    };
+
+    // '_Pass' selects the pairing strategy (see pairpass.hpp)
+    template<typename _Pass = PairingTwoPass, typename _Ord> void          _push(const _Ord &ord, PairingNodeT *node);
+    template<typename _Pass = PairingTwoPass, typename _Ord> void          _push_list(const _Ord &ord, PairingNodeT *list);
+    template<typename _Pass = PairingTwoPass, typename _Ord> PairingNodeT *_pop(const _Ord &ord);
+    template<typename _Pass = PairingTwoPass, typename _Ord> void          _replace(const _Ord &ord);   // the root's key changed
+    template<typename _Ord>                                  PairingNodeT *_merge(const _Ord &ord, PairingNodeT *h1, PairingNodeT *h2) const;
+    template<typename _Pass = PairingTwoPass, typename _Ord> PairingNodeT *_build(const _Ord &ord, PairingNodeT *h) const;
+    template<typename _Pass = PairingTwoPass, typename _Ord> void          _meld(const _Ord &ord, PairingHeapEasyT &rhs);
+    template<typename _Ord>                                  void          _consolidate(const _Ord &ord);
+    template<typename _Ord>                                  PairingNodeT *_drain(const _Ord &ord);   // yield all nodes, sorted
 
-    PairingNodeT *_pop();
-    PairingNodeT *_merge(PairingNodeT *h1, PairingNodeT *h2) const;
-    PairingNodeT *_build(PairingNodeT *h) const;
+    PairingNodeT        *_yield();
+    void                 _take(PairingHeapEasyT &rhs);
 
     static PairingNodeT* _cons(PairingNodeT* a, PairingNodeT* b);
     static PairingNodeT* _dunk(PairingNodeT* a, PairingNodeT* b);
     static PairingNodeT *_shred_pop(PairingNodeT * &pref);
 
     void   validate_tree(size_t nodes) const;
+    void   validate_tree() const { validate_tree(_m_size); }
+    HeapShape shape_stats() const;
+
+    // pointer links for the shared pairing pass (see pairpass.hpp)
+    template<typename _Ord>
+    struct _Links {
+        using link_type = PairingNodeT*;
+        static constexpr PairingNodeT *nil{ nullptr };
+        const PairingHeapEasyT *_m_heap;
+        const _Ord             *_m_ord;
+
+        PairingNodeT *next(PairingNodeT *n) const                  { return n->_m_next; }
+        void          next(PairingNodeT *n, PairingNodeT *s) const { n->_m_next = s; }
+        PairingNodeT *merge(PairingNodeT *a, PairingNodeT *b) const { return _m_heap->_merge(*_m_ord, a, b); }
+        void          prefetch(PairingNodeT *n) const              { heap_prefetch(n); }
+    };
 
     PairingNodeT *_m_root { nullptr };
+    std::size_t   _m_size { 0 };        // number of nodes in the tree
+    PairingNodeT *_m_amin { nullptr };  // auxiliary twopass: least root list member
 };
 
+// two simple helpers to attach nodes in horizontal or vertical order:
+
+inline PairingHeapEasyT::PairingNodeT*
+PairingHeapEasyT::_cons(PairingNodeT* a, PairingNodeT* b)
+{
+  return a ? ((a->_m_next = b), a) : b;
+}
+
+inline PairingHeapEasyT::PairingNodeT*
+PairingHeapEasyT::_dunk(PairingNodeT* a, PairingNodeT* b)
+{
+  return a ? ((a->_m_down = b), a) : b;
+}
+
+/// @brief cut the whole tree from the heap
+/// @return the former root
+inline PairingHeapEasyT::PairingNodeT*
+PairingHeapEasyT::_yield()
+{
+    PairingNodeT *hold{ nullptr };
+    std::swap(hold, _m_root);
+    _m_size = 0;
+    _m_amin = nullptr;
+    return hold;
+}
+
+/// @brief move the tree of another heap into this (empty) heap
+/// @param rhs  heap to take the nodes from; empty afterwards
+inline void
+PairingHeapEasyT::_take(
+    PairingHeapEasyT &rhs)
+{
+    std::size_t   size{ rhs._m_size };
+    PairingNodeT *amin{ rhs._m_amin };
+    _m_root = rhs._yield();
+    _m_size = size;
+    _m_amin = amin;
+}
+
+// The core algorithms are templates on the order policy; the virtual predicate flavour is
+// instantiated once in the library.
+
+/// @brief merge two heaps. O(1) actual -- the magic of Pairing Heaps!
+/// @param ord  order policy
+/// @param h1   1st heap
+/// @param h2   2nd heap
+/// @return     root of combined heap
+template<typename _Ord>
+PairingHeapEasyT::PairingNodeT*
+PairingHeapEasyT::_merge(
+    const _Ord   &ord,
+    PairingNodeT *h1,
+    PairingNodeT *h2) const
+{
+    PairingNodeT * retv;
+
+    // merging a NULL heap with another heap obviously yields the other heap. With both heaps
+    // present, we have have to decide which one becomes a child of the other heap. h1 gets
+    // precedence unless that would violate the order constraint.
+    if (nullptr == h1) {
+        retv = h2;
+    } else if (nullptr == h2) {
+        retv = h1;
+    } else {
+        // select instead of branching: with an inlined order this is a pair of cmovs
+        const bool flip{ ord(*h2, *h1) };
+        PairingNodeT * const kid{ flip ? h1 : h2 };
+        retv = flip ? h2 : h1;
+        retv = _dunk(retv, _cons(kid, retv->_m_down));
+        heap_stats_link(ord);
+    }
+    if (nullptr != retv) {
+        retv->_m_next = nullptr;
+    }
+    return retv;
+}
+
+/// @brief build a heap from a sibling list of sub-heaps
+/// @param ord  order policy
+/// @param h    head if sibling list
+/// @return     root of combined heap
+///
+/// This is the core function of the Pairing Heap algorithm; the passes themselves are
+/// @c heap_pairing_pass() in pairpass.hpp, shared with @c CompactPairingHeapT.
+template<typename _Pass, typename _Ord>
+PairingHeapEasyT::PairingNodeT*
+PairingHeapEasyT::_build(
+    const _Ord   &ord,
+    PairingNodeT *h) const
+{
+    [[maybe_unused]] const auto timer{ heap_stats_timer(ord, HeapPhase::build) };
+    std::size_t   roots{ 0 };
+    PairingNodeT *retv{ heap_pairing_pass<_Pass>(_Links<_Ord>{ this, &ord }, h, roots) };
+    heap_stats_build(ord, roots);
+    return retv;
+}
+
+/// @brief combine the root list with multipass, below its least member
+/// @param ord  order policy
+///
+/// The least member is taken out of the list and merged first, so it wins all ties: the
+/// node @c front() showed is the one @c pop() removes.
+template<typename _Ord>
+void
+PairingHeapEasyT::_consolidate(
+    const _Ord &ord)
+{
+    if (nullptr != _m_root && nullptr != _m_root->_m_next) {
+        PairingNodeT *least{ _m_amin }, **link{ &_m_root };
+        while (nullptr != *link && least != *link) {
+            link = &(*link)->_m_next;
+        }
+        if (nullptr == *link) {
+            least = _m_root;        // not on the list: the root is as good as any
+            link  = &_m_root;
+        }
+        *link = least->_m_next;
+        least->_m_next = nullptr;
+        _m_root = _merge(ord, least, _build<PairingMultiPass>(ord, _m_root));
+    }
+    _m_amin = _m_root;
+}
+
+/// @brief push a node into the heap
+/// @param ord  order policy
+/// @param node node to insert
+///
+/// With @c PairingAuxTwoPass the node goes to the list of pending trees behind the root,
+/// costing a comparison against the least member so far, but no link.
+template<typename _Pass, typename _Ord>
+void
+PairingHeapEasyT::_push(
+    const _Ord   &ord,
+    PairingNodeT *node)
+{
+    if constexpr (_Pass::auxiliary) {
+        if (nullptr == _m_amin) {
+            _m_root = _m_amin = node;
+        } else {
+            node->_m_next = _m_root->_m_next;
+            _m_root->_m_next = node;
+            if (ord(*node, *_m_amin)) {
+                _m_amin = node;
+            }
+        }
+    } else {
+        _m_root = _merge(ord, _m_root, node);
+    }
+    ++_m_size;
+}
+
+/// @brief push a list of nodes into the heap
+/// @param ord  order policy
+/// @param list nodes to insert, chained via @c _m_next (their @c _m_down must be clear)
+///
+/// One pairing pass builds the list into a tree, which is then merged with the root: O(k)
+/// for k nodes.  With @c PairingAuxTwoPass the nodes join the pending trees instead.
+template<typename _Pass, typename _Ord>
+void
+PairingHeapEasyT::_push_list(
+    const _Ord   &ord,
+    PairingNodeT *list)
+{
+    if constexpr (_Pass::auxiliary) {
+        while (nullptr != list) {
+            PairingNodeT *node{ list };
+            list = list->_m_next;
+            node->_m_next = nullptr;
+            _push<_Pass>(ord, node);
+        }
+    } else {
+        for (PairingNodeT *scan{ list }; nullptr != scan; scan = scan->_m_next) {
+            ++_m_size;
+        }
+        _m_root = _merge(ord, _m_root, _build<_Pass>(ord, list));
+    }
+}
+
+/// @brief pop the tip/root node from the heap and build a new heap from its children
+/// @param ord  order policy
+/// @return pointer to former root or @c nullptr if empty
+template<typename _Pass, typename _Ord>
+PairingHeapEasyT::PairingNodeT*
+PairingHeapEasyT::_pop(
+    const _Ord &ord)
+{
+    if constexpr (_Pass::auxiliary) {
+        _consolidate(ord);
+    }
+    PairingNodeT *retv { _m_root };
+    if (nullptr != retv) {
+        _m_root = _build<_Pass>(ord, retv->_m_down);
+        retv->_m_down = retv->_m_next = nullptr;
+        --_m_size;
+        heap_stats_pop(ord);
+    }
+    if constexpr (_Pass::auxiliary) {
+        _m_amin = _m_root;
+    }
+    return retv;
+}
+
+/// @brief restore the heap after the key of the root node changed (in any direction)
+/// @param ord  order policy
+///
+/// This is 'pop()' and 'push()' of the root node in one go: the children are combined by the
+/// pairing pass and merged with the root once, and no node leaves the heap.  With
+/// @c PairingAuxTwoPass the root list is consolidated first, so the root is the least node.
+template<typename _Pass, typename _Ord>
+void
+PairingHeapEasyT::_replace(
+    const _Ord &ord)
+{
+    if constexpr (_Pass::auxiliary) {
+        _consolidate(ord);
+    }
+    PairingNodeT *root{ _m_root };
+    if (nullptr != root) {
+        PairingNodeT *kids{ root->_m_down };
+        root->_m_down = nullptr;
+        _m_root = _merge(ord, _build<_Pass>(ord, kids), root);
+    }
+    if constexpr (_Pass::auxiliary) {
+        _m_amin = _m_root;
+    }
+}
+
+/// @brief merge another heap into this one
+/// @param ord  order policy
+/// @param rhs  heap to absorb; empty afterwards
+template<typename _Pass, typename _Ord>
+void
+PairingHeapEasyT::_meld(
+    const _Ord       &ord,
+    PairingHeapEasyT &rhs)
+{
+    if (this != &rhs) {
+        if constexpr (_Pass::auxiliary) {
+            _consolidate(ord);
+            rhs._consolidate(ord);
+        }
+        std::size_t size{ _m_size + rhs._m_size };
+        _m_root = _merge(ord, _yield(), rhs._yield());
+        _m_size = size;
+        if constexpr (_Pass::auxiliary) {
+            _m_amin = _m_root;
+        }
+    }
+}
+
+/// @brief cut all nodes from the heap, in order
+/// @param ord  order policy
+/// @return     the nodes as a sorted list chained via @c _m_next
+template<typename _Ord>
+PairingHeapEasyT::PairingNodeT*
+PairingHeapEasyT::_drain(
+    const _Ord &ord)
+{
+    PairingNodeT *tree{ _yield() }, *list{ nullptr }, *node;
+    while (nullptr != (node = _shred_pop(tree))) {
+        list = _cons(node, list);
+    }
+    return heap_sort_list<PairingNodeT, &PairingNodeT::_m_next>(ord, list);
+}
+
+extern template void                            PairingHeapEasyT::_push (const VirtualOrderT&, PairingNodeT*);
+extern template void                            PairingHeapEasyT::_push_list(const VirtualOrderT&, PairingNodeT*);
+extern template PairingHeapEasyT::PairingNodeT* PairingHeapEasyT::_pop  (const VirtualOrderT&);
+extern template void                            PairingHeapEasyT::_replace(const VirtualOrderT&);
+extern template PairingHeapEasyT::PairingNodeT* PairingHeapEasyT::_merge(const VirtualOrderT&, PairingNodeT*, PairingNodeT*) const;
+extern template PairingHeapEasyT::PairingNodeT* PairingHeapEasyT::_build(const VirtualOrderT&, PairingNodeT*) const;
+extern template void                            PairingHeapEasyT::_meld (const VirtualOrderT&, PairingHeapEasyT&);
+extern template PairingHeapEasyT::PairingNodeT* PairingHeapEasyT::_drain(const VirtualOrderT&);
+
+// @c _Pass selects the pairing strategy (see pairpass.hpp), @c _KeyOf caches the compare key
+// in the node header (see keyof.hpp); @c _Comp orders keys then.
 template<typename _Type,
          typename _Comp = std::less<_Type>,
-         typename Alloc = std::allocator<_Type> >
+         typename Alloc = std::allocator<_Type>,
+         bool     _Inline = false,
+         typename _Stats = NoHeapStats,
+         typename _Pass = PairingTwoPass,
+         typename _KeyOf = IdentityKey >
 class PairingHeapEasy : protected PairingHeapEasyT
 {
     // --- allocator guard ---
@@ -53,12 +375,18 @@ class PairingHeapEasy : protected PairingHeapEasyT
     static_assert(std::is_empty<_Comp>::value,
         "LeftistHeap merge, move, or assignment require a stateless comparator");
 
+    // --- pairing guard ---
+    static_assert(!_Pass::bounded,
+        "PairingHeapEasy has no bounded pairing, it needs the parent links of PairingHeap");
+
 protected:
-    struct _XNode : public PairingNodeT {
+    struct _XNode : public PairingNodeT, public HeapKeyT<_Type, _KeyOf> {
         _Type _m_value;
 
-        _XNode(const _Type &  rhs) : _m_value{ rhs            } { /*NOP*/ }
-        _XNode(      _Type && rhs) : _m_value{ std::move(rhs) } { /*NOP*/ }
+        _XNode(const _Type &  rhs) : _m_value{ rhs            } { this->_load(_m_value); }
+        _XNode(      _Type && rhs) : _m_value{ std::move(rhs) } { this->_load(_m_value); }
+
+        const auto &_cmp_key() const { return this->_key(_m_value); }
     };
 
     using value_allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<_Type>;
@@ -85,10 +413,24 @@ protected:
       }
     }
 
+    struct _XOrder {
+        bool operator()(const PairingNodeT &n1, const PairingNodeT &n2) const {
+            const auto & rn1{ static_cast<const _XNode&>(n1)._cmp_key() };
+            const auto & rn2{ static_cast<const _XNode&>(n2)._cmp_key() };
+            return _Comp()(rn1, rn2);
+        }
+    };
+
     bool _pred(const PairingNodeT &n1, const PairingNodeT &n2) const override {
-        const _Type & rn1{ static_cast<const _XNode&>(n1)._m_value };
-        const _Type & rn2{ static_cast<const _XNode&>(n2)._m_value };
-        return _Comp()(rn1, rn2);
+        return _XOrder()(n1, n2);
+    }
+
+    auto _order() const {
+        if constexpr (_Inline) {
+            return heap_stats_order<_Stats>(_XOrder(), _m_stats);
+        } else {
+            return heap_stats_order<_Stats>(VirtualOrderT{ this }, _m_stats);
+        }
     }
 
     void _clear(PairingNodeT *root) {
@@ -98,14 +440,17 @@ protected:
     }
 
     node_allocator_type _m_alloc;
+    mutable _Stats      _m_stats;
 
   public:
 
+    using allocator_type = Alloc;
+
     PairingHeapEasy()
     { /*NOP*/ }
 
-    PairingHeapEasy(PairingHeapEasy&& rhs) {
-        std::swap(_m_root, rhs._m_root);
+    PairingHeapEasy(PairingHeapEasy&& rhs) : _m_stats{ std::move(rhs._m_stats) } {
+        _take(rhs);
     }
     PairingHeapEasy(const PairingHeapEasy & rhs) = delete;
 
@@ -114,51 +459,158 @@ protected:
     }
 
     PairingHeapEasy& operator=(PairingHeapEasy&& rhs) {
-        PairingNodeT *hold { _m_root };
-        _m_root = rhs._m_root;
-        rhs._m_root = nullptr;
-        _clear(hold);
+        if (this != &rhs) {
+            _clear(_yield());
+            _take(rhs);
+            _m_stats = std::move(rhs._m_stats);
+        }
         return *this;
     }
     PairingHeapEasy& operator=(const PairingHeapEasy &) = delete;
 
     PairingHeapEasy& merge(PairingHeapEasy& rhs) {
-        PairingNodeT *hold{ nullptr };
-        std::swap(hold, rhs._m_root);
-        _m_root = _merge(_m_root, hold);
+        _meld<_Pass>(_order(), rhs);
         return *this;
     }
 
     void clear() {
-        PairingNodeT *hold{ nullptr };
-        std::swap(hold, _m_root);
-        _clear(hold);
+        // with nothing to destroy, a pool that holds no other nodes takes these back at once
+        const std::size_t size{ _m_size };
+        PairingNodeT * const root{ _yield() };
+        if constexpr (std::is_trivially_destructible<_XNode>::value) {
+            if (node_pool_traits<node_allocator_type>::recycle(_m_alloc, size)) {
+                return;
+            }
+        }
+        _clear(root);
+    }
+
+    /// @brief pre-populate the node allocator, if it supports that ( @c NodePoolAllocator does)
+    /// @param n    number of nodes that can be pushed afterwards without allocating memory
+    void reserve(std::size_t n) {
+        node_pool_traits<node_allocator_type>::reserve(_m_alloc, n);
     }
 
-    void push(const _Type &  rhs) {  _push(_create_node(rhs           )); }
-    void push(      _Type && rhs) {  _push(_create_node(std::move(rhs))); }
+    void push(const _Type &  rhs) {  _push<_Pass>(_order(), _create_node(rhs           )); }
+    void push(      _Type && rhs) {  _push<_Pass>(_order(), _create_node(std::move(rhs))); }
 
     _Type &front() const
     {
         if (nullptr == _m_root) {
             throw std::invalid_argument("empty");
         }
-        return static_cast<_XNode*>(_m_root)->_m_value;
+        return static_cast<_XNode*>(_Pass::auxiliary ? _m_amin : _m_root)->_m_value;
     }
 
     void pop()
     {
-        PairingNodeT *ptr { _pop() };
+        PairingNodeT *ptr { _pop<_Pass>(_order()) };
         if (nullptr != ptr) {
             _destroy_node(ptr);
         }
     }
 
+    /// @brief move the @c k least values out, in order
+    /// @param k    number of values to pop; all of them if @c k >= @c size()
+    /// @param out  output iterator receiving the values
+    /// @return     @c out past the last value written
+    ///
+    /// Below @c size() this pops node by node, each pop with its own pairing pass: every pass
+    /// leaves the children better ordered for the next pop, so deferring them all to one pass
+    /// at the end costs a scan of the pending trees per pop, and measured slower.
+    template<typename _OutIt>
+    _OutIt pop_n(std::size_t k, _OutIt out) {
+        if (k >= _m_size) {
+            return drain(out);
+        }
+        for (; k > 0; --k) {
+            _XNode *node{ static_cast<_XNode*>(_pop<_Pass>(_order())) };
+            try {
+                *out = std::move(node->_m_value);
+                ++out;
+            } catch (...) {
+                _destroy_node(node);
+                throw;
+            }
+            _destroy_node(node);
+        }
+        return out;
+    }
+
+    /// @brief move all values out, in order, leaving the heap empty
+    /// @param out  output iterator receiving the values
+    /// @return     @c out past the last value written
+    ///
+    /// This does not pop node by node, but sorts the nodes of the whole tree at once (see
+    /// listsort.hpp).  If writing a value throws, the values not yet written stay in the heap.
+    template<typename _OutIt>
+    _OutIt drain(_OutIt out) {
+        PairingNodeT *list{ _drain(_order()) };
+        try {
+            while (nullptr != list) {
+                *out = std::move(static_cast<_XNode*>(list)->_m_value);
+                ++out;
+                PairingNodeT *node{ list };
+                list = list->_m_next;
+                _destroy_node(node);
+            }
+        } catch (...) {
+            this->template _push_list<_Pass>(_order(), list);
+            throw;
+        }
+        return out;
+    }
+
+
+    /// @brief pop the least value and push @c value, reusing the node
+    /// @param value    value to insert
+    /// @return         the former least value
+    ///
+    /// One pairing pass and one merge, and no allocation.  Throws @c std::invalid_argument
+    /// on an empty heap, like @c front().
+    _Type replace_top(_Type value) {
+        if (nullptr == _m_root) {
+            throw std::invalid_argument("empty");
+        }
+        if constexpr (_Pass::auxiliary) {
+            _consolidate(_order());         // bring the least node to the root
+        }
+        _XNode *node{ static_cast<_XNode*>(_m_root) };
+        std::swap(node->_m_value, value);
+        node->_load(node->_m_value);
+        _replace<_Pass>(_order());
+        return value;
+    }
+
+    /// @brief push @c value and pop the least value, reusing the node
+    /// @param value    value to insert
+    /// @return         the least value of the heap with @c value added
+    ///
+    /// If @c value is not greater than the least value in the heap, it is returned right away
+    /// and the heap is not touched at all.
+    _Type push_pop(_Type value) {
+        const PairingNodeT *least{ _Pass::auxiliary ? _m_amin : _m_root };
+        if (nullptr == least ||
+            !_Comp()(static_cast<const _XNode*>(least)->_cmp_key(), _XNode::_extract(value))) {
+            return value;
+        }
+        return replace_top(std::move(value));
+    }
+
     bool empty() const {
         return nullptr == _m_root;
     }
 
+    std::size_t size() const {
+        return _m_size;
+    }
+
+    /// @brief operation counters of the statistics policy
+    const _Stats &stats() const { return _m_stats; }
+    void reset_stats() { _m_stats = _Stats(); }
+
     using PairingHeapEasyT::validate_tree;
+    using PairingHeapEasyT::shape_stats;
 };
 
 #endif // PHQUEUE2_9687E0DD_D406_474B_9534_94B7C1D81D33
@@ -12,8 +12,18 @@
 #ifndef PHQUEUE3_9687E0DD_D406_474B_9534_94B7C1D81D33
 #define PHQUEUE3_9687E0DD_D406_474B_9534_94B7C1D81D33
 
+#include <cassert>
+#include <cstdint>
 #include <stdexcept>
 #include <functional>
+#include <type_traits>
+
+#include "heapstats.hpp"
+#include "keyof.hpp"
+#include "listsort.hpp"
+#include "nodepool.hpp"
+#include "pairpass.hpp"
+#include "prefetch.hpp"
 
 // -------------------------------------------------------------------------------------------
 // definition of the core functions of a PairingHeap, meant for use in derived classes
@@ -33,16 +43,49 @@ public:
     // in template specializations built upon this base class
     virtual bool  _pred(const BaseNodeT &n1, const BaseNodeT &n2) const = 0;
 
-    BaseNodeT* _push(BaseNodeT* node);
-    BaseNodeT* _pop();
-    BaseNodeT* _merge(BaseNodeT *h1, BaseNodeT *h2) const; // merge (absorb) h2 into h1
-    BaseNodeT* _build(BaseNodeT *h) const;                 // pairing phase -- make heap from list
-    BaseNodeT* _ncut(BaseNodeT* h);                        // cut the node 'h' from heap
-    BaseNodeT* _tcut(BaseNodeT* h);                        // cut branch (subtree) rooted at h from heap
+    // The core algorithms are templates on an order policy, so derived classes may choose
+    // between the virtual call through '_pred()' (the default, instantiated once in the
+    // library) and a stateless policy that lets the compiler inline the comparison.
+    struct VirtualOrderT {
+        const PairingHeapT *_m_heap;
+        bool operator()(const BaseNodeT &n1, const BaseNodeT &n2) const { return _m_heap->_pred(n1, n2); }
+    };
+
+    // The pairing strategy '_Pass' (see pairpass.hpp) is a second policy; it comes first, so
+    // the order policy can still be deduced.
+    template<typename _Pass = PairingTwoPass, typename _Ord> BaseNodeT* _push(const _Ord &ord, BaseNodeT* node);
+    template<typename _Pass = PairingTwoPass, typename _Ord> BaseNodeT* _pop(const _Ord &ord);
+    template<typename _Ord> BaseNodeT* _merge(const _Ord &ord, BaseNodeT *h1, BaseNodeT *h2) const; // merge (absorb) h2 into h1
+    template<typename _Pass = PairingTwoPass, typename _Ord> BaseNodeT* _build(const _Ord &ord, BaseNodeT *h) const; // pairing phase -- make heap from list
+    template<typename _Pass = PairingTwoPass, typename _Ord> BaseNodeT* _ncut(const _Ord &ord, BaseNodeT* h);        // cut the node 'h' from heap
+    template<typename _Pass = PairingTwoPass, typename _Ord> BaseNodeT* _decrease(const _Ord &ord, BaseNodeT* h);    // re-insert for strictly decreasing key of 'h'
+    template<typename _Pass = PairingTwoPass, typename _Ord> BaseNodeT* _reinsert(const _Ord &ord, BaseNodeT* h);    // adjust for arbitrary key change of 'h'
+    template<typename _Pass = PairingTwoPass, typename _Ord> void       _meld(const _Ord &ord, PairingHeapT &rhs);   // absorb all nodes of 'rhs'
+    template<typename _Ord> BaseNodeT* _drain(const _Ord &ord);                                     // yield all nodes, sorted
+    template<typename _Pass = PairingTwoPass, typename _Ord> BaseNodeT* _split(const _Ord &ord, std::size_t want, std::size_t &count); // cut subtrees below the root
+    template<typename _Pass = PairingTwoPass, typename _Ord> void       _adopt(const _Ord &ord, BaseNodeT *list, std::size_t count);  // fill an empty heap with a tree list
+
+    // auxiliary twopass only: the root list is the root and the pending trees behind it
+    template<typename _Ord> void       _consolidate(const _Ord &ord);                               // combine the root list into one tree
+    template<typename _Ord> BaseNodeT* _rootmin(const _Ord &ord) const;                             // scan the root list for the minimum
+    void       _rlink(BaseNodeT* h);                       // append the tree 'h' to the root list
 
+    // bounded pairing only: the root list holds at most one tree per rank, ascending
+    static constexpr unsigned _Ranks{ 64 };                // rank slots, the last one takes all above
+    static unsigned    _lowest(std::uint64_t x);           // index of the lowest set bit, x != 0
+    static unsigned    _degree(const BaseNodeT* h);        // number of children, capped to the last rank
+    bool               _inroots(const BaseNodeT* h) const; // is 'h' a member of the root list?
+    template<typename _Ord> void _rcarry(const _Ord &ord, BaseNodeT *h, unsigned rank);               // add tree 'h' of 'rank'
+    template<typename _Ord> void _rfold(const _Ord &ord, BaseNodeT *drop);                           // rebuild without 'drop'
+    template<typename _Ord> std::uint64_t _rslot(const _Ord &ord, BaseNodeT **slot, std::uint64_t mask, BaseNodeT *h, unsigned rank) const;
+
+    void        _check_roots() const;                      // validation: root node and root list
+    std::size_t _check_walk(const BaseNodeT* top, const BaseNodeT* parent, std::size_t budget) const;
+
+    BaseNodeT* _tcut(BaseNodeT* h);                        // cut branch (subtree) rooted at h from heap
+    static std::size_t _tsize(const BaseNodeT* h);         // number of nodes in the subtree rooted at h
     BaseNodeT* _yield();                                   // cut the whole tree from the sentinel
-    BaseNodeT* _decrease(BaseNodeT* h);                    // re-insert for strictly decreasing key of 'h'
-    BaseNodeT* _reinsert(BaseNodeT* h);                    // adjust for arbitrary key change of 'h'
+    void       _take(PairingHeapT &rhs);                   // move the tree of 'rhs' to an empty heap
 
     static BaseNodeT* _cons(BaseNodeT* a, BaseNodeT* b);   // connect b as successor ('next') of a
     static BaseNodeT* _dunk(BaseNodeT* a, BaseNodeT* b);   // connect b as child ('down') of a
@@ -58,23 +101,735 @@ public:
 
     static bool _iter_same(const BaseNodeT* p1, const BaseNodeT* np2);
 
-    void validate_tree() const;
+    void        validate_tree() const;
+    void        validate_stream() const;                   // full check, O(1) extra memory
+    std::size_t validate_sample(std::size_t subtrees, std::size_t budget, std::uint64_t seed) const;
+    HeapShape   shape_stats() const;
 
-    BaseNodeT  _m_root { nullptr };                        // the root holder & end sentinel
+    BaseNodeT   _m_root { nullptr };                       // the root holder & end sentinel
+    std::size_t _m_size { 0 };                             // number of nodes in the tree
+    BaseNodeT  *_m_amin { nullptr };                       // auxiliary twopass: least root list member
+    std::uint64_t _m_rank { 0 };                           // bounded pairing: ranks of the root list members
 };
 
+// -------------------------------------------------------------------------------------------
+// connecting nodes / primitives on node level
+
+/// @brief make b the immediate successor of a
+/// @param a    left sibling node
+/// @param b    right sibling node
+/// @return     a if not @c NULL, else b
+inline PairingHeapT::BaseNodeT*
+PairingHeapT::_cons(
+    BaseNodeT* a,
+    BaseNodeT* b)
+{
+    if (a) a->_m_next = b;
+    if (b) b->_m_prev = a;
+    return a ? a : b;
+}
+
+/// @brief make b the immediate child of a
+/// @param a    parent node
+/// @param b    child node
+/// @return     a if not @c NULL, else b
+inline PairingHeapT::BaseNodeT*
+PairingHeapT::_dunk(
+    BaseNodeT* a,
+    BaseNodeT* b)
+{
+    if (a) a->_m_down = b;
+    if (b) b->_m_prev = a;
+    return a ? a : b;
+}
+
+// -------------------------------------------------------------------------------------------
+// core functions -- this makes a binary tree a Pairing Heap
+//
+// These are templates on the order policy '_Ord'.  The instantiations for the virtual
+// predicate are compiled once into the library (see the 'extern template' list below), so
+// only heaps that opt into an inlined order pay for another copy of the algorithms.
+
+/// @brief merge two heaps given by the root nodes
+/// @param ord  order policy
+/// @param h1   1st heap / left side
+/// @param h2   2nd heap / right side
+/// @return root of merged heap
+template<typename _Ord>
+PairingHeapT::BaseNodeT*
+PairingHeapT::_merge(
+    const _Ord &ord,
+    BaseNodeT  *h1,
+    BaseNodeT  *h2) const
+{
+    BaseNodeT * retv;
+
+    if (nullptr == h1) {
+        retv = h2;
+    } else if (nullptr == h2) {
+        retv = h1;
+    } else {
+        // select instead of branching: with an inlined order this is a pair of cmovs
+        const bool flip{ ord(*h2, *h1) };
+        BaseNodeT * const kid{ flip ? h1 : h2 };
+        retv = flip ? h2 : h1;
+        retv = _dunk(retv, _cons(kid, retv->_m_down));
+        heap_stats_link(ord);
+    }
+    if (nullptr != retv) {
+        retv->_m_prev = retv->_m_next = nullptr;
+    }
+    return retv;
+}
+
+/// @brief build a heap from a sibling list
+/// @param ord  order policy
+/// @param node start of list
+/// @return     root of created heap
+///
+/// This is the "magic" function of the Pairing Heap.  As we have the sibling list as, well,
+/// a list, merging pairs of nodes, storing them in a list, and finally merging all these little
+/// heaps into one is a moderate effort in pointer swivelling.
+///
+/// With @c PairingMultiPass, the pairing step is simply repeated on the list of merged pairs
+/// until a single tree remains.  (Every pass reverses the list, which does no harm.)
+template<typename _Pass, typename _Ord>
+PairingHeapT::BaseNodeT*
+PairingHeapT::_build(
+    const _Ord &ord,
+    BaseNodeT  *node) const
+{
+    [[maybe_unused]] const auto timer{ heap_stats_timer(ord, HeapPhase::build) };
+    BaseNodeT  *q{ nullptr }, *a, *b;
+    std::size_t roots{ 0 };
+    while ((a = node) && (b = a->_m_next)) {
+        node = b->_m_next;
+        heap_prefetch(node);            // the next pair, while this one is merged
+        q = _cons(_merge(ord, a, b), q);
+        roots += 2;
+    }
+    heap_stats_build(ord, roots + (nullptr != node));
+
+    if constexpr (_Pass::multipass) {
+        // put the odd one out back and go again; the result of the last pass is a singleton
+        while ((node = _cons(node, q)) && node->_m_next) {
+            q = nullptr;
+            while ((a = node) && (b = a->_m_next)) {
+                node = b->_m_next;
+                q = _cons(_merge(ord, a, b), q);
+            }
+        }
+        if (node) {
+            node->_m_prev = nullptr;
+        }
+        return node;
+    }
+
+    // since we did some sloppy chopping, we have to make sure that 'node' does not keep
+    // a dangling pointer to the left/parent side. (This happens if node was a singleton!)
+    if ((a = q)) {
+        do {
+            q = a->_m_next;
+            node = _merge(ord, a, node);
+        } while ((a = q));
+    } else if (node) {
+        node->_m_prev = nullptr;
+    }
+
+    return node;
+}
+
+/// @brief append a tree to the root list (auxiliary twopass)
+/// @param node root of a cleanly cut tree; the heap must not be empty
+inline void
+PairingHeapT::_rlink(
+    BaseNodeT *node)
+{
+    BaseNodeT * const root{ _m_root._m_down };
+    _cons(root, _cons(node, root->_m_next));
+}
+
+/// @brief find the least member of the root list (auxiliary twopass)
+/// @param ord  order policy
+/// @return     the least tree root or @c NULL on empty heap
+template<typename _Ord>
+PairingHeapT::BaseNodeT*
+PairingHeapT::_rootmin(
+    const _Ord &ord) const
+{
+    BaseNodeT *best{ _m_root._m_down };
+    for (BaseNodeT *scan{ best }; scan && (scan = scan->_m_next); /*NOP*/) {
+        if (ord(*scan, *best)) {
+            best = scan;
+        }
+    }
+    return best;
+}
+
+/// @brief combine the root list with multipass, below its least member
+/// @param ord  order policy
+///
+/// The least member is taken out of the list and merged first, so it wins all ties: the
+/// node @c front() showed is the one @c pop() removes.
+template<typename _Ord>
+void
+PairingHeapT::_consolidate(
+    const _Ord &ord)
+{
+    BaseNodeT * const root{ _m_root._m_down };
+    if (nullptr != root && nullptr != root->_m_next) {
+        BaseNodeT *least{ (nullptr != _m_amin) ? _m_amin : root }, *rest{ root };
+        if (least == root) {
+            rest = root->_m_next;
+        } else {
+            // not the head of the list: its predecessor is its left sibling
+            least->_m_prev->_m_next = least->_m_next;
+            if (nullptr != least->_m_next) {
+                least->_m_next->_m_prev = least->_m_prev;
+            }
+        }
+        least->_m_next = nullptr;
+        _dunk(&_m_root, _merge(ord, least, _build<PairingMultiPass>(ord, rest)));
+    }
+    _m_amin = _m_root._m_down;
+}
+
+/// @brief index of the lowest set bit (bounded pairing)
+/// @param x    bit set, not 0
+inline unsigned
+PairingHeapT::_lowest(
+    std::uint64_t x)
+{
+    assert(0 != x);
+#if defined(__GNUC__) || defined(__clang__)
+    return unsigned(__builtin_ctzll(x));
+#else
+    unsigned idx{ 0 };
+    for (; !(x & 1); x >>= 1) {
+        ++idx;
+    }
+    return idx;
+#endif
+}
+
+/// @brief count the children of a node (bounded pairing)
+/// @param node tree root
+/// @return     the number of children, but at most the last rank
+inline unsigned
+PairingHeapT::_degree(
+    const BaseNodeT *node)
+{
+    unsigned deg{ 0 };
+    for (node = node->_m_down; nullptr != node && deg < _Ranks - 1; node = node->_m_next) {
+        ++deg;
+    }
+    return deg;
+}
+
+/// @brief check if a node is a member of the root list (bounded pairing)
+/// @param node linked node
+///
+/// This walks back to the first sibling, whose predecessor is either its parent or the
+/// sentinel; it takes as many steps as the node has left siblings.
+inline bool
+PairingHeapT::_inroots(
+    const BaseNodeT *node) const
+{
+    while (node == node->_m_prev->_m_next) {
+        node = node->_m_prev;
+    }
+    return &_m_root == node->_m_prev;
+}
+
+/// @brief put a tree into a rank slot, linking it with the occupants like a carry (bounded pairing)
+/// @param ord  order policy
+/// @param slot rank slots
+/// @param mask occupied slots
+/// @param node tree root
+/// @param rank rank of the tree
+/// @return     the new set of occupied slots
+template<typename _Ord>
+std::uint64_t
+PairingHeapT::_rslot(
+    const _Ord    &ord,
+    BaseNodeT    **slot,
+    std::uint64_t  mask,
+    BaseNodeT     *node,
+    unsigned       rank) const
+{
+    node->_m_prev = node->_m_next = nullptr;
+    for (std::uint64_t bit{ std::uint64_t(1) << rank }; 0 != (mask & bit); /*NOP*/) {
+        node  = _merge(ord, slot[rank], node);
+        mask &= ~bit;
+        if (rank + 1 < _Ranks) {
+            ++rank;
+            bit <<= 1;
+        }
+    }
+    slot[rank] = node;
+    return mask | (std::uint64_t(1) << rank);
+}
+
+/// @brief add a tree to the root list, linking equal ranks like a carry (bounded pairing)
+/// @param ord  order policy
+/// @param node root of a cleanly cut tree
+/// @param rank rank of the tree, not below the degree of its root
+///
+/// The trees of lower rank are skipped, then every tree of the same rank is linked with the
+/// carried tree, which moves up a rank each time.  That's O(log N) links at worst and O(1)
+/// amortized for pushes alone, as incrementing a binary counter is.
+template<typename _Ord>
+void
+PairingHeapT::_rcarry(
+    const _Ord &ord,
+    BaseNodeT  *node,
+    unsigned    rank)
+{
+    BaseNodeT *pred{ &_m_root }, *scan{ _m_root._m_down };
+    for (std::uint64_t low{ _m_rank & ((std::uint64_t(1) << rank) - 1) }; 0 != low; low &= low - 1) {
+        pred = scan;
+        scan = scan->_m_next;
+    }
+    bool least{ nullptr == _m_amin || node == _m_amin };
+    for (std::uint64_t bit{ std::uint64_t(1) << rank }; 0 != (_m_rank & bit); /*NOP*/) {
+        BaseNodeT * const next{ scan->_m_next };
+        least    = least || (scan == _m_amin);
+        node     = _merge(ord, scan, node);
+        scan     = next;
+        _m_rank &= ~bit;
+        if (rank + 1 < _Ranks) {
+            ++rank;
+            bit <<= 1;
+        }
+    }
+    _m_rank |= std::uint64_t(1) << rank;
+    if (&_m_root == pred) {
+        _dunk(&_m_root, _cons(node, scan));
+    } else {
+        _cons(pred, _cons(node, scan));
+    }
+    // a link involving the least member has its winner at the root: equal or less
+    if (least || ord(*node, *_m_amin)) {
+        _m_amin = node;
+    }
+}
+
+/// @brief rebuild the root list from its members except @c drop, and the children of @c drop
+/// @param ord  order policy
+/// @param drop root list member to leave out, or @c NULL
+///
+/// All trees go through rank slots, then the occupied slots form the new root list.  With at
+/// most one tree per rank, and the children of @c drop having fewer than its rank, this is
+/// O(log N) links and a scan of as many roots for the least one.
+template<typename _Ord>
+void
+PairingHeapT::_rfold(
+    const _Ord &ord,
+    BaseNodeT  *drop)
+{
+    [[maybe_unused]] const auto timer{ heap_stats_timer(ord, HeapPhase::build) };
+    BaseNodeT     *slot[_Ranks];
+    std::uint64_t  mask{ 0 };
+    std::size_t    roots{ 0 };
+    BaseNodeT     *scan{ _m_root._m_down }, *next;
+
+    for (std::uint64_t bits{ _m_rank }; nullptr != scan; scan = next, bits &= bits - 1) {
+        next = scan->_m_next;
+        if (scan != drop) {
+            mask = _rslot(ord, slot, mask, scan, _lowest(bits));
+            ++roots;
+        }
+    }
+    for (scan = drop ? drop->_m_down : nullptr; nullptr != scan; scan = next) {
+        next = scan->_m_next;
+        mask = _rslot(ord, slot, mask, scan, _degree(scan));
+        ++roots;
+    }
+    heap_stats_build(ord, roots);
+
+    BaseNodeT *tail{ &_m_root };
+    _m_amin = nullptr;
+    for (std::uint64_t bits{ mask }; 0 != bits; bits &= bits - 1) {
+        BaseNodeT * const tree{ slot[_lowest(bits)] };
+        if (&_m_root == tail) {
+            _dunk(&_m_root, tree);
+        } else {
+            _cons(tail, tree);
+        }
+        tail = tree;
+        if (nullptr == _m_amin || ord(*tree, *_m_amin)) {
+            _m_amin = tree;
+        }
+    }
+    if (&_m_root == tail) {
+        _m_root._m_down = nullptr;
+    }
+    _m_rank = mask;
+}
+
+/// @brief push a node into the heap
+/// @param ord  order policy
+/// @param node node to insert
+/// @return @c node
+///
+/// With @c PairingAuxTwoPass the node goes to the root list, costing a comparison against
+/// the least member so far, but no link.  With @c PairingBoundedPass it is carried into the
+/// root list as a tree of rank 0.
+template<typename _Pass, typename _Ord>
+PairingHeapT::BaseNodeT*
+PairingHeapT::_push(
+    const _Ord &ord,
+    BaseNodeT  *node)
+{
+    if constexpr (_Pass::bounded) {
+        _rcarry(ord, node, 0);
+    } else if constexpr (_Pass::auxiliary) {
+        if (nullptr == _m_amin) {
+            _dunk(&_m_root, node);
+            _m_amin = node;
+        } else {
+            _rlink(node);
+            if (ord(*node, *_m_amin)) {
+                _m_amin = node;
+            }
+        }
+    } else {
+        _dunk(&_m_root, _merge(ord, _m_root._m_down, node));
+    }
+    ++_m_size;
+    return node;
+}
+
+/// @brief pop the root element
+/// @param ord  order policy
+/// @return the old root or @c NULL on empty heap
+///
+/// The bounded heap pops its least root list member and folds the rest of the list and the
+/// children of the popped node into a new one.
+template<typename _Pass, typename _Ord>
+PairingHeapT::BaseNodeT*
+PairingHeapT::_pop(
+    const _Ord &ord)
+{
+    if constexpr (_Pass::bounded) {
+        BaseNodeT *retv{ _m_amin };
+        if (nullptr != retv) {
+            _rfold(ord, retv);
+            retv->_m_prev = retv->_m_down = retv->_m_next = nullptr;
+            --_m_size;
+            heap_stats_pop(ord);
+        }
+        return retv;
+    }
+    if constexpr (_Pass::auxiliary) {
+        _consolidate(ord);
+    }
+    BaseNodeT *retv { _m_root._m_down };
+    if (nullptr != retv) {
+        _dunk(&_m_root, _build<_Pass>(ord, retv->_m_down));
+        retv->_m_prev = retv->_m_down = retv->_m_next = nullptr;
+        --_m_size;
+        heap_stats_pop(ord);
+    }
+    if constexpr (_Pass::auxiliary) {
+        _m_amin = _m_root._m_down;
+    }
+    return retv;
+}
+
+/// @brief cut a node from the tree
+/// @param ord  order policy
+/// @param node node to cut from the tree
+/// @return @node as singleton heap
+///
+/// This replaces @c node by the heap created from its children. If there are none, the replacement
+/// has to be the next sibling of the node, of course.  This retains most of the order already
+/// achieved in the heap.
+///
+/// Cutting the least root list member of an auxiliary twopass heap needs a scan of the root list.
+/// A bounded heap folds the root list anew when one of its members goes.
+template<typename _Pass, typename _Ord>
+PairingHeapT::BaseNodeT*
+PairingHeapT::_ncut(
+    const _Ord      &ord,
+    BaseNodeT *const node)
+{
+    assert(node && node->_m_prev);    // automagically breaks on sentinel!
+    if constexpr (_Pass::bounded) {
+        if (_inroots(node)) {
+            _rfold(ord, node);
+            node->_m_prev = node->_m_next = node->_m_down = nullptr;
+            --_m_size;
+            return node;
+        }
+    }
+    BaseNodeT *repl{ _build<_Pass>(ord, node->_m_down) };
+    BaseNodeT * const pred{ node->_m_prev };
+    if (node == pred ->_m_next) {
+        _cons(pred, _cons(repl, node->_m_next));
+    } else {
+        _dunk(pred, _cons(repl, node->_m_next));
+    }
+    node->_m_prev = node->_m_next = node->_m_down = nullptr;
+    --_m_size;
+    if constexpr (_Pass::auxiliary) {
+        if (node == _m_amin) {
+            _m_amin = _rootmin(ord);
+        }
+    }
+    return node;
+}
+
+/// @brief handle a decrease in the node's priority
+/// @param ord  order policy
+/// @param node node to reposition in heap
+/// @return     @c node
+///
+/// This an actual O(1) operation, as cutting a subtree from any position is O(1), and so
+/// is the following merge of the subtree with the remaining heap.  As decreasing the the
+/// node's weight does @e not invalidate the subtree rooted at @c node, we can prune and
+/// graft the whole subtree here.  ( @c _reinsert() is more complicated, as we cannot
+/// assume the heap invariant between the node and its children is preserved.)
+///
+/// The auxiliary twopass heap moves the subtree to the root list instead of merging it; the
+/// bounded one carries it in with the degree of its root as rank.
+template<typename _Pass, typename _Ord>
+PairingHeapT::BaseNodeT*
+PairingHeapT::_decrease(
+    const _Ord &ord,
+    BaseNodeT  *node)
+{
+    assert(node && node->_m_prev);
+    if constexpr (_Pass::bounded) {
+        if (!_inroots(node)) {
+            _rcarry(ord, _tcut(node), _degree(node));
+        } else if (ord(*node, *_m_amin)) {
+            _m_amin = node;
+        }
+    } else if constexpr (_Pass::auxiliary) {
+        if (node != _m_root._m_down) {
+            _rlink(_tcut(node));
+        }
+        if (ord(*node, *_m_amin)) {
+            _m_amin = node;
+        }
+    } else if (node != _m_root._m_down) {
+        _dunk(&_m_root, _merge(ord, _m_root._m_down, _tcut(node)));
+    }
+    return node;
+}
+
+/// @brief re-insert a node after an arbitrary priority change
+/// @param ord  order policy
+/// @param node node to reposition in heap
+/// @return     @c node
+///
+/// This cuts the node from the heap, effectively making it a singleton heap, and then
+/// merges it again with the heap.
+template<typename _Pass, typename _Ord>
+PairingHeapT::BaseNodeT*
+PairingHeapT::_reinsert(
+    const _Ord &ord,
+    BaseNodeT  *node)
+{
+    assert(node && node->_m_prev);
+    return _push<_Pass>(ord, _ncut<_Pass>(ord, node));
+}
+
+/// @brief merge another heap into this one
+/// @param ord  order policy
+/// @param rhs  heap to absorb; empty afterwards
+template<typename _Pass, typename _Ord>
+void
+PairingHeapT::_meld(
+    const _Ord   &ord,
+    PairingHeapT &rhs)
+{
+    if (this != &rhs) {
+        if constexpr (_Pass::bounded) {
+            // carry the trees of 'rhs' in one by one, with their ranks
+            std::size_t   size{ _m_size + rhs._m_size };
+            std::uint64_t bits{ rhs._m_rank };
+            for (BaseNodeT *scan{ rhs._yield() }, *next; nullptr != scan; scan = next, bits &= bits - 1) {
+                next = scan->_m_next;
+                scan->_m_prev = scan->_m_next = nullptr;
+                _rcarry(ord, scan, _lowest(bits));
+            }
+            _m_size = size;
+            return;
+        }
+        if constexpr (_Pass::auxiliary) {
+            _consolidate(ord);
+            rhs._consolidate(ord);
+        }
+        std::size_t size{ _m_size + rhs._m_size };
+        _dunk(&_m_root, _merge(ord, _yield(), rhs._yield()));
+        _m_size = size;
+        if constexpr (_Pass::auxiliary) {
+            _m_amin = _m_root._m_down;
+        }
+    }
+}
+
+/// @brief move the tree of another heap into this (empty) heap
+/// @param rhs  heap to take the nodes from; empty afterwards
+inline void
+PairingHeapT::_take(
+    PairingHeapT &rhs)
+{
+    assert(nullptr == _m_root._m_down);
+    std::size_t size{ rhs._m_size };
+    BaseNodeT    *amin{ rhs._m_amin };
+    std::uint64_t rank{ rhs._m_rank };
+    _dunk(&_m_root, rhs._yield());
+    _m_size = size;
+    _m_amin = amin;
+    _m_rank = rank;
+}
+
+/// @brief cut whole subtrees of about @c want nodes from below the least root
+/// @param ord      order policy
+/// @param want     number of nodes to take; the subtrees are not split, so it may be more
+/// @param count    receives the number of nodes actually taken
+/// @return         the subtrees as a list chained via @c _m_next, or @c NULL if the least
+///                 root has no children
+///
+/// The children of the least root are taken from the front of its child list, one subtree
+/// after the other, until @c want nodes are reached.  At least one subtree is taken if there
+/// is any, and the least root itself always stays.  The cut is O(1) in pointer operations;
+/// the nodes taken have to be counted though, O(@c count).
+///
+/// The auxiliary twopass heap combines its root list first, the way @c _pop() does.  A bounded
+/// heap takes the children of its least root list member; the rank of that one stays valid, as
+/// a rank may be above the degree of the tree.  If that member has no children, the other
+/// members of the root list go instead, whole trees with their rank given up.
+template<typename _Pass, typename _Ord>
+PairingHeapT::BaseNodeT*
+PairingHeapT::_split(
+    const _Ord  &ord,
+    std::size_t  want,
+    std::size_t &count)
+{
+    if constexpr (_Pass::auxiliary && !_Pass::bounded) {
+        _consolidate(ord);
+    }
+    BaseNodeT * const top{ _Pass::auxiliary ? _m_amin : _m_root._m_down };
+    BaseNodeT * const head{ top ? top->_m_down : nullptr };
+    BaseNodeT        *last{ head };
+    count = 0;
+    if constexpr (_Pass::bounded) {
+        if (nullptr != top && nullptr == head) {
+            BaseNodeT *list{ nullptr }, *scan{ _m_root._m_down }, *next;
+            for (std::uint64_t bits{ _m_rank }; nullptr != scan && count < want; scan = next, bits &= bits - 1) {
+                next = scan->_m_next;
+                if (scan != top) {
+                    _m_rank &= ~(std::uint64_t(1) << _lowest(bits));
+                    count += _tsize(_tcut(scan));
+                    if (nullptr == list) {
+                        list = scan;
+                    } else {
+                        _cons(last, scan);
+                    }
+                    last = scan;
+                }
+            }
+            _m_size -= count;
+            return list;
+        }
+    }
+    if (nullptr == head) {
+        return nullptr;
+    }
+    while (((count += _tsize(last)) < want) && (nullptr != last->_m_next)) {
+        last = last->_m_next;
+    }
+    _dunk(top, last->_m_next);
+    head->_m_prev = last->_m_next = nullptr;
+    _m_size -= count;
+    return head;
+}
+
+/// @brief make a heap from a list of trees
+/// @param ord      order policy
+/// @param list     trees chained via @c _m_next, as @c _split() returns them
+/// @param count    number of nodes in these trees
+///
+/// The heap must be empty.  A bounded heap carries the trees in by the degree of their roots,
+/// the others combine them with their pairing pass.
+template<typename _Pass, typename _Ord>
+void
+PairingHeapT::_adopt(
+    const _Ord  &ord,
+    BaseNodeT   *list,
+    std::size_t  count)
+{
+    assert(nullptr == _m_root._m_down);
+    if constexpr (_Pass::bounded) {
+        for (BaseNodeT *next; nullptr != list; list = next) {
+            next = list->_m_next;
+            list->_m_prev = list->_m_next = nullptr;
+            _rcarry(ord, list, _degree(list));
+        }
+    } else {
+        _dunk(&_m_root, _build<_Pass>(ord, list));
+        if constexpr (_Pass::auxiliary) {
+            _m_amin = _m_root._m_down;
+        }
+    }
+    _m_size = count;
+}
+
+/// @brief cut all nodes from the heap, in order
+/// @param ord  order policy
+/// @return     the nodes as a sorted list chained via @c _m_next (no back-links)
+template<typename _Ord>
+PairingHeapT::BaseNodeT*
+PairingHeapT::_drain(
+    const _Ord &ord)
+{
+    BaseNodeT *tree{ _yield() }, *list{ nullptr }, *node;
+    while (nullptr != (node = _shred_pop(tree))) {
+        node->_m_prev = node->_m_down = nullptr;
+        node->_m_next = list;
+        list = node;
+    }
+    return heap_sort_list<BaseNodeT, &BaseNodeT::_m_next>(ord, list);
+}
+
+extern template PairingHeapT::BaseNodeT* PairingHeapT::_push    (const VirtualOrderT&, BaseNodeT*);
+extern template PairingHeapT::BaseNodeT* PairingHeapT::_pop     (const VirtualOrderT&);
+extern template PairingHeapT::BaseNodeT* PairingHeapT::_merge   (const VirtualOrderT&, BaseNodeT*, BaseNodeT*) const;
+extern template PairingHeapT::BaseNodeT* PairingHeapT::_build   (const VirtualOrderT&, BaseNodeT*) const;
+extern template PairingHeapT::BaseNodeT* PairingHeapT::_ncut    (const VirtualOrderT&, BaseNodeT*);
+extern template PairingHeapT::BaseNodeT* PairingHeapT::_decrease(const VirtualOrderT&, BaseNodeT*);
+extern template PairingHeapT::BaseNodeT* PairingHeapT::_reinsert(const VirtualOrderT&, BaseNodeT*);
+extern template void                     PairingHeapT::_meld    (const VirtualOrderT&, PairingHeapT&);
+extern template PairingHeapT::BaseNodeT* PairingHeapT::_drain   (const VirtualOrderT&);
+extern template PairingHeapT::BaseNodeT* PairingHeapT::_split   (const VirtualOrderT&, std::size_t, std::size_t&);
+extern template void                     PairingHeapT::_adopt   (const VirtualOrderT&, BaseNodeT*, std::size_t);
+
 // -----------------------------------------------------------------------------------------------
 // template class for a typed PairingHeap, derived from the basic heap class.  Supports iteration
 // and the value type, the compare predicate and the allocator can be specified.
 //
 // Since moving nodes assumes the same allocator and since merge requires the same order criterion
 // both are specified as classes and cannot be substituted by lambdas.
+//
+// With @c _Inline set, the core algorithms are instantiated for this heap with the comparator
+// compiled in, trading code size for avoiding the virtual predicate call on every comparison.
+// @c _Stats selects a statistics policy (see heapstats.hpp); the default counts nothing.
+// @c _Pass selects the pairing strategy (see pairpass.hpp); the default is the classic two-pass.
+// @c _KeyOf caches the compare key in the node header (see keyof.hpp); @c _Comp orders keys then.
 // -----------------------------------------------------------------------------------------------
 
 template<
     typename _Type,
     typename _Comp = std::less<_Type>,
-    typename Alloc = std::allocator<_Type> >
+    typename Alloc = std::allocator<_Type>,
+    bool     _Inline = false,
+    typename _Stats = NoHeapStats,
+    typename _Pass = PairingTwoPass,
+    typename _KeyOf = IdentityKey >
 class PairingHeap : protected PairingHeapT
 {
     // --- allocator guard ---
@@ -87,11 +842,13 @@ class PairingHeap : protected PairingHeapT
 
 protected:
 
-    struct _XNode : public BaseNodeT {
+    struct _XNode : public BaseNodeT, public HeapKeyT<_Type, _KeyOf> {
         _Type _m_value;
 
-        _XNode(const _Type &  rhs) : _m_value{ rhs            } { /*NOP*/ }
-        _XNode(      _Type && rhs) : _m_value{ std::move(rhs) } { /*NOP*/ }
+        _XNode(const _Type &  rhs) : _m_value{ rhs            } { this->_load(_m_value); }
+        _XNode(      _Type && rhs) : _m_value{ std::move(rhs) } { this->_load(_m_value); }
+
+        const auto &_cmp_key() const { return this->_key(_m_value); }
     };
 
     using value_allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<_Type>;
@@ -118,10 +875,24 @@ protected:
         }
     }
 
+    struct _XOrder {
+        bool operator()(const BaseNodeT &n1, const BaseNodeT &n2) const {
+            const auto & rn1{ static_cast<const _XNode&>(n1)._cmp_key() };
+            const auto & rn2{ static_cast<const _XNode&>(n2)._cmp_key() };
+            return _Comp()(rn1, rn2);
+        }
+    };
+
     bool _pred(const BaseNodeT &n1, const BaseNodeT &n2) const override {
-        const _Type & rn1{ static_cast<const _XNode&>(n1)._m_value };
-        const _Type & rn2{ static_cast<const _XNode&>(n2)._m_value };
-        return _Comp()(rn1, rn2);
+        return _XOrder()(n1, n2);
+    }
+
+    auto _order() const {
+        if constexpr (_Inline) {
+            return heap_stats_order<_Stats>(_XOrder(), _m_stats);
+        } else {
+            return heap_stats_order<_Stats>(VirtualOrderT{ this }, _m_stats);
+        }
     }
 
     void _clear(BaseNodeT *root) {
@@ -131,9 +902,12 @@ protected:
     }
 
     node_allocator_type _m_alloc;
+    mutable _Stats      _m_stats;
 
   public:
 
+    using allocator_type = Alloc;
+
     struct iterator {
         using iterator_category = std::bidirectional_iterator_tag;
         using value_type        = _Type;
@@ -151,8 +925,8 @@ protected:
         iterator& operator--()    { _m_ipos = _iter_pred(_m_ipos); return *this;     }
         iterator  operator--(int) { return { _iter_pred(_m_ipos) }; }
 
-        friend bool operator==(const iterator& i1, const iterator& i2) { return  _iter_same(i1._m_ipos, i2._m_ipos); }
-        friend bool operator!=(const iterator& i1, const iterator& i2) { return !_iter_same(i1._m_ipos, i2._m_ipos); }
+        friend bool operator==(const iterator& i1, const iterator& i2) { return  ::PairingHeapT::_iter_same(i1._m_ipos, i2._m_ipos); }
+        friend bool operator!=(const iterator& i1, const iterator& i2) { return !::PairingHeapT::_iter_same(i1._m_ipos, i2._m_ipos); }
 
     protected:
         friend PairingHeap;
@@ -183,8 +957,8 @@ protected:
         const_iterator& operator--()    { _m_ipos = _iter_pred(_m_ipos); return *this; }
         const_iterator  operator--(int) { return { _iter_pred(_m_ipos) }; }
 
-        friend bool operator==(const const_iterator& i1, const const_iterator& i2) { return  _iter_same(i1._m_ipos, i2._m_ipos); }
-        friend bool operator!=(const const_iterator& i1, const const_iterator& i2) { return !_iter_same(i1._m_ipos, i2._m_ipos); }
+        friend bool operator==(const const_iterator& i1, const const_iterator& i2) { return  ::PairingHeapT::_iter_same(i1._m_ipos, i2._m_ipos); }
+        friend bool operator!=(const const_iterator& i1, const const_iterator& i2) { return !::PairingHeapT::_iter_same(i1._m_ipos, i2._m_ipos); }
 
     protected:
         friend PairingHeap;
@@ -199,8 +973,8 @@ protected:
 
     PairingHeap() { /*NOP*/ }
 
-    PairingHeap(PairingHeap&& rhs) {
-        _dunk(&_m_root, rhs._yield());
+    PairingHeap(PairingHeap&& rhs) : _m_stats{ std::move(rhs._m_stats) } {
+        _take(rhs);
     }
     PairingHeap(const PairingHeap & rhs) = delete;
 
@@ -211,43 +985,146 @@ protected:
     PairingHeap& operator=(PairingHeap&& rhs) {
         if (this != &rhs) {
             _clear(_yield());
-            _dunk(&_m_root, rhs._yield());
+            _take(rhs);
+            _m_stats = std::move(rhs._m_stats);
         }
         return *this;
     }
     PairingHeap& operator=(const PairingHeap &) = delete;
 
     PairingHeap& merge(PairingHeap& rhs) {
-        if (this != &rhs)
-            _dunk(&_m_root, _merge(_yield(), rhs._yield()));
+        _meld<_Pass>(_order(), rhs);
         return *this;
     }
 
+    /// @brief move whole subtrees of about @c n values into a new heap (see @c _split())
+    /// @param n    number of values to move; more if a subtree is larger, never the front
+    /// @return     heap with the moved values, empty if the front has no subtrees below it
+    ///
+    /// The values moved are good ones -- each subtree is headed by a child of the front -- but
+    /// not the best, which is what a work-stealing thief wants.  Nodes move, they are not
+    /// copied.  The heaps are not thread-safe, so the owner of the heap has to agree to it.
+    /// Not with a @c NodePoolAllocator: its pool is per thread, and a thief would free the
+    /// owner's nodes into its own pool, where they dangle once the owner thread exits.
+    PairingHeap split(std::size_t n) {
+        static_assert(!node_pool_traits<node_allocator_type>::thread_affine,
+            "PairingHeap::split() moves nodes to other threads, a thread-affine pool cannot follow");
+        PairingHeap retv;
+        std::size_t count;
+        BaseNodeT  *list{ _split<_Pass>(_order(), n, count) };
+        retv.template _adopt<_Pass>(retv._order(), list, count);
+        return retv;
+    }
+
+    /// @brief move one subtree below the front into a new heap; see @c split()
+    PairingHeap steal_subtree() {
+        return split(1);
+    }
+
     void clear() {
-        _clear(_yield());
+        // with nothing to destroy, a pool that holds no other nodes takes these back at once
+        const std::size_t size{ _m_size };
+        BaseNodeT * const root{ _yield() };
+        if constexpr (std::is_trivially_destructible<_XNode>::value) {
+            if (node_pool_traits<node_allocator_type>::recycle(_m_alloc, size)) {
+                return;
+            }
+        }
+        _clear(root);
+    }
+
+    /// @brief pre-populate the node allocator, if it supports that ( @c NodePoolAllocator does)
+    /// @param n    number of nodes that can be pushed afterwards without allocating memory
+    void reserve(std::size_t n) {
+        node_pool_traits<node_allocator_type>::reserve(_m_alloc, n);
     }
 
-    iterator push(const _Type &  rhs) {  return { _push(_create_node(rhs           ))}; }
-    iterator push(      _Type && rhs) {  return { _push(_create_node(std::move(rhs)))}; }
+    iterator push(const _Type &  rhs) {  return { _push<_Pass>(_order(), _create_node(rhs           ))}; }
+    iterator push(      _Type && rhs) {  return { _push<_Pass>(_order(), _create_node(std::move(rhs)))}; }
 
     template<typename... Args>
-    iterator emplace(Args&&... args) { return { _push(_create_node(std::forward<Args>(args)...)) }; }
+    iterator emplace(Args&&... args) { return { _push<_Pass>(_order(), _create_node(std::forward<Args>(args)...)) }; }
 
     _Type &front() const {
         if (nullptr == _m_root._m_down) {
             throw std::invalid_argument("empty");
         }
-        return static_cast<_XNode*>(_m_root._m_down)->_m_value;
+        BaseNodeT *node{ _Pass::auxiliary ? _m_amin : _m_root._m_down };
+        return static_cast<_XNode*>(node)->_m_value;
     }
 
     void pop() {
-        _destroy_node(_pop());
+        _destroy_node(_pop<_Pass>(_order()));
+    }
+
+    /// @brief move the @c k least values out, in order
+    /// @param k    number of values to pop; all of them if @c k >= @c size()
+    /// @param out  output iterator receiving the values
+    /// @return     @c out past the last value written
+    ///
+    /// Below @c size() this pops node by node, each pop with its own pairing pass: every pass
+    /// leaves the children better ordered for the next pop, so deferring them all to one pass
+    /// at the end costs a scan of the pending trees per pop, and measured slower.
+    template<typename _OutIt>
+    _OutIt pop_n(std::size_t k, _OutIt out) {
+        if (k >= _m_size) {
+            return drain(out);
+        }
+        for (; k > 0; --k) {
+            _XNode *node{ static_cast<_XNode*>(_pop<_Pass>(_order())) };
+            try {
+                *out = std::move(node->_m_value);
+                ++out;
+            } catch (...) {
+                _destroy_node(node);
+                throw;
+            }
+            _destroy_node(node);
+        }
+        return out;
+    }
+
+    /// @brief move all values out, in order, leaving the heap empty
+    /// @param out  output iterator receiving the values
+    /// @return     @c out past the last value written
+    ///
+    /// This does not pop node by node, but sorts the nodes of the whole tree at once (see
+    /// listsort.hpp).  If writing a value throws, the values not yet written stay in the heap.
+    template<typename _OutIt>
+    _OutIt drain(_OutIt out) {
+        BaseNodeT *list{ _drain(_order()) };
+        try {
+            while (nullptr != list) {
+                *out = std::move(static_cast<_XNode*>(list)->_m_value);
+                ++out;
+                BaseNodeT *node{ list };
+                list = list->_m_next;
+                _destroy_node(node);
+            }
+        } catch (...) {
+            while (nullptr != list) {
+                BaseNodeT *node{ list };
+                list = list->_m_next;
+                node->_m_next = nullptr;
+                _push<_Pass>(_order(), node);
+            }
+            throw;
+        }
+        return out;
     }
 
     bool empty() const {
         return nullptr == _m_root._m_down;
     }
 
+    std::size_t size() const {
+        return _m_size;
+    }
+
+    /// @brief operation counters of the statistics policy
+    const _Stats &stats() const { return _m_stats; }
+    void reset_stats() { _m_stats = _Stats(); }
+
     /// @brief remove the node the iterator references
     /// @param itpos node to remove
     /// @return iterator to successor of @c itpos
@@ -255,7 +1132,7 @@ protected:
     ///       active iterators for this heap!
     iterator remove(const iterator &itpos) {
         BaseNodeT*succ{ _iter_succ(itpos._m_ipos) };
-        _destroy_node(_ncut(itpos._m_ipos));
+        _destroy_node(_ncut<_Pass>(_order(), itpos._m_ipos));
         return { succ };
     }
 
@@ -264,7 +1141,8 @@ protected:
     /// @return         @c itpos for convenience
     /// @note This will distort all active iterators for this heap!
     iterator decrease(const iterator &itpos) {
-        return { _decrease(itpos._m_ipos) };
+        static_cast<_XNode*>(itpos._m_ipos)->_load(*itpos);
+        return { _decrease<_Pass>(_order(), itpos._m_ipos) };
     }
 
     /// @brief fully restore heap invariants after key/prio at @c *itpos was changed
@@ -272,10 +1150,198 @@ protected:
     /// @return         @c itpos for convenience
     /// @note This will distort all active iterators for this heap!
     iterator readjust(const iterator &itpos) {
-        return { _reinsert(itpos._m_ipos) };
+        static_cast<_XNode*>(itpos._m_ipos)->_load(*itpos);
+        return { _reinsert<_Pass>(_order(), itpos._m_ipos) };
+    }
+
+    using PairingHeapT::validate_tree;
+    using PairingHeapT::validate_stream;
+    using PairingHeapT::validate_sample;
+    using PairingHeapT::shape_stats;
+};
+
+// -----------------------------------------------------------------------------------------------
+// intrusive PairingHeap: the elements carry the links themselves, by deriving (publicly) from
+// the hook type @c PairingHeapT::BaseNodeT.  The heap never allocates, copies or destroys an
+// element; it only links and unlinks them.  An element can be in at most one heap at a time,
+// and it must not be destroyed while it is linked.
+// -----------------------------------------------------------------------------------------------
+
+using PairingHeapHook = PairingHeapT::BaseNodeT;
+
+template<
+    typename _Type,
+    typename _Comp = std::less<_Type>,
+    bool     _Inline = false >
+class IntrusivePairingHeap : protected PairingHeapT
+{
+    // --- hook guard ---
+    static_assert(std::is_base_of<PairingHeapHook, _Type>::value,
+        "IntrusivePairingHeap requires the value type to derive from PairingHeapHook");
+
+    // --- comparator guard ---
+    static_assert(std::is_empty<_Comp>::value,
+        "IntrusivePairingHeap merge, move, or assignment require a stateless comparator");
+
+protected:
+    struct _XOrder {
+        bool operator()(const BaseNodeT &n1, const BaseNodeT &n2) const {
+            return _Comp()(static_cast<const _Type&>(n1), static_cast<const _Type&>(n2));
+        }
+    };
+
+    bool _pred(const BaseNodeT &n1, const BaseNodeT &n2) const override {
+        return _XOrder()(n1, n2);
+    }
+
+    auto _order() const {
+        if constexpr (_Inline) {
+            return _XOrder();
+        } else {
+            return VirtualOrderT{ this };
+        }
+    }
+
+    static void _clear(BaseNodeT *root) {
+        while (nullptr != root) {
+            BaseNodeT *node{ _shred_pop(root) };
+            node->_m_prev = node->_m_next = node->_m_down = nullptr;
+        }
+    }
+
+  public:
+
+    struct iterator {
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type        = _Type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = _Type*;
+        using reference         = _Type&;
+
+        iterator() = default;
+
+        reference operator*()  const { return  static_cast<_Type&>(*_m_ipos); }
+        pointer   operator->() const { return &static_cast<_Type&>(*_m_ipos); }
+
+        iterator& operator++()    { _m_ipos = _iter_succ(_m_ipos); return *this; }
+        iterator  operator++(int) { return { _iter_succ(_m_ipos) }; }
+        iterator& operator--()    { _m_ipos = _iter_pred(_m_ipos); return *this;     }
+        iterator  operator--(int) { return { _iter_pred(_m_ipos) }; }
+
+        friend bool operator==(const iterator& i1, const iterator& i2) { return  ::PairingHeapT::_iter_same(i1._m_ipos, i2._m_ipos); }
+        friend bool operator!=(const iterator& i1, const iterator& i2) { return !::PairingHeapT::_iter_same(i1._m_ipos, i2._m_ipos); }
+
+    protected:
+        friend IntrusivePairingHeap;
+
+        BaseNodeT *_m_ipos{ nullptr };
+
+        iterator(BaseNodeT* ipos) : _m_ipos{ ipos } { /*NOP*/ }
+    };
+
+    iterator begin() { return { _iter_head() }; }
+    iterator end()   { return { &_m_root     }; }
+
+    IntrusivePairingHeap() { /*NOP*/ }
+
+    IntrusivePairingHeap(IntrusivePairingHeap&& rhs) {
+        _take(rhs);
+    }
+    IntrusivePairingHeap(const IntrusivePairingHeap & rhs) = delete;
+
+    ~IntrusivePairingHeap() {
+        _clear(_yield());
+    }
+
+    IntrusivePairingHeap& operator=(IntrusivePairingHeap&& rhs) {
+        if (this != &rhs) {
+            _clear(_yield());
+            _take(rhs);
+        }
+        return *this;
+    }
+    IntrusivePairingHeap& operator=(const IntrusivePairingHeap &) = delete;
+
+    IntrusivePairingHeap& merge(IntrusivePairingHeap& rhs) {
+        _meld(_order(), rhs);
+        return *this;
+    }
+
+    /// @brief unlink all elements (the elements themselves are not touched otherwise)
+    void clear() {
+        _clear(_yield());
+    }
+
+    /// @brief link an element into the heap
+    /// @param item element to insert; must not be linked into any heap
+    /// @return iterator to @c item
+    iterator push(_Type &item) {
+        assert(!is_linked(item));
+        return { _push(_order(), &item) };
+    }
+
+    _Type &front() const {
+        if (nullptr == _m_root._m_down) {
+            throw std::invalid_argument("empty");
+        }
+        return static_cast<_Type&>(*_m_root._m_down);
+    }
+
+    /// @brief unlink the top element
+    /// @return the former top element or @c nullptr if the heap was empty
+    _Type *pop() {
+        return static_cast<_Type*>(_pop(_order()));
+    }
+
+    bool empty() const {
+        return nullptr == _m_root._m_down;
+    }
+
+    std::size_t size() const {
+        return _m_size;
+    }
+
+    /// @brief check if an element is linked into some heap
+    static bool is_linked(const _Type &item) {
+        return nullptr != item._m_prev;
+    }
+
+    /// @brief get an iterator to a linked element
+    iterator iterator_to(_Type &item) {
+        return { &item };
+    }
+
+    /// @brief unlink an element from the heap
+    /// @param item element to remove, must be linked into this heap
+    void remove(_Type &item) {
+        _ncut(_order(), &item);
+    }
+
+    /// @brief unlink the element the iterator references
+    /// @param itpos element to remove
+    /// @return iterator to successor of @c itpos
+    iterator remove(const iterator &itpos) {
+        BaseNodeT*succ{ _iter_succ(itpos._m_ipos) };
+        _ncut(_order(), itpos._m_ipos);
+        return { succ };
+    }
+
+    /// @brief quickly restore heap invariants after key/prio of @c item was reduced
+    /// @param item element that should go closer to the root
+    void decrease(_Type &item) {
+        _decrease(_order(), &item);
+    }
+
+    /// @brief fully restore heap invariants after key/prio of @c item was changed
+    /// @param item element that should be re-evaluated for position in heap
+    void readjust(_Type &item) {
+        _reinsert(_order(), &item);
     }
 
     using PairingHeapT::validate_tree;
+    using PairingHeapT::validate_stream;
+    using PairingHeapT::validate_sample;
+    using PairingHeapT::shape_stats;
 };
 
 #endif // PHQUEUE3_9687E0DD_D406_474B_9534_94B7C1D81D33
\ No newline at end of file
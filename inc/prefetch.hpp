@@ -0,0 +1,45 @@
+// -------------------------------------------------------------------------------------------
+// Software prefetching for the meld loops
+// -------------------------------------------------------------------------------------------
+// This file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+// Merging along a spine and the pairing pass are pointer chases: the next node is known only
+// once the current one is in cache.  With 'PQ_HEAP_PREFETCH' defined to 1, the loops ask for
+// the nodes of the next step before they compare the current ones, so the cache misses of
+// both overlap:
+//
+//  - pairing pass: the next sibling pair while the current pair is merged;
+//  - Leftist / Min-Dist merge: the children of both spine candidates ahead of the comparison
+//    that decides which one to descend into.
+//
+// For heaps that fit into the cache this is wasted issue bandwidth, hence the opt-in.  The
+// CMake option 'PQ_PREFETCH' sets the macro for the library and everything linking it; the
+// setting must be the same in all translation units.
+// -------------------------------------------------------------------------------------------
+#ifndef PREFETCH_9687E0DD_D406_474B_9534_94B7C1D81D33
+#define PREFETCH_9687E0DD_D406_474B_9534_94B7C1D81D33
+
+#ifndef PQ_HEAP_PREFETCH
+# define PQ_HEAP_PREFETCH 0
+#endif
+
+/// @brief hint that the node at @c addr will be read and linked soon; @c nullptr is fine
+///
+/// A no-op in constant evaluation, so the core algorithms calling it may be @c constexpr.
+inline constexpr void
+heap_prefetch(const void *addr)
+{
+#if PQ_HEAP_PREFETCH && (defined(__GNUC__) || defined(__clang__))
+    if (!__builtin_is_constant_evaluated()) {
+        __builtin_prefetch(addr, 1, 3);
+    }
+#else
+    (void)addr;
+#endif
+}
+
+#endif // PREFETCH_9687E0DD_D406_474B_9534_94B7C1D81D33
@@ -0,0 +1,417 @@
+// -------------------------------------------------------------------------------------------
+// Radix Heap: monotone priority queue on integer keys
+// -------------------------------------------------------------------------------------------
+// This file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+// Dijkstra and discrete event simulation never push a key below the one popped last.  A
+// Radix Heap exploits that: with @c last the key of the latest pop, a node with key @c k sits
+// in bucket @c bit_width(k ^ last), 0..64.  Bucket 0 holds the keys equal to @c last, and a
+// bucket index only depends on the highest bit where the key differs from @c last.
+//
+// Popping from an empty bucket 0 takes the least node of the lowest non-empty bucket @c b,
+// makes its key the new @c last, and spreads the rest of bucket @c b over the buckets below
+// @c b -- their keys now agree with @c last on that bit.  The buckets above @c b remain valid.
+// A node only ever moves down, at most 64 times, so a pop costs O(log C) amortised for keys
+// below C, with plain list operations instead of comparisons along pointer paths.  A decrease
+// that stays in its bucket is O(1), otherwise the node moves to a lower bucket.
+//
+// The price is the contract: pushing a key below @c last, or decreasing a key below it,
+// throws @c std::out_of_range and leaves the heap unchanged.  Once the heap runs empty, any
+// key goes again.  Heaps cannot be merged, as the other heap may hold keys below @c last.
+// -------------------------------------------------------------------------------------------
+#ifndef RADIXHEAP_9687E0DD_D406_474B_9534_94B7C1D81D33
+#define RADIXHEAP_9687E0DD_D406_474B_9534_94B7C1D81D33
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+#include "keyof.hpp"
+#include "nodepool.hpp"
+
+// -------------------------------------------------------------------------------------------
+// definition of the core functions of a Radix Heap; they only look at the unsigned 64-bit
+// image of the keys, so there is no order predicate at all.
+// -------------------------------------------------------------------------------------------
+
+class RadixHeapT
+{
+public:
+    struct BaseNodeT {
+        BaseNodeT    *_m_prev { nullptr };
+        BaseNodeT    *_m_next { nullptr };
+        std::uint64_t _m_rkey { 0 };                       // the key mapped to an unsigned word
+    };
+
+    static constexpr unsigned _Buckets{ 65 };
+
+    static unsigned _bit_width(std::uint64_t x);           // number of significant bits
+    static unsigned _lowest(std::uint64_t x);              // index of the lowest set bit, x != 0
+
+    unsigned   _bucket_of(std::uint64_t rkey) const { return _bit_width(rkey ^ _m_last); }
+
+    void       _admit(std::uint64_t rkey) const;           // throw if 'rkey' is below '_m_last'
+    void       _link(BaseNodeT* node);                     // put the node into its bucket
+    void       _unlink(BaseNodeT* node);                   // take the node from its bucket
+
+    BaseNodeT* _push(BaseNodeT* node);                     // insert a node, key preloaded
+    BaseNodeT* _top() const;                               // least node, found lazily
+    BaseNodeT* _pop();                                     // remove the least node
+    BaseNodeT* _ncut(BaseNodeT* node);                     // remove the node 'node'
+    BaseNodeT* _rekey(BaseNodeT* node, std::uint64_t rkey);// move 'node' after a key change
+    BaseNodeT* _yield();                                   // cut all nodes as one list
+    void       _take(RadixHeapT &rhs);                     // move the nodes of 'rhs' to an empty heap
+
+    // -------------------------------------------------------------------------------------------
+    // iteration support: bucket by bucket, the lists in any order
+    BaseNodeT* _iter_head() const;
+    BaseNodeT* _iter_succ(const BaseNodeT* node) const;
+
+    void validate_tree() const;
+
+    BaseNodeT     *_m_head[_Buckets] { };                  // bucket lists
+    std::uint64_t  _m_mask { 0 };                          // bit b-1 set: bucket b > 0 is not empty
+    std::uint64_t  _m_last { 0 };                          // key of the latest pop from bucket > 0, 0 when empty
+    std::size_t    _m_size { 0 };                          // number of nodes in the buckets
+    mutable BaseNodeT *_m_top { nullptr };                 // least node if known
+};
+
+/// @brief number of bits needed to represent @c x, 0 for 0
+inline unsigned
+RadixHeapT::_bit_width(
+    std::uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return x ? unsigned(64 - __builtin_clzll(x)) : 0u;
+#else
+    unsigned bits{ 0 };
+    for (; x; x >>= 1) {
+        ++bits;
+    }
+    return bits;
+#endif
+}
+
+/// @brief index of the lowest bit set in @c x, which must not be 0
+inline unsigned
+RadixHeapT::_lowest(
+    std::uint64_t x)
+{
+    assert(0 != x);
+#if defined(__GNUC__) || defined(__clang__)
+    return unsigned(__builtin_ctzll(x));
+#else
+    unsigned idx{ 0 };
+    for (; !(x & 1); x >>= 1) {
+        ++idx;
+    }
+    return idx;
+#endif
+}
+
+/// @brief check the monotone contract for a key about to be pushed
+inline void
+RadixHeapT::_admit(
+    std::uint64_t rkey) const
+{
+    if (rkey < _m_last) {
+        throw std::out_of_range("key below the last popped key");
+    }
+}
+
+/// @brief put a node at the head of its bucket
+/// @param node node with a key not below @c _m_last
+inline void
+RadixHeapT::_link(
+    BaseNodeT *node)
+{
+    const unsigned bkt{ _bucket_of(node->_m_rkey) };
+    node->_m_prev = nullptr;
+    node->_m_next = _m_head[bkt];
+    if (nullptr != node->_m_next) {
+        node->_m_next->_m_prev = node;
+    }
+    _m_head[bkt] = node;
+    if (0 != bkt) {
+        _m_mask |= std::uint64_t(1) << (bkt - 1);
+    }
+}
+
+/// @brief take a node from its bucket
+/// @param node linked node
+inline void
+RadixHeapT::_unlink(
+    BaseNodeT *node)
+{
+    const unsigned bkt{ _bucket_of(node->_m_rkey) };
+    if (nullptr != node->_m_prev) {
+        node->_m_prev->_m_next = node->_m_next;
+    } else {
+        _m_head[bkt] = node->_m_next;
+    }
+    if (nullptr != node->_m_next) {
+        node->_m_next->_m_prev = node->_m_prev;
+    }
+    if (0 != bkt && nullptr == _m_head[bkt]) {
+        _m_mask &= ~(std::uint64_t(1) << (bkt - 1));
+    }
+    node->_m_prev = node->_m_next = nullptr;
+}
+
+// -----------------------------------------------------------------------------------------------
+// RadixHeap -- a monotone priority queue of values with an integral key of up to 64 bits.
+//
+// The key is the value itself or, with @c _KeyOf (see keyof.hpp), extracted from it; it is
+// cached in the node, so changing the key of a queued value requires @c decrease() or
+// @c readjust().  Signed keys are fine, also negative ones: the heap orders them as integers.
+// The least key comes first; there is no comparator to reverse that.
+//
+// Nodes never move, neither by pops nor by key changes, so an iterator stays a valid handle
+// until its own node is popped or removed.  This is a forward iterator over all values, bucket
+// by bucket, and not in heap order.
+// -----------------------------------------------------------------------------------------------
+
+template<
+    typename _Type,
+    typename _KeyOf = IdentityKey,
+    typename Alloc = std::allocator<_Type> >
+class RadixHeap : protected RadixHeapT
+{
+    // --- allocator guard ---
+    static_assert(std::allocator_traits<Alloc>::is_always_equal::value,
+         "RadixHeap requires an allocator with is_always_equal == true");
+
+protected:
+    using key_type = typename HeapKeyT<_Type, _KeyOf>::key_type;
+
+    // --- key guard ---
+    static_assert(std::is_integral<key_type>::value && !std::is_same<key_type, bool>::value &&
+                  sizeof(key_type) <= sizeof(std::uint64_t),
+        "RadixHeap requires an integral key of at most 64 bits");
+
+    /// @brief order preserving image of the key in an unsigned word
+    static std::uint64_t _radix(const _Type &value) {
+        using ukey = typename std::make_unsigned<key_type>::type;
+        const ukey key( HeapKeyT<_Type, _KeyOf>::_extract(value) );
+        if constexpr (std::is_signed<key_type>::value) {
+            // flip the sign bit: the negative keys go below the others
+            return std::uint64_t(ukey(key ^ ukey(ukey(1) << (8 * sizeof(ukey) - 1))));
+        } else {
+            return std::uint64_t(key);
+        }
+    }
+
+    struct _XNode : public BaseNodeT {
+        _Type _m_value;
+
+        template<typename... Args>
+        explicit _XNode(Args&&... args) : _m_value( std::forward<Args>(args)... ) { this->_m_rkey = _radix(_m_value); }
+    };
+
+    using node_allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<_XNode>;
+    using node_alloc_traits = std::allocator_traits<node_allocator_type>;
+
+    template<typename... Args>
+    BaseNodeT* _create_node(Args&&... args) {
+        _XNode* p = node_alloc_traits::allocate(_m_alloc, 1);
+        try {
+            node_alloc_traits::construct(_m_alloc, p, std::forward<Args>(args)...);
+        } catch (...) {
+            node_alloc_traits::deallocate(_m_alloc, p, 1);
+            throw;
+        }
+        return p;
+    }
+
+    void _destroy_node(BaseNodeT* n) {
+        if (n) {
+            _XNode* p = static_cast<_XNode*>(n);
+            node_alloc_traits::destroy(_m_alloc, p);
+            node_alloc_traits::deallocate(_m_alloc, p, 1);
+        }
+    }
+
+    /// @brief push a fresh node; it is destroyed again if its key is out of range
+    BaseNodeT* _insert(BaseNodeT *node) {
+        try {
+            return _push(node);
+        } catch (...) {
+            _destroy_node(node);
+            throw;
+        }
+    }
+
+    void _clear(BaseNodeT *list) {
+        while (nullptr != list) {
+            BaseNodeT *node{ list };
+            list = list->_m_next;
+            _destroy_node(node);
+        }
+    }
+
+    node_allocator_type _m_alloc;
+
+  public:
+
+    using allocator_type = Alloc;
+
+    struct iterator {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = _Type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = _Type*;
+        using reference         = _Type&;
+
+        iterator() = default;
+
+        reference operator*()  const { return  static_cast<_XNode*>(_m_ipos)->_m_value; }
+        pointer   operator->() const { return &static_cast<_XNode*>(_m_ipos)->_m_value; }
+
+        iterator& operator++()    { _m_ipos = _m_heap->_iter_succ(_m_ipos); return *this; }
+        iterator  operator++(int) { iterator temp{ *this }; ++*this; return temp; }
+
+        friend bool operator==(const iterator& i1, const iterator& i2) { return i1._m_ipos == i2._m_ipos; }
+        friend bool operator!=(const iterator& i1, const iterator& i2) { return i1._m_ipos != i2._m_ipos; }
+
+    protected:
+        friend RadixHeap;
+
+        const RadixHeapT *_m_heap{ nullptr };
+        BaseNodeT        *_m_ipos{ nullptr };
+
+        iterator(const RadixHeapT *heap, BaseNodeT* ipos) : _m_heap{ heap }, _m_ipos{ ipos } { /*NOP*/ }
+    };
+
+    iterator begin() { return { this, _iter_head() }; }
+    iterator end()   { return { this, nullptr      }; }
+
+    struct const_iterator {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = const _Type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const _Type*;
+        using reference         = const _Type&;
+
+        const_iterator() = default;
+        const_iterator(const iterator &it): _m_heap{ it._m_heap }, _m_ipos{ it._m_ipos } { /*NOP*/ }
+
+        reference operator*()  const { return  static_cast<const _XNode*>(_m_ipos)->_m_value; }
+        pointer   operator->() const { return &static_cast<const _XNode*>(_m_ipos)->_m_value; }
+
+        const_iterator& operator++()    { _m_ipos = _m_heap->_iter_succ(_m_ipos); return *this; }
+        const_iterator  operator++(int) { const_iterator temp{ *this }; ++*this; return temp; }
+
+        friend bool operator==(const const_iterator& i1, const const_iterator& i2) { return i1._m_ipos == i2._m_ipos; }
+        friend bool operator!=(const const_iterator& i1, const const_iterator& i2) { return i1._m_ipos != i2._m_ipos; }
+
+    protected:
+        friend RadixHeap;
+
+        const RadixHeapT *_m_heap{ nullptr };
+        BaseNodeT const  *_m_ipos{ nullptr };
+
+        const_iterator(const RadixHeapT *heap, BaseNodeT const *ipos): _m_heap{ heap }, _m_ipos{ ipos } { /*NOP*/ }
+    };
+
+    const_iterator begin() const { return { this, _iter_head() }; }
+    const_iterator end()   const { return { this, nullptr      }; }
+
+    RadixHeap() { /*NOP*/ }
+
+    /// @note Iterators into @c rhs remain handles for @c decrease(), @c readjust() and
+    ///       @c remove() on this heap, but cannot be advanced any more.
+    RadixHeap(RadixHeap&& rhs) {
+        _take(rhs);
+    }
+    RadixHeap(const RadixHeap & rhs) = delete;
+
+    ~RadixHeap() {
+        _clear(_yield());
+    }
+
+    RadixHeap& operator=(RadixHeap&& rhs) {
+        if (this != &rhs) {
+            _clear(_yield());
+            _take(rhs);
+        }
+        return *this;
+    }
+    RadixHeap& operator=(const RadixHeap &) = delete;
+
+    /// @brief drop all values; as for any empty heap, any key may be pushed afterwards
+    void clear() {
+        _clear(_yield());
+    }
+
+    /// @brief pre-populate the node allocator, if it supports that ( @c NodePoolAllocator does)
+    /// @param n    number of nodes that can be pushed afterwards without allocating memory
+    void reserve(std::size_t n) {
+        node_pool_traits<node_allocator_type>::reserve(_m_alloc, n);
+    }
+
+    /// @throw std::out_of_range if the key is below the key popped last
+    iterator push(const _Type &  rhs) { return { this, _insert(_create_node(rhs           )) }; }
+    iterator push(      _Type && rhs) { return { this, _insert(_create_node(std::move(rhs))) }; }
+
+    template<typename... Args>
+    iterator emplace(Args&&... args) { return { this, _insert(_create_node(std::forward<Args>(args)...)) }; }
+
+    _Type &front() const {
+        if (0 == _m_size) {
+            throw std::invalid_argument("empty");
+        }
+        return static_cast<_XNode*>(_top())->_m_value;
+    }
+
+    void pop() {
+        _destroy_node(_pop());
+    }
+
+    bool empty() const {
+        return 0 == _m_size;
+    }
+
+    std::size_t size() const {
+        return _m_size;
+    }
+
+    /// @brief remove the node the iterator references
+    /// @param itpos node to remove
+    /// @return iterator to successor of @c itpos
+    iterator remove(const iterator &itpos) {
+        BaseNodeT*succ{ _iter_succ(itpos._m_ipos) };
+        _destroy_node(_ncut(itpos._m_ipos));
+        return { this, succ };
+    }
+
+    /// @brief restore heap invariants after key/prio at @c *itpos was reduced
+    /// @param itpos    node that should go closer to the front
+    /// @return         @c itpos for convenience
+    /// @throw std::out_of_range if the key is now below the key popped last; the node keeps
+    ///        its old place then
+    ///
+    /// This is O(1) if the node stays in its bucket.  Other iterators are not affected.
+    iterator decrease(const iterator &itpos) {
+        return { this, _rekey(itpos._m_ipos, _radix(*itpos)) };
+    }
+
+    /// @brief restore heap invariants after key/prio at @c *itpos was changed in any direction
+    /// @param itpos    node that should be re-evaluated for position in heap
+    /// @return         @c itpos for convenience
+    /// @throw std::out_of_range as @c decrease()
+    iterator readjust(const iterator &itpos) {
+        return { this, _rekey(itpos._m_ipos, _radix(*itpos)) };
+    }
+
+    using RadixHeapT::validate_tree;
+};
+
+#endif // RADIXHEAP_9687E0DD_D406_474B_9534_94B7C1D81D33
@@ -0,0 +1,465 @@
+// -------------------------------------------------------------------------------------------
+// Pairing Heap with inline storage for the first few elements
+// -------------------------------------------------------------------------------------------
+// This file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+// Lots of tiny queues -- per connection, per task -- hardly ever hold more than a handful of
+// elements, yet every push into a 'PairingHeap' allocates a node and links it.
+// 'SmallPairingHeap<T, N>' carries N node slots inside the heap object:
+//
+//  - While at most N elements are held, the heap is @e small: the nodes sit in the inline
+//    slots, unlinked from each other except for the root list, and the least one is tracked.
+//    Pushing is a comparison, popping a scan over at most N contiguous nodes.  This is exactly
+//    the root list of the auxiliary twopass heap (see pairpass.hpp) holding singletons only.
+//  - Pushing element N+1 @e spills: the root list is built into a tree by one multipass run
+//    of the pairing pass (or, with 'PairingBoundedPass', carried into its rank list), and
+//    from then on the heap is a plain 'PairingHeap' with '_Pass'.
+//    The inline slots are still used first; further nodes come from the allocator.
+//  - Once the heap runs empty, it is small again.
+//
+// Nodes never move, neither in small mode nor by spilling, so iterators have the same
+// contract as for 'PairingHeap', including 'decrease()' and 'readjust()' across a spill.
+// Since the inline nodes belong to the heap object, moving or merging a heap is O(n) here.
+// -------------------------------------------------------------------------------------------
+#ifndef SMALLHEAP_9687E0DD_D406_474B_9534_94B7C1D81D33
+#define SMALLHEAP_9687E0DD_D406_474B_9534_94B7C1D81D33
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+#include "phqueue3.hpp"
+
+template<
+    typename    _Type,
+    std::size_t _Small = 16,
+    typename    _Comp = std::less<_Type>,
+    typename    Alloc = std::allocator<_Type>,
+    bool        _Inline = false,
+    typename    _Pass = PairingTwoPass >
+class SmallPairingHeap : protected PairingHeapT
+{
+    // --- allocator guard ---
+    static_assert(std::allocator_traits<Alloc>::is_always_equal::value,
+         "SmallPairingHeap requires an allocator with is_always_equal == true");
+
+    // --- comparator guard ---
+    static_assert(std::is_empty<_Comp>::value,
+        "SmallPairingHeap merge, move, or assignment require a stateless comparator");
+
+    // --- capacity guard ---
+    static_assert(_Small > 0 && _Small < 256, "SmallPairingHeap holds 1..255 inline nodes");
+
+protected:
+    using _SmallPass = PairingAuxTwoPass;
+
+    struct _XNode : public BaseNodeT {
+        _Type _m_value;
+
+        template<typename... Args>
+        explicit _XNode(Args&&... args) : _m_value( std::forward<Args>(args)... ) { /*NOP*/ }
+    };
+
+    struct _XSlot {
+        alignas(_XNode) unsigned char _m_raw[sizeof(_XNode)];
+    };
+
+    using node_allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<_XNode>;
+    using node_alloc_traits = std::allocator_traits<node_allocator_type>;
+
+    /// @brief index of the inline slot holding @c node, or @c _Small for an allocated node
+    std::size_t _slot_of(const BaseNodeT *node) const {
+        const void *addr{ static_cast<const _XNode*>(node) };
+        if (std::less<const void*>()(addr, _m_slot) || !std::less<const void*>()(addr, _m_slot + _Small)) {
+            return _Small;
+        }
+        return std::size_t(static_cast<const _XSlot*>(addr) - _m_slot);
+    }
+
+    template<typename... Args>
+    BaseNodeT* _create_node(Args&&... args) {
+        if (0 != _m_nspare) {
+            const std::uint8_t idx{ _m_spare[_m_nspare - 1] };
+            _XNode *p{ ::new (static_cast<void*>(_m_slot + idx)) _XNode(std::forward<Args>(args)...) };
+            --_m_nspare;
+            return p;
+        }
+        _XNode* p = node_alloc_traits::allocate(_m_alloc, 1);
+        try {
+            node_alloc_traits::construct(_m_alloc, p, std::forward<Args>(args)...);
+        } catch (...) {
+            node_alloc_traits::deallocate(_m_alloc, p, 1);
+            throw;
+        }
+        return p;
+    }
+
+    void _destroy_node(BaseNodeT* n) {
+        if (n) {
+            _XNode* p = static_cast<_XNode*>(n);
+            const std::size_t idx{ _slot_of(n) };
+            if (idx < _Small) {
+                p->~_XNode();
+                _m_spare[_m_nspare++] = std::uint8_t(idx);
+            } else {
+                node_alloc_traits::destroy(_m_alloc, p);
+                node_alloc_traits::deallocate(_m_alloc, p, 1);
+            }
+        }
+    }
+
+    struct _XOrder {
+        bool operator()(const BaseNodeT &n1, const BaseNodeT &n2) const {
+            return _Comp()(static_cast<const _XNode&>(n1)._m_value, static_cast<const _XNode&>(n2)._m_value);
+        }
+    };
+
+    bool _pred(const BaseNodeT &n1, const BaseNodeT &n2) const override {
+        return _XOrder()(n1, n2);
+    }
+
+    auto _order() const {
+        if constexpr (_Inline) {
+            return _XOrder();
+        } else {
+            return VirtualOrderT{ this };
+        }
+    }
+
+    /// @brief turn the root list into one tree; the heap is a plain Pairing Heap afterwards
+    void _spill() {
+        if constexpr (_Pass::bounded) {
+            // the singletons are carried into the ranks one by one instead
+            const std::size_t size{ _m_size };
+            for (BaseNodeT *node{ _yield() }, *next; nullptr != node; node = next) {
+                next = node->_m_next;
+                node->_m_prev = node->_m_next = nullptr;
+                _rcarry(_order(), node, 0);
+            }
+            _m_size = size;
+        } else {
+            _consolidate(_order());
+        }
+        if constexpr (!_Pass::auxiliary) {
+            _m_amin = nullptr;
+        }
+        _m_spilled = true;
+    }
+
+    /// @brief go back to small mode once the heap ran empty
+    void _settle() {
+        if (0 == _m_size) {
+            _m_spilled = false;
+            _m_amin = nullptr;
+        }
+    }
+
+    BaseNodeT *_link(BaseNodeT *node) {
+        if (!_m_spilled) {
+            if (_m_size < _Small) {
+                return _push<_SmallPass>(_order(), node);
+            }
+            _spill();
+        }
+        return _push<_Pass>(_order(), node);
+    }
+
+    BaseNodeT *_unlink_top() {
+        BaseNodeT *node;
+        if (!_m_spilled) {
+            node = (nullptr != _m_amin) ? _ncut<_SmallPass>(_order(), _m_amin) : nullptr;
+        } else {
+            node = _pop<_Pass>(_order());
+            _settle();
+        }
+        return node;
+    }
+
+    BaseNodeT *_unlink(BaseNodeT *node) {
+        if (!_m_spilled) {
+            return _ncut<_SmallPass>(_order(), node);
+        }
+        node = _ncut<_Pass>(_order(), node);
+        _settle();
+        return node;
+    }
+
+    void _clear(BaseNodeT *root) {
+        while (nullptr != root) {
+            _destroy_node(_shred_pop(root));
+        }
+        _m_spilled = false;
+    }
+
+    /// @brief take over all values of @c rhs, relinking its allocated nodes
+    void _absorb(SmallPairingHeap &rhs) {
+        BaseNodeT *tree{ rhs._yield() };
+        rhs._m_spilled = false;
+        while (BaseNodeT *node = _shred_pop(tree)) {
+            node->_m_prev = node->_m_next = node->_m_down = nullptr;
+            if (rhs._slot_of(node) < _Small) {
+                BaseNodeT *copy{ nullptr };
+                try {
+                    copy = _create_node(std::move(static_cast<_XNode*>(node)->_m_value));
+                } catch (...) {
+                    rhs._destroy_node(node);
+                    rhs._clear(tree);
+                    throw;
+                }
+                rhs._destroy_node(node);
+                node = copy;
+            }
+            _link(node);
+        }
+    }
+
+    _XSlot              _m_slot[_Small];
+    std::uint8_t        _m_spare[_Small];     // free inline slots, used from the back
+    std::size_t         _m_nspare{ _Small };
+    bool                _m_spilled{ false };
+    node_allocator_type _m_alloc;
+
+  public:
+
+    using allocator_type = Alloc;
+
+    struct iterator {
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type        = _Type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = _Type*;
+        using reference         = _Type&;
+
+        iterator() = default;
+
+        reference operator*()  const { return  static_cast<_XNode*>(_m_ipos)->_m_value; }
+        pointer   operator->() const { return &static_cast<_XNode*>(_m_ipos)->_m_value; }
+
+        iterator& operator++()    { _m_ipos = _iter_succ(_m_ipos); return *this; }
+        iterator  operator++(int) { return { _iter_succ(_m_ipos) }; }
+        iterator& operator--()    { _m_ipos = _iter_pred(_m_ipos); return *this;     }
+        iterator  operator--(int) { return { _iter_pred(_m_ipos) }; }
+
+        friend bool operator==(const iterator& i1, const iterator& i2) { return  ::PairingHeapT::_iter_same(i1._m_ipos, i2._m_ipos); }
+        friend bool operator!=(const iterator& i1, const iterator& i2) { return !::PairingHeapT::_iter_same(i1._m_ipos, i2._m_ipos); }
+
+    protected:
+        friend SmallPairingHeap;
+
+        BaseNodeT *_m_ipos{ nullptr };
+
+        iterator(BaseNodeT* ipos) : _m_ipos{ ipos } { /*NOP*/ }
+    };
+
+    iterator begin() { return { _iter_head() }; }
+    iterator end()   { return { &_m_root     }; }
+
+    struct const_iterator {
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type        = const _Type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const _Type*;
+        using reference         = const _Type&;
+
+        const_iterator() = default;
+        const_iterator(const iterator &it): _m_ipos{ it._m_ipos } { /*NOP*/ }
+
+        reference operator*()  const { return  static_cast<const _XNode*>(_m_ipos)->_m_value; }
+        pointer   operator->() const { return &static_cast<const _XNode*>(_m_ipos)->_m_value; }
+
+        const_iterator& operator++()    { _m_ipos = _iter_succ(_m_ipos); return *this; }
+        const_iterator  operator++(int) { return { _iter_succ(_m_ipos) }; }
+        const_iterator& operator--()    { _m_ipos = _iter_pred(_m_ipos); return *this; }
+        const_iterator  operator--(int) { return { _iter_pred(_m_ipos) }; }
+
+        friend bool operator==(const const_iterator& i1, const const_iterator& i2) { return  ::PairingHeapT::_iter_same(i1._m_ipos, i2._m_ipos); }
+        friend bool operator!=(const const_iterator& i1, const const_iterator& i2) { return !::PairingHeapT::_iter_same(i1._m_ipos, i2._m_ipos); }
+
+    protected:
+        friend SmallPairingHeap;
+
+        BaseNodeT const *_m_ipos{ nullptr };
+
+        const_iterator(BaseNodeT const *ipos): _m_ipos{ ipos } { /*NOP*/ }
+    };
+
+    const_iterator begin() const { return { _iter_head() }; }
+    const_iterator end()   const { return { &_m_root     }; }
+
+    SmallPairingHeap() {
+        for (std::size_t idx{ 0 }; idx < _Small; ++idx) {
+            _m_spare[idx] = std::uint8_t(_Small - 1 - idx);
+        }
+    }
+
+    /// @brief move construction; O(n), as the inline nodes cannot change hands
+    SmallPairingHeap(SmallPairingHeap&& rhs) : SmallPairingHeap() {
+        _absorb(rhs);
+    }
+    SmallPairingHeap(const SmallPairingHeap & rhs) = delete;
+
+    ~SmallPairingHeap() {
+        _clear(_yield());
+    }
+
+    SmallPairingHeap& operator=(SmallPairingHeap&& rhs) {
+        if (this != &rhs) {
+            _clear(_yield());
+            _absorb(rhs);
+        }
+        return *this;
+    }
+    SmallPairingHeap& operator=(const SmallPairingHeap &) = delete;
+
+    /// @brief merge another heap into this one; O(rhs.size())
+    SmallPairingHeap& merge(SmallPairingHeap& rhs) {
+        if (this != &rhs) {
+            _absorb(rhs);
+        }
+        return *this;
+    }
+
+    void clear() {
+        _clear(_yield());
+    }
+
+    /// @brief number of elements held without spilling
+    static constexpr std::size_t small_capacity() { return _Small; }
+
+    /// @brief check if the heap is a tree now
+    bool spilled() const { return _m_spilled; }
+
+    /// @brief pre-populate the node allocator for the nodes beyond the inline ones
+    /// @param n    number of nodes that can be pushed afterwards without allocating memory
+    void reserve(std::size_t n) {
+        if (n > _Small) {
+            node_pool_traits<node_allocator_type>::reserve(_m_alloc, n - _Small);
+        }
+    }
+
+    iterator push(const _Type &  rhs) {  return { _link(_create_node(rhs           ))}; }
+    iterator push(      _Type && rhs) {  return { _link(_create_node(std::move(rhs)))}; }
+
+    template<typename... Args>
+    iterator emplace(Args&&... args) { return { _link(_create_node(std::forward<Args>(args)...)) }; }
+
+    _Type &front() const {
+        if (nullptr == _m_root._m_down) {
+            throw std::invalid_argument("empty");
+        }
+        BaseNodeT *node{ (!_m_spilled || _Pass::auxiliary) ? _m_amin : _m_root._m_down };
+        return static_cast<_XNode*>(node)->_m_value;
+    }
+
+    void pop() {
+        _destroy_node(_unlink_top());
+    }
+
+    /// @brief move the @c k least values out, in order
+    /// @param k    number of values to pop; all of them if @c k >= @c size()
+    /// @param out  output iterator receiving the values
+    /// @return     @c out past the last value written
+    template<typename _OutIt>
+    _OutIt pop_n(std::size_t k, _OutIt out) {
+        for (k = std::min(k, _m_size); k > 0; --k) {
+            _XNode *node{ static_cast<_XNode*>(_unlink_top()) };
+            try {
+                *out = std::move(node->_m_value);
+                ++out;
+            } catch (...) {
+                _destroy_node(node);
+                throw;
+            }
+            _destroy_node(node);
+        }
+        return out;
+    }
+
+    /// @brief move all values out, in order, leaving the heap empty
+    /// @param out  output iterator receiving the values
+    /// @return     @c out past the last value written
+    ///
+    /// The nodes are sorted at once (see listsort.hpp; the root list needs no spill for that).
+    /// If writing a value throws, the values not yet written stay in the heap.
+    template<typename _OutIt>
+    _OutIt drain(_OutIt out) {
+        BaseNodeT *list{ _drain(_order()) };
+        _m_spilled = false;
+        try {
+            while (nullptr != list) {
+                *out = std::move(static_cast<_XNode*>(list)->_m_value);
+                ++out;
+                BaseNodeT *node{ list };
+                list = list->_m_next;
+                _destroy_node(node);
+            }
+        } catch (...) {
+            while (nullptr != list) {
+                BaseNodeT *node{ list };
+                list = list->_m_next;
+                node->_m_next = nullptr;
+                _link(node);
+            }
+            throw;
+        }
+        return out;
+    }
+
+    bool empty() const {
+        return nullptr == _m_root._m_down;
+    }
+
+    std::size_t size() const {
+        return _m_size;
+    }
+
+    /// @brief remove the node the iterator references
+    /// @param itpos node to remove
+    /// @return iterator to successor of @c itpos
+    /// @note This invalidates all other iterators to the same position and distorts all other
+    ///       active iterators for this heap!
+    iterator remove(const iterator &itpos) {
+        BaseNodeT*succ{ _iter_succ(itpos._m_ipos) };
+        _destroy_node(_unlink(itpos._m_ipos));
+        return { succ };
+    }
+
+    /// @brief quickly restore heap invariants after key/prio at @c *itpos was reduced
+    /// @param itpos    node that should go closer to the root
+    /// @return         @c itpos for convenience
+    /// @note This will distort all active iterators for this heap!
+    iterator decrease(const iterator &itpos) {
+        if (!_m_spilled) {
+            return { _decrease<_SmallPass>(_order(), itpos._m_ipos) };
+        }
+        return { _decrease<_Pass>(_order(), itpos._m_ipos) };
+    }
+
+    /// @brief fully restore heap invariants after key/prio at @c *itpos was changed
+    /// @param itpos    node that should be re-evaluated for position in heap
+    /// @return         @c itpos for convenience
+    /// @note This will distort all active iterators for this heap!
+    iterator readjust(const iterator &itpos) {
+        if (!_m_spilled) {
+            return { _reinsert<_SmallPass>(_order(), itpos._m_ipos) };
+        }
+        return { _reinsert<_Pass>(_order(), itpos._m_ipos) };
+    }
+
+    using PairingHeapT::validate_tree;
+    using PairingHeapT::validate_stream;
+    using PairingHeapT::validate_sample;
+    using PairingHeapT::shape_stats;
+};
+
+#endif // SMALLHEAP_9687E0DD_D406_474B_9534_94B7C1D81D33
@@ -0,0 +1,107 @@
+// -------------------------------------------------------------------------------------------
+// Heap snapshots: flat files for a fast warm restart
+// -------------------------------------------------------------------------------------------
+// This file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+// Rebuilding a big heap after a restart, one 'push()' at a time, costs O(N log N) comparisons
+// on cold memory.  A snapshot saves the tree itself: the nodes in pre-order, each record a
+// shape byte telling which children follow, the leaf distance and the raw bytes of the value.
+// Loading maps the file and relinks freshly allocated nodes in one sequential pass, without a
+// single comparison.  If the shape data does not describe a tree, or the caller asks for it
+// ('HeapLoad::rebuild', e.g. since the order changed), the values are built into a heap from
+// scratch, which is O(N) as well.
+//
+//    header    magic, version, value size, node count
+//    record    uint8 shape | uint8 0 | int16 leaf distance | value bytes
+//
+// Values must be trivially copyable and must not point into memory of the saving process;
+// the file is in native byte order.  'save()' writes to "<path>.tmp" first and renames it,
+// so a crash never leaves a torn snapshot under the real name.
+// -------------------------------------------------------------------------------------------
+#ifndef SNAPSHOT_9687E0DD_D406_474B_9534_94B7C1D81D33
+#define SNAPSHOT_9687E0DD_D406_474B_9534_94B7C1D81D33
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/// @brief how @c load() treats the tree structure of a snapshot
+enum class HeapLoad {
+    shape,          ///< relink the saved tree if it is one, rebuild otherwise
+    rebuild         ///< ignore the saved tree, build a heap from the values
+};
+
+struct HeapSnapshotHeader {
+    char          _m_magic[8];
+    std::uint32_t _m_version;
+    std::uint32_t _m_value_size;
+    std::uint64_t _m_count;
+
+    static constexpr std::uint32_t version{ 1 };
+    static constexpr unsigned      left{ 1 }, right{ 2 };   // shape bits of a record
+    static constexpr std::size_t   prefix{ 4 };             // record bytes before the value
+
+    static std::size_t record_size(std::size_t value_size) { return prefix + value_size; }
+};
+
+/// @brief buffered output to "<path>.tmp", renamed to @c path by @c commit()
+class HeapSnapshotWriter
+{
+public:
+    HeapSnapshotWriter(const char *path, std::size_t value_size, std::uint64_t count);
+    ~HeapSnapshotWriter();
+
+    HeapSnapshotWriter(const HeapSnapshotWriter&) = delete;
+    HeapSnapshotWriter& operator=(const HeapSnapshotWriter&) = delete;
+
+    void record(unsigned shape, int dist, const void *value);
+    void commit();
+
+protected:
+    void _flush();
+    void _fail();
+
+    std::string                 _m_path;
+    std::FILE                  *_m_file{ nullptr };
+    std::size_t                 _m_value_size;
+    std::vector<unsigned char>  _m_buf;
+};
+
+/// @brief read-only view of a snapshot file, memory mapped where the platform offers it
+class HeapSnapshotReader
+{
+public:
+    HeapSnapshotReader(const char *path, std::size_t value_size);
+    ~HeapSnapshotReader();
+
+    HeapSnapshotReader(const HeapSnapshotReader&) = delete;
+    HeapSnapshotReader& operator=(const HeapSnapshotReader&) = delete;
+
+    std::size_t          count() const { return _m_count; }
+    std::size_t          record_size() const { return _m_recsz; }
+    const unsigned char *record(std::size_t idx) const { return _m_data + sizeof(HeapSnapshotHeader) + idx * _m_recsz; }
+
+    static unsigned shape(const unsigned char *rec) { return rec[0] & (HeapSnapshotHeader::left | HeapSnapshotHeader::right); }
+    static short    dist(const unsigned char *rec);
+    static const unsigned char *value(const unsigned char *rec) { return rec + HeapSnapshotHeader::prefix; }
+
+    bool is_tree() const;                                   // do the shape bytes make a pre-order tree?
+
+protected:
+    void _unmap();
+
+    const unsigned char        *_m_data{ nullptr };
+    std::size_t                 _m_size{ 0 };
+    std::size_t                 _m_count{ 0 };
+    std::size_t                 _m_recsz{ 0 };
+    bool                        _m_mapped{ false };
+    std::vector<unsigned char>  _m_copy;                    // file contents without mmap
+};
+
+#endif // SNAPSHOT_9687E0DD_D406_474B_9534_94B7C1D81D33
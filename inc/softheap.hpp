@@ -0,0 +1,457 @@
+// -------------------------------------------------------------------------------------------
+// Soft Heap: an approximate priority queue with a bounded share of out-of-order pops
+// -------------------------------------------------------------------------------------------
+// This file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+// The soft heap of Chazelle, in the simplified form of Kaplan, Tarjan and Zwick ("Soft Heaps
+// Simplified", SIAM J. Comput. 42, 2013).  Consumers like load shedding or an approximate
+// top-K can live with a few pops out of order, and the soft heap makes that trade explicit:
+// with an error rate @c eps, at most @c eps*n of the values in the heap are 'corrupted' at
+// any time, where @c n is the number of pushes so far.  A corrupted value is queued under a
+// larger key than its own and may come out late.  All others come out in order.
+//
+// A heap is a list of binary trees in ascending order of rank, one tree per rank at most.
+// Every tree node carries a list of values and a common key for all of them, not below any
+// of their own keys -- the key of the last child list it took over.  The nodes obey the heap
+// order on these keys.  When a node's list runs empty, 'sift' refills it from the child with
+// the smaller key, which in turn refills from its own children, and so on.  Below rank
+// @c r = ceil(log2(9/eps)) a node takes one child list; above it, it takes lists until it has
+// 3/2 times as many values as its children are meant to hold, and those lists share the
+// larger key from then on.
+//
+// Costs, amortised: 'push()' O(log 1/eps), 'pop()' and 'front()' O(1).  A pop takes the head
+// of the list of the root with the least key; only an emptied list costs a sift and the
+// update of the suffix minimum pointers of the roots in front, which the pushes pay for.
+// There is no 'decrease()': a soft heap cannot find a value's place any more.
+// -------------------------------------------------------------------------------------------
+#ifndef SOFTHEAP_9687E0DD_D406_474B_9534_94B7C1D81D33
+#define SOFTHEAP_9687E0DD_D406_474B_9534_94B7C1D81D33
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "keyof.hpp"
+#include "nodepool.hpp"
+
+// -------------------------------------------------------------------------------------------
+// definition of the core functions of a Soft Heap, templated on the tree operations '_Ops'
+// of the typed heap: 'ops(t1, t2)' orders two trees by their keys, 'ops._assign(dst, src)'
+// copies a key, 'ops._make(from, rank)' takes a spare tree node and 'ops._drop(tree)' frees
+// one.  The typed heap allocates the spares a push needs before it starts, so no link fails
+// half way for lack of memory.
+// -------------------------------------------------------------------------------------------
+
+class SoftHeapT
+{
+public:
+    struct BaseNodeT {
+        BaseNodeT *_m_next { nullptr };                    // next value in the list of a tree node
+    };
+
+    struct TreeNodeT {
+        TreeNodeT  *_m_left  { nullptr };                  // children
+        TreeNodeT  *_m_right { nullptr };
+        TreeNodeT  *_m_next  { nullptr };                  // roots only: next root, of a higher rank
+        TreeNodeT  *_m_smin  { nullptr };                  // roots only: root of the least key from here on
+        BaseNodeT  *_m_head  { nullptr };                  // list of values sharing the node's key
+        BaseNodeT  *_m_tail  { nullptr };
+        std::size_t _m_count { 0 };                        // length of the list
+        unsigned    _m_rank  { 0 };
+    };
+
+    static constexpr unsigned _Ranks{ 65 };                // more trees than a 64-bit size allows
+
+    virtual bool _pred(const TreeNodeT &t1, const TreeNodeT &t2) const = 0;   // key order of trees
+    virtual bool _ipred(const BaseNodeT &n1, const TreeNodeT &t2) const = 0;  // value key before tree key
+    virtual bool _tpred(const TreeNodeT &t1, const BaseNodeT &n2) const = 0;  // tree key before value key
+
+    void       _setup(double eps);                         // rank threshold and list targets
+    static bool _leaf(const TreeNodeT* x) { return nullptr == x->_m_left && nullptr == x->_m_right; }
+
+    template<typename _Ops> void       _sift(const _Ops &ops, TreeNodeT *x);                   // refill the list of 'x'
+    template<typename _Ops> TreeNodeT* _link(const _Ops &ops, TreeNodeT *x, TreeNodeT *y);     // join two trees of equal rank
+    template<typename _Ops> void       _insert(const _Ops &ops, TreeNodeT *t);                 // add a rank 0 tree
+    template<typename _Ops> BaseNodeT* _extract(const _Ops &ops);                              // remove the front value
+    template<typename _Ops> void       _rescan(const _Ops &ops, TreeNodeT *x, bool drop);      // roots up to 'x' changed
+
+    unsigned   _carries() const;                           // links the next push will do
+    TreeNodeT* _spare();                                   // a tree node allocated ahead
+    TreeNodeT* _yield();                                   // cut all trees and spares as one list
+    void       _take(SoftHeapT &rhs);                      // move the trees of 'rhs' to an empty heap
+
+    void        validate_tree() const;
+    std::size_t corrupted() const;
+
+    TreeNodeT   *_m_first { nullptr };                     // root list
+    std::size_t  _m_size  { 0 };                           // number of values
+    std::size_t  _m_pushes{ 0 };                           // number of pushes, the 'n' of the error bound
+    double       _m_eps   { 0 };                           // error rate
+    unsigned     _m_rmin  { 0 };                           // ranks up to this one hold a single list
+    std::size_t  _m_target[_Ranks] { };                    // target list length per rank
+    TreeNodeT   *_m_spare { nullptr };                     // tree nodes for the links of a push, via '_m_next'
+    unsigned     _m_nspare{ 0 };
+};
+
+/// @brief refill the emptied list of a node from its children
+/// @param ops  tree operations
+/// @param x    node with an empty list
+///
+/// The child with the smaller key hands over its list and key, and refills its own list the
+/// same way; a child left without values and children is freed.  The recursion goes at most
+/// as deep as the rank of @c x.
+template<typename _Ops>
+void
+SoftHeapT::_sift(
+    const _Ops &ops,
+    TreeNodeT  *x)
+{
+    while (x->_m_count < _m_target[x->_m_rank] && ! _leaf(x)) {
+        if (nullptr == x->_m_left || (nullptr != x->_m_right && ops(*x->_m_right, *x->_m_left))) {
+            std::swap(x->_m_left, x->_m_right);
+        }
+        TreeNodeT *y{ x->_m_left };
+        if (nullptr == x->_m_head) {
+            x->_m_head = y->_m_head;
+        } else {
+            x->_m_tail->_m_next = y->_m_head;
+        }
+        x->_m_tail   = y->_m_tail;
+        x->_m_count += y->_m_count;
+        ops._assign(*x, *y);
+        y->_m_head = y->_m_tail = nullptr;
+        y->_m_count = 0;
+        if (_leaf(y)) {
+            x->_m_left = nullptr;
+            ops._drop(y);
+        } else {
+            _sift(ops, y);
+        }
+    }
+}
+
+/// @brief join two trees of the same rank below a new node
+/// @return the tree of the next rank
+template<typename _Ops>
+SoftHeapT::TreeNodeT*
+SoftHeapT::_link(
+    const _Ops &ops,
+    TreeNodeT  *x,
+    TreeNodeT  *y)
+{
+    assert(x->_m_rank == y->_m_rank);
+    TreeNodeT *z{ ops._make(*x, x->_m_rank + 1) };
+    z->_m_left  = x;
+    z->_m_right = y;
+    x->_m_next = x->_m_smin = y->_m_next = y->_m_smin = nullptr;
+    _sift(ops, z);
+    return z;
+}
+
+/// @brief add a tree of rank 0, carrying it through the roots of equal rank like a counter
+template<typename _Ops>
+void
+SoftHeapT::_insert(
+    const _Ops &ops,
+    TreeNodeT  *t)
+{
+    while (nullptr != _m_first && _m_first->_m_rank == t->_m_rank) {
+        TreeNodeT *x{ _m_first };
+        _m_first = x->_m_next;
+        t = _link(ops, x, t);
+    }
+    // the roots behind keep their suffix minima
+    t->_m_next = _m_first;
+    t->_m_smin = (nullptr != _m_first && ops(*_m_first->_m_smin, *t)) ? _m_first->_m_smin : t;
+    _m_first   = t;
+}
+
+/// @brief remove and return the head of the list of the least root
+template<typename _Ops>
+SoftHeapT::BaseNodeT*
+SoftHeapT::_extract(
+    const _Ops &ops)
+{
+    TreeNodeT *x{ _m_first->_m_smin };
+    BaseNodeT *node{ x->_m_head };
+    if (nullptr == (x->_m_head = node->_m_next)) {
+        x->_m_tail = nullptr;
+    }
+    node->_m_next = nullptr;
+    --_m_size;
+    if (0 == --x->_m_count) {
+        // the key of the root goes up, or the root goes away
+        const bool drop{ _leaf(x) };
+        if ( ! drop) {
+            _sift(ops, x);
+        }
+        _rescan(ops, x, drop);
+    }
+    return node;
+}
+
+/// @brief renew the suffix minima of the roots up to @c x, after its key changed
+/// @param ops  tree operations
+/// @param x    root whose key changed
+/// @param drop @c x is empty and to be removed
+template<typename _Ops>
+void
+SoftHeapT::_rescan(
+    const _Ops &ops,
+    TreeNodeT  *x,
+    bool        drop)
+{
+    TreeNodeT  *prefix[_Ranks];
+    unsigned    count{ 0 };
+    TreeNodeT **link{ &_m_first };
+
+    for (; *link != x; link = &(*link)->_m_next) {
+        prefix[count++] = *link;
+    }
+    if (drop) {
+        *link = x->_m_next;
+        ops._drop(x);
+    } else {
+        prefix[count++] = x;
+    }
+    while (count-- > 0) {
+        TreeNodeT *root{ prefix[count] };
+        TreeNodeT *next{ root->_m_next };
+        root->_m_smin = (nullptr != next && ops(*next->_m_smin, *root)) ? next->_m_smin : root;
+    }
+}
+
+// -----------------------------------------------------------------------------------------------
+// SoftHeap -- approximate priority queue of values, ordered by '_Comp' up to @c eps*n corrupted
+//
+// The key of a tree node is a copy of a value's key: the value itself, or with @c _KeyOf (see
+// keyof.hpp) the key extracted from it, which then must be copy assignable.  Values never
+// move, but they have no handles either: a soft heap can't tell where a value went.
+// -----------------------------------------------------------------------------------------------
+
+template<
+    typename _Type,
+    typename _Comp = std::less<_Type>,
+    typename Alloc = std::allocator<_Type>,
+    typename _KeyOf = IdentityKey >
+class SoftHeap : protected SoftHeapT
+{
+    // --- allocator guard ---
+    static_assert(std::allocator_traits<Alloc>::is_always_equal::value,
+         "SoftHeap requires an allocator with is_always_equal == true");
+
+    // --- comparator guard ---
+    static_assert(std::is_empty<_Comp>::value,
+        "SoftHeap move or assignment require a stateless comparator");
+
+protected:
+    using key_type = typename HeapKeyT<_Type, _KeyOf>::key_type;
+
+    struct _XNode : public BaseNodeT {
+        _Type _m_value;
+
+        template<typename... Args>
+        explicit _XNode(Args&&... args) : _m_value( std::forward<Args>(args)... ) { /*NOP*/ }
+
+        decltype(auto) _cmp_key() const { return HeapKeyT<_Type, _KeyOf>::_extract(_m_value); }
+    };
+
+    struct _XTree : public TreeNodeT {
+        key_type _m_ckey;
+
+        template<typename... Args>
+        explicit _XTree(Args&&... args) : _m_ckey( std::forward<Args>(args)... ) { /*NOP*/ }
+    };
+
+    using node_allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<_XNode>;
+    using node_alloc_traits = std::allocator_traits<node_allocator_type>;
+    using tree_allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<_XTree>;
+    using tree_alloc_traits = std::allocator_traits<tree_allocator_type>;
+
+    template<typename _Traits, typename _Alloc, typename... Args>
+    static auto _create(_Alloc &alloc, Args&&... args) {
+        auto *p = _Traits::allocate(alloc, 1);
+        try {
+            _Traits::construct(alloc, p, std::forward<Args>(args)...);
+        } catch (...) {
+            _Traits::deallocate(alloc, p, 1);
+            throw;
+        }
+        return p;
+    }
+
+    void _destroy_node(BaseNodeT* n) {
+        if (n) {
+            _XNode* p = static_cast<_XNode*>(n);
+            node_alloc_traits::destroy(_m_alloc, p);
+            node_alloc_traits::deallocate(_m_alloc, p, 1);
+        }
+    }
+
+    void _destroy_tree(TreeNodeT* t) {
+        if (t) {
+            _XTree* p = static_cast<_XTree*>(t);
+            tree_alloc_traits::destroy(_m_talloc, p);
+            tree_alloc_traits::deallocate(_m_talloc, p, 1);
+        }
+    }
+
+    static const key_type &_tkey(const TreeNodeT &t) { return static_cast<const _XTree&>(t)._m_ckey; }
+
+    /// tree operations for the core functions
+    struct _XOps {
+        SoftHeap *_m_heap;
+
+        bool operator()(const TreeNodeT &t1, const TreeNodeT &t2) const { return _Comp()(_tkey(t1), _tkey(t2)); }
+        void _assign(TreeNodeT &dst, const TreeNodeT &src) const { static_cast<_XTree&>(dst)._m_ckey = _tkey(src); }
+        TreeNodeT* _make(const TreeNodeT &from, unsigned rank) const {
+            TreeNodeT *t{ _m_heap->_spare() };
+            _assign(*t, from);
+            t->_m_rank = rank;
+            return t;
+        }
+        void _drop(TreeNodeT *t) const { _m_heap->_destroy_tree(t); }
+    };
+
+    _XOps _ops() { return { this }; }
+
+    bool _pred(const TreeNodeT &t1, const TreeNodeT &t2) const override {
+        return _Comp()(_tkey(t1), _tkey(t2));
+    }
+    bool _ipred(const BaseNodeT &n1, const TreeNodeT &t2) const override {
+        return _Comp()(static_cast<const _XNode&>(n1)._cmp_key(), _tkey(t2));
+    }
+    bool _tpred(const TreeNodeT &t1, const BaseNodeT &n2) const override {
+        return _Comp()(_tkey(t1), static_cast<const _XNode&>(n2)._cmp_key());
+    }
+
+    /// @brief wrap a fresh value node into a tree of rank 0 and add it
+    void _add(BaseNodeT *node) {
+        const auto &key{ static_cast<_XNode*>(node)->_cmp_key() };
+        try {
+            for (unsigned need{ _carries() + 1 }; _m_nspare < need; ++_m_nspare) {
+                TreeNodeT *t{ _create<tree_alloc_traits>(_m_talloc, key) };
+                t->_m_next = _m_spare;
+                _m_spare   = t;
+            }
+        } catch (...) {
+            _destroy_node(node);
+            throw;
+        }
+        TreeNodeT *t{ _spare() };
+        static_cast<_XTree*>(t)->_m_ckey = key;
+        t->_m_head = t->_m_tail = node;
+        t->_m_count = 1;
+        _insert(_ops(), t);
+        ++_m_size;
+        ++_m_pushes;
+    }
+
+    void _clear(TreeNodeT *tree) {
+        while (nullptr != tree) {
+            TreeNodeT *next{ tree->_m_next };
+            _clear(tree->_m_left);
+            _clear(tree->_m_right);
+            for (BaseNodeT *node{ tree->_m_head }; nullptr != node; /*NOP*/) {
+                BaseNodeT *succ{ node->_m_next };
+                _destroy_node(node);
+                node = succ;
+            }
+            _destroy_tree(tree);
+            tree = next;
+        }
+    }
+
+    node_allocator_type _m_alloc;
+    tree_allocator_type _m_talloc;
+
+  public:
+
+    using allocator_type = Alloc;
+
+    /// @brief empty heap
+    /// @param eps  share of corrupted values allowed, in (0, 1)
+    /// @throw std::invalid_argument if @c eps is out of range
+    explicit SoftHeap(double eps = 0.1) {
+        _setup(eps);
+    }
+
+    SoftHeap(SoftHeap&& rhs) {
+        _take(rhs);
+    }
+    SoftHeap(const SoftHeap & rhs) = delete;
+
+    ~SoftHeap() {
+        _clear(_yield());
+    }
+
+    SoftHeap& operator=(SoftHeap&& rhs) {
+        if (this != &rhs) {
+            _clear(_yield());
+            _take(rhs);
+        }
+        return *this;
+    }
+    SoftHeap& operator=(const SoftHeap &) = delete;
+
+    /// @brief drop all values; the error bound starts over
+    void clear() {
+        _clear(_yield());
+    }
+
+    /// @brief pre-populate the value node allocator, if it supports that ( @c NodePoolAllocator does)
+    void reserve(std::size_t n) {
+        node_pool_traits<node_allocator_type>::reserve(_m_alloc, n);
+    }
+
+    void push(const _Type &  rhs) { _add(_create<node_alloc_traits>(_m_alloc, rhs)); }
+    void push(      _Type && rhs) { _add(_create<node_alloc_traits>(_m_alloc, std::move(rhs))); }
+
+    template<typename... Args>
+    void emplace(Args&&... args) { _add(_create<node_alloc_traits>(_m_alloc, std::forward<Args>(args)...)); }
+
+    /// @brief the value the next @c pop() removes: in order, unless it is corrupted
+    _Type &front() const {
+        if (0 == _m_size) {
+            throw std::invalid_argument("empty");
+        }
+        return static_cast<_XNode*>(_m_first->_m_smin->_m_head)->_m_value;
+    }
+
+    void pop() {
+        if (0 != _m_size) {
+            _destroy_node(_extract(_ops()));
+        }
+    }
+
+    bool empty() const {
+        return 0 == _m_size;
+    }
+
+    std::size_t size() const {
+        return _m_size;
+    }
+
+    /// @brief the error rate the heap was made with
+    double epsilon() const {
+        return _m_eps;
+    }
+
+    /// @brief number of pushes so far; at most @c epsilon() times as many values are corrupted
+    std::size_t pushes() const {
+        return _m_pushes;
+    }
+
+    using SoftHeapT::validate_tree;
+    using SoftHeapT::corrupted;
+};
+
+#endif // SOFTHEAP_9687E0DD_D406_474B_9534_94B7C1D81D33
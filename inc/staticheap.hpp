@@ -0,0 +1,410 @@
+// -------------------------------------------------------------------------------------------
+// Static Heaps: fixed capacity, nodes inside the heap object, constexpr in C++20
+// -------------------------------------------------------------------------------------------
+// This file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+// Embedded and real-time code may not allocate after startup.  The heaps here hold at most
+// N values in a 'std::array' of N nodes inside the heap object, and never allocate:
+//
+//   StaticPairingHeap<T, N>    the forward-only Pairing Heap, on the index-linked core of
+//                              'CompactPairingHeap' (see compact.hpp); the index type is the
+//                              smallest unsigned type holding N
+//   StaticLeftistHeap<T, N>    the forward-only Leftist Heap, on the pointer-linked core of
+//                              'LeftistHeapEasy' (see lhqueue2.hpp)
+//
+// Both run the merge and build algorithms of the dynamic heaps, not copies of them.  Popped
+// nodes go to an intrusive free list chained through the node links; nodes not in use since
+// construction or 'clear()' sit above a high-water mark, so neither costs anything per node.
+//
+// Pushing into a full heap throws 'std::length_error'; 'try_push()' and 'try_pop()' report by
+// their result instead.  Values must be default-constructible, since the node array is; a
+// popped value stays in its node until the node is reused.
+//
+// With C++20, everything but 'validate_tree()' is constexpr, given a constexpr comparator,
+// so a schedule can be built at compile time and baked into the binary:
+//
+//   constexpr StaticPairingHeap<Job, 16> jobs{ ... };
+//
+// A Leftist Heap links its nodes by pointer, which copying the heap rebases into the new
+// array; a constexpr 'StaticLeftistHeap' variable needs static storage duration (a pointer
+// into an automatic object is no constant expression).
+// -------------------------------------------------------------------------------------------
+#ifndef STATICHEAP_9687E0DD_D406_474B_9534_94B7C1D81D33
+#define STATICHEAP_9687E0DD_D406_474B_9534_94B7C1D81D33
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "compact.hpp"
+#include "lhqueue2.hpp"
+
+/// @brief the smallest unsigned type indexing @c _Cap nodes, the largest value left for @c npos
+template<std::size_t _Cap>
+using static_heap_index_t =
+    std::conditional_t<(_Cap < 0xffULL),   std::uint8_t,
+    std::conditional_t<(_Cap < 0xffffULL), std::uint16_t,
+                                           std::uint32_t>>;
+
+template<typename    _Type,
+         std::size_t _Cap,
+         typename    _Comp = std::less<_Type>,
+         typename    _Pass = PairingTwoPass >
+class StaticPairingHeap : protected CompactPairingHeapT<static_heap_index_t<_Cap>>
+{
+    using _Base = CompactPairingHeapT<static_heap_index_t<_Cap>>;
+    using _Index = typename _Base::index_type;
+    using typename _Base::LinkT;
+    using _Base::npos;
+
+    // --- capacity guard ---
+    static_assert(_Cap > 0 && _Cap < 0xffffffffULL, "StaticPairingHeap holds 1..2^32-2 nodes");
+
+    // --- comparator guard ---
+    static_assert(std::is_empty<_Comp>::value,
+        "StaticPairingHeap requires a stateless comparator");
+
+protected:
+    struct _XNode : public LinkT {
+        _Type _m_value{};
+    };
+
+    struct _XOrder {
+        constexpr bool operator()(const _XNode &n1, const _XNode &n2) const { return _Comp()(n1._m_value, n2._m_value); }
+    };
+
+    std::array<_XNode, _Cap> _m_nodes{};
+    std::size_t              _m_used{ 0 };      // high-water mark: nodes from here up are not in use
+
+    /// @brief take a node off the free list or from above the high-water mark
+    /// @return @c npos if the heap is full
+    ///
+    /// Either way the links are cleared: after a @c clear(), the nodes from the high-water
+    /// mark up still hold the links of their former tree.
+    template<typename _Arg>
+    constexpr _Index _create_node(_Arg &&value) {
+        _Index node{ this->_m_free };
+        if (npos != node) {
+            this->_m_free = _m_nodes[node]._m_next;
+        } else if (_m_used < _Cap) {
+            node = _Index(_m_used++);
+        } else {
+            return npos;
+        }
+        _m_nodes[node]._m_next = _m_nodes[node]._m_down = npos;
+        _m_nodes[node]._m_value = std::forward<_Arg>(value);
+        return node;
+    }
+
+    template<typename _Arg>
+    constexpr bool _insert(_Arg &&value) {
+        const _Index node{ _create_node(std::forward<_Arg>(value)) };
+        if (npos == node) {
+            return false;
+        }
+        this->_push(_XOrder(), _m_nodes.data(), node);
+        return true;
+    }
+
+public:
+    using value_type = _Type;
+    using index_type = _Index;
+
+    /// size of one node in bytes
+    static constexpr std::size_t node_size = sizeof(_XNode);
+
+    constexpr StaticPairingHeap()
+    { /*NOP*/ }
+
+    constexpr StaticPairingHeap(std::initializer_list<_Type> values) {
+        push(values.begin(), values.end());
+    }
+
+    /// @brief the fixed number of nodes
+    static constexpr std::size_t capacity() { return _Cap; }
+
+    constexpr bool        empty() const { return npos == this->_m_root; }
+    constexpr bool        full() const { return _Cap == this->_m_size; }
+    constexpr std::size_t size() const { return this->_m_size; }
+
+    /// @brief push a value, if there is room
+    /// @return @c false if the heap was full
+    constexpr bool try_push(const _Type &  value) { return _insert(value); }
+    constexpr bool try_push(      _Type && value) { return _insert(std::move(value)); }
+
+    constexpr void push(const _Type &  value) {
+        if (!_insert(value)) {
+            throw std::length_error("StaticPairingHeap is full");
+        }
+    }
+    constexpr void push(_Type && value) {
+        if (!_insert(std::move(value))) {
+            throw std::length_error("StaticPairingHeap is full");
+        }
+    }
+
+    /// @brief batch insert in O(N), by one pairing pass over the new nodes
+    ///
+    /// All or nothing: throws @c std::length_error before pushing anything if the values do
+    /// not fit.
+    template <typename It>
+    constexpr void push(It first, It last) {
+        using category = typename std::iterator_traits<It>::iterator_category;
+        static_assert(std::is_base_of<std::forward_iterator_tag, category>::value, "push() requires a forward iterator");
+        if (std::size_t(std::distance(first, last)) > _Cap - this->_m_size) {
+            throw std::length_error("StaticPairingHeap is full");
+        }
+        _Index      head{ npos };
+        std::size_t count{ 0 };
+        for (; first != last; ++first, ++count) {
+            const _Index node{ _create_node(*first) };
+            _m_nodes[node]._m_next = head;
+            head = node;
+        }
+        _XNode *nodes{ _m_nodes.data() };
+        this->_m_root = this->_merge(_XOrder(), nodes, this->_m_root, this->template _build<_Pass>(_XOrder(), nodes, head));
+        this->_m_size += count;
+    }
+
+    constexpr const _Type &front() const {
+        if (npos == this->_m_root) {
+            throw std::invalid_argument("empty");
+        }
+        return _m_nodes[this->_m_root]._m_value;
+    }
+
+    constexpr void pop() {
+        const _Index node{ this->template _pop<_Pass>(_XOrder(), _m_nodes.data()) };
+        if (npos == node) {
+            throw std::invalid_argument("empty");
+        }
+        this->_release(_m_nodes.data(), node);
+    }
+
+    /// @brief pop the least value, if any
+    /// @return @c false if the heap was empty
+    constexpr bool try_pop(_Type &out) {
+        const _Index node{ this->template _pop<_Pass>(_XOrder(), _m_nodes.data()) };
+        if (npos == node) {
+            return false;
+        }
+        out = std::move(_m_nodes[node]._m_value);
+        this->_release(_m_nodes.data(), node);
+        return true;
+    }
+
+    /// @brief drop all values, in O(1)
+    constexpr void clear() {
+        this->_m_root = this->_m_free = npos;
+        this->_m_size = 0;
+        _m_used = 0;
+    }
+
+    void validate_tree() const {
+        this->_validate(_XOrder(), _m_nodes.data(), _m_used);
+    }
+};
+
+// -------------------------------------------------------------------------------------------
+
+template<typename    _Type,
+         std::size_t _Cap,
+         typename    _Comp = std::less<_Type> >
+class StaticLeftistHeap : protected LeftistHeapEasyT
+{
+    // --- capacity guard ---
+    static_assert(_Cap > 0, "StaticLeftistHeap holds at least one node");
+
+    // --- comparator guard ---
+    static_assert(std::is_empty<_Comp>::value,
+        "StaticLeftistHeap requires a stateless comparator");
+
+protected:
+    struct _XNode : public BaseNodeT {
+        _Type _m_value{};
+    };
+
+    struct _XOrder {
+        constexpr bool operator()(const BaseNodeT &n1, const BaseNodeT &n2) const {
+            return _Comp()(static_cast<const _XNode&>(n1)._m_value, static_cast<const _XNode&>(n2)._m_value);
+        }
+    };
+
+    bool _pred(const BaseNodeT &n1, const BaseNodeT &n2) const override {
+        return _XOrder()(n1, n2);
+    }
+
+    std::array<_XNode, _Cap> _m_nodes{};
+    std::size_t              _m_used{ 0 };      // high-water mark: nodes from here up are not in use
+    BaseNodeT               *_m_free{ nullptr };    // free list, chained via '_m_rptr'
+
+    /// @brief take a node off the free list or from above the high-water mark
+    /// @return @c nullptr if the heap is full
+    template<typename _Arg>
+    constexpr BaseNodeT *_create_node(_Arg &&value) {
+        _XNode *node{ nullptr };
+        if (nullptr != _m_free) {
+            node = static_cast<_XNode*>(_m_free);
+            _m_free = _m_free->_m_rptr;
+        } else if (_m_used < _Cap) {
+            node = &_m_nodes[_m_used++];
+        } else {
+            return nullptr;
+        }
+        node->_m_value = std::forward<_Arg>(value);
+        return _singleton(node);
+    }
+
+    constexpr void _release(BaseNodeT *node) {
+        _m_free = _cons(node, _m_free);
+    }
+
+    template<typename _Arg>
+    constexpr bool _insert(_Arg &&value) {
+        BaseNodeT *node{ _create_node(std::forward<_Arg>(value)) };
+        if (nullptr == node) {
+            return false;
+        }
+        _push(_XOrder(), node);
+        return true;
+    }
+
+    /// @brief the node of this heap in the place of @c node of @c rhs
+    constexpr BaseNodeT *_local(const StaticLeftistHeap &rhs, const BaseNodeT *node) {
+        return (nullptr == node) ? nullptr
+             : &_m_nodes[std::size_t(static_cast<const _XNode*>(node) - rhs._m_nodes.data())];
+    }
+
+    /// @brief point all links copied from @c rhs into the own node array
+    ///
+    /// All nodes, not only those below the high-water mark: after a @c clear() the others
+    /// still hold stale links, which must not point into @c rhs either.
+    constexpr void _rehome(const StaticLeftistHeap &rhs) {
+        _m_root = _local(rhs, rhs._m_root);
+        _m_free = _local(rhs, rhs._m_free);
+        for (std::size_t idx{ 0 }; idx < _Cap; ++idx) {
+            _m_nodes[idx]._m_lptr = _local(rhs, rhs._m_nodes[idx]._m_lptr);
+            _m_nodes[idx]._m_rptr = _local(rhs, rhs._m_nodes[idx]._m_rptr);
+        }
+    }
+
+public:
+    using value_type = _Type;
+
+    /// size of one node in bytes
+    static constexpr std::size_t node_size = sizeof(_XNode);
+
+    constexpr StaticLeftistHeap()
+    { /*NOP*/ }
+
+    constexpr StaticLeftistHeap(std::initializer_list<_Type> values) {
+        push(values.begin(), values.end());
+    }
+
+    /// @brief copy, with the links rebased into the own node array; moving copies, too
+    constexpr StaticLeftistHeap(const StaticLeftistHeap &rhs)
+        : LeftistHeapEasyT(rhs), _m_nodes{ rhs._m_nodes }, _m_used{ rhs._m_used } {
+        _rehome(rhs);
+    }
+
+    constexpr StaticLeftistHeap &operator=(const StaticLeftistHeap &rhs) {
+        if (this != &rhs) {
+            _m_nodes = rhs._m_nodes;
+            _m_used  = rhs._m_used;
+            _m_size  = rhs._m_size;
+            _rehome(rhs);
+        }
+        return *this;
+    }
+
+    /// @brief the fixed number of nodes
+    static constexpr std::size_t capacity() { return _Cap; }
+
+    constexpr bool        empty() const { return nullptr == _m_root; }
+    constexpr bool        full() const { return _Cap == _m_size; }
+    constexpr std::size_t size() const { return _m_size; }
+
+    /// @brief push a value, if there is room
+    /// @return @c false if the heap was full
+    constexpr bool try_push(const _Type &  value) { return _insert(value); }
+    constexpr bool try_push(      _Type && value) { return _insert(std::move(value)); }
+
+    constexpr void push(const _Type &  value) {
+        if (!_insert(value)) {
+            throw std::length_error("StaticLeftistHeap is full");
+        }
+    }
+    constexpr void push(_Type && value) {
+        if (!_insert(std::move(value))) {
+            throw std::length_error("StaticLeftistHeap is full");
+        }
+    }
+
+    /// @brief batch insert in O(N), by @c LeftistHeapEasyT::_build()
+    ///
+    /// All or nothing: throws @c std::length_error before pushing anything if the values do
+    /// not fit.
+    template <typename It>
+    constexpr void push(It first, It last) {
+        using category = typename std::iterator_traits<It>::iterator_category;
+        static_assert(std::is_base_of<std::forward_iterator_tag, category>::value, "push() requires a forward iterator");
+        if (std::size_t(std::distance(first, last)) > _Cap - _m_size) {
+            throw std::length_error("StaticLeftistHeap is full");
+        }
+        BaseNodeT *head{ nullptr };
+        for (; first != last; ++first) {
+            head = _cons(_create_node(*first), head);
+        }
+        _push_list(_XOrder(), head);
+    }
+
+    constexpr const _Type &front() const {
+        if (nullptr == _m_root) {
+            throw std::invalid_argument("empty");
+        }
+        return static_cast<const _XNode*>(_m_root)->_m_value;
+    }
+
+    constexpr void pop() {
+        BaseNodeT *node{ _pop(_XOrder()) };
+        if (nullptr == node) {
+            throw std::invalid_argument("empty");
+        }
+        _release(node);
+    }
+
+    /// @brief pop the least value, if any
+    /// @return @c false if the heap was empty
+    constexpr bool try_pop(_Type &out) {
+        BaseNodeT *node{ _pop(_XOrder()) };
+        if (nullptr == node) {
+            return false;
+        }
+        out = std::move(static_cast<_XNode*>(node)->_m_value);
+        _release(node);
+        return true;
+    }
+
+    /// @brief drop all values, in O(1)
+    constexpr void clear() {
+        _m_root = _m_free = nullptr;
+        _m_size = 0;
+        _m_used = 0;
+    }
+
+    void validate_tree() const {
+        LeftistHeapEasyT::validate_tree(_m_size);
+    }
+};
+
+#endif // STATICHEAP_9687E0DD_D406_474B_9534_94B7C1D81D33
@@ -0,0 +1,273 @@
+// -------------------------------------------------------------------------------------------
+// TimerQueue: deadlines on a MinDistHeap, with cancellation and one-sweep expiry
+// -------------------------------------------------------------------------------------------
+// This file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+// 'TimerQueue<P, Clock>' keeps timers -- a deadline and a payload of type P -- in a MinDistHeap
+// ordered by deadline, and by scheduling order among equal deadlines.  What the heap offers
+// maps onto a timer queue directly:
+//
+//  - 'schedule()' returns the heap iterator of the timer as its handle.  Handles stay valid
+//    until the timer expires or is cancelled, whatever happens to the other timers;
+//  - 'cancel()' removes the node by its handle, and 'reschedule()' moves it by 'readjust()',
+//    both in O(log N);
+//  - 'expire_until()' takes all timers due at some point in one sweep of the heap (see
+//    'MinDistHeap::pop_while()') and hands them to a callback as one batch, in order.
+//
+// With C++20 coroutines, 'sleep_until()' makes an awaitable for a 'TimerQueue<TimerWakeup>':
+// awaiting it schedules the suspended coroutine, 'resume_until()' resumes what is due, and
+// the sleeper keeps the timer handle for 'cancel()' until its timer expires.  The queue owns
+// the coroutines suspended on it: 'clear()' and the destructor disarm their sleepers and
+// destroy them, as nothing could resume them any more.
+// -------------------------------------------------------------------------------------------
+#ifndef TIMERQUEUE_9687E0DD_D406_474B_9534_94B7C1D81D33
+#define TIMERQUEUE_9687E0DD_D406_474B_9534_94B7C1D81D33
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+# if __has_include(<coroutine>)
+#  include <coroutine>
+#  define PQ_TIMER_COROUTINES 1
+# endif
+#endif
+
+#include "mdqueue3.hpp"
+
+#if defined(PQ_TIMER_COROUTINES)
+/// @brief payload of a timer a coroutine sleeps on: the coroutine, and the flag telling its
+///        sleeper that the timer is still pending
+struct TimerWakeup {
+    std::coroutine_handle<> co;
+    bool                   *armed{ nullptr };
+
+    void resume() const { co.resume(); }
+};
+#endif
+
+template<typename _Payload,
+         typename _Clock = std::chrono::steady_clock,
+         typename Alloc = std::allocator<_Payload> >
+class TimerQueue
+{
+public:
+    using clock_type = _Clock;
+    using time_point = typename _Clock::time_point;
+
+    struct timer {
+        time_point    due;
+        std::uint64_t seq;          // scheduling order, breaks the tie between equal deadlines
+        _Payload      payload;
+    };
+
+protected:
+    struct _XEarlier {
+        bool operator()(const timer &t1, const timer &t2) const {
+            return (t1.due < t2.due) || (!(t2.due < t1.due) && (t1.seq < t2.seq));
+        }
+    };
+
+    using timer_allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<timer>;
+    using heap_type = MinDistHeap<timer, _XEarlier, timer_allocator_type, true>;
+
+    heap_type          _m_heap;
+    std::uint64_t      _m_seq{ 0 };
+    std::vector<timer> _m_batch;    // kept for its capacity between the sweeps
+
+public:
+    TimerQueue() = default;
+    TimerQueue(TimerQueue &&) = default;
+    ~TimerQueue() { clear(); }
+
+    TimerQueue& operator=(TimerQueue &&rhs) {
+        if (this != &rhs) {
+            clear();
+            _m_heap = std::move(rhs._m_heap);
+            _m_seq  = rhs._m_seq;
+        }
+        return *this;
+    }
+
+    /// @brief handle of a scheduled timer: @c h->due and @c h->payload may be read, but the
+    ///        deadline changes through @c reschedule() only
+    using handle = typename heap_type::iterator;
+
+    /// @brief pre-populate the node allocator (see @c MinDistHeap::reserve())
+    void reserve(std::size_t n) { _m_heap.reserve(n); }
+
+    handle schedule(time_point due, const _Payload &  payload) { return _m_heap.push(timer{ due, _m_seq++, payload }); }
+    handle schedule(time_point due,       _Payload && payload) { return _m_heap.push(timer{ due, _m_seq++, std::move(payload) }); }
+
+    /// @brief remove a timer before it expires
+    /// @param h    handle of a pending timer; invalid afterwards
+    /// @return     the payload of the timer
+    _Payload cancel(handle h) {
+        _Payload retv{ std::move(h->payload) };
+        _m_heap.remove(h);
+        return retv;
+    }
+
+    /// @brief move a pending timer to another deadline
+    /// @param h    handle of a pending timer; it stays valid
+    /// @param due  new deadline; the timer goes behind those already due at the same time
+    /// @return     @c h for convenience
+    handle reschedule(handle h, time_point due) {
+        h->due = due;
+        h->seq = _m_seq++;
+        return _m_heap.readjust(h);
+    }
+
+    /// @brief the earliest deadline, or @c time_point::max() if no timer is pending
+    time_point next_due() const {
+        return _m_heap.empty() ? time_point::max() : _m_heap.front().due;
+    }
+
+    /// @brief expire all timers due at @c now, in one sweep
+    /// @param now  point in time; timers with @c due <= @c now expire
+    /// @param fn   callback taking a @c std::vector<timer>& with the expired timers, in order;
+    ///             not called if there are none
+    /// @return     number of timers expired
+    ///
+    /// The expired timers are off the queue before @c fn runs, so it may schedule, cancel and
+    /// even expire other timers.  A throwing callback loses the rest of its batch.
+    template<typename _Fn>
+    std::size_t expire_until(time_point now, _Fn &&fn) {
+        std::vector<timer> batch;
+        batch.swap(_m_batch);       // a nested call starts from an empty vector
+        _m_heap.pop_while([now](const timer &item) { return !(now < item.due); }, std::back_inserter(batch));
+        const std::size_t count{ batch.size() };
+#if defined(PQ_TIMER_COROUTINES)
+        // the whole batch is off the queue: no sleeper must try to cancel its timer any more
+        if constexpr (std::is_same<_Payload, TimerWakeup>::value) {
+            for (timer &item : batch) {
+                *item.payload.armed = false;
+            }
+        }
+#endif
+        if (0 != count) {
+            try {
+                fn(batch);
+            } catch (...) {
+                batch.clear();
+                _m_batch.swap(batch);
+                throw;
+            }
+        }
+        batch.clear();
+        _m_batch.swap(batch);
+        return count;
+    }
+
+    bool        empty() const { return _m_heap.empty(); }
+    std::size_t size() const { return _m_heap.size(); }
+
+    /// @brief drop all pending timers, without calling anything
+    ///
+    /// For a @c TimerQueue<TimerWakeup> this disarms the sleepers of all pending timers first
+    /// and then destroys their coroutines.  Destroying a coroutine runs its destructors, which
+    /// may still reach a sleeper of this queue, but find it disarmed; timers they schedule go
+    /// the same way.
+    void clear() {
+#if defined(PQ_TIMER_COROUTINES)
+        if constexpr (std::is_same<_Payload, TimerWakeup>::value) {
+            while (!_m_heap.empty()) {
+                heap_type pending{ std::move(_m_heap) };
+                for (timer &item : pending) {
+                    *item.payload.armed = false;
+                }
+                for (timer &item : pending) {
+                    item.payload.co.destroy();
+                }
+            }
+            return;
+        }
+#endif
+        _m_heap.clear();
+    }
+
+    void validate_tree() const { _m_heap.validate_tree(); }
+
+#if defined(PQ_TIMER_COROUTINES)
+    /// @brief awaitable made by @c sleep_until()
+    ///
+    /// While its timer is pending, the sleeper is armed and holds the handle of the timer, so
+    /// whoever can reach the sleeper may @c cancel() or @c reschedule() it.  Expiry disarms
+    /// the sleepers of a whole batch before the first coroutine of it is resumed.  The queue
+    /// points to the sleeper while armed, so it lives where it is made, in the coroutine frame.
+    class sleeper {
+    public:
+        sleeper(const sleeper &) = delete;
+        sleeper& operator=(const sleeper &) = delete;
+
+        bool await_ready() const { return !(_Clock::now() < _m_due); }
+        void await_suspend(std::coroutine_handle<> co) {
+            _m_timer = _m_queue->schedule(_m_due, TimerWakeup{ co, &_m_armed });
+            _m_armed = true;
+        }
+        void await_resume() const { /*NOP*/ }
+
+        bool       armed() const { return _m_armed; }
+        time_point due() const { return _m_due; }
+
+    protected:
+        friend TimerQueue;
+
+        sleeper(TimerQueue *queue, time_point due) : _m_queue{ queue }, _m_due{ due } { /*NOP*/ }
+
+        TimerQueue *_m_queue;
+        time_point  _m_due;
+        handle      _m_timer{};
+        bool        _m_armed{ false };
+    };
+
+    /// @brief awaitable suspending the coroutine until @c due, unless that has passed already
+    sleeper sleep_until(time_point due) {
+        static_assert(std::is_same<_Payload, TimerWakeup>::value,
+            "sleep_until() requires a TimerQueue<TimerWakeup>");
+        return { this, due };
+    }
+
+    /// @brief cancel the timer of a suspended sleeper
+    /// @return the payload of its timer (with the coroutine, which stays suspended), or an
+    ///         empty one if the sleeper was not armed
+    _Payload cancel(sleeper &s) {
+        if (!s._m_armed) {
+            return _Payload();
+        }
+        s._m_armed = false;
+        return cancel(s._m_timer);
+    }
+
+    /// @brief move the timer of a suspended sleeper to another deadline
+    /// @return @c false if the sleeper was not armed
+    bool reschedule(sleeper &s, time_point due) {
+        if (s._m_armed) {
+            reschedule(s._m_timer, s._m_due = due);
+        }
+        return s._m_armed;
+    }
+
+    /// @brief expire all timers due at @c now and resume their coroutines, in order
+    /// @return number of coroutines resumed
+    std::size_t resume_until(time_point now) {
+        return expire_until(now, [](std::vector<timer> &batch) {
+            for (timer &item : batch) {
+                item.payload.resume();
+            }
+        });
+    }
+#endif
+};
+
+#endif // TIMERQUEUE_9687E0DD_D406_474B_9534_94B7C1D81D33
@@ -16,64 +16,113 @@
 #include <limits>
 #include <algorithm>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define PQ_POINTERMAP_SSE2 1
+# include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+# define PQ_POINTERMAP_NEON 1
+# include <arm_neon.h>
+#endif
+
 // The table is constructed according to a few rules:
 //
-// First, the probing steps we calculate are in the range [1,128], so the table size must be
-// co-prime to to all primes <= 128.  (This ensures that all probing steps *WILL* visit the
-// whole table!)
+// First, the hash picks a home group, and the probing visits the groups at triangular
+// offsets from there (+1, +3, +6, ...).  With a power of 2 for the group count, this visits
+// every group exactly once before it comes back.
 //
-// Second, the table size should grow roughly exponentially, but not too fast:  We take
-// approximately GOLDEN**N as starting point and use the closest number that satisfies the
-// co-primality constraint.
+// Second, a pointer goes into the first empty slot along its probe sequence.  Since nothing
+// is removed, a lookup can stop at the first group with an empty slot: the pointer would
+// have gone there, at the latest.
 //
-// (Using the golden ratio, (1 + sqrt(5)) / 2 )
-
-const PointerMapT::HMapInfoT PointerMapT::_mapInfo[] = {
-    /* 11 */ {        132,        199,         46 },
-    /* 12 */ {        211,        317,        232 },
-    /* 13 */ {        347,        521,        117 },
-    /* 14 */ {        559,        839,        446 },
-    /* 15 */ {        911,       1367,        932 },
-    /* 16 */ {       1471,       2207,       1841 },
-    /* 17 */ {       2380,       3571,        611 },
-    /* 18 */ {       3852,       5779,       2938 },
-    /* 19 */ {       6232,       9349,       8649 },
-    /* 20 */ {      10087,      15131,       2684 },
-    /* 21 */ {      16315,      24473,       4742 },
-    /* 22 */ {      26400,      39601,       1240 },
-    /* 23 */ {      42719,      64079,       8242 },
-    /* 24 */ {      69120,     103681,      85552 },
-    /* 25 */ {     111839,     167759,       1378 },
-    /* 26 */ {     180960,     271441,     227794 },
-    /* 27 */ {     292804,     439207,     401250 },
-    /* 28 */ {     473760,     710641,     563733 },
-    /* 29 */ {     766568,    1149853,     266341 },
-// beyond this point, the table size become more academical than practical:
-    /* 30 */ {    1240327,    1860491,     954068 },
-    /* 31 */ {    2006899,    3010349,    2209622 },
-    /* 32 */ {    3247231,    4870847,    3751089 },
-    /* 33 */ {    5254131,    7881197,    7596128 },
-    /* 34 */ {    8501360,   12752041,   10281520 },
-    /* 35 */ {   13755491,   20633237,    3254000 },
-    /* 36 */ {   22256852,   33385279,   21651584 },
-    /* 37 */ {   36012347,   54018521,   27504137 },
-    /* 38 */ {   58269200,   87403801,   12181047 },
-    /* 39 */ {   94281552,  141422329,   52297426 },
-    /* 40 */ {  152550748,  228826123,  176097082 },
-    /* 41 */ {  246832300,  370248451,  222234335 },
-  {0, 0, 0 } // sentinel, not counted!
-};
-const size_t PointerMapT::_mapSize{ sizeof(_mapInfo) / sizeof(*_mapInfo) - 1 };
+// Third, the table never gets more than 7/8 full, so the expected probe length stays at
+// about one group, and it doubles when it would.
+
+namespace {
+    /// @brief bit mask of the slots in a group whose control byte is @c tag
+    inline std::uint32_t
+    group_match(const std::uint8_t *ctrl, std::uint8_t tag)
+    {
+#if defined(PQ_POINTERMAP_SSE2)
+        const __m128i grp{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl)) };
+        return std::uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(grp, _mm_set1_epi8(char(tag)))));
+#elif defined(PQ_POINTERMAP_NEON)
+        static const std::uint8_t weight[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+        const uint8x16_t bits{ vandq_u8(vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(tag)), vld1q_u8(weight)) };
+        return std::uint32_t(vaddv_u8(vget_low_u8(bits))) | (std::uint32_t(vaddv_u8(vget_high_u8(bits))) << 8);
+#else
+        std::uint32_t mask{ 0 };
+        for (unsigned idx{ 0 }; idx < 16; ++idx) {
+            mask |= std::uint32_t(ctrl[idx] == tag) << idx;
+        }
+        return mask;
+#endif
+    }
+
+    /// @brief bit mask of the empty slots in a group: the only control bytes with the high bit
+    inline std::uint32_t
+    group_empty(const std::uint8_t *ctrl)
+    {
+#if defined(PQ_POINTERMAP_SSE2)
+        return std::uint32_t(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))));
+#elif defined(PQ_POINTERMAP_NEON)
+        return group_match(ctrl, 0x80);
+#else
+        std::uint32_t mask{ 0 };
+        for (unsigned idx{ 0 }; idx < 16; ++idx) {
+            mask |= std::uint32_t(ctrl[idx] >> 7) << idx;
+        }
+        return mask;
+#endif
+    }
+
+    /// @brief index of the lowest set bit, @c x != 0
+    inline unsigned
+    lowest(std::uint32_t x)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return unsigned(__builtin_ctz(x));
+#else
+        unsigned idx{ 0 };
+        for (; !(x & 1); x >>= 1) {
+            ++idx;
+        }
+        return idx;
+#endif
+    }
 
+    inline void
+    prefetch(const void *addr)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(addr, 1, 3);
+#else
+        (void)addr;
+#endif
+    }
+}
+
+/// @brief empty set, with room for @c n pointers
+/// @throw std::range_error if @c n is beyond the largest possible table
 PointerMapT::PointerMapT(size_t n)
-  : _table()
-  , _tinfo(std::lower_bound(_mapInfo, _mapInfo + _mapSize, n,
-        [](const HMapInfoT& i, std::uint32_t s){ return i.tcap < s;}) )
 {
-    if (_tinfo == _mapInfo + _mapSize) {
-        throw std::range_error("table size");
+    reserve(n);
+}
+
+/// @brief make room for @c n pointers, so that inserting them does no rehash
+/// @throw std::range_error if @c n is beyond the largest possible table
+void
+PointerMapT::reserve(
+    std::size_t n)
+{
+    std::size_t groups{ std::max<std::size_t>(_groups, 1) };
+    while (groups * _Group / 8 * 7 < n) {
+        if ((groups *= 2) > _MaxGroups) {
+            throw std::range_error("table size");
+        }
+    }
+    if (groups != _groups) {
+        _rehash(groups);
     }
-    _table.resize(_tinfo->tlen, nullptr);
 }
 
 /// @brief bit-twiddler based on the Jenkins OAT finaliser
@@ -103,57 +152,108 @@ PointerMapT::hash_ptr(const void* ptr)
     return static_cast<std::uint32_t>(key);
 }
 
+/// @brief add a pointer
+/// @return @c true if it was not in the set before
+/// @throw std::overflow_error if the table is full and cannot grow any more
 bool
 PointerMapT::insert(const void* p)
 {
-    // TODO: guard against overstuffing...
-    auto [hash, step]{ _stepinfo(p) };
-    while (nullptr != _table[hash] && p != _table[hash])
-        if ((hash += step) >= _table.size())
-            hash -= _table.size();
-    bool retv = (nullptr == _table[hash]);
-    if (retv) {
-        _table[hash] = p;
-        if (++_used > _tinfo->tcap)
-            _rehash();
+    if (_used >= _limit) {
+        if (lookup(p)) {
+            return false;
+        }
+        if (2 * _groups > _MaxGroups) {
+            throw std::overflow_error("cannot rehash");
+        }
+        _rehash(2 * _groups);
+    }
+    return _place(p, hash_ptr(p));
+}
+
+/// @brief add @c n pointers
+/// @return the number of pointers that were not in the set before
+/// @throw std::range_error if the result might not fit into the largest possible table
+///
+/// The probes run in batches: the home groups of a batch are hashed and prefetched before
+/// the first one is looked at, so their cache misses overlap instead of coming one by one.
+std::size_t
+PointerMapT::insert_many(
+    const void* const *p,
+    std::size_t        n)
+{
+    std::uint32_t hash[_Batch];
+    std::size_t   added{ 0 };
+
+    reserve(_used + n);
+    for (std::size_t base{ 0 }; base < n; base += _Batch) {
+        const std::size_t cnt{ std::min(_Batch, n - base) };
+        for (std::size_t idx{ 0 }; idx < cnt; ++idx) {
+            const std::size_t home{ _home(hash[idx] = hash_ptr(p[base + idx])) };
+            prefetch(_ctrl.data() + home * _Group);
+            prefetch(_slots.data() + home * _Group);
+        }
+        for (std::size_t idx{ 0 }; idx < cnt; ++idx) {
+            added += _place(p[base + idx], hash[idx]);
+        }
     }
-    return retv;
+    return added;
 }
 
 bool
 PointerMapT::lookup(const void* p) const
 {
-    auto [hash, step]{ _stepinfo(p) };
-    while (nullptr != _table[hash] && p != _table[hash])
-        if ((hash += step) >= _table.size())
-            hash -= _table.size();
-    return nullptr != _table[hash];
+    const std::uint32_t hash{ hash_ptr(p) };
+    const std::uint8_t  tag{ _tag(hash) };
+
+    for (std::size_t group{ _home(hash) }, step{ 0 }; /*NOP*/; group = (group + ++step) & (_groups - 1)) {
+        const std::uint8_t *ctrl{ _ctrl.data() + group * _Group };
+        for (std::uint32_t bits{ group_match(ctrl, tag) }; 0 != bits; bits &= bits - 1) {
+            if (p == _slots[group * _Group + lowest(bits)]) {
+                return true;
+            }
+        }
+        if (0 != group_empty(ctrl)) {
+            return false;
+        }
+    }
 }
 
-void
-PointerMapT::_rehash()
+bool
+PointerMapT::_place(const void* p, std::uint32_t hash)
 {
-    ++_tinfo;
-    if (0 == _tinfo->tlen) {
-        --_tinfo;
-        throw std::overflow_error("cannot rehash");
+    const std::uint8_t tag{ _tag(hash) };
+
+    for (std::size_t group{ _home(hash) }, step{ 0 }; /*NOP*/; group = (group + ++step) & (_groups - 1)) {
+        const std::uint8_t *ctrl{ _ctrl.data() + group * _Group };
+        for (std::uint32_t bits{ group_match(ctrl, tag) }; 0 != bits; bits &= bits - 1) {
+            if (p == _slots[group * _Group + lowest(bits)]) {
+                return false;
+            }
+        }
+        if (const std::uint32_t room{ group_empty(ctrl) }; 0 != room) {
+            const std::size_t slot{ group * _Group + lowest(room) };
+            _ctrl[slot]  = tag;
+            _slots[slot] = p;
+            ++_used;
+            return true;
+        }
     }
-    std::vector<void const*> holder(_tinfo->tlen, nullptr);
-    std::swap(_table, holder);
-    _used = 0;
-    for (auto p : holder)
-        (!p) || insert(p);
 }
 
-std::pair<size_t, size_t>
-PointerMapT::_stepinfo(const void* p) const
+void
+PointerMapT::_rehash(std::size_t groups)
 {
-    std::uint32_t phash{ hash_ptr(p) };
-    std::uint32_t step{ (phash & 127) + 1 };
-    std::uint32_t hash{ (std::uint32_t)((std::uint64_t(phash) * _tinfo->tlen + _tinfo->bias) >> 32) };
-    if (hash >= _table.size()) {
-        throw std::logic_error("hash index mapping");
+    std::vector<std::uint8_t> ctrl(groups * _Group, _Empty);
+    std::vector<const void*>  slots(groups * _Group, nullptr);
+    std::swap(_ctrl, ctrl);
+    std::swap(_slots, slots);
+    _groups = groups;
+    _limit  = groups * _Group / 8 * 7;
+    _used   = 0;
+    for (std::size_t idx{ 0 }; idx < ctrl.size(); ++idx) {
+        if (_Empty != ctrl[idx]) {
+            _place(slots[idx], hash_ptr(slots[idx]));
+        }
     }
-    return { hash, step };
 }
 // --*-- that's all folks --*--
@@ -10,43 +10,51 @@
 // With forward-only tree (Pairing / Leftist Heap with 2 pointers) detecting cross-linking
 // is tricky.  The best we can do is checking whether a node has been seen before or not, and
 // the pointer map is designed exactly for that purpose.
+//
+// The table is open addressing in groups of 16 slots, after the SwissTable design: a control
+// byte per slot holds 7 bits of the hash (or marks the slot empty), so one 16-byte compare
+// (SSE2 or NEON, a plain loop elsewhere) finds the candidates of a whole group, and only
+// those are compared as pointers.  Nothing is ever removed, so there are no tombstones.
 // -------------------------------------------------------------------------------------------
 #ifndef POINTERMAP_9687E0DD_D406_474B_9534_94B7C1D81D33
 #define POINTERMAP_9687E0DD_D406_474B_9534_94B7C1D81D33
 
+#include <cstddef>
 #include <cstdint>
-#include <utility>
 #include <vector>
 
 class PointerMapT {
 public:
     PointerMapT(std::size_t N);
 
-    bool insert(const void* p);
-    bool lookup(const void* p) const;
+    bool        insert(const void* p);
+    std::size_t insert_many(const void* const* p, std::size_t n);   // number of new pointers
+    bool        lookup(const void* p) const;
+    void        reserve(std::size_t n);
 
     static std::uint32_t hash_ptr(const void* ptr);
 
-    std::size_t capacity() const { return _tinfo->tlen; }
-    std::size_t limit() const { return _tinfo->tcap; }
+    std::size_t capacity() const { return _slots.size(); }
+    std::size_t limit() const { return _limit; }
     std::size_t used() const { return _used; }
 
 protected:
-    struct HMapInfoT {
-        std::uint32_t tcap; // capacit limit
-        std::uint32_t tlen; // table size / multiplier
-        std::uint32_t bias; // bias (actually debias correction helper)
-    };
-
-    static const HMapInfoT _mapInfo[];
-    static const size_t    _mapSize;
-
-    std::pair<std::size_t, std::size_t> _stepinfo(const void* p) const;
-    void _rehash();
-
-    std::vector<const void*> _table;
-    HMapInfoT const         *_tinfo;
-    std::size_t              _used{ 0 };
+    static constexpr std::size_t  _Group{ 16 };            // slots per group
+    static constexpr std::size_t  _Batch{ 8 };             // 'insert_many()': probes in flight
+    static constexpr std::size_t  _MaxGroups{ std::size_t(1) << 25 };   // hash bits above the tag
+    static constexpr std::uint8_t _Empty{ 0x80 };          // control byte of an empty slot
+
+    static std::uint8_t _tag(std::uint32_t hash) { return std::uint8_t(hash & 0x7f); }
+    std::size_t         _home(std::uint32_t hash) const { return (hash >> 7) & (_groups - 1); }
+
+    bool _place(const void* p, std::uint32_t hash);       // insert, capacity is there
+    void _rehash(std::size_t groups);
+
+    std::vector<std::uint8_t> _ctrl;
+    std::vector<const void*>  _slots;
+    std::size_t               _groups{ 0 };                // a power of 2
+    std::size_t               _limit{ 0 };                 // 7/8 of the slots
+    std::size_t               _used{ 0 };
 };
 
 #endif // POINTERMAP_9687E0DD_D406_474B_9534_94B7C1D81D33
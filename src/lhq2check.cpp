@@ -10,7 +10,7 @@
 // A classic children-links-only implementation: no iteration, no decrease-key support,
 // only push or multi-push, tip, pop
 // -------------------------------------------------------------------------------------
-// tree validation code
+// tree validation code and shape statistics
 // -------------------------------------------------------------------------------------
 #include "lhqueue2.hpp"
 #include <queue>
@@ -18,6 +18,8 @@
 #include <cstdint>
 #include <algorithm>
 #include <limits>
+#include <utility>
+#include <vector>
 
 #include "PointerMap.hpp"
 
@@ -25,11 +27,13 @@
 
 
 /// @brief validate a 2-way Leftist heap
-/// @param nodes    upper bound of nodes to expect
+/// @param nodes    size hint for the set of visited nodes; the count the walk must reach is
+///                 the heap's own @c _m_size
 ///
 /// This does all checks that are possible on a Leftist Heap with forward-only pointers:
 ///  - the heap invariant between a node and its children is maintained
 ///  - any reachable node can be reached only in one way
+///  - the number of reachable nodes matches the node count
 /// Everything else would need structural assistance a simple 2-way tree cannot provide.
 void
 LeftistHeapEasyT::validate_tree(
@@ -68,6 +72,15 @@ LeftistHeapEasyT::validate_tree(
     PointerMapT set(nodes);
     PointerQueT que;
 
+    // Step 0: pending nodes of a lazy heap are clean singletons, chained via the right link
+    std::size_t npend{ 0 };
+    for (BaseNodeT const *node{ _m_pend }; nullptr != node; node = node->_m_rptr) {
+        ASSERT(set.insert(node));
+        ASSERT((nullptr == node->_m_lptr) && (1 == node->_m_dist));
+        ++npend;
+    }
+    ASSERT(npend == _m_npend);
+
     // Step I: testing the root node. That one is simple:
     if (nullptr != _m_root) {
         ASSERT(set.insert(_m_root));            // and must not yet be in the queue
@@ -100,5 +113,42 @@ LeftistHeapEasyT::validate_tree(
         ASSERT(wrc <= wlc);
         ASSERT(node->_m_dist == (wrc + 1));
     }
+
+    // Step III: every node was inserted into the set exactly once
+    ASSERT(set.used() == _m_size);
 }
+
+/// @brief walk the tree once and report its shape
+///
+/// Without parent links the walk needs a stack as deep as the tree, up to O(N) entries for a
+/// degenerate one.  Allocating it can throw @c std::bad_alloc.  Pending nodes of a lazy-insert
+/// heap are counted, but not part of the tree yet.
+HeapShape
+LeftistHeapEasyT::shape_stats() const
+{
+    HeapShape shape;
+    std::vector<std::pair<BaseNodeT const *, std::size_t>> stack;
+
+    shape.pending = _m_npend;
+    for (BaseNodeT const *scan{ _m_root }; nullptr != scan; scan = scan->_m_rptr) {
+        ++shape.spine;
+    }
+    if (nullptr != _m_root) {
+        stack.emplace_back(_m_root, 0);
+    }
+    while ( ! stack.empty()) {
+        const auto [node, depth] = stack.back();
+        stack.pop_back();
+        shape._visit(depth);
+        shape._ldist(node->_m_dist);
+        if (nullptr != node->_m_rptr) {
+            stack.emplace_back(node->_m_rptr, depth + 1);
+        }
+        if (nullptr != node->_m_lptr) {
+            stack.emplace_back(node->_m_lptr, depth + 1);
+        }
+    }
+    return shape._done();
+}
+
 // --*-- that's all folks --*--
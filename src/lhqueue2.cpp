@@ -14,101 +14,19 @@
 // -------------------------------------------------------------------------------------
 
 #include "lhqueue2.hpp"
-#include <climits>
 
-LeftistHeapEasyT::BaseNodeT*
-LeftistHeapEasyT::_singleton(BaseNodeT* node)
-{
-    if (nullptr != node) {
-        node->_m_lptr = node->_m_rptr = nullptr;
-        node->_m_dist = 1;
-    }
-    return node;
-}
-
-/// @brief merge two heaps. O(log(N)) actual
-/// @param h1   1st heap
-/// @param h2   2nd heap
-/// @return     root of combined heap
-LeftistHeapEasyT::BaseNodeT*
-LeftistHeapEasyT::_merge(
-    BaseNodeT *h1,
-    BaseNodeT *h2) const
-{
-    if (nullptr == h1) {
-        std::swap(h1, h2);
-    }
-    if (nullptr != h2) {
-        if (_pred(*h2, *h1)) {
-            std::swap(h1, h2);
-        }
-        h1->_m_rptr = _merge(h1->_m_rptr, h2);
-        if ((nullptr == h1->_m_lptr) || (h1->_m_rptr->_m_dist > h1->_m_lptr->_m_dist)) {
-            std::swap(h1->_m_rptr, h1->_m_lptr);
-        }
-        h1->_m_dist = (h1->_m_rptr ? h1->_m_rptr->_m_dist : 0) + 1;
-    }
-    return h1;
-}
-
-/// @brief push a node into the heap
-/// @param node node to insert
-void
-LeftistHeapEasyT::_push(
-    BaseNodeT* node)
-{
-    _m_root = _merge(_m_root, _singleton(node));
-}
-
-/// @brief batch-building a heap from a list of nodes in O(N)
-/// @param head head of a list chained via @c _m_rptr
-void
-LeftistHeapEasyT::_push_list(
-    BaseNodeT* head)
-{
-    static constexpr unsigned limit{ sizeof(void*) * CHAR_BIT };
-    BaseNodeT* hedge[limit];
-    unsigned   hsize{ 0 }, hidx;
-    BaseNodeT* node;
-
-    // Phase I: construct the hedge, bottom-up
-    while (nullptr != (node = head)) {  // more work to do?
-        head = node->_m_rptr;
-
-        _singleton(node);
-        for (hidx = 0; (hidx < hsize) && (nullptr != hedge[hidx]); ++hidx) {
-            node = _merge(hedge[hidx], node);
-            hedge[hidx] = nullptr;
-        }
-        if (hidx < hsize) {
-            hedge[hidx] = node;
-        } else if (hsize < limit) {
-            hedge[hsize++] = node;
-        } else {
-            hedge[limit - 1] = node;
-        }
-    }
-
-    // Phase II: combine all nodes in hedge
-    for (hidx = 0; hidx < hsize; ++hidx)
-        if (nullptr != hedge[hidx])
-            node = _merge(hedge[hidx], node);
-
-    // Phase III: merge the created heap with the existing heap!
-    _m_root = _merge(_m_root, node);
-}
-
-/// @brief pop the tip/root node from the heap and build a new heap from its children
-/// @return pointer to former root or @c nullptr if empty
-LeftistHeapEasyT::BaseNodeT*
-LeftistHeapEasyT::_pop()
-{
-    BaseNodeT *retv { _m_root };
-    if (nullptr != retv) {
-        _m_root = _merge(retv->_m_lptr, retv->_m_rptr);
-    }
-    return _singleton(retv);
-}
+// The core algorithms are templates in the header; instantiate them here once for the
+// virtual order predicate.
+
+template void                         LeftistHeapEasyT::_push     (const VirtualOrderT&, BaseNodeT*);
+template void                         LeftistHeapEasyT::_push_list(const VirtualOrderT&, BaseNodeT*);
+template void                         LeftistHeapEasyT::_push_lists(const VirtualOrderT&, BaseNodeT* const*, unsigned);
+template LeftistHeapEasyT::BaseNodeT* LeftistHeapEasyT::_build    (const VirtualOrderT&, BaseNodeT*, std::size_t&) const;
+template LeftistHeapEasyT::BaseNodeT* LeftistHeapEasyT::_pop      (const VirtualOrderT&);
+template void                         LeftistHeapEasyT::_replace  (const VirtualOrderT&);
+template LeftistHeapEasyT::BaseNodeT* LeftistHeapEasyT::_merge    (const VirtualOrderT&, BaseNodeT*, BaseNodeT*) const;
+template void                         LeftistHeapEasyT::_meld     (const VirtualOrderT&, LeftistHeapEasyT&);
+template LeftistHeapEasyT::BaseNodeT* LeftistHeapEasyT::_drain    (const VirtualOrderT&);
 
 /// @brief shred a tree to single nodes
 /// @param pref root of tree to shred
@@ -7,10 +7,11 @@
 //    visit https://creativecommons.org/publicdomain/zero/1.0/
 //
 // -------------------------------------------------------------------------------------------
-// Tree validation code
+// Tree validation code and shape statistics
 // -------------------------------------------------------------------------------------------
 #include "mdqueue3.hpp"
 #include <queue>
+#include <random>
 #include <stdexcept>
 #include <cstdint>
 #include <algorithm>
@@ -60,6 +61,7 @@ MinDistHeapT::validate_tree() const
       priority_queue<BaseNodeT const*, std::vector<BaseNodeT const*>, DistComp>;
 
     PointerQueT que;
+    std::size_t count{ 0 };
 
     // Step I: testing the root node. That one is simple:
     ASSERT(nullptr == _m_root._m_pptr);
@@ -77,6 +79,7 @@ MinDistHeapT::validate_tree() const
         short wlc{ 0 }, wrc{ 0 };
         BaseNodeT const *node{ que.top() };
         que.pop();
+        ++count;
 
         if (nullptr != node->_m_lptr) {
             ASSERT(node == node->_m_lptr->_m_pptr);
@@ -93,5 +96,196 @@ MinDistHeapT::validate_tree() const
         }
         ASSERT(node->_m_dist == (std::min(wlc, wrc) + 1));
     }
+
+    // Step III: pending nodes of a lazy heap are clean singletons, chained via the parent link
+    std::size_t npend{ 0 };
+    for (BaseNodeT const *node{ _m_pend }; nullptr != node; node = node->_m_pptr) {
+        ASSERT((nullptr == node->_m_lptr) && (nullptr == node->_m_rptr) && (1 == node->_m_dist));
+        ++npend;
+    }
+    ASSERT(npend == _m_npend);
+
+    // Step IV: the node count must match the number of reachable nodes
+    ASSERT(count + npend == _m_size);
+}
+
+/// @brief walk the tree once and report its shape
+///
+/// The walk follows the parent links, without a stack.  Pending nodes of a lazy-insert heap
+/// are counted, but not part of the tree yet.
+HeapShape
+MinDistHeapT::shape_stats() const
+{
+    HeapShape        shape;
+    BaseNodeT const *node{ _m_root._m_lptr };
+    std::size_t      depth{ 0 };
+
+    shape.pending = _m_npend;
+    for (BaseNodeT const *scan{ node }; nullptr != scan; scan = scan->_m_rptr) {
+        ++shape.spine;
+    }
+    while (nullptr != node) {
+        shape._visit(depth);
+        shape._ldist(node->_m_dist);
+        if (nullptr != node->_m_lptr || nullptr != node->_m_rptr) {
+            node = (nullptr != node->_m_lptr) ? node->_m_lptr : node->_m_rptr;
+            ++depth;
+            continue;
+        }
+        // climb until a right sibling is still to be done
+        for (;;) {
+            BaseNodeT const *up{ node->_m_pptr };
+            if (&_m_root == up) {
+                node = nullptr;
+                break;
+            }
+            if (node == up->_m_lptr && nullptr != up->_m_rptr) {
+                node = up->_m_rptr;
+                break;
+            }
+            node = up;
+            --depth;
+        }
+    }
+    return shape._done();
+}
+
+// -------------------------------------------------------------------------------------------
+// streaming validation
+//
+// 'validate_tree()' keeps a queue of open subtrees, up to half the heap for a balanced tree.
+// The checks below walk the tree along its own links instead, like 'shape_stats()', so they
+// need no memory besides a few pointers.  That suits heaps too big for a queue of their
+// size, or living in mapped memory where a second pass would page the tree in again.
+
+/// @brief check the children of a node: back links, heap order and the leaf distance
+void
+MinDistHeapT::_check_node(
+    const BaseNodeT *node) const
+{
+    short wlc{ 0 }, wrc{ 0 };
+
+    ASSERT((nullptr == node->_m_lptr) || (node->_m_lptr != node->_m_rptr));
+    if (nullptr != node->_m_lptr) {
+        ASSERT(node == node->_m_lptr->_m_pptr);
+        ASSERT(!_pred(*node->_m_lptr, *node));     // heap invariant
+        wlc = node->_m_lptr->_m_dist;
+    }
+    if (nullptr != node->_m_rptr) {
+        ASSERT(node == node->_m_rptr->_m_pptr);
+        ASSERT(!_pred(*node->_m_rptr, *node));     // heap invariant
+        wrc = node->_m_rptr->_m_dist;
+    }
+    ASSERT(node->_m_dist == (std::min(wlc, wrc) + 1));
+}
+
+/// @brief check the subtree below @c top in pre-order, up to @c budget nodes
+/// @return the number of nodes checked
+std::size_t
+MinDistHeapT::_check_walk(
+    const BaseNodeT *top,
+    std::size_t      budget) const
+{
+    BaseNodeT const *node{ top };
+    std::size_t      count{ 0 };
+
+    while (nullptr != node && count < budget) {
+        ++count;
+        _check_node(node);
+        if (nullptr != node->_m_lptr || nullptr != node->_m_rptr) {
+            node = (nullptr != node->_m_lptr) ? node->_m_lptr : node->_m_rptr;
+            continue;
+        }
+        // climb until a right subtree is left to do, but never above 'top'
+        for (;;) {
+            if (node == top) {
+                node = nullptr;
+                break;
+            }
+            BaseNodeT const *up{ node->_m_pptr };
+            if (node == up->_m_lptr && nullptr != up->_m_rptr) {
+                node = up->_m_rptr;
+                break;
+            }
+            node = up;
+        }
+    }
+    return count;
+}
+
+/// @brief check the whole heap like @c validate_tree(), without the queue
+/// @throw std::logic_error naming the first check that failed
+///
+/// A corrupted link may make the walk run in circles; it stops one node past the heap size,
+/// which then fails the node count.
+void
+MinDistHeapT::validate_stream() const
+{
+    std::size_t count{ 0 };
+
+    ASSERT(nullptr == _m_root._m_pptr);
+    ASSERT(nullptr == _m_root._m_rptr);
+    if (nullptr != _m_root._m_lptr) {
+        ASSERT(&_m_root == _m_root._m_lptr->_m_pptr);
+        count = _check_walk(_m_root._m_lptr, _m_size + 1);
+    }
+
+    // pending nodes of a lazy heap are clean singletons, chained via the parent link
+    std::size_t npend{ 0 };
+    for (BaseNodeT const *node{ _m_pend }; nullptr != node && npend <= _m_npend; node = node->_m_pptr) {
+        ASSERT((nullptr == node->_m_lptr) && (nullptr == node->_m_rptr) && (1 == node->_m_dist));
+        ++npend;
+    }
+    ASSERT(npend == _m_npend);
+    ASSERT(count + npend == _m_size);
 }
+
+/// @brief check randomly chosen subtrees only
+/// @param subtrees number of subtrees to check
+/// @param budget   most nodes to check per subtree
+/// @param seed     seed of the choice, for a repeatable run
+/// @return the number of nodes checked
+/// @throw std::logic_error naming the first check that failed
+///
+/// Each sample follows a random path down to a leaf, checking the nodes on the way, climbs
+/// back a random number of levels and checks the subtree found there.  The path is at most
+/// as long as the tree is deep, so the cost is O(subtrees * (depth + budget)) and a monitor
+/// can spot check a heap of any size now and then.  Pending nodes are not looked at.
+std::size_t
+MinDistHeapT::validate_sample(
+    std::size_t   subtrees,
+    std::size_t   budget,
+    std::uint64_t seed) const
+{
+    std::mt19937_64  rng{ seed };
+    BaseNodeT const *root{ _m_root._m_lptr };
+    std::size_t      count{ 0 };
+
+    if (nullptr == root) {
+        ASSERT(_m_npend == _m_size);
+        return 0;
+    }
+    ASSERT(&_m_root == root->_m_pptr);
+    while (subtrees-- > 0) {
+        BaseNodeT const *node{ root };
+        std::size_t      depth{ 0 };
+        for (;;) {
+            _check_node(node);
+            BaseNodeT const *lptr{ node->_m_lptr };
+            BaseNodeT const *rptr{ node->_m_rptr };
+            BaseNodeT const *step{ (nullptr == lptr) ? rptr : (nullptr == rptr) ? lptr : (rng() & 1) ? lptr : rptr };
+            if (nullptr == step) {
+                break;
+            }
+            ASSERT(++depth <= _m_size);
+            node = step;
+        }
+        for (std::size_t back{ std::size_t(rng() % (depth + 1)) }; back > 0; --back) {
+            node = node->_m_pptr;
+        }
+        count += _check_walk(node, budget);
+    }
+    return count;
+}
+
 // --*-- that's all folks --*--
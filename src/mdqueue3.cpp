@@ -16,16 +16,6 @@
 
 /// @file Leaf Distance balanced Heap with 3-way nodes
 
-MinDistHeapT::BaseNodeT*
-MinDistHeapT::_singleton(BaseNodeT* const node)
-{
-    if (node) {
-        node->_m_lptr = node->_m_rptr = node->_m_pptr = nullptr;
-        node->_m_dist = 1;
-    }
-    return node;
-}
-
 MinDistHeapT::BaseNodeT *MinDistHeapT::_yield()
 {
     // cut the whole tree from the sentinel
@@ -33,81 +23,29 @@ MinDistHeapT::BaseNodeT *MinDistHeapT::_yield()
     std::swap(temp, _m_root._m_lptr);
     if (temp)
         temp->_m_pptr = nullptr;
-    return temp;
-}
-
-// -------------------------------------------------------------------------------------------
-// connecting nodes / primitives on node level
-
-/// @brief make b the left child of a
-/// @param a    parent node
-/// @param b    new left child
-/// @return     a if not @c NULL, else b
-MinDistHeapT::BaseNodeT*
-MinDistHeapT::_lgraft(
-    BaseNodeT* a,
-    BaseNodeT* b)
-{
-    if (a) a->_m_lptr = b;
-    if (b) b->_m_pptr = a;
-    return a ? a : b;
-}
 
-/// @brief make b the right child of a
-/// @param a    parent node
-/// @param b    new right child
-/// @return     a if not @c NULL, else b
-MinDistHeapT::BaseNodeT*
-MinDistHeapT::_rgraft(
-    BaseNodeT* a,
-    BaseNodeT* b)
-{
-    if (a) a->_m_rptr = b;
-    if (b) b->_m_pptr = a;
-    return a ? a : b;
-}
-
-/// @brief unidirectional CONS operation via parent pointer
-/// @param a    new head of the list
-/// @param b    tail to attach to node
-/// @return     a if not @c NULL, else b
-MinDistHeapT::BaseNodeT*
-MinDistHeapT::_pcons(
-    BaseNodeT* a,
-    BaseNodeT* b)
-{
-    if (a) a->_m_pptr = b;
-    return a ? a : b;
+    // Pending nodes come first, with the tree hung behind the last one.  That's no heap, but
+    // exactly what '_shred_pop()' expects; a heap-ordered tree needs a '_flush()' before.
+    if (_m_pend) {
+        BaseNodeT *tail{ _m_pend };
+        while (tail->_m_pptr)
+            tail = tail->_m_pptr;
+        tail->_m_pptr = temp;
+        temp = _m_pend;
+        _m_pend = nullptr;
+        _m_npend = 0;
+    }
+    _m_size = 0;
+    return temp;
 }
 
 // -------------------------------------------------------------------------------------------
 // cutting nodes or whole subtrees from the heap
 
-/// @brief cut a node from the tree
-/// @param node node to cut from the tree
-/// @return @node as singleton heap
-///
-/// This replaces @c node by the heap created from its children. If there are none, the replacement
-/// has to be the next sibling of the node, of course.  This retains most of the order already
-/// achieved in the heap.
-MinDistHeapT::BaseNodeT*
-MinDistHeapT::_ncut(
-    BaseNodeT * const node)
-{
-    assert(node && node->_m_pptr);    // automagically breaks on sentinel!
-    BaseNodeT* root{ node->_m_pptr };
-    if (node == root->_m_lptr) {
-        _merge(root, &root->_m_lptr, node->_m_lptr, node->_m_rptr);
-    } else {
-        _merge(root, &root->_m_rptr, node->_m_lptr, node->_m_rptr);
-    }
-    node->_m_lptr = node->_m_rptr = node->_m_pptr = nullptr;
-    return node;
-}
-
 /// @brief cut a subtree from the heap
 /// @param node subtree root
 /// @return @c node, but cleanly cut (next/prev are @c nullptr)
+/// @note The node count is not touched: the subtree is meant to be merged back right away.
 MinDistHeapT::BaseNodeT*
 MinDistHeapT::_tcut(
     BaseNodeT* const node)
@@ -118,170 +56,65 @@ MinDistHeapT::_tcut(
     // !Note! Why do we call merge with two empty heaps here? Well, it not only sets a NULL leaf,
     // but it also updates the perent leaf distances. A slight form of abuse, but convenient.
     if (node == root->_m_lptr) {
-        _merge(root, &root->_m_lptr, nullptr, nullptr);
+        _merge(VirtualOrderT{ this }, root, &root->_m_lptr, nullptr, nullptr);
     } else {
-        _merge(root, &root->_m_lptr, nullptr, nullptr);
+        _merge(VirtualOrderT{ this }, root, &root->_m_rptr, nullptr, nullptr);
     }
     node->_m_pptr = nullptr;
     return node;
 }
 
 // -------------------------------------------------------------------------------------------
-// core functions -- this makes a binary tree a LDB Heap
-
-void
-MinDistHeapT::_merge(
-    BaseNodeT *root,
-    BaseNodeT **link,
-    BaseNodeT  *h1,
-    BaseNodeT  *h2) const
-{
-    int steps{ 1 };
-
-    // Phase I: merge trees until at most one is surviving
-    while (h1 && h2) {
-        ++steps;
-        if (_pred(*h2, *h1)) {
-            (*link = h2)->_m_pptr = root;
-            root = h2;
-            if (!root->_m_lptr || (root->_m_rptr && root->_m_rptr->_m_dist > root->_m_lptr->_m_dist))
-                link = &root->_m_lptr;
-            else
-                link = &root->_m_rptr;
-            h2 = *link;
-        } else {
-            (*link = h1)->_m_pptr = root;
-            root = h1;
-            if (!root->_m_lptr || (root->_m_rptr && root->_m_rptr->_m_dist > root->_m_lptr->_m_dist))
-                link = &root->_m_lptr;
-            else
-                link = &root->_m_rptr;
-            h1 = *link;
-        }
-    }
+// snapshots
 
-    // Phase II: connect the survivor.
-    // Unless we entered this with two empty heaps, we have exactly one survivor here. Make sure
-    // the survivor is has a proper back/parent link.
-    if ((*link = (h1 ? h1 : h2)))
-        (*link)->_m_pptr = root;
-
-    // Phase III: update the leaf distances.
-    // We have to do AT LEAST as many steps as we had merging steps in Phase I.  If we continue
-    // after that, we do so until the node weight does not change any more.
-    //
-    // In a min-dist heap (and the leftist heap as a special form of that), each node stores
-    // the minimum null-path length of its children, which is logarithmically bounded by the
-    // subtree size. Any local structural modification can only affect this value while it
-    // remains below that bound.  Therefore, any upward propagation of distance updates,
-    // whether due to increase or decrease, terminates after at most O(log N) steps.
-
-    while (root) {
-        int lcw{ root->_m_lptr ? root->_m_lptr->_m_dist : 0 };
-        int rcw{ root->_m_rptr ? root->_m_rptr->_m_dist : 0 };
-        int nnw{ std::min(lcw, rcw) + 1 };
-        if ((--steps < 0) && (nnw == root->_m_dist))
-            break;
-        root->_m_dist = nnw;
-        root = root->_m_pptr;
-    }
-}
-
-/// @brief build a heap from a sibling list
-/// @param node start of list
-/// @return     root of created heap
-MinDistHeapT::BaseNodeT*
-MinDistHeapT::_build(
-    BaseNodeT *head) const
-{
-    BaseNodeT *h1, *h2;
-    while ((h1 = head) && (h2 = head->_m_pptr)) {
-        BaseNodeT *list{ nullptr };
-        do {
-            BaseNodeT *hold;
-            head = h2->_m_pptr;
-            _merge(nullptr, &hold, h1, h2);
-            hold->_m_pptr = list;
-            list = hold;
-        } while ((h1 = head) && (h2 = head->_m_pptr));
-        if (head)
-            head->_m_pptr = list;
-        else
-            head = list;
-    }
-    return head;
-}
-
-/// @brief push a node into the heap
-/// @param node node to insert
-/// @return @c node
-MinDistHeapT::BaseNodeT*
-MinDistHeapT::_push(
-    BaseNodeT* node)
-{
-    _merge(&_m_root, &_m_root._m_lptr, _m_root._m_lptr, _singleton(node));
-    return node;
-}
-
-/// @brief push a node list into the heap
-/// @param node node to insert
-/// @return @c node
-void
-MinDistHeapT::_push_list(
-    BaseNodeT* head)
-{
-    _merge(&_m_root, &_m_root._m_lptr, _m_root._m_lptr, _build(head));
-}
-
-
-/// @brief pop the root element
-/// @return the old root or @c NULL on empty heap
-MinDistHeapT::BaseNodeT*
-MinDistHeapT::_pop()
-{
-    BaseNodeT *retv{ _m_root._m_lptr };
-    if (nullptr != retv) {
-        _merge(&_m_root, &_m_root._m_lptr, retv->_m_lptr, retv->_m_rptr);
-        retv->_m_lptr = retv->_m_rptr = retv->_m_pptr = nullptr;
-        retv->_m_dist = 0;
-    }
-    return retv;
-}
-
-/// @brief handle a decrease in the node's priority
-/// @param node node to reposition in heap
-/// @return     @c node
+/// @brief check the leaf distances saved in a snapshot before relinking its tree
+/// @param snap snapshot whose records make a tree ( @c HeapSnapshotReader::is_tree() )
+/// @return @c true if every saved distance is one more than the smaller one of its children
 ///
-/// This an actual O(1) operation, as cutting a subtree from any position is O(1), and so
-/// is the following merge of the subtree with the remaining heap.  As decreasing the the
-/// node's weight does _not_ invalidate the subtree rooted at @c node, we can prune and
-/// graft the whole subtree here.  ( @c _reinsert() is more complicated, as we cannot
-/// assume the heap invariant between the node and its children is preserved.)
-MinDistHeapT::BaseNodeT*
-MinDistHeapT::_decrease(
-    BaseNodeT* node)
-{
-    assert(node && node->_m_pptr);
-    if (node != _m_root._m_lptr) {
-        _merge(&_m_root, &_m_root._m_lptr, _m_root._m_lptr, _tcut(node));
+/// The merge relies on the distances to pick its path and to stop updating them, so a tree
+/// with wrong ones must not be relinked.  Walking the pre-order records backwards, the
+/// subtrees of a node are done before the node itself, their distances on top of a stack.
+bool
+MinDistHeapT::_check_dists(
+    const HeapSnapshotReader &snap)
+{
+    std::vector<short> stack;                              // distances of the subtrees done
+    for (std::size_t idx{ snap.count() }; idx-- > 0; ) {
+        const unsigned char * const rec{ snap.record(idx) };
+        const unsigned              shape{ HeapSnapshotReader::shape(rec) };
+        int lcw{ 0 }, rcw{ 0 };
+        if (0 != (shape & HeapSnapshotHeader::left)) {
+            lcw = stack.back();
+            stack.pop_back();
+        }
+        if (0 != (shape & HeapSnapshotHeader::right)) {
+            rcw = stack.back();
+            stack.pop_back();
+        }
+        const short dist{ HeapSnapshotReader::dist(rec) };
+        if (dist != std::min(lcw, rcw) + 1) {
+            return false;
+        }
+        stack.push_back(dist);
     }
-    return node;
+    return true;
 }
 
-/// @brief re-insert a node after an arbitrary priority change
-/// @param node node to reposition in heap
-/// @return     @c node
-///
-/// This cuts the node from the heap, effectively making it a singleton heap, and then
-/// merges it again with the heap.
-MinDistHeapT::BaseNodeT*
-MinDistHeapT::_reinsert(
-    BaseNodeT* node)
-{
-    assert(node && node->_m_pptr);
-    _merge(&_m_root, &_m_root._m_lptr, _m_root._m_lptr, _tcut(node));
-    return node;
-}
+// -------------------------------------------------------------------------------------------
+// core functions -- the algorithms are templates in the header; instantiate them here once
+// for the virtual order predicate.
+
+template void                     MinDistHeapT::_push_list(const VirtualOrderT&, BaseNodeT*);
+template void                     MinDistHeapT::_push_lists(const VirtualOrderT&, BaseNodeT* const*, unsigned);
+template void                     MinDistHeapT::_merge    (const VirtualOrderT&, BaseNodeT*, BaseNodeT**, BaseNodeT*, BaseNodeT*) const;
+template MinDistHeapT::BaseNodeT* MinDistHeapT::_push     (const VirtualOrderT&, BaseNodeT*);
+template MinDistHeapT::BaseNodeT* MinDistHeapT::_pop      (const VirtualOrderT&);
+template MinDistHeapT::BaseNodeT* MinDistHeapT::_build    (const VirtualOrderT&, BaseNodeT*) const;
+template MinDistHeapT::BaseNodeT* MinDistHeapT::_ncut     (const VirtualOrderT&, BaseNodeT*);
+template MinDistHeapT::BaseNodeT* MinDistHeapT::_decrease (const VirtualOrderT&, BaseNodeT*);
+template MinDistHeapT::BaseNodeT* MinDistHeapT::_reinsert (const VirtualOrderT&, BaseNodeT*);
+template void                     MinDistHeapT::_meld     (const VirtualOrderT&, MinDistHeapT&);
+template MinDistHeapT::BaseNodeT* MinDistHeapT::_drain    (const VirtualOrderT&);
 
 // -----------------------------------------------------------------------------------------------
 // iterative serialization (destructive node enumeration)
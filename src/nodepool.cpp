@@ -0,0 +1,164 @@
+// -------------------------------------------------------------------------------------------
+// Slab-style node pool allocator for heap nodes
+// -------------------------------------------------------------------------------------------
+// This file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+// untyped pool implementation
+// -------------------------------------------------------------------------------------------
+
+#include "nodepool.hpp"
+#include <algorithm>
+
+namespace {
+    constexpr std::size_t chunk_bytes { 64 * 1024 };    // target chunk size
+    constexpr std::size_t chunk_nodes { 32 };           // minimum blocks per chunk
+
+    constexpr std::size_t
+    round_up(std::size_t n, std::size_t a)
+    {
+        return (n + a - 1) / a * a;
+    }
+}
+
+NodePoolT::NodePoolT(
+    std::size_t size,
+    std::size_t align,
+    NodePoolT *&chain)
+  : _m_size ()
+  , _m_align(std::max(align, alignof(_FreeT)))
+  , _m_head ()
+  , _m_link (chain)
+  , _m_chain(&chain)
+{
+    chain = this;
+
+    // every block must be able to hold the free list link, and a chunk starts with its
+    // own link to the next chunk, followed by the properly aligned blocks.
+    _m_size = round_up(std::max(size, sizeof(_FreeT)), _m_align);
+    _m_head = round_up(sizeof(_ChunkT), _m_align);
+}
+
+NodePoolT::~NodePoolT()
+{
+    // Blocks still in use are lost with their chunk -- that's the documented deal for a
+    // thread-local pool.  We cannot do anything sensible about it here.
+    _m_live = 0;
+    release();
+
+    // thread-local objects die in reverse order of construction, so we're the chain head now
+    if (this == *_m_chain) {
+        *_m_chain = _m_link;
+    }
+}
+
+/// @brief add another chunk to the pool, a recycled one if there is one
+/// @return new head of the free list (never @c nullptr)
+NodePoolT::_FreeT*
+NodePoolT::_grow()
+{
+    std::size_t nodes{ std::max(chunk_nodes, (chunk_bytes - _m_head) / _m_size) };
+    void       *mem;
+    if (nullptr != _m_spare) {
+        mem = _m_spare;
+        _m_spare = _m_spare->_m_next;
+    } else {
+        mem = ::operator new(_m_head + nodes * _m_size, std::align_val_t{ _m_align });
+        _m_total += nodes;
+    }
+
+    _ChunkT *chunk{ static_cast<_ChunkT*>(mem) };
+    chunk->_m_next = _m_chunk;
+    _m_chunk = chunk;
+
+    // thread the blocks back to front, so allocation proceeds in address order
+    char *base{ static_cast<char*>(mem) + _m_head };
+    for (std::size_t idx{ nodes }; idx-- > 0; /*NOP*/) {
+        _FreeT *node{ reinterpret_cast<_FreeT*>(base + idx * _m_size) };
+        node->_m_next = _m_free;
+        _m_free = node;
+    }
+    return _m_free;
+}
+
+/// @brief pre-allocate chunks
+/// @param n    number of blocks that must be available without further allocation
+void
+NodePoolT::reserve(
+    std::size_t n)
+{
+    while (_m_total - _m_live < n) {
+        _grow();
+    }
+}
+
+/// @brief take back all blocks at once
+/// @param n    number of blocks the caller holds
+/// @return @c true if these were all live blocks and the pool took them back, @c false else
+///
+/// This is the bulk clear: the caller forgets its blocks without handing them back one by
+/// one, so it must not need them destroyed.  The chunks become spares, which '_grow()' threads
+/// into the free list again as it runs dry, so this is O(chunks) and allocates nothing.
+bool
+NodePoolT::recycle(
+    std::size_t n)
+{
+    if (n != _m_live) {
+        return false;
+    }
+    if (nullptr != _m_chunk) {
+        _ChunkT *tail{ _m_chunk };
+        while (nullptr != tail->_m_next) {
+            tail = tail->_m_next;
+        }
+        tail->_m_next = _m_spare;
+        _m_spare = _m_chunk;
+        _m_chunk = nullptr;
+    }
+    _m_free = nullptr;
+    _m_live = 0;
+    return true;
+}
+
+/// @brief return all chunks to the system
+/// @return @c true if the pool was idle and is empty now, @c false if blocks are still in use
+///
+/// This is the bulk release: instead of handing back block by block, whole chunks are
+/// dropped.  That's only possible once no block of the pool is live.
+bool
+NodePoolT::release()
+{
+    if (0 != _m_live) {
+        return false;
+    }
+    for (_ChunkT *list : { _m_chunk, _m_spare }) {
+        while (nullptr != list) {
+            _ChunkT *next{ list->_m_next };
+            ::operator delete(static_cast<void*>(list), std::align_val_t{ _m_align });
+            list = next;
+        }
+    }
+    _m_chunk = nullptr;
+    _m_spare = nullptr;
+    _m_free  = nullptr;
+    _m_total = 0;
+    return true;
+}
+
+/// @brief release a chain of pools
+/// @param pool first pool in chain
+/// @return @c true if all pools in the chain were idle and are empty now
+bool
+NodePoolT::release_chain(
+    NodePoolT *pool)
+{
+    bool retv{ true };
+    for (/*NOP*/; nullptr != pool; pool = pool->_m_link) {
+        retv = pool->release() && retv;
+    }
+    return retv;
+}
+// --*-- that's all folks --*--
@@ -7,7 +7,7 @@
 //    visit https://creativecommons.org/publicdomain/zero/1.0/
 //
 // -------------------------------------------------------------------------------------------
-// Tree validation code
+// Tree validation code and shape statistics
 // -------------------------------------------------------------------------------------------
 #include "phqueue2.hpp"
 #include <vector>
@@ -15,6 +15,7 @@
 #include <cstdint>
 #include <algorithm>
 #include <limits>
+#include <utility>
 
 #include "PointerMap.hpp"
 
@@ -22,11 +23,13 @@
 
 
 /// @brief validate a 2-way Pairing heap
-/// @param nodes    upper bound of nodes to expect
+/// @param nodes    size hint for the set of visited nodes and the work queue; the count
+///                 the walk must reach is the heap's own @c _m_size
 ///
 /// This does all checks that are possible on a Pairing Heap with forward-only pointers:
 ///  - the heap invariant between a node and its children is maintained
 ///  - any reachable node can be reached only in one way
+///  - the number of reachable nodes matches the node count
 /// Everything else would need structural assistance a simple 2-way tree cannot provide.
 void
 PairingHeapEasyT::validate_tree(
@@ -43,8 +46,19 @@ PairingHeapEasyT::validate_tree(
 
     // Step I: testing the root node. That one is simple:
     if (nullptr != _m_root) {
-        ASSERT(nullptr == _m_root->_m_next);    // root must not have a sibling
+        // root must not have a sibling, unless the pending trees of an auxiliary twopass
+        // heap follow it; their least member must be known
+        ASSERT((nullptr == _m_root->_m_next) || (nullptr != _m_amin));
         ASSERT(set.insert(_m_root));            // and must not yet be in the queue
+        if (nullptr != _m_amin) {
+            bool found{ false };
+            for (PairingNodeT const *scan{ _m_root }; nullptr != scan; scan = scan->_m_next) {
+                ASSERT((scan == _m_root) || set.insert(scan));
+                ASSERT(!_pred(*scan, *_m_amin));
+                found = found || (scan == _m_amin);
+            }
+            ASSERT(found);
+        }
         que.push_back(_m_root);
     }
 
@@ -63,6 +77,11 @@ PairingHeapEasyT::validate_tree(
     // of the the tip, unless there is none, in which case we pop and reduce the height
     // of the stack.  And if a node has children, we push the head of the the children
     // list.  This handles both extreme structures very efficient with a max depth of 1.
+    //
+    // The children go into the set in batches, which lets it overlap the cache misses of
+    // their probes.  A batch is small enough to catch a cycle in the list soon after all.
+    const void  *batch[64];
+    std::size_t  nbatch{ 0 };
     while (!que.empty()) {
         PairingNodeT const *node{ que.back() };
         PairingNodeT const *chld{ node->_m_down };
@@ -72,10 +91,54 @@ PairingHeapEasyT::validate_tree(
         if (nullptr != chld) {
             que.push_back(chld);
             do {
-                ASSERT(set.insert(chld));       // node never seen before
                 ASSERT(!_pred(*chld, *node));   // heap invariant
+                batch[nbatch++] = chld;
+                if ((nullptr == chld->_m_next) || (nbatch == sizeof(batch) / sizeof(*batch))) {
+                    ASSERT(set.insert_many(batch, nbatch) == nbatch);   // nodes never seen before
+                    nbatch = 0;
+                }
             } while (nullptr != (chld = chld->_m_next));
         }
     }
+
+    // Step III: every node was inserted into the set exactly once
+    ASSERT(set.used() == _m_size);
 }
+
+/// @brief walk the tree once and report its shape
+///
+/// Without parent links the walk needs a stack as deep as the tree, up to O(N) entries for a
+/// degenerate one.  Allocating it can throw @c std::bad_alloc.
+HeapShape
+PairingHeapEasyT::shape_stats() const
+{
+    HeapShape shape;
+    std::vector<std::pair<PairingNodeT const *, std::size_t>> stack;
+
+    if (nullptr != _m_root) {
+        for (PairingNodeT const *scan{ _m_root->_m_down }; nullptr != scan; scan = scan->_m_next) {
+            ++shape.roots;
+        }
+        for (PairingNodeT const *scan{ _m_root->_m_next }; nullptr != scan; scan = scan->_m_next) {
+            ++shape.pending;
+        }
+        // the root's siblings are the pending trees: the walk starts below the root
+        shape._visit(0);
+        if (nullptr != _m_root->_m_down) {
+            stack.emplace_back(_m_root->_m_down, 1);
+        }
+    }
+    while ( ! stack.empty()) {
+        const auto [node, depth] = stack.back();
+        if (nullptr == (stack.back().first = node->_m_next)) {
+            stack.pop_back();
+        }
+        shape._visit(depth);
+        if (nullptr != node->_m_down) {
+            stack.emplace_back(node->_m_down, depth + 1);
+        }
+    }
+    return shape._done();
+}
+
 // --*-- that's all folks --*--
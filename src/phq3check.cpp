@@ -7,9 +7,10 @@
 //    visit https://creativecommons.org/publicdomain/zero/1.0/
 //
 // -------------------------------------------------------------------------------------------
-// Tree validation code
+// Tree validation code and shape statistics
 // -------------------------------------------------------------------------------------------
 #include "phqueue3.hpp"
+#include <random>
 #include <stdexcept>
 
 #define ASSERT(x) do { if (!(x)) throw std::logic_error( #x ); } while(false)
@@ -19,11 +20,15 @@ PairingHeapT::validate_tree() const
 {
     BaseNodeT const                *node;
     std::vector<BaseNodeT const *> stack;
+    std::size_t                    count{ 0 };
 
     if (nullptr != (node = _m_root._m_down)) {
-        // root node must not have a successor or a predecessor!
-        ASSERT((&_m_root == node->_m_prev) && (nullptr == node->_m_next));
+        _check_roots();
+        for (BaseNodeT const *scan{ node->_m_next }; nullptr != scan; scan = scan->_m_next) {
+            ++count;
+        }
         stack.push_back(node);
+        ++count;
     }
 
     while ( ! stack.empty()) {
@@ -43,8 +48,231 @@ PairingHeapT::validate_tree() const
 
                 // check sibling link: If there is one, it must link back to this node.
                 ASSERT((nullptr == chld->_m_next) || (chld == chld->_m_next->_m_prev));
+                ++count;
             } while (nullptr != (chld = chld->_m_next));
         }
     }
+
+    // and the node count must match the number of reachable nodes
+    ASSERT(count == _m_size);
+}
+
+/// @brief walk the tree once and report its shape
+///
+/// The walk follows the sibling and parent links, without a stack: after the last sibling it
+/// goes back to the first one, whose '_m_prev' is the parent.
+HeapShape
+PairingHeapT::shape_stats() const
+{
+    HeapShape        shape;
+    BaseNodeT const *root{ _m_root._m_down };
+    BaseNodeT const *node{ nullptr };
+    std::size_t      depth{ 1 };
+
+    if (nullptr != root) {
+        for (BaseNodeT const *scan{ root->_m_down }; nullptr != scan; scan = scan->_m_next) {
+            ++shape.roots;
+        }
+        for (BaseNodeT const *scan{ root->_m_next }; nullptr != scan; scan = scan->_m_next) {
+            ++shape.pending;
+        }
+        // the root's siblings are the pending trees: the walk starts below the root
+        shape._visit(0);
+        node = root->_m_down;
+    }
+    while (nullptr != node) {
+        shape._visit(depth);
+        if (nullptr != node->_m_down) {
+            node = node->_m_down;
+            ++depth;
+            continue;
+        }
+        while (nullptr != node && nullptr == node->_m_next) {
+            while (node->_m_prev->_m_next == node) {
+                node = node->_m_prev;
+            }
+            node = node->_m_prev;
+            if (root == node) {
+                node = nullptr;
+            } else {
+                --depth;
+            }
+        }
+        if (nullptr != node) {
+            node = node->_m_next;
+        }
+    }
+    return shape._done();
+}
+
+// -------------------------------------------------------------------------------------------
+// streaming validation
+//
+// 'validate_tree()' keeps a stack of sibling lists, which gets big for the wide trees of a
+// lazy heap.  The checks below walk the tree along its own links instead, like
+// 'shape_stats()', so they need no memory besides a few pointers and touch every node only
+// a bounded number of times.  That suits heaps too big for a stack of their size, or living
+// in mapped memory where a second pass would page the tree in again.
+
+namespace {
+    using BaseNodeT = PairingHeapT::BaseNodeT;
+
+    /// @brief parent of a node: the '_m_prev' of its first sibling
+    const BaseNodeT*
+    parent_of(const BaseNodeT *node)
+    {
+        while (node == node->_m_prev->_m_next) {
+            node = node->_m_prev;
+        }
+        return node->_m_prev;
+    }
 }
+
+/// @brief check the root node and the root list of pending trees
+void
+PairingHeapT::_check_roots() const
+{
+    BaseNodeT const *node{ _m_root._m_down };
+
+    // root node must not have a predecessor, nor a successor unless the pending trees of an
+    // auxiliary twopass heap follow it.  Their least member must be known.
+    ASSERT(&_m_root == node->_m_prev);
+    ASSERT((nullptr == node->_m_next) || (nullptr != _m_amin));
+    if (nullptr != _m_amin) {
+        bool found{ false };
+        for (BaseNodeT const *scan{ node }; nullptr != scan; scan = scan->_m_next) {
+            ASSERT( ! _pred(*scan, *_m_amin));
+            ASSERT((nullptr == scan->_m_next) || (scan == scan->_m_next->_m_prev));
+            found = found || (scan == _m_amin);
+        }
+        ASSERT(found);
+    }
+    if (0 != _m_rank) {
+        // bounded pairing: one member per rank, ascending, none with more children than that
+        std::uint64_t bits{ _m_rank };
+        for (BaseNodeT const *scan{ node }; nullptr != scan; scan = scan->_m_next, bits &= bits - 1) {
+            ASSERT(0 != bits);
+            ASSERT(_degree(scan) <= _lowest(bits));
+        }
+        ASSERT(0 == bits);
+    }
+}
+
+/// @brief check the subtree below @c top in pre-order, up to @c budget nodes
+/// @param top      first node, its siblings are not part of the walk
+/// @param parent   parent of @c top, or @c nullptr for a member of the root list
+/// @param budget   most nodes to visit
+/// @return the number of nodes checked
+std::size_t
+PairingHeapT::_check_walk(
+    const BaseNodeT *top,
+    const BaseNodeT *parent,
+    std::size_t      budget) const
+{
+    BaseNodeT const *node{ top };
+    std::size_t      count{ 0 };
+
+    while (count < budget) {
+        // heap invariant against the parent, and the back links of the next step down
+        ++count;
+        ASSERT((nullptr == parent) || ! _pred(*node, *parent));
+        if (nullptr != node->_m_down) {
+            ASSERT(node == node->_m_down->_m_prev);
+            parent = node;
+            node   = node->_m_down;
+            continue;
+        }
+        // climb until there is a sibling to go on with, but never beside 'top'
+        // the parent of 'top' is never needed: on a root list 'parent_of()' would walk all the
+        // siblings before it, O(k^2) for the whole list
+        while (node != top && nullptr == node->_m_next) {
+            node = parent;
+            if (node == top) {
+                break;
+            }
+            parent = parent_of(node);
+        }
+        if (node == top) {
+            break;
+        }
+        ASSERT(node == node->_m_next->_m_prev);
+        node = node->_m_next;
+    }
+    return count;
+}
+
+/// @brief check the whole heap like @c validate_tree(), without the stack
+/// @throw std::logic_error naming the first check that failed
+///
+/// A corrupted link may make the walk run in circles; it stops one node past the heap size,
+/// which then fails the node count.
+void
+PairingHeapT::validate_stream() const
+{
+    std::size_t count{ 0 };
+
+    if (nullptr != _m_root._m_down) {
+        _check_roots();
+        for (BaseNodeT const *scan{ _m_root._m_down }; nullptr != scan && count <= _m_size; scan = scan->_m_next) {
+            count += _check_walk(scan, nullptr, _m_size - count + 1);
+        }
+    }
+    ASSERT(count == _m_size);
+}
+
+/// @brief check randomly chosen subtrees only
+/// @param subtrees number of subtrees to check
+/// @param budget   most nodes to check per subtree
+/// @param seed     seed of the choice, for a repeatable run
+/// @return the number of nodes checked
+/// @throw std::logic_error naming the first check that failed
+///
+/// Each sample follows a random path through the child and sibling links down to a node
+/// without either, checking the links on the way, backs up a random number of those steps
+/// and checks the subtree found there.  The cost is O(subtrees * (depth + budget)), so a
+/// monitor can spot check a heap of any size now and then; it does not read the root list,
+/// which may be long for a lazy heap.
+std::size_t
+PairingHeapT::validate_sample(
+    std::size_t   subtrees,
+    std::size_t   budget,
+    std::uint64_t seed) const
+{
+    std::mt19937_64  rng{ seed };
+    BaseNodeT const *root{ _m_root._m_down };
+    std::size_t      count{ 0 };
+
+    if (nullptr == root) {
+        ASSERT(0 == _m_size);
+        return 0;
+    }
+    ASSERT(&_m_root == root->_m_prev);
+    while (subtrees-- > 0) {
+        BaseNodeT const *node{ root };
+        std::size_t      depth{ 0 };
+        for (;;) {
+            BaseNodeT const *down{ node->_m_down };
+            BaseNodeT const *next{ node->_m_next };
+            BaseNodeT const *step{ (nullptr == down) ? next : (nullptr == next) ? down : (rng() & 1) ? down : next };
+            if (nullptr == step) {
+                break;
+            }
+            ASSERT(node == step->_m_prev);
+            ASSERT(++depth <= _m_size);
+            node = step;
+        }
+        for (std::size_t back{ std::size_t(rng() % (depth + 1)) }; back > 0; --back) {
+            node = node->_m_prev;
+        }
+        BaseNodeT const *parent{ parent_of(node) };
+        if (&_m_root == parent) {
+            // a member of the root list, none goes before the least one
+            ASSERT((nullptr == _m_amin) || ! _pred(*node, *_m_amin));
+            parent = nullptr;
+        }
+        count += _check_walk(node, parent, budget);
+    }
+    return count;
+}
+
 // --*-- that's all folks --*--
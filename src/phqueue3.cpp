@@ -16,37 +16,6 @@
 
 /// @file Pairing Heap with 3-way nodes
 
-// -------------------------------------------------------------------------------------------
-// connecting nodes / primitives on node level
-
-/// @brief make b the immediate successor of a
-/// @param a    left sibling node
-/// @param b    right sibling node
-/// @return     a if not @c NULL, else b
-PairingHeapT::BaseNodeT*
-PairingHeapT::_cons(
-    BaseNodeT* a,
-    BaseNodeT* b)
-{
-    if (a) a->_m_next = b;
-    if (b) b->_m_prev = a;
-    return a ? a : b;
-}
-
-/// @brief make b the immediate child of a
-/// @param a    parent node
-/// @param b    child node
-/// @return     a if not @c NULL, else b
-PairingHeapT::BaseNodeT*
-PairingHeapT::_dunk(
-    BaseNodeT* a,
-    BaseNodeT* b)
-{
-    if (a) a->_m_down = b;
-    if (b) b->_m_prev = a;
-    return a ? a : b;
-}
-
 PairingHeapT::BaseNodeT *
 PairingHeapT::_yield()
 {
@@ -54,38 +23,19 @@ PairingHeapT::_yield()
     std::swap(temp, _m_root._m_down);
     if (temp)
         temp->_m_prev = nullptr;
+    _m_size = 0;
+    _m_amin = nullptr;
+    _m_rank = 0;
     return temp;
 }
 
 // -------------------------------------------------------------------------------------------
 // cutting nodes or whole subtrees from the heap
 
-/// @brief cut a node from the tree
-/// @param node node to cut from the tree
-/// @return @node as singleton heap
-///
-/// This replaces @c node by the heap created from its children. If there are none, the replacement
-/// has to be the next sibling of the node, of course.  This retains most of the order already
-/// achieved in the heap.
-PairingHeapT::BaseNodeT*
-PairingHeapT::_ncut(
-    BaseNodeT * const node)
-{
-    assert(node && node->_m_prev);    // automagically breaks on sentinel!
-    BaseNodeT *repl{ _build(node->_m_down) };
-    BaseNodeT * const pred{ node->_m_prev };
-    if (node == pred ->_m_next) {
-        _cons(pred, _cons(repl, node->_m_next));
-    } else {
-        _dunk(pred, _cons(repl, node->_m_next));
-    }
-    node->_m_prev = node->_m_next = node->_m_down = nullptr;
-    return node;
-}
-
 /// @brief cut a subtree from the heap
 /// @param node subtree root
 /// @return @c node, but cleanly cut (next/prev are @c nullptr)
+/// @note The node count is not touched: the subtree is meant to be merged back right away.
 PairingHeapT::BaseNodeT*
 PairingHeapT::_tcut(
     BaseNodeT* const node)
@@ -102,124 +52,51 @@ PairingHeapT::_tcut(
     return node;
 }
 
-// -------------------------------------------------------------------------------------------
-// core functions -- this makes a binary tree a Pairing Heap
-
-/// @brief merge two heaps given by the root nodes
-/// @param h1   1st heap / left side
-/// @param h2   2nd heap / right side
-/// @return root of merged heap
-PairingHeapT::BaseNodeT*
-PairingHeapT::_merge(
-    BaseNodeT *h1,
-    BaseNodeT *h2) const
-{
-    BaseNodeT * retv;
-
-    if (nullptr == h1) {
-        retv = h2;
-    } else if (nullptr == h2) {
-        retv = h1;
-    } else if ( ! _pred(*h2, *h1)) {
-        retv = _dunk(h1, _cons(h2, h1->_m_down));
-    } else {
-        retv = _dunk(h2, _cons(h1, h2->_m_down));
-    }
-    if (nullptr != retv) {
-        retv->_m_prev = retv->_m_next = nullptr;
-    }
-    return retv;
-}
-
-/// @brief build a heap from a sibling list
-/// @param node start of list
-/// @return     root of created heap
+/// @brief count the nodes of a subtree
+/// @param node subtree root; its siblings do not count
+/// @return     number of nodes, O(1) extra memory
 ///
-/// This is the "magic" function of the Pairing Heap.  As we have the sibling list as, well,
-/// a list, merging pairs of nodes, storing them in a list, and finally merging all these little
-/// heaps into one is a moderate effort in pointer swivelling.
-PairingHeapT::BaseNodeT*
-PairingHeapT::_build(
-    BaseNodeT *node) const
-{
-    BaseNodeT *q{ nullptr }, *a, *b;
-    while ((a = node) && (b = a->_m_next)) {
-        node = b->_m_next;
-        q = _cons(_merge(a, b), q);
-    }
-
-    // since we did some sloppy chopping, we have to make sure that 'node' does not keep
-    // a dangling pointer to the left/parent side. (This happens if node was a singleton!)
-    if ((a = q)) {
-        do {
-            q = a->_m_next;
-            node = _merge(a, node);
-        } while ((a = q));
-    } else if (node) {
-        node->_m_prev = nullptr;
-    }
-
-    return node;
-}
-
-/// @brief push a node into the heap
-/// @param node node to insert
-/// @return @c node
-PairingHeapT::BaseNodeT*
-PairingHeapT::_push(
-    BaseNodeT* node)
-{
-    _dunk(&_m_root, _merge(_m_root._m_down, node));
-    return node;
-}
-
-/// @brief pop the root element
-/// @return the old root or @c NULL on empty heap
-PairingHeapT::BaseNodeT*
-PairingHeapT::_pop()
-{
-    BaseNodeT *retv { _m_root._m_down };
-    if (nullptr != retv) {
-        _dunk(&_m_root, _build(retv->_m_down));
-        retv->_m_down = retv->_m_next = nullptr;
-    }
-    return retv;
-}
-
-/// @brief handle a decrease in the node's priority
-/// @param node node to reposition in heap
-/// @return     @c node
-///
-/// This an actual O(1) operation, as cutting a subtree from any position is O(1), and so
-/// is the following merge of the subtree with the remaining heap.  As decreasing the the
-/// node's weight does @e not invalidate the subtree rooted at @c node, we can prune and
-/// graft the whole subtree here.  ( @c _reinsert() is more complicated, as we cannot
-/// assume the heap invariant between the node and its children is preserved.)
-PairingHeapT::BaseNodeT*
-PairingHeapT::_decrease(
-    BaseNodeT* node)
-{
-    assert(node && node->_m_prev);
-    if (node != _m_root._m_down) {
-        _dunk(&_m_root, _merge(_m_root._m_down, _tcut(node)));
+/// The walk goes down first, then along the siblings, and back up through their first one
+/// once a sibling list is done.  Every back-link is followed once, so this is O(N).
+std::size_t
+PairingHeapT::_tsize(
+    const BaseNodeT* const node)
+{
+    std::size_t count{ 0 };
+    for (const BaseNodeT *scan{ node }; /*NOP*/; /*NOP*/) {
+        ++count;
+        if (nullptr != scan->_m_down) {
+            scan = scan->_m_down;
+            continue;
+        }
+        while ((scan != node) && (nullptr == scan->_m_next)) {
+            while (scan == scan->_m_prev->_m_next) {
+                scan = scan->_m_prev;              // back to the first sibling
+            }
+            scan = scan->_m_prev;                  // ... and up to the parent
+        }
+        if (scan == node) {
+            return count;
+        }
+        scan = scan->_m_next;
     }
-    return node;
 }
 
-/// @brief re-insert a node after an arbitrary priority change
-/// @param node node to reposition in heap
-/// @return     @c node
-///
-/// This cuts the node from the heap, effectively making it a singleton heap, and then
-/// merges it again with the heap.
-PairingHeapT::BaseNodeT*
-PairingHeapT::_reinsert(
-    BaseNodeT* node)
-{
-    assert(node && node->_m_prev);
-    _dunk(&_m_root, _merge(_m_root._m_down, _ncut(node)));
-    return node;
-}
+// -------------------------------------------------------------------------------------------
+// core functions -- the algorithms are templates in the header; instantiate them here once
+// for the virtual order predicate.
+
+template PairingHeapT::BaseNodeT* PairingHeapT::_push    (const VirtualOrderT&, BaseNodeT*);
+template PairingHeapT::BaseNodeT* PairingHeapT::_pop     (const VirtualOrderT&);
+template PairingHeapT::BaseNodeT* PairingHeapT::_merge   (const VirtualOrderT&, BaseNodeT*, BaseNodeT*) const;
+template PairingHeapT::BaseNodeT* PairingHeapT::_build   (const VirtualOrderT&, BaseNodeT*) const;
+template PairingHeapT::BaseNodeT* PairingHeapT::_ncut    (const VirtualOrderT&, BaseNodeT*);
+template PairingHeapT::BaseNodeT* PairingHeapT::_decrease(const VirtualOrderT&, BaseNodeT*);
+template PairingHeapT::BaseNodeT* PairingHeapT::_reinsert(const VirtualOrderT&, BaseNodeT*);
+template void                     PairingHeapT::_meld    (const VirtualOrderT&, PairingHeapT&);
+template PairingHeapT::BaseNodeT* PairingHeapT::_drain   (const VirtualOrderT&);
+template PairingHeapT::BaseNodeT* PairingHeapT::_split   (const VirtualOrderT&, std::size_t, std::size_t&);
+template void                     PairingHeapT::_adopt   (const VirtualOrderT&, BaseNodeT*, std::size_t);
 
 // -----------------------------------------------------------------------------------------------
 // iterative serialization (destructive node enumeration)
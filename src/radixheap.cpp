@@ -0,0 +1,213 @@
+// -------------------------------------------------------------------------------------------
+// Radix Heap: monotone priority queue on integer keys
+// -------------------------------------------------------------------------------------------
+// This file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+// Implementation of the core functions of a Radix Heap, meant for use in derived classes
+// to handle the bucket management in one location without template code bloat.
+// -------------------------------------------------------------------------------------------
+
+#include <cassert>
+#include "radixheap.hpp"
+
+/// @file Radix Heap with doubly linked bucket lists
+
+// -------------------------------------------------------------------------------------------
+// core functions
+
+/// @brief push a node into the heap
+/// @param node node with the key image loaded
+/// @return @c node
+/// @throw std::out_of_range if the key is below the key popped last
+RadixHeapT::BaseNodeT*
+RadixHeapT::_push(
+    BaseNodeT *node)
+{
+    _admit(node->_m_rkey);
+    _link(node);
+    ++_m_size;
+    if (nullptr != _m_top && node->_m_rkey < _m_top->_m_rkey) {
+        _m_top = node;
+    }
+    return node;
+}
+
+/// @brief find the least node
+/// @return the least node or @c NULL on empty heap
+///
+/// Bucket 0 holds the least keys, all equal.  Otherwise the lowest non-empty bucket is
+/// scanned; the result is kept until a push or key change undercuts it or it is removed.
+/// This does not touch @c _m_last: it may only advance by a pop.
+RadixHeapT::BaseNodeT*
+RadixHeapT::_top() const
+{
+    if (nullptr == _m_top && 0 != _m_size) {
+        if (nullptr != (_m_top = _m_head[0])) {
+            return _m_top;
+        }
+        BaseNodeT *scan{ _m_head[_lowest(_m_mask) + 1] };
+        for (_m_top = scan; nullptr != (scan = scan->_m_next); /*NOP*/) {
+            if (scan->_m_rkey < _m_top->_m_rkey) {
+                _m_top = scan;
+            }
+        }
+    }
+    return _m_top;
+}
+
+/// @brief pop the least node
+/// @return the old least node or @c NULL on empty heap
+///
+/// Popping from a bucket above 0 makes the popped key the new @c _m_last and redistributes
+/// the other nodes of that bucket; each of them goes to a lower bucket.  An empty heap has
+/// nothing to keep in order, so the bound is lifted again.
+RadixHeapT::BaseNodeT*
+RadixHeapT::_pop()
+{
+    BaseNodeT * const retv{ _top() };
+    if (nullptr != retv) {
+        const unsigned bkt{ _bucket_of(retv->_m_rkey) };
+        _unlink(retv);
+        --_m_size;
+        if (0 != bkt) {
+            BaseNodeT *list{ _m_head[bkt] };
+            _m_head[bkt] = nullptr;
+            _m_mask &= ~(std::uint64_t(1) << (bkt - 1));
+            _m_last = retv->_m_rkey;
+            while (nullptr != list) {
+                BaseNodeT *node{ list };
+                list = list->_m_next;
+                _link(node);
+            }
+        }
+        _m_top = _m_head[0];
+        if (0 == _m_size) {
+            _m_last = 0;
+        }
+    }
+    return retv;
+}
+
+/// @brief remove a node from the heap
+/// @param node linked node
+/// @return @c node, unlinked
+RadixHeapT::BaseNodeT*
+RadixHeapT::_ncut(
+    BaseNodeT *node)
+{
+    _unlink(node);
+    --_m_size;
+    if (node == _m_top) {
+        _m_top = nullptr;
+    }
+    if (0 == _m_size) {
+        _m_last = 0;
+    }
+    return node;
+}
+
+/// @brief handle a change of the key of a node
+/// @param node linked node
+/// @param rkey new key image
+/// @return @c node
+/// @throw std::out_of_range if the key is below the key popped last; the node keeps its
+///        old key image, and the heap is unchanged
+///
+/// The node moves if the new key falls into another bucket, which is a lower one for a
+/// decrease.
+RadixHeapT::BaseNodeT*
+RadixHeapT::_rekey(
+    BaseNodeT     *node,
+    std::uint64_t  rkey)
+{
+    _admit(rkey);
+    const std::uint64_t prev{ node->_m_rkey };
+    if (_bucket_of(prev) != _bucket_of(rkey)) {
+        _unlink(node);
+        node->_m_rkey = rkey;
+        _link(node);
+    } else {
+        node->_m_rkey = rkey;
+    }
+    if (node == _m_top) {
+        if (prev < rkey) {
+            _m_top = nullptr;       // some other node may be less now
+        }
+    } else if (nullptr != _m_top && rkey < _m_top->_m_rkey) {
+        _m_top = node;
+    }
+    return node;
+}
+
+/// @brief cut all nodes from the heap and reset it, including the key bound
+/// @return the nodes as list linked by @c _m_next
+RadixHeapT::BaseNodeT*
+RadixHeapT::_yield()
+{
+    BaseNodeT *list{ nullptr };
+    for (unsigned bkt{ 0 }; bkt < _Buckets; ++bkt) {
+        while (BaseNodeT *node{ _m_head[bkt] }) {
+            _m_head[bkt] = node->_m_next;
+            node->_m_prev = nullptr;
+            node->_m_next = list;
+            list = node;
+        }
+    }
+    _m_mask = _m_last = 0;
+    _m_size = 0;
+    _m_top = nullptr;
+    return list;
+}
+
+/// @brief move the nodes of another heap into this (empty) heap
+/// @param rhs  heap to take the nodes from; empty afterwards
+void
+RadixHeapT::_take(
+    RadixHeapT &rhs)
+{
+    assert(0 == _m_size);
+    for (unsigned bkt{ 0 }; bkt < _Buckets; ++bkt) {
+        _m_head[bkt] = rhs._m_head[bkt];
+        rhs._m_head[bkt] = nullptr;
+    }
+    _m_mask = rhs._m_mask;
+    _m_last = rhs._m_last;
+    _m_size = rhs._m_size;
+    _m_top  = rhs._m_top;
+    rhs._m_mask = rhs._m_last = 0;
+    rhs._m_size = 0;
+    rhs._m_top  = nullptr;
+}
+
+// -------------------------------------------------------------------------------------------
+// iteration support
+
+/// @brief first node of the lowest non-empty bucket
+RadixHeapT::BaseNodeT*
+RadixHeapT::_iter_head() const
+{
+    if (nullptr != _m_head[0] || 0 == _m_mask) {
+        return _m_head[0];
+    }
+    return _m_head[_lowest(_m_mask) + 1];
+}
+
+/// @brief next node in the bucket, or the first one of the next non-empty bucket
+RadixHeapT::BaseNodeT*
+RadixHeapT::_iter_succ(
+    const BaseNodeT *node) const
+{
+    if (nullptr != node->_m_next) {
+        return node->_m_next;
+    }
+    // bucket c > 0 has bit c-1, so the buckets above 'bkt' start at bit 'bkt'
+    const unsigned      bkt{ _bucket_of(node->_m_rkey) };
+    const std::uint64_t above{ (bkt < 64) ? (_m_mask & (~std::uint64_t(0) << bkt)) : 0 };
+    return above ? _m_head[_lowest(above) + 1] : nullptr;
+}
+
+// --*-- that's all folks --*--
@@ -0,0 +1,48 @@
+// -------------------------------------------------------------------------------------------
+// Radix Heap: monotone priority queue on integer keys
+// -------------------------------------------------------------------------------------------
+// This file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+// Bucket validation code
+// -------------------------------------------------------------------------------------------
+#include "radixheap.hpp"
+#include <stdexcept>
+
+#define ASSERT(x) do { if (!(x)) throw std::logic_error( #x ); } while(false)
+
+void
+RadixHeapT::validate_tree() const
+{
+    std::size_t        count{ 0 };
+    BaseNodeT const   *least{ nullptr };
+
+    for (unsigned bkt{ 0 }; bkt < _Buckets; ++bkt) {
+        BaseNodeT const *node{ _m_head[bkt] };
+
+        // the mask tells the non-empty buckets above 0
+        if (0 != bkt) {
+            ASSERT((nullptr != node) == (0 != (_m_mask & (std::uint64_t(1) << (bkt - 1)))));
+        }
+        ASSERT((nullptr == node) || (nullptr == node->_m_prev));
+
+        for (/*NOP*/; nullptr != node; node = node->_m_next) {
+            // every node is in the bucket of its key, and none is below the bound
+            ASSERT(bkt == _bucket_of(node->_m_rkey));
+            ASSERT(_m_last <= node->_m_rkey);
+            ASSERT((nullptr == node->_m_next) || (node == node->_m_next->_m_prev));
+            if (nullptr == least || node->_m_rkey < least->_m_rkey) {
+                least = node;
+            }
+            ++count;
+        }
+    }
+
+    // a known least node has the least key, and the node count must match
+    ASSERT((nullptr == _m_top) || (nullptr != least && _m_top->_m_rkey == least->_m_rkey));
+    ASSERT(count == _m_size);
+}
+// --*-- that's all folks --*--
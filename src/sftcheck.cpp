@@ -0,0 +1,98 @@
+// -------------------------------------------------------------------------------------------
+// Soft Heap: an approximate priority queue with a bounded share of out-of-order pops
+// -------------------------------------------------------------------------------------------
+// This file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+// Tree validation code and the count of corrupted values
+// -------------------------------------------------------------------------------------------
+#include "softheap.hpp"
+#include <stdexcept>
+#include <vector>
+
+#define ASSERT(x) do { if (!(x)) throw std::logic_error( #x ); } while(false)
+
+void
+SoftHeapT::validate_tree() const
+{
+    std::vector<TreeNodeT const *> stack;
+    std::size_t                    count{ 0 };
+
+    // Step I: the roots ascend in rank, and each knows the least root from there on
+    for (TreeNodeT const *root{ _m_first }; nullptr != root; root = root->_m_next) {
+        ASSERT((nullptr == root->_m_next) || (root->_m_rank < root->_m_next->_m_rank));
+        bool found{ false };
+        for (TreeNodeT const *scan{ root }; nullptr != scan; scan = scan->_m_next) {
+            ASSERT( ! _pred(*scan, *root->_m_smin));
+            found = found || (scan == root->_m_smin);
+        }
+        ASSERT(found);
+        stack.push_back(root);
+    }
+
+    // Step II: every node holds a list of values, none with a key above that of the node,
+    // and the children of a node are of the next lower rank and do not go before it
+    while ( ! stack.empty()) {
+        TreeNodeT const *node{ stack.back() };
+        stack.pop_back();
+
+        std::size_t items{ 0 };
+        ASSERT(nullptr != node->_m_head);
+        for (BaseNodeT const *scan{ node->_m_head }; nullptr != scan; scan = scan->_m_next) {
+            ASSERT( ! _tpred(*node, *scan));
+            ASSERT((nullptr != scan->_m_next) || (scan == node->_m_tail));
+            ++items;
+        }
+        ASSERT(items == node->_m_count);
+        count += items;
+
+        for (TreeNodeT const *chld : { node->_m_left, node->_m_right }) {
+            if (nullptr != chld) {
+                ASSERT(chld->_m_rank + 1 == node->_m_rank);
+                ASSERT((nullptr == chld->_m_next) && (nullptr == chld->_m_smin));
+                ASSERT( ! _pred(*chld, *node));
+                stack.push_back(chld);
+            }
+        }
+    }
+
+    // Step III: the value count must match, and so must the number of spares
+    ASSERT(count == _m_size);
+    unsigned spares{ 0 };
+    for (TreeNodeT const *scan{ _m_spare }; nullptr != scan; scan = scan->_m_next) {
+        ++spares;
+    }
+    ASSERT(spares == _m_nspare);
+}
+
+/// @brief count the values queued under a key above their own
+///
+/// This walks all of the heap; the soft heap guarantees at most @c eps times the number of
+/// pushes so far.
+std::size_t
+SoftHeapT::corrupted() const
+{
+    std::vector<TreeNodeT const *> stack;
+    std::size_t                    count{ 0 };
+
+    for (TreeNodeT const *root{ _m_first }; nullptr != root; root = root->_m_next) {
+        stack.push_back(root);
+    }
+    while ( ! stack.empty()) {
+        TreeNodeT const *node{ stack.back() };
+        stack.pop_back();
+        for (BaseNodeT const *scan{ node->_m_head }; nullptr != scan; scan = scan->_m_next) {
+            count += _ipred(*scan, *node);
+        }
+        for (TreeNodeT const *chld : { node->_m_left, node->_m_right }) {
+            if (nullptr != chld) {
+                stack.push_back(chld);
+            }
+        }
+    }
+    return count;
+}
+// --*-- that's all folks --*--
@@ -0,0 +1,258 @@
+// -------------------------------------------------------------------------------------------
+// Heap snapshots: flat files for a fast warm restart
+// -------------------------------------------------------------------------------------------
+// This file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+// File access for the snapshots: buffered stdio for writing, mmap for reading on POSIX
+// systems, and a plain read into memory elsewhere.
+// -------------------------------------------------------------------------------------------
+
+#include "snapshot.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+# define PQ_SNAPSHOT_MMAP 1
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#else
+# define PQ_SNAPSHOT_MMAP 0
+#endif
+
+/// @file heap snapshot files
+
+namespace {
+    const char        s_magic[8] = { 'P', 'Q', 'H', 'E', 'A', 'P', '\0', '\x1a' };
+    const std::size_t s_chunk{ std::size_t(1) << 16 };     // bytes per write
+
+    [[noreturn]] void
+    snapshot_error(const std::string &path, const char *what)
+    {
+        throw std::runtime_error("heap snapshot '" + path + "': " + what);
+    }
+}
+
+// -------------------------------------------------------------------------------------------
+// writing
+
+/// @brief open "<path>.tmp" and write the header
+/// @param path         final name of the snapshot
+/// @param value_size   bytes per value
+/// @param count        number of records that will follow
+HeapSnapshotWriter::HeapSnapshotWriter(
+    const char    *path,
+    std::size_t    value_size,
+    std::uint64_t  count)
+    : _m_path{ path }
+    , _m_value_size{ value_size }
+{
+    _m_file = std::fopen((_m_path + ".tmp").c_str(), "wb");
+    if (nullptr == _m_file) {
+        snapshot_error(_m_path, "cannot create");
+    }
+    HeapSnapshotHeader head;
+    std::memcpy(head._m_magic, s_magic, sizeof(s_magic));
+    head._m_version    = HeapSnapshotHeader::version;
+    head._m_value_size = std::uint32_t(value_size);
+    head._m_count      = count;
+    _m_buf.reserve(s_chunk + HeapSnapshotHeader::record_size(value_size));
+    _m_buf.resize(sizeof(head));
+    std::memcpy(_m_buf.data(), &head, sizeof(head));
+}
+
+/// @brief an uncommitted snapshot is removed again
+HeapSnapshotWriter::~HeapSnapshotWriter()
+{
+    if (nullptr != _m_file) {
+        std::fclose(_m_file);
+        std::remove((_m_path + ".tmp").c_str());
+    }
+}
+
+/// @brief append one node record
+/// @param shape    @c left / @c right bits for the children following in pre-order
+/// @param dist     leaf distance of the node
+/// @param value    @c value_size bytes of the value
+void
+HeapSnapshotWriter::record(
+    unsigned    shape,
+    int         dist,
+    const void *value)
+{
+    const std::size_t   pos{ _m_buf.size() };
+    const std::int16_t  d16( dist );
+    _m_buf.resize(pos + HeapSnapshotHeader::record_size(_m_value_size));
+    unsigned char * const rec{ _m_buf.data() + pos };
+    rec[0] = (unsigned char)(shape);
+    rec[1] = 0;
+    std::memcpy(rec + 2, &d16, sizeof(d16));
+    std::memcpy(rec + HeapSnapshotHeader::prefix, value, _m_value_size);
+    if (_m_buf.size() >= s_chunk) {
+        _flush();
+    }
+}
+
+void
+HeapSnapshotWriter::_flush()
+{
+    if (!_m_buf.empty() && _m_buf.size() != std::fwrite(_m_buf.data(), 1, _m_buf.size(), _m_file)) {
+        _fail();
+    }
+    _m_buf.clear();
+}
+
+void
+HeapSnapshotWriter::_fail()
+{
+    std::fclose(_m_file);
+    _m_file = nullptr;
+    std::remove((_m_path + ".tmp").c_str());
+    snapshot_error(_m_path, "write failed");
+}
+
+/// @brief write out the rest and give the file its final name
+void
+HeapSnapshotWriter::commit()
+{
+    _flush();
+    if (0 != std::fflush(_m_file)) {
+        _fail();
+    }
+#if PQ_SNAPSHOT_MMAP
+    if (0 != ::fsync(::fileno(_m_file))) {
+        _fail();
+    }
+#endif
+    const int rc{ std::fclose(_m_file) };
+    _m_file = nullptr;
+    if (0 != rc || 0 != std::rename((_m_path + ".tmp").c_str(), _m_path.c_str())) {
+        std::remove((_m_path + ".tmp").c_str());
+        snapshot_error(_m_path, "write failed");
+    }
+}
+
+// -------------------------------------------------------------------------------------------
+// reading
+
+/// @brief map a snapshot file and check its header
+/// @param path         snapshot file
+/// @param value_size   bytes per value the caller expects
+/// @throw std::runtime_error if the file cannot be read, is no snapshot, is truncated or has
+///        values of another size
+HeapSnapshotReader::HeapSnapshotReader(
+    const char  *path,
+    std::size_t  value_size)
+{
+#if PQ_SNAPSHOT_MMAP
+    const int fd{ ::open(path, O_RDONLY) };
+    if (fd < 0) {
+        snapshot_error(path, "cannot open");
+    }
+    struct stat st;
+    if (0 != ::fstat(fd, &st)) {
+        ::close(fd);
+        snapshot_error(path, "cannot open");
+    }
+    _m_size = std::size_t(st.st_size);
+    if (_m_size >= sizeof(HeapSnapshotHeader)) {
+        void *addr{ ::mmap(nullptr, _m_size, PROT_READ, MAP_PRIVATE, fd, 0) };
+        if (MAP_FAILED == addr) {
+            ::close(fd);
+            snapshot_error(path, "cannot map");
+        }
+        ::madvise(addr, _m_size, MADV_SEQUENTIAL);
+        _m_data   = static_cast<const unsigned char*>(addr);
+        _m_mapped = true;
+    }
+    ::close(fd);
+#else
+    std::FILE *file{ std::fopen(path, "rb") };
+    if (nullptr == file) {
+        snapshot_error(path, "cannot open");
+    }
+    unsigned char chunk[1 << 14];
+    for (std::size_t got; 0 != (got = std::fread(chunk, 1, sizeof(chunk), file)); /*NOP*/) {
+        _m_copy.insert(_m_copy.end(), chunk, chunk + got);
+    }
+    std::fclose(file);
+    _m_data = _m_copy.data();
+    _m_size = _m_copy.size();
+#endif
+
+    HeapSnapshotHeader head;
+    if (_m_size < sizeof(head)) {
+        _unmap();
+        snapshot_error(path, "truncated");
+    }
+    std::memcpy(&head, _m_data, sizeof(head));
+    const char *what{ nullptr };
+    if (0 != std::memcmp(head._m_magic, s_magic, sizeof(s_magic))) {
+        what = "not a snapshot";
+    } else if (HeapSnapshotHeader::version != head._m_version) {
+        what = "unknown version";
+    } else if (value_size != head._m_value_size) {
+        what = "value size mismatch";
+    } else if ((_m_size - sizeof(head)) / HeapSnapshotHeader::record_size(value_size) != head._m_count ||
+               (_m_size - sizeof(head)) % HeapSnapshotHeader::record_size(value_size) != 0) {
+        what = "truncated";
+    }
+    if (nullptr != what) {
+        _unmap();
+        snapshot_error(path, what);
+    }
+    _m_count = std::size_t(head._m_count);
+    _m_recsz = HeapSnapshotHeader::record_size(value_size);
+}
+
+HeapSnapshotReader::~HeapSnapshotReader()
+{
+    _unmap();
+}
+
+void
+HeapSnapshotReader::_unmap()
+{
+#if PQ_SNAPSHOT_MMAP
+    if (_m_mapped) {
+        ::munmap(const_cast<unsigned char*>(_m_data), _m_size);
+        _m_mapped = false;
+    }
+#endif
+}
+
+/// @brief leaf distance of a record
+short
+HeapSnapshotReader::dist(
+    const unsigned char *rec)
+{
+    std::int16_t d16;
+    std::memcpy(&d16, rec + 2, sizeof(d16));
+    return short(d16);
+}
+
+/// @brief check that the shape bytes describe one binary tree in pre-order
+///
+/// Every node fills one open child slot and opens one per child it announces; a tree leaves
+/// no slot open and never runs out of them before the last record.
+bool
+HeapSnapshotReader::is_tree() const
+{
+    std::size_t open{ 1 };
+    for (std::size_t idx{ 0 }; idx < _m_count; ++idx) {
+        const unsigned char *rec{ record(idx) };
+        if (0 == open || 0 != (rec[0] & ~(HeapSnapshotHeader::left | HeapSnapshotHeader::right))) {
+            return false;
+        }
+        open += !!(rec[0] & HeapSnapshotHeader::left) + !!(rec[0] & HeapSnapshotHeader::right) - 1;
+    }
+    return (0 == open) || (0 == _m_count);
+}
+
+// --*-- that's all folks --*--
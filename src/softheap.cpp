@@ -0,0 +1,109 @@
+// -------------------------------------------------------------------------------------------
+// Soft Heap: an approximate priority queue with a bounded share of out-of-order pops
+// -------------------------------------------------------------------------------------------
+// This file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+// Implementation of the parts of a Soft Heap that need no order: the list targets per rank
+// and the bookkeeping of the root list and the spare tree nodes.
+// -------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "softheap.hpp"
+
+/// @file Soft Heap in the simplified form of Kaplan, Tarjan and Zwick
+
+/// @brief set up the rank threshold and the list targets for an error rate
+/// @param eps  share of corrupted values allowed, in (0, 1)
+/// @throw std::invalid_argument if @c eps is out of range
+///
+/// Up to rank @c r a node holds the list of one child; from there on, the target grows by 3/2
+/// per rank.  A list of rank @c k > r is shorter than about 3 times its target, and no more
+/// than n/2^k nodes of rank @c k are ever made, so at most 9n/2^r values share a list with
+/// others: @c r = ceil(log2(9/eps)) makes that @c eps*n.
+void
+SoftHeapT::_setup(
+    double eps)
+{
+    if (!(eps > 0.0 && eps < 1.0)) {
+        throw std::invalid_argument("soft heap error rate must be in (0, 1)");
+    }
+    _m_eps  = eps;
+    _m_rmin = unsigned(std::ceil(std::log2(9.0 / eps)));
+    for (unsigned rank{ 0 }; rank < _Ranks; ++rank) {
+        const std::size_t prev{ rank ? _m_target[rank - 1] : 1 };
+        _m_target[rank] = (rank <= _m_rmin) ? 1
+                        : (prev < std::numeric_limits<std::size_t>::max() / 4) ? (3 * prev + 1) / 2
+                        : prev;
+    }
+}
+
+/// @brief number of links a push does: the roots in front of ranks 0, 1, 2, ...
+unsigned
+SoftHeapT::_carries() const
+{
+    unsigned rank{ 0 };
+    for (TreeNodeT const *root{ _m_first }; nullptr != root && root->_m_rank == rank; root = root->_m_next) {
+        ++rank;
+    }
+    return rank;
+}
+
+/// @brief take a spare tree node, blank but for its key
+SoftHeapT::TreeNodeT*
+SoftHeapT::_spare()
+{
+    assert(0 != _m_nspare);
+    TreeNodeT *tree{ _m_spare };
+    _m_spare = tree->_m_next;
+    --_m_nspare;
+    tree->_m_left = tree->_m_right = tree->_m_next = tree->_m_smin = nullptr;
+    tree->_m_head = tree->_m_tail = nullptr;
+    tree->_m_count = 0;
+    tree->_m_rank  = 0;
+    return tree;
+}
+
+/// @brief cut all trees and the spare tree nodes from the heap, which is empty afterwards
+/// @return the roots and spares, chained via '_m_next'
+SoftHeapT::TreeNodeT*
+SoftHeapT::_yield()
+{
+    TreeNodeT **link{ &_m_first };
+    while (nullptr != *link) {
+        link = &(*link)->_m_next;
+    }
+    *link = _m_spare;
+
+    TreeNodeT *list{ _m_first };
+    _m_first  = _m_spare = nullptr;
+    _m_size   = _m_pushes = 0;
+    _m_nspare = 0;
+    return list;
+}
+
+/// @brief move the trees of @c rhs to this empty heap, along with its error rate
+void
+SoftHeapT::_take(
+    SoftHeapT &rhs)
+{
+    _m_first  = rhs._m_first;
+    _m_size   = rhs._m_size;
+    _m_pushes = rhs._m_pushes;
+    _m_spare  = rhs._m_spare;
+    _m_nspare = rhs._m_nspare;
+    _m_eps    = rhs._m_eps;
+    _m_rmin   = rhs._m_rmin;
+    std::copy(rhs._m_target, rhs._m_target + _Ranks, _m_target);
+
+    rhs._m_first  = rhs._m_spare = nullptr;
+    rhs._m_size   = rhs._m_pushes = 0;
+    rhs._m_nspare = 0;
+}
+
+// --*-- that's all folks --*--
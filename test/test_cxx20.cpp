@@ -0,0 +1,204 @@
+// -------------------------------------------------------------------------------------------
+// priority queue unit tests that need C++20
+// -------------------------------------------------------------------------------------------
+// this file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+// Built into 'pq_tests_cxx20' only, so 'pq_tests' stays on C++17: the constexpr static heaps
+// (inc/staticheap.hpp) and the coroutine interface of the timer queue (inc/timerqueue.hpp).
+// -------------------------------------------------------------------------------------------
+#include "inc/staticheap.hpp"
+#include "inc/timerqueue.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+namespace {
+    // a schedule worked out at compile time
+    template<typename _Heap>
+    constexpr std::array<int, 6> static_schedule() {
+        _Heap h{ 5, 3, 9, 1, 7 };
+        h.pop();
+        h.push(4);
+        h.push(0);
+        std::array<int, 6> out{};
+        for (auto &slot : out) {
+            h.try_pop(slot);
+        }
+        return out;
+    }
+
+    constexpr std::array<int, 6> expected_schedule{ 0, 3, 4, 5, 7, 9 };
+    static_assert(static_schedule<StaticPairingHeap<int, 6>>() == expected_schedule, "constexpr pairing heap");
+    static_assert(static_schedule<StaticPairingHeap<int, 6, std::less<int>, PairingMultiPass>>() == expected_schedule, "constexpr multipass");
+    static_assert(static_schedule<StaticLeftistHeap<int, 6>>() == expected_schedule, "constexpr leftist heap");
+
+    // ... and baked into the binary
+    constexpr StaticPairingHeap<int, 8> baked_pairing{ 4, 2, 6 };
+    constexpr StaticLeftistHeap<int, 8> baked_leftist{ 4, 2, 6 };
+    static_assert(2 == baked_pairing.front() && 3 == baked_pairing.size(), "constexpr pairing heap");
+    static_assert(2 == baked_leftist.front() && 3 == baked_leftist.size(), "constexpr leftist heap");
+}
+
+TEST(StaticHeap, Constexpr) {
+    std::vector<int> out;
+    StaticLeftistHeap<int, 8> copy{ baked_leftist };
+    for (int value; copy.try_pop(value); ) out.push_back(value);
+    EXPECT_EQ((std::vector<int>{ 2, 4, 6 }), out);
+    EXPECT_EQ(3u, baked_leftist.size());
+    baked_leftist.validate_tree();
+    baked_pairing.validate_tree();
+}
+
+#if defined(PQ_TIMER_COROUTINES)
+namespace {
+    // a clock the tests move by hand
+    struct ManualClock {
+        using rep        = std::int64_t;
+        using period     = std::milli;
+        using duration   = std::chrono::duration<rep, period>;
+        using time_point = std::chrono::time_point<ManualClock>;
+        static constexpr bool is_steady{ true };
+
+        static time_point now() { return current; }
+        static inline time_point current{};
+    };
+
+    using ManualTime = ManualClock::time_point;
+
+    ManualTime at(int ms) { return ManualTime{ ManualClock::duration{ ms } }; }
+
+    // a coroutine nobody waits for: it starts right away and frees itself at the end
+    struct Detached {
+        struct promise_type {
+            Detached            get_return_object() { return {}; }
+            std::suspend_never  initial_suspend() noexcept { return {}; }
+            std::suspend_never  final_suspend() noexcept { return {}; }
+            void                return_void() { /*NOP*/ }
+            void                unhandled_exception() { std::terminate(); }
+        };
+    };
+
+    using CoQueue = TimerQueue<TimerWakeup, ManualClock>;
+
+    Detached
+    sleep_task(CoQueue &timers, CoQueue::sleeper *&self, std::vector<int> &log, int id, ManualTime due)
+    {
+        CoQueue::sleeper sleep{ timers.sleep_until(due) };
+        self = &sleep;
+        co_await sleep;
+        self = nullptr;
+        log.push_back(id);
+    }
+
+    // like 'sleep_task()', but logs '-id' when its frame goes, whether it ran to the end or
+    // was destroyed while suspended -- provided its sleeper is disarmed by then
+    Detached
+    guarded_task(CoQueue &timers, std::vector<int> &log, int id, ManualTime due)
+    {
+        struct Guard {
+            CoQueue          &timers;
+            CoQueue::sleeper &sleep;
+            std::vector<int> &log;
+            int               id;
+            ~Guard() {
+                if (!sleep.armed() && !timers.cancel(sleep).co) {
+                    log.push_back(-id);
+                }
+            }
+        };
+        CoQueue::sleeper sleep{ timers.sleep_until(due) };
+        Guard            guard{ timers, sleep, log, id };
+        co_await sleep;
+        log.push_back(id);
+    }
+}
+
+TEST(TimerQueue, Coroutine) {
+    ManualClock::current = at(0);
+    CoQueue timers;
+    std::vector<int> log;
+    CoQueue::sleeper *sleepers[5]{};
+
+    // a deadline that has passed does not suspend at all
+    sleep_task(timers, sleepers[0], log, 0, at(0));
+    EXPECT_EQ(std::vector<int>{ 0 }, log);
+    EXPECT_TRUE(timers.empty());
+
+    sleep_task(timers, sleepers[1], log, 1, at(30));
+    sleep_task(timers, sleepers[2], log, 2, at(10));
+    sleep_task(timers, sleepers[3], log, 3, at(20));
+    sleep_task(timers, sleepers[4], log, 4, at(40));
+    EXPECT_EQ(4u, timers.size());
+    EXPECT_TRUE(sleepers[1]->armed());
+
+    // reschedule moves a sleeper, cancel hands the suspended coroutine back
+    EXPECT_TRUE(timers.reschedule(*sleepers[3], at(5)));
+    EXPECT_EQ(at(5), sleepers[3]->due());
+    CoQueue::sleeper *gone{ sleepers[4] };
+    TimerWakeup wake{ timers.cancel(*gone) };
+    ASSERT_TRUE(wake.co);
+    EXPECT_FALSE(gone->armed());
+    EXPECT_FALSE(timers.cancel(*gone).co);
+    wake.co.destroy();
+
+    EXPECT_EQ(0u, timers.resume_until(at(4)));
+    EXPECT_EQ(2u, timers.resume_until(at(15)));
+    EXPECT_EQ((std::vector<int>{ 0, 3, 2 }), log);
+
+    // once its timer expired, a sleeper cannot be cancelled any more, not even by a coroutine
+    // resumed before it in the same batch
+    sleep_task(timers, sleepers[3], log, 3, at(30));
+    CoQueue::sleeper *late{ sleepers[1] };
+    timers.expire_until(at(30), [&](std::vector<CoQueue::timer> &batch) {
+        EXPECT_EQ(2u, batch.size());
+        EXPECT_FALSE(late->armed());
+        EXPECT_FALSE(timers.cancel(*late).co);
+        for (CoQueue::timer &item : batch) item.payload.resume();
+    });
+    EXPECT_EQ((std::vector<int>{ 0, 3, 2, 1, 3 }), log);
+    EXPECT_TRUE(timers.empty());
+}
+
+TEST(TimerQueue, ClearSleepers) {
+    static_assert(!std::is_copy_constructible<CoQueue::sleeper>::value, "the queue points to the sleeper");
+    static_assert(!std::is_move_constructible<CoQueue::sleeper>::value, "the queue points to the sleeper");
+
+    ManualClock::current = at(0);
+    std::vector<int> log;
+    {
+        CoQueue timers;
+        guarded_task(timers, log, 1, at(10));
+        guarded_task(timers, log, 2, at(20));
+        guarded_task(timers, log, 3, at(30));
+        EXPECT_EQ(1u, timers.resume_until(at(10)));
+        EXPECT_EQ((std::vector<int>{ 1, -1 }), log);
+
+        // the armed sleepers are disarmed before their coroutines are destroyed
+        log.clear();
+        timers.clear();
+        EXPECT_TRUE(timers.empty());
+        std::sort(log.begin(), log.end());
+        EXPECT_EQ((std::vector<int>{ -3, -2 }), log);
+
+        // the queue is as good as new, and its destructor does the same
+        log.clear();
+        guarded_task(timers, log, 4, at(40));
+        EXPECT_EQ(1u, timers.size());
+        EXPECT_TRUE(log.empty());
+    }
+    EXPECT_EQ(std::vector<int>{ -4 }, log);
+}
+#endif
+
+// --*-- that's all folks --*--
@@ -9,8 +9,78 @@
 // -------------------------------------------------------------------------------------------
 #include "inc/lhqueue2.hpp"
 #include "inc/mdqueue3.hpp"
+#include "inc/bounded.hpp"
+#include "inc/indexed.hpp"
+#include "inc/timerqueue.hpp"
+#include "inc/minmax.hpp"
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// an output for pop_n() and drain() that throws once its budget is spent
+struct LimitedSink {
+    using iterator_category = std::output_iterator_tag;
+    using value_type        = void;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = void;
+    using reference         = void;
+
+    std::vector<int> *v;
+    int               budget;
+
+    LimitedSink &operator*()  { return *this; }
+    LimitedSink &operator++() { return *this; }
+    LimitedSink &operator=(int x) {
+        if (0 == budget--) throw std::length_error("full");
+        v->push_back(x);
+        return *this;
+    }
+};
+
+// an allocator that fails once its budget is spent, and counts the blocks it handed out;
+// the budget is shared by all threads, -1 means no limit
+std::atomic<long> g_alloc_budget{ -1 };
+std::atomic<long> g_alloc_live{ 0 };
+
+template<typename T>
+struct BudgetAlloc {
+    using value_type      = T;
+    using is_always_equal = std::true_type;
+
+    BudgetAlloc() = default;
+    template<typename U> BudgetAlloc(const BudgetAlloc<U> &) {}
+
+    T *allocate(std::size_t n) {
+        if (0 == g_alloc_budget.fetch_sub(1)) throw std::bad_alloc();
+        ++g_alloc_live;
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T *p, std::size_t n) {
+        --g_alloc_live;
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template<typename U> bool operator==(const BudgetAlloc<U> &) const { return true; }
+    template<typename U> bool operator!=(const BudgetAlloc<U> &) const { return false; }
+};
+
+} // namespace
 
 TEST(MinDist2, InsertAndPopOrder) {
     LeftistHeapEasy<int> pq;
@@ -61,6 +131,239 @@ TEST(MinDist2, BatchBuild) {
     EXPECT_TRUE(b.empty());
 }
 
+// parallel bulk build: random access input (nodes created on the workers), a list (nodes
+// created up front), and a pool allocator (thread-affine, nodes created up front)
+template<typename _Heap>
+class MinDistParallel : public ::testing::Test {};
+using MinDistParallels = ::testing::Types<
+    LeftistHeapEasy<int>,
+    LeftistHeapEasy<int, std::less<int>, NodePoolAllocator<int>, true, HeapStats>,
+    LeftistHeapEasy<int, std::less<int>, std::allocator<int>, false, NoHeapStats, true>,
+    MinDistHeap<int>,
+    MinDistHeap<int, std::less<int>, NodePoolAllocator<int>, true, HeapStats>,
+    MinDistHeap<int, std::less<int>, std::allocator<int>, false, NoHeapStats, true>>;
+TYPED_TEST_SUITE(MinDistParallel, MinDistParallels);
+
+TYPED_TEST(MinDistParallel, Build) {
+    std::mt19937 rng(4711);
+    std::vector<int> v(100000);
+    for (auto &x : v) x = int(rng() % 1000000);
+    std::list<int> l(v.begin(), v.end());
+
+    TypeParam a, b;
+    a.push(7);
+    a.push(v.begin(), v.end(), HeapParallel{ 4 });
+    b.push(l.begin(), l.end(), HeapParallel{ 3 });
+    ASSERT_EQ(v.size() + 1, a.size());
+    ASSERT_EQ(v.size(), b.size());
+    a.validate_tree();
+    b.validate_tree();
+
+    a.merge(b);
+    v.push_back(7);
+    v.insert(v.end(), l.begin(), l.end());
+    std::sort(v.begin(), v.end());
+    for (int x : v) {
+        ASSERT_EQ(x, a.front());
+        a.pop();
+    }
+    EXPECT_TRUE(a.empty());
+}
+
+// a node allocation failing on a worker or in the list path: the exception comes through,
+// the nodes made so far are gone, and the heap holds what it held before
+template<typename _Heap>
+class MinDistParallelThrow : public ::testing::Test {};
+using MinDistParallelThrows = ::testing::Types<
+    LeftistHeapEasy<int, std::less<int>, BudgetAlloc<int>>,
+    MinDistHeap<int, std::less<int>, BudgetAlloc<int>>>;
+TYPED_TEST_SUITE(MinDistParallelThrow, MinDistParallelThrows);
+
+TYPED_TEST(MinDistParallelThrow, Build) {
+    std::vector<int> v(100000);
+    for (int i = 0; i < 100000; ++i) v[i] = i * 7919 % 100000;
+    std::list<int> l(v.begin(), v.end());
+
+    TypeParam a;
+    for (int i : { 5, 3, 8 }) a.push(i);
+    const long live{ g_alloc_live };
+    for (long budget : { 60000L, 10L, 0L }) {
+        g_alloc_budget = budget;
+        EXPECT_THROW(a.push(v.begin(), v.end(), HeapParallel{ 4 }), std::bad_alloc);
+        g_alloc_budget = budget;
+        EXPECT_THROW(a.push(l.begin(), l.end(), HeapParallel{ 4 }), std::bad_alloc);
+        g_alloc_budget = -1;
+        EXPECT_EQ(live, g_alloc_live);
+        EXPECT_EQ(3u, a.size());
+        a.validate_tree();
+        EXPECT_EQ(3, a.front());
+    }
+
+    a.push(v.begin(), v.end(), HeapParallel{ 4 });
+    EXPECT_EQ(100003u, a.size());
+    a.validate_tree();
+}
+
+TEST(MinDist2, ParallelBuildSmall) {
+    LeftistHeapEasy<int> small;         // below the grain: a single chunk
+    std::vector<int> v{ 3, 1, 2 };
+    small.push(v.begin(), v.end(), HeapParallel{ 8 });
+    EXPECT_EQ(1, small.front());
+    small.validate_tree();
+}
+
+template<typename _Heap>
+class MinDistBulkPop : public ::testing::Test {};
+using MinDistBulkPops = ::testing::Types<
+    LeftistHeapEasy<int>,
+    LeftistHeapEasy<int, std::less<int>, std::allocator<int>, true, HeapStats, true>,
+    MinDistHeap<int>,
+    MinDistHeap<int, std::less<int>, std::allocator<int>, true, HeapStats, true>>;
+TYPED_TEST_SUITE(MinDistBulkPop, MinDistBulkPops);
+
+TYPED_TEST(MinDistBulkPop, PopNAndDrain) {
+    TypeParam h;
+    std::vector<int> v(1000);
+    for (int i = 0; i < 1000; ++i) v[i] = i / 2;
+    std::shuffle(v.begin(), v.end(), std::mt19937(4711));
+    for (int x : v) h.push(x);
+
+    std::vector<int> out;
+    h.pop_n(10, std::back_inserter(out));
+    ASSERT_EQ(10u, out.size());
+    EXPECT_EQ(990u, h.size());
+    h.validate_tree();
+
+    EXPECT_THROW(h.drain(LimitedSink{ &out, 20 }), std::length_error);
+    EXPECT_EQ(970u, h.size());
+    h.validate_tree();
+
+    h.drain(std::back_inserter(out));
+    EXPECT_TRUE(h.empty());
+    EXPECT_EQ(0u, h.size());
+    h.pop_n(5, std::back_inserter(out));
+    std::sort(v.begin(), v.end());
+    EXPECT_EQ(v, out);
+}
+
+TEST(MinDist2, ReplaceTop) {
+    LeftistHeapEasy<int, std::less<int>, std::allocator<int>, false, HeapStats, true> a;
+    for (int i : { 5, 3, 8, 1 }) a.push(i);     // lazy: 'replace_top()' settles first
+    EXPECT_EQ(1, a.replace_top(9));
+    EXPECT_EQ(3, a.front());
+    EXPECT_EQ(2, a.push_pop(2));
+    EXPECT_EQ(3, a.push_pop(4));
+    EXPECT_EQ(0u, a.stats().pops);
+    a.validate_tree();
+
+    BoundedHeap<int, 3, std::less<int>, LeftistHeapEasy<int, ReverseOrder<std::less<int>>>> best;
+    for (int x : { 7, 2, 9, 4, 1, 8 }) best.offer(x);
+    EXPECT_EQ(4, best.worst());
+    EXPECT_EQ((std::vector<int>{ 1, 2, 4 }), best.sorted());
+}
+
+TEST(MinDist2, InlineOrder) {
+    LeftistHeapEasy<int, std::less<int>, std::allocator<int>, true> pq;
+    std::vector<int> v(200);
+    for (int i = 0; i < 200; ++i) v[i] = i;
+    std::shuffle(v.begin(), v.end(), std::mt19937(4711));
+
+    pq.push(v.begin(), v.begin() + 100);
+    for (auto it{ v.begin() + 100 }; it != v.end(); ++it) pq.push(*it);
+    pq.validate_tree(v.size());
+
+    for (int i = 0; i < 200; ++i) {
+        ASSERT_EQ(i, pq.front());
+        pq.pop();
+    }
+    EXPECT_TRUE(pq.empty());
+}
+
+TEST(MinDist2, MeldMany) {
+    // many melds of heaps with long right spines; checks the leftist property throughout
+    std::vector<LeftistHeapEasy<int>> heaps(64);
+    std::vector<int> all;
+    std::mt19937 rng(815);
+    for (auto &h : heaps) {
+        for (int i = 0; i < 100; ++i) {
+            int x = int(rng() % 10000);
+            h.push(x);
+            all.push_back(x);
+        }
+    }
+    for (size_t step = 1; step < heaps.size(); step *= 2) {
+        for (size_t i = 0; i + step < heaps.size(); i += 2 * step) {
+            heaps[i].merge(heaps[i + step]);
+            heaps[i].validate_tree(100 * 2 * step);
+        }
+    }
+
+    std::sort(all.begin(), all.end());
+    for (int x : all) {
+        ASSERT_EQ(x, heaps.front().front());
+        heaps.front().pop();
+    }
+    EXPECT_TRUE(heaps.front().empty());
+}
+
+TEST(MinDist2, SizeAndStats) {
+    LeftistHeapEasy<int, std::less<int>, std::allocator<int>, false, HeapStats> a, b;
+    std::vector<int> v(100);
+    for (int i = 0; i < 100; ++i) v[i] = i;
+    a.push(v.begin(), v.end());
+    for (int i = 0; i < 50; ++i) b.push(i);
+    ASSERT_EQ(100u, a.size());
+    EXPECT_EQ(100u, a.stats().max_roots);
+
+    a.merge(b);
+    ASSERT_EQ(150u, a.size());
+    ASSERT_EQ(0u, b.size());
+    a.validate_tree();
+
+    for (int i = 0; i < 10; ++i) a.pop();
+    ASSERT_EQ(140u, a.size());
+    EXPECT_EQ(10u, a.stats().pops);
+    EXPECT_GT(a.stats().links, 0u);
+    a.validate_tree();
+}
+
+TEST(MinDist2, LazyBurst) {
+    // a burst of pushes costs no comparison at all; the first 'front()' builds in O(N)
+    LeftistHeapEasy<int, std::less<int>, std::allocator<int>, true, HeapStats, true> a, b;
+    std::vector<int> v(10000);
+    for (int i = 0; i < 10000; ++i) v[i] = i;
+    std::shuffle(v.begin(), v.end(), std::mt19937(4711));
+
+    for (int x : v) a.push(x);
+    ASSERT_EQ(10000u, a.size());
+    EXPECT_EQ(0u, a.stats().comparisons);
+    a.validate_tree();
+
+    ASSERT_EQ(0, a.front());
+    EXPECT_EQ(10000u, a.stats().max_roots);
+    EXPECT_LT(a.stats().links, 3u * 10000u);
+    a.validate_tree();
+
+    // pending nodes survive a move, and go along with a merge
+    for (int i = 10000; i < 10100; ++i) a.push(i);
+    for (int i = -50; i < 0; ++i) b.push(i);
+    auto c{ std::move(a) };
+    c.merge(b);
+    ASSERT_TRUE(b.empty());
+    ASSERT_EQ(10150u, c.size());
+    c.validate_tree();
+    for (int i = -50; i < 10100; ++i) {
+        ASSERT_EQ(i, c.front());
+        c.pop();
+    }
+    EXPECT_TRUE(c.empty());
+
+    // and clearing takes the pending nodes, too
+    for (int x : v) c.push(x);
+    c.clear();
+    EXPECT_TRUE(c.empty());
+}
+
 TEST(MinDist3, InsertAndPopOrder) {
     MinDistHeap<int> pq;
 
@@ -199,4 +502,666 @@ TEST(MinDist3, IterBackAfterErase) {
     ASSERT_EQ(50, cnt);
 }
 
+TEST(MinDist3, InlineOrder) {
+    MinDistHeap<int, std::less<int>, std::allocator<int>, true> pq;
+    std::vector<int> v(200);
+    for (int i = 0; i < 200; ++i) v[i] = i;
+    std::shuffle(v.begin(), v.end(), std::mt19937(4711));
+
+    pq.push(v);
+    pq.validate_tree();
+    for (int i = 0; i < 200; ++i) {
+        ASSERT_EQ(i, pq.front());
+        pq.pop();
+    }
+    EXPECT_TRUE(pq.empty());
+}
+
+TEST(MinDist3, DecreaseAndReadjust) {
+    MinDistHeap<int> a;
+    std::vector<MinDistHeap<int>::iterator> its;
+    for (int i = 0; i < 100; ++i)
+        its.push_back(a.push(i));
+
+    // push some items down, pull others up; right children are hit as well as left ones
+    for (int i = 0; i < 100; i += 2) {
+        *its[i] += 1000;
+        a.readjust(its[i]);
+        a.validate_tree();
+    }
+    for (int i = 1; i < 100; i += 4) {
+        *its[i] -= 1000;
+        a.decrease(its[i]);
+        a.validate_tree();
+    }
+
+    int prev{ a.front() }, cnt{ 0 };
+    while (!a.empty()) {
+        ASSERT_LE(prev, a.front());
+        prev = a.front();
+        a.pop();
+        ++cnt;
+    }
+    ASSERT_EQ(100, cnt);
+}
+
+TEST(MinDist3, SizeAndStats) {
+    MinDistHeap<int, std::less<int>, std::allocator<int>, false, HeapStats> a, b;
+    std::vector<decltype(a)::iterator> its;
+    for (int i = 0; i < 100; ++i) its.push_back(a.push(i));
+    b.push(std::vector<int>{ 5, 3, 1 });
+    ASSERT_EQ(3u, b.size());
+
+    a.merge(b);
+    ASSERT_EQ(103u, a.size());
+    ASSERT_EQ(0u, b.size());
+
+    a.remove(its[10]);
+    *its[20] -= 100;
+    a.decrease(its[20]);
+    *its[30] += 100;
+    a.readjust(its[30]);
+    ASSERT_EQ(102u, a.size());
+    a.validate_tree();
+
+    auto c{ std::move(a) };
+    ASSERT_EQ(102u, c.size());
+    c.pop();
+    ASSERT_EQ(101u, c.size());
+    EXPECT_EQ(1u, c.stats().pops);
+    EXPECT_GT(c.stats().comparisons, 0u);
+    c.validate_tree();
+}
+
+TEST(MinDist3, LazyInsert) {
+    MinDistHeap<int, std::less<int>, std::allocator<int>, false, HeapStats, true> a;
+    std::vector<decltype(a)::iterator> its;
+    for (int i = 0; i < 1000; ++i) its.push_back(a.push(999 - i));
+    EXPECT_EQ(0u, a.stats().comparisons);
+    ASSERT_EQ(1000u, a.size());
+    a.validate_tree();
+
+    // iterator based operations settle the heap first; so does begin()
+    *its[10] -= 2000;
+    a.decrease(its[10]);
+    a.validate_tree();
+    EXPECT_EQ(1000u, a.stats().max_roots);
+    for (int i = 0; i < 100; ++i) a.push(2000 + i);
+    std::size_t cnt{ 0 };
+    for (auto it{ a.begin() }; it != a.end(); ++it) ++cnt;
+    ASSERT_EQ(1100u, cnt);
+
+    for (int i = 0; i < 100; ++i) a.push(5000 + i);
+    a.remove(its[20]);
+    *its[30] += 10000;
+    a.readjust(its[30]);
+    ASSERT_EQ(1199u, a.size());
+    a.validate_tree();
+
+    ASSERT_EQ(989 - 2000, a.front());
+    int prev{ a.front() };
+    while (!a.empty()) {
+        ASSERT_LE(prev, a.front());
+        prev = a.front();
+        a.pop();
+    }
+    ASSERT_EQ(969 + 10000, prev);
+
+    for (int i = 0; i < 100; ++i) a.push(i);
+    a.clear();
+    EXPECT_EQ(0u, a.size());
+}
+
+namespace {
+    struct Fat {
+        std::uint32_t prio;
+        char          payload[196];
+    };
+    struct FatPrio {
+        std::uint32_t operator()(const Fat &f) const { return f.prio; }
+    };
+
+    // to get at the node layout
+    template<typename _Heap>
+    struct NodeProbe : public _Heap {
+        static constexpr std::size_t header{ sizeof(typename _Heap::_XNode) - sizeof(Fat) };
+    };
+}
+
+TEST(MinDist3, KeyOf) {
+    using Keyed  = MinDistHeap<Fat, std::less<std::uint32_t>, std::allocator<Fat>, false, NoHeapStats, false, FatPrio>;
+    using Keyed2 = LeftistHeapEasy<Fat, std::less<std::uint32_t>, std::allocator<Fat>, false, NoHeapStats, false, FatPrio>;
+
+    // a 32-bit key goes into the padding behind '_m_dist': the node headers don't grow at all
+    EXPECT_EQ(4 * sizeof(void*), NodeProbe<Keyed>::header);
+    EXPECT_EQ(3 * sizeof(void*), NodeProbe<Keyed2>::header);
+
+    Keyed a;
+    std::vector<Keyed::iterator> its;
+    for (std::uint32_t i = 0; i < 200; ++i) its.push_back(a.push(Fat{ 3 * i, { 0 } }));
+
+    // the cached key follows the value through decrease and readjust
+    its[100]->prio = 1;
+    a.decrease(its[100]);
+    its[0]->prio = 10000;
+    a.readjust(its[0]);
+    a.validate_tree();
+    ASSERT_EQ(1u, a.front().prio);
+
+    LeftistHeapEasy<Fat, std::less<std::uint32_t>, std::allocator<Fat>, true, NoHeapStats, true, FatPrio> b;
+    for (std::uint32_t i = 0; i < 200; ++i) b.push(Fat{ (7 * i) % 200, { 0 } });
+    b.validate_tree();
+
+    for (std::uint32_t i = 0; i < 200; ++i) {
+        ASSERT_EQ(i, b.front().prio);
+        b.pop();
+    }
+
+    std::uint32_t prev{ 0 };
+    while (!a.empty()) {
+        ASSERT_LE(prev, a.front().prio);
+        prev = a.front().prio;
+        a.pop();
+    }
+    ASSERT_EQ(10000u, prev);
+}
+
+namespace {
+    struct JobMinDist3 : public MinDistHeapHook {
+        int prio;
+    };
+    struct JobMinDist3Less {
+        bool operator()(const JobMinDist3 &j1, const JobMinDist3 &j2) const { return j1.prio < j2.prio; }
+    };
+}
+
+TEST(Intrusive, MinDist3) {
+    std::vector<JobMinDist3> jobs(100);
+    IntrusiveMinDistHeap<JobMinDist3, JobMinDist3Less> pq;
+
+    for (int i = 0; i < 100; ++i) {
+        jobs[i].prio = i;
+        pq.push(jobs[i]);
+    }
+    EXPECT_TRUE(pq.is_linked(jobs[42]));
+    pq.validate_tree();
+
+    // odd jobs go away, every 4th job gets urgent, job 10 becomes the least urgent
+    for (int i = 1; i < 100; i += 2) {
+        pq.remove(jobs[i]);
+        EXPECT_FALSE(pq.is_linked(jobs[i]));
+    }
+    for (int i = 0; i < 100; i += 4) {
+        jobs[i].prio -= 1000;
+        pq.decrease(jobs[i]);
+    }
+    jobs[10].prio = 5000;
+    pq.readjust(jobs[10]);
+    pq.validate_tree();
+
+    int cnt{ 0 }, prev{ pq.front().prio };
+    while (JobMinDist3 *job = pq.pop()) {
+        ASSERT_LE(prev, job->prio);
+        ASSERT_FALSE(pq.is_linked(*job));
+        prev = job->prio;
+        ++cnt;
+    }
+    ASSERT_EQ(50, cnt);
+    ASSERT_EQ(5000, prev);              // job 10 came out last
+
+    // elements can be relinked after coming out
+    for (auto &j : jobs) pq.push(j);
+    for (auto it{ pq.begin() }; it != pq.end(); /*NOP*/) {
+        it = (it->prio & 1) ? pq.remove(it) : ++it;
+    }
+    pq.validate_tree();
+    pq.clear();
+    for (auto &j : jobs) ASSERT_FALSE(pq.is_linked(j));
+}
+
+TEST(IndexedHeap, MinDist3) {
+    // Dijkstra on a random graph, checked against the O(V^2) textbook version
+    constexpr unsigned V{ 500 }, E{ 4000 }, inf{ ~0u };
+    std::mt19937 rng(16);
+    std::vector<std::vector<std::pair<unsigned, unsigned>>> adj(V);
+    for (unsigned e = 0; e < E; ++e) {
+        adj[rng() % V].emplace_back(rng() % V, rng() % 100);
+    }
+
+    std::vector<unsigned> ref(V, inf), dist(V, inf);
+    std::vector<bool>     done(V, false);
+    ref[0] = 0;
+    for (unsigned round = 0; round < V; ++round) {
+        unsigned v{ V };
+        for (unsigned w = 0; w < V; ++w) {
+            if (!done[w] && ref[w] != inf && (v == V || ref[w] < ref[v])) v = w;
+        }
+        if (v == V) break;
+        done[v] = true;
+        for (auto [w, len] : adj[v]) ref[w] = std::min(ref[w], ref[v] + len);
+    }
+
+    IndexedMinDistHeap<unsigned> pq(V);
+    EXPECT_TRUE(pq.push_or_decrease(0, 0));
+    EXPECT_FALSE(pq.push_or_decrease(0, 7));
+    while (!pq.empty()) {
+        auto [v, d] = pq.top();
+        ASSERT_EQ(v, pq.pop());
+        ASSERT_FALSE(pq.contains(v));
+        dist[v] = d;
+        for (auto [w, len] : adj[v]) {
+            if (dist[w] == inf) pq.push_or_decrease(w, d + len);
+        }
+    }
+    pq.validate_tree();
+    EXPECT_EQ(ref, dist);
+
+    // erase and update in any direction
+    for (unsigned id = 0; id < 10; ++id) pq.push_or_update(id, 100 + id);
+    EXPECT_TRUE(pq.erase(3));
+    EXPECT_FALSE(pq.erase(3));
+    EXPECT_FALSE(pq.contains(3));
+    pq.push_or_update(7, 1);
+    pq.push_or_update(0, 500);
+    pq.validate_tree();
+    EXPECT_EQ(9u, pq.size());
+    EXPECT_EQ(7u, pq.pop());
+    EXPECT_EQ(1u, pq.pop());
+    pq.clear();
+    EXPECT_FALSE(pq.contains(0));
+    EXPECT_THROW(pq.pop(), std::invalid_argument);
+}
+
+TEST(Snapshot, MinDist3) {
+    using Heap = MinDistHeap<int, std::less<int>, std::allocator<int>, false, HeapStats>;
+    const std::string path{ ::testing::TempDir() + "pq_mindist.snap" };
+    std::mt19937 rng(99);
+    Heap a;
+    for (int i = 0; i < 5000; ++i) a.push(int(rng() % 100000));
+    for (int i = 0; i < 1000; ++i) a.pop();    // an irregular shape
+    a.save(path);
+
+    // relinked: the same tree, hence the same iteration sequence, and no comparisons
+    Heap b;
+    b.load(path);
+    b.validate_tree();
+    ASSERT_EQ(a.size(), b.size());
+    EXPECT_EQ(0u, b.stats().comparisons);
+    EXPECT_TRUE(std::equal(a.begin(), a.end(), b.begin(), b.end()));
+
+    // loaded into a non-empty heap, rebuilt, and rebuilt because the shape is damaged
+    Heap c, d, e;
+    c.push(-1);
+    c.load(path);
+    d.load(path, HeapLoad::rebuild);
+    {
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(sizeof(HeapSnapshotHeader));
+        f.put(char(HeapSnapshotHeader::left | HeapSnapshotHeader::right));
+    }
+    e.load(path);
+    std::vector<int> ref, out;
+    a.drain(std::back_inserter(ref));
+    for (Heap *h : { &c, &d, &e }) {
+        h->validate_tree();
+        out.clear();
+        h->drain(std::back_inserter(out));
+        if (h == &c) {
+            ASSERT_EQ(-1, out.front());
+            out.erase(out.begin());
+        }
+        EXPECT_EQ(ref, out);
+    }
+
+    // a saved leaf distance that does not fit its subtrees: rebuilt, not relinked
+    b.save(path);
+    {
+        const std::int16_t bad{ 99 };
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(sizeof(HeapSnapshotHeader) + 2);
+        f.write(reinterpret_cast<const char*>(&bad), sizeof(bad));
+    }
+    Heap g;
+    g.load(path);
+    g.validate_tree();
+    EXPECT_GT(g.stats().comparisons, 0u);
+    out.clear();
+    g.drain(std::back_inserter(out));
+    EXPECT_EQ(ref, out);
+
+    // an empty heap, a file for another value type, a truncated file, no file
+    Heap().save(path);
+    c.load(path);
+    EXPECT_TRUE(c.empty());
+    MinDistHeap<long long>().save(path);
+    EXPECT_THROW(c.load(path), std::runtime_error);
+    a.push(1);
+    a.save(path);
+    {
+        std::ofstream f(path, std::ios::app | std::ios::binary);
+        f.put('x');
+    }
+    EXPECT_THROW(c.load(path), std::runtime_error);
+    std::remove(path.c_str());
+    EXPECT_THROW(c.load(path), std::runtime_error);
+    EXPECT_TRUE(c.empty());
+}
+
+namespace {
+    void check_shape(const HeapShape &shape, std::size_t size)
+    {
+        std::size_t dist{ 0 };
+        for (std::size_t cnt : shape.dist) dist += cnt;
+        ASSERT_EQ(size, shape.nodes + shape.pending);
+        ASSERT_EQ(shape.nodes, dist);
+        ASSERT_LE(shape.avg_depth, double(shape.max_depth));
+        // a balanced right spine: no longer than log2 of the tree size, plus one
+        std::size_t log{ 1 };
+        while ((std::size_t(1) << log) <= shape.nodes) ++log;
+        ASSERT_LE(shape.spine, log);
+        ASSERT_EQ(shape.nodes > 0, shape.spine > 0);
+    }
+}
+
+TEST(MinDist2, ShapeStats) {
+    LeftistHeapEasy<int, std::less<int>, std::allocator<int>, false, HeapCycleStats, true> a;
+    check_shape(a.shape_stats(), a.size());
+    for (int i = 0; i < 1000; ++i) a.push(i * 7919 % 1000);
+    EXPECT_EQ(1000u, a.shape_stats().pending);
+    check_shape(a.shape_stats(), a.size());
+    a.pop();
+    EXPECT_EQ(0u, a.shape_stats().pending);
+    EXPECT_EQ(1u, a.stats().builds);
+    EXPECT_GT(a.stats().merges, 0u);
+    check_shape(a.shape_stats(), a.size());
+}
+
+TEST(MinDist3, ShapeStats) {
+    MinDistHeap<int, std::less<int>, std::allocator<int>, false, HeapCycleStats> a;
+    check_shape(a.shape_stats(), a.size());
+    for (int i = 0; i < 1000; ++i) a.push(i * 7919 % 1000);
+    EXPECT_EQ(1000u, a.stats().merges);
+    EXPECT_EQ(0u, a.stats().builds);
+    check_shape(a.shape_stats(), a.size());
+    for (int i = 0; i < 500; ++i) a.pop();
+    check_shape(a.shape_stats(), a.size());
+
+    // lazy insert: the pending nodes join the tree on the first pop
+    MinDistHeap<int, std::less<int>, std::allocator<int>, false, NoHeapStats, true> b;
+    b.push(1);
+    check_shape(b.shape_stats(), b.size());
+    for (int i = 0; i < 100; ++i) b.push(i);
+    b.pop();
+    const HeapShape shape{ b.shape_stats() };
+    EXPECT_EQ(100u, shape.nodes);
+    EXPECT_EQ(0u, shape.pending);
+    check_shape(b.shape_stats(), b.size());
+}
+
+template<typename _Heap>
+class MinDist3Stream : public ::testing::Test {};
+using MinDist3Streams = ::testing::Types<
+    MinDistHeap<int>,
+    MinDistHeap<int, std::less<int>, std::allocator<int>, false, NoHeapStats, true>>;
+TYPED_TEST_SUITE(MinDist3Stream, MinDist3Streams);
+
+TYPED_TEST(MinDist3Stream, Validate) {
+    TypeParam heap;
+    heap.validate_stream();
+    EXPECT_EQ(0u, heap.validate_sample(4, 16, 1));
+    for (int i = 0; i < 2000; ++i) heap.push(i * 7919 % 2000);
+    heap.validate_stream();
+    for (int i = 0; i < 500; ++i) heap.pop();
+    for (int i = 0; i < 300; ++i) heap.push(i * 31 % 1000);
+    heap.validate_stream();
+    heap.validate_tree();
+
+    // the samples stay within their budget, and the whole run repeats with the seed
+    const std::size_t seen{ heap.validate_sample(16, 64, 42) };
+    EXPECT_GT(seen, 0u);
+    EXPECT_LE(seen, 16u * 64u);
+    EXPECT_EQ(seen, heap.validate_sample(16, 64, 42));
+
+    // a value changed behind the heap's back breaks the order below its parent
+    auto pos{ heap.begin() };
+    while (*pos == heap.front()) ++pos;
+    const int keep{ *pos };
+    *pos = -1;
+    EXPECT_THROW(heap.validate_stream(), std::logic_error);
+    EXPECT_THROW(heap.validate_tree(), std::logic_error);
+    *pos = keep;
+    heap.validate_stream();
+}
+
+TEST(MinDist3, StreamValidateLazy) {
+    // pending nodes of a lazy heap are checked by the full walk only
+    MinDistHeap<int, std::less<int>, std::allocator<int>, false, NoHeapStats, true> lazy;
+    for (int i = 0; i < 100; ++i) lazy.push(i);
+    lazy.validate_stream();
+    EXPECT_EQ(0u, lazy.validate_sample(4, 16, 1));
+}
+
+TEST(MinDist3, PopWhile) {
+    std::mt19937 rng(1234);
+    MinDistHeap<int> heap;
+    std::vector<int> all;
+    for (int i = 0; i < 5000; ++i) {
+        all.push_back(int(rng() % 10000));
+        heap.push(all.back());
+    }
+    std::sort(all.begin(), all.end());
+
+    // nothing due: the heap is not touched
+    std::vector<int> out;
+    heap.pop_while([](int v) { return v < 0; }, std::back_inserter(out));
+    EXPECT_TRUE(out.empty());
+    EXPECT_EQ(5000u, heap.size());
+
+    // several sweeps, each one taking the next slice in order
+    for (int limit : { 10, 1000, 1001, 4000, 9999 }) {
+        heap.pop_while([limit](int v) { return v < limit; }, std::back_inserter(out));
+        heap.validate_tree();
+        EXPECT_EQ(all.size() - out.size(), heap.size());
+        EXPECT_TRUE(heap.empty() || heap.front() >= limit);
+    }
+    EXPECT_EQ(std::vector<int>(all.begin(), all.begin() + std::ptrdiff_t(out.size())), out);
+    heap.pop_while([](int) { return true; }, std::back_inserter(out));
+    EXPECT_TRUE(heap.empty());
+    EXPECT_EQ(all, out);
+
+    // the pending nodes of a lazy heap are settled first
+    MinDistHeap<int, std::less<int>, std::allocator<int>, false, NoHeapStats, true> lazy;
+    for (int i = 100; i > 0; --i) lazy.push(i);
+    std::vector<int> low;
+    lazy.pop_while([](int v) { return v <= 50; }, std::back_inserter(low));
+    EXPECT_EQ(50u, low.size());
+    EXPECT_TRUE(std::is_sorted(low.begin(), low.end()));
+    EXPECT_EQ(51, lazy.front());
+    lazy.validate_tree();
+}
+
+namespace {
+    // a clock the tests move by hand
+    struct ManualClock {
+        using rep        = std::int64_t;
+        using period     = std::milli;
+        using duration   = std::chrono::duration<rep, period>;
+        using time_point = std::chrono::time_point<ManualClock>;
+        static constexpr bool is_steady{ true };
+
+        static time_point now() { return current; }
+        static inline time_point current{};
+    };
+
+    using ManualTime = ManualClock::time_point;
+
+    ManualTime at(int ms) { return ManualTime{ ManualClock::duration{ ms } }; }
+}
+
+TEST(TimerQueue, Expire) {
+    using Queue = TimerQueue<int, ManualClock>;
+    Queue timers;
+    EXPECT_EQ(ManualTime::max(), timers.next_due());
+
+    std::mt19937 rng(99);
+    std::map<int, Queue::handle> pending;
+    for (int i = 0; i < 2000; ++i) {
+        pending[i] = timers.schedule(at(int(rng() % 1000)), i);
+    }
+    timers.validate_tree();
+
+    // cancelled timers never fire, rescheduled ones fire at their new deadline
+    for (int i = 0; i < 2000; i += 7) {
+        EXPECT_EQ(i, timers.cancel(pending[i]));
+        pending.erase(i);
+    }
+    for (int i = 3; i < 2000; i += 11) {
+        if (pending.count(i)) {
+            timers.reschedule(pending[i], at(1500 + i % 10));
+        }
+    }
+    timers.validate_tree();
+    EXPECT_EQ(pending.size(), timers.size());
+
+    std::size_t fired{ 0 }, batches{ 0 };
+    ManualTime  last{ at(-1) };
+    for (int now = 0; now <= 2000; now += 97) {
+        const std::size_t count{ timers.expire_until(at(now), [&](std::vector<Queue::timer> &batch) {
+            ++batches;
+            for (const Queue::timer &item : batch) {
+                EXPECT_LE(item.due, at(now));
+                EXPECT_LE(last, item.due);
+                EXPECT_EQ(1u, pending.erase(item.payload));
+                last = item.due;
+            }
+        }) };
+        fired += count;
+        timers.validate_tree();
+        EXPECT_TRUE(timers.empty() || timers.next_due() > at(now));
+    }
+    EXPECT_TRUE(timers.empty());
+    EXPECT_TRUE(pending.empty());
+    EXPECT_EQ(2000u - 286u, fired);
+    EXPECT_EQ(0u, timers.expire_until(at(5000), [&](std::vector<Queue::timer> &) { ++batches; }));
+    EXPECT_GE(21u, batches);
+
+    // equal deadlines expire in scheduling order, and a callback may schedule again
+    std::vector<int> seen;
+    for (int i = 0; i < 10; ++i) timers.schedule(at(100), i);
+    timers.expire_until(at(100), [&](std::vector<Queue::timer> &batch) {
+        for (const Queue::timer &item : batch) seen.push_back(item.payload);
+        timers.schedule(at(50), 10);
+    });
+    timers.expire_until(at(100), [&](std::vector<Queue::timer> &batch) {
+        for (const Queue::timer &item : batch) seen.push_back(item.payload);
+    });
+    EXPECT_EQ((std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 }), seen);
+}
+
+TEST(MinMaxHeap, Handles) {
+    // values are (key, id), so they are unique and every one has its handle in 'where'
+    using Value = std::pair<int, int>;
+    using Heap  = MinMaxHeap<Value>;
+    std::mt19937 rng(2024);
+    Heap heap;
+    std::set<Value> ref;
+    std::map<int, Heap::iterator> where;
+
+    EXPECT_THROW(heap.front(), std::invalid_argument);
+    EXPECT_THROW(heap.back(), std::invalid_argument);
+    heap.pop_min();
+    heap.pop_max();
+
+    for (int id = 0; id < 20000; ++id) {
+        const unsigned op{ unsigned(rng() % 8) };
+        if (op < 4 || ref.empty()) {
+            const Value v{ int(rng() % 50000), id };
+            where[id] = heap.push(v);
+            ref.insert(v);
+        } else if (op == 4) {
+            where.erase(ref.begin()->second);
+            ref.erase(ref.begin());
+            heap.pop_min();
+        } else if (op == 5) {
+            where.erase(std::prev(ref.end())->second);
+            ref.erase(std::prev(ref.end()));
+            heap.pop_max();
+        } else {
+            // change a random value through its handle: down, up, anywhere, or remove it
+            auto pos{ where.lower_bound(int(rng() % unsigned(id))) };
+            if (pos == where.end()) pos = where.begin();
+            Heap::iterator it{ pos->second };
+            ref.erase(*it);
+            const unsigned how{ unsigned(rng() % 4) };
+            if (how == 3) {
+                heap.remove(it);
+                where.erase(pos);
+                continue;
+            }
+            const int delta{ int(rng() % 1000) };
+            it->first += (how == 0) ? -delta : (how == 1) ? delta : delta - 500;
+            if (how == 0) heap.decrease(it);
+            else if (how == 1) heap.increase(it);
+            else heap.readjust(it);
+            ref.insert(*it);
+        }
+        ASSERT_EQ(ref.size(), heap.size());
+        if (!ref.empty()) {
+            ASSERT_EQ(*ref.begin(), heap.front());
+            ASSERT_EQ(*std::prev(ref.end()), heap.back());
+        }
+        if (0 == id % 2000) {
+            heap.validate_tree();
+        }
+    }
+    heap.validate_tree();
+
+    // iteration visits every value once, and removing along the way keeps going
+    std::set<Value> seen;
+    for (const Value &v : heap) {
+        EXPECT_TRUE(seen.insert(v).second);
+    }
+    EXPECT_EQ(ref, seen);
+    for (auto it = heap.begin(); it != heap.end(); ) {
+        if (it->second % 2) {
+            ref.erase(*it);
+            it = heap.remove(it);
+        } else {
+            ++it;
+        }
+    }
+    heap.validate_tree();
+    EXPECT_EQ(ref.size(), heap.size());
+
+    // merged heaps keep both ends, and draining from both sides meets in the middle
+    Heap other;
+    for (int i = 0; i < 100; ++i) {
+        other.push(Value{ -1 - i, -1 - i });
+        ref.insert(Value{ -1 - i, -1 - i });
+    }
+    heap.merge(other);
+    EXPECT_TRUE(other.empty());
+    heap.validate_tree();
+    Heap moved{ std::move(heap) };
+    EXPECT_TRUE(heap.empty());
+    while (!moved.empty()) {
+        ASSERT_EQ(*ref.begin(), moved.front());
+        ref.erase(ref.begin());
+        moved.pop_min();
+        if (moved.empty()) break;
+        ASSERT_EQ(*std::prev(ref.end()), moved.back());
+        ref.erase(std::prev(ref.end()));
+        moved.pop_max();
+    }
+    EXPECT_TRUE(ref.empty());
+
+    // the inlined order and a pool work the same way
+    MinMaxHeap<int, std::less<int>, NodePoolAllocator<int>, true> pooled;
+    pooled.reserve(64);
+    for (int i = 0; i < 64; ++i) pooled.push(i * 37 % 64);
+    EXPECT_EQ(0, pooled.front());
+    EXPECT_EQ(63, pooled.back());
+    pooled.validate_tree();
+}
+
 // --*-- that's all folks --*--
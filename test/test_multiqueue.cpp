@@ -0,0 +1,105 @@
+// -------------------------------------------------------------------------------------------
+// MultiQueue unit tests
+// -------------------------------------------------------------------------------------------
+// this file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+#include "inc/multiqueue.hpp"
+#include "inc/phqueue3.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+TEST(MultiQueue, SingleShardIsExact) {
+    MultiQueue<int> mq(1);
+    for (int i : { 5, 1, 4, 2, 3 }) {
+        mq.push(i);
+    }
+    EXPECT_EQ(5u, mq.size());
+
+    int v{ 0 };
+    for (int expect{ 1 }; expect <= 5; ++expect) {
+        ASSERT_TRUE(mq.try_pop(v));
+        EXPECT_EQ(expect, v);
+    }
+    EXPECT_TRUE(mq.empty());
+    EXPECT_FALSE(mq.try_pop(v));
+}
+
+TEST(MultiQueue, EveryElementOnce) {
+    MultiQueue<int, std::less<int>, PairingHeap<int>> mq(8);
+    for (int i{ 0 }; i < 1000; ++i) {
+        mq.push(i);
+    }
+
+    std::vector<int> out;
+    int v{ 0 };
+    while (mq.try_pop(v)) {
+        out.push_back(v);
+    }
+    ASSERT_EQ(1000u, out.size());
+    std::sort(out.begin(), out.end());
+    for (int i{ 0 }; i < 1000; ++i) {
+        EXPECT_EQ(i, out[i]);
+    }
+}
+
+TEST(MultiQueue, Concurrent) {
+    constexpr int kThreads{ 4 }, kPerThread{ 5000 };
+    MultiQueue<int> mq(2 * kThreads);
+
+    std::vector<std::vector<int>> got(kThreads);
+    std::vector<std::thread> pool;
+    for (int t{ 0 }; t < kThreads; ++t) {
+        pool.emplace_back([&mq, &got, t]() {
+            int v{ 0 };
+            for (int i{ 0 }; i < kPerThread; ++i) {
+                mq.push(t * kPerThread + i);
+                if ((i & 1) && mq.try_pop(v)) {
+                    got[t].push_back(v);
+                }
+            }
+        });
+    }
+    for (auto &th : pool) {
+        th.join();
+    }
+
+    std::vector<int> all;
+    for (auto &g : got) {
+        all.insert(all.end(), g.begin(), g.end());
+    }
+    int v{ 0 };
+    while (mq.try_pop(v)) {
+        all.push_back(v);
+    }
+    ASSERT_EQ(std::size_t(kThreads * kPerThread), all.size());
+    std::sort(all.begin(), all.end());
+    for (int i{ 0 }; i < kThreads * kPerThread; ++i) {
+        EXPECT_EQ(i, all[i]);
+    }
+}
+
+TEST(MultiQueue, MergeInto) {
+    MultiQueue<int> mq(4);
+    for (int i{ 100 }; i > 0; --i) {
+        mq.push(i);
+    }
+
+    PairingHeapEasy<int> heap;
+    heap.push(0);
+    mq.merge_into(heap);
+    EXPECT_TRUE(mq.empty());
+    ASSERT_EQ(101u, heap.size());
+    for (int expect{ 0 }; expect <= 100; ++expect) {
+        EXPECT_EQ(expect, heap.front());
+        heap.pop();
+    }
+}
+
+// --*-- that's all folks --*--
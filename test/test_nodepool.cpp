@@ -0,0 +1,120 @@
+// -------------------------------------------------------------------------------------------
+// node pool unit tests
+// -------------------------------------------------------------------------------------------
+// this file is part of "PrioQueueCC" by J.Perlinger.
+//
+// PrioQueueCC by J.Perlinger is marked CC0 1.0. To view a copy of this mark,
+//    visit https://creativecommons.org/publicdomain/zero/1.0/
+//
+// -------------------------------------------------------------------------------------------
+#include "inc/nodepool.hpp"
+#include "inc/phqueue2.hpp"
+#include "inc/phqueue3.hpp"
+#include "inc/lhqueue2.hpp"
+#include "inc/mdqueue3.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+TEST(NodePool, RecycleAndRelease) {
+    NodePoolT *chain{ nullptr };
+    NodePoolT pool(24, 8, chain);
+
+    pool.reserve(100);
+    EXPECT_GE(pool.capacity(), 100u);
+    EXPECT_EQ(0u, pool.live());
+
+    void *p1 = pool.allocate();
+    pool.deallocate(p1);
+    void *p2 = pool.allocate();
+    EXPECT_EQ(p1, p2);                  // LIFO free list
+    EXPECT_FALSE(pool.release());       // one block is still live
+
+    pool.deallocate(p2);
+    EXPECT_TRUE(pool.release());
+    EXPECT_EQ(0u, pool.capacity());
+}
+
+TEST(NodePool, HeapsOnPool) {
+    struct Tag {};
+    using Alloc = NodePoolAllocator<int, Tag>;
+
+    PairingHeap<int, std::less<int>, Alloc>      ph3;
+    PairingHeapEasy<int, std::less<int>, Alloc>  ph2;
+    LeftistHeapEasy<int, std::less<int>, Alloc>  lh2;
+    MinDistHeap<int, std::less<int>, Alloc>      md3;
+
+    // the heaps that hand nodes to other threads (MultiQueue, MpscPairingHeap) reject these
+    static_assert(heap_thread_affine<decltype(ph3)>::value && heap_thread_affine<decltype(md3)>::value,
+        "heaps on a pool are thread-affine");
+    static_assert(!heap_thread_affine<PairingHeapEasy<int>>::value, "heaps on std::allocator are not");
+
+    ph3.reserve(1000);
+    for (int i = 1000; i-- > 0; /*NOP*/) {
+        ph3.push(i);
+        ph2.push(i);
+        lh2.push(i);
+        md3.push(i);
+    }
+    for (int i = 0; i < 500; ++i) {
+        ASSERT_EQ(i, ph3.front()); ph3.pop();
+        ASSERT_EQ(i, ph2.front()); ph2.pop();
+        ASSERT_EQ(i, lh2.front()); lh2.pop();
+        ASSERT_EQ(i, md3.front()); md3.pop();
+    }
+    ph3.validate_tree();
+    md3.validate_tree();
+
+    ASSERT_FALSE(Alloc::release());
+    ph3.clear();
+    ph2.clear();
+    lh2.clear();
+    md3.clear();
+    ASSERT_TRUE(Alloc::release());
+}
+
+TEST(NodePool, BulkClear) {
+    struct Tag {};
+    using Alloc = NodePoolAllocator<int, Tag>;
+    using Heap  = PairingHeap<int, std::less<int>, Alloc>;
+
+    struct Probe : Heap { using Heap::node_allocator_type; };
+
+    // the only heap on its pool: 'clear()' hands all nodes back without walking the tree
+    Heap a;
+    for (int i = 0; i < 10000; ++i) a.push(i * 7919 % 10000);
+    NodePoolT &pool{ Probe::node_allocator_type::pool() };
+    const std::size_t capacity{ pool.capacity() };
+    EXPECT_EQ(10000u, pool.live());
+    a.clear();
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(0u, pool.live());
+
+    // the chunks stay: pushing as many again allocates nothing
+    for (int i = 0; i < 10000; ++i) a.push(i);
+    EXPECT_EQ(capacity, pool.capacity());
+    a.validate_tree();
+    EXPECT_EQ(0, a.front());
+
+    // with another heap on the same pool, the nodes go back one by one
+    Heap b;
+    b.push(1);
+    b.push(2);
+    a.clear();
+    EXPECT_EQ(2u, pool.live());
+    EXPECT_FALSE(Alloc::release());
+    b.clear();
+    EXPECT_EQ(0u, pool.live());
+    EXPECT_TRUE(Alloc::release());
+    EXPECT_EQ(0u, pool.capacity());
+
+    // a value with a destructor is always destroyed node by node
+    MinDistHeap<std::string, std::less<std::string>, NodePoolAllocator<std::string, Tag>> c;
+    for (int i = 0; i < 100; ++i) c.push(std::string(40, char('a' + i % 26)));
+    EXPECT_FALSE(Alloc::release());
+    c.clear();
+    EXPECT_TRUE(Alloc::release());
+}
+
+// --*-- that's all folks --*--
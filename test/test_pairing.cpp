@@ -9,8 +9,28 @@
 // -------------------------------------------------------------------------------------------
 #include "inc/phqueue2.hpp"
 #include "inc/phqueue3.hpp"
+#include "inc/mpscheap.hpp"
+#include "inc/bounded.hpp"
+#include "inc/compact.hpp"
+#include "inc/indexed.hpp"
+#include "inc/smallheap.hpp"
+#include "inc/radixheap.hpp"
+#include "inc/softheap.hpp"
+#include "inc/staticheap.hpp"
+#include "src/PointerMap.hpp"
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 TEST(Pairing2, InsertAndPopOrder) {
     PairingHeapEasy<int> pq;
@@ -45,6 +65,22 @@ TEST(Pairing2, MergePreservesOrder) {
     }
 }
 
+TEST(Pairing2, InlineOrder) {
+    PairingHeapEasy<int, std::less<int>, std::allocator<int>, true> pq;
+    std::vector<int> v(200);
+    for (int i = 0; i < 200; ++i) v[i] = i;
+    std::shuffle(v.begin(), v.end(), std::mt19937(4711));
+
+    for (int i : v) pq.push(i);
+    pq.validate_tree(v.size());
+
+    for (int i = 0; i < 200; ++i) {
+        ASSERT_EQ(i, pq.front());
+        pq.pop();
+    }
+    EXPECT_TRUE(pq.empty());
+}
+
 TEST(Pairing3, InsertAndPopOrder) {
     PairingHeap<int> pq;
 
@@ -168,4 +204,1246 @@ TEST(Pairing3, IterBackAfterErase) {
     ASSERT_EQ(50, cnt);
 }
 
+TEST(Pairing3, InlineOrder) {
+    PairingHeap<int, std::greater<int>, std::allocator<int>, true> pq;
+    std::vector<PairingHeap<int, std::greater<int>, std::allocator<int>, true>::iterator> its;
+
+    for (int i = 0; i < 100; ++i)
+        its.push_back(pq.push(i));
+    pq.validate_tree();
+
+    // lift every 3rd item to the top range, then let the heap catch up
+    for (int i = 0; i < 100; i += 3) {
+        *its[i] += 1000;
+        pq.decrease(its[i]);
+    }
+    pq.validate_tree();
+
+    ASSERT_EQ(1099, pq.front());
+    int prev{ pq.front() };
+    while (!pq.empty()) {
+        ASSERT_LE(pq.front(), prev);
+        prev = pq.front();
+        pq.pop();
+    }
+}
+
+TEST(Pairing2, SizeAndStats) {
+    PairingHeapEasy<int, std::less<int>, std::allocator<int>, false, HeapStats> a, b;
+    for (int i = 0; i < 100; ++i) a.push(i);
+    for (int i = 0; i < 50; ++i) b.push(i);
+    ASSERT_EQ(100u, a.size());
+
+    a.merge(b);
+    ASSERT_EQ(150u, a.size());
+    ASSERT_EQ(0u, b.size());
+    a.validate_tree();
+
+    auto c{ std::move(a) };
+    ASSERT_EQ(150u, c.size());
+    ASSERT_EQ(0u, a.size());
+    for (int i = 0; i < 10; ++i) c.pop();
+    ASSERT_EQ(140u, c.size());
+    c.validate_tree();
+
+    EXPECT_EQ(10u, c.stats().pops);
+    EXPECT_GE(c.stats().comparisons, c.stats().links);
+    EXPECT_GT(c.stats().links, 0u);
+    EXPECT_GT(c.stats().max_roots, 1u);
+    c.reset_stats();
+    EXPECT_EQ(0u, c.stats().comparisons);
+
+    c.clear();
+    ASSERT_EQ(0u, c.size());
+}
+
+TEST(Pairing3, SizeAndStats) {
+    PairingHeap<int, std::less<int>, std::allocator<int>, true, HeapStats> a, b;
+    std::vector<decltype(a)::iterator> its;
+    for (int i = 0; i < 100; ++i) its.push_back(a.push(i));
+    for (int i = 0; i < 50; ++i) b.push(i);
+
+    a.merge(b);
+    ASSERT_EQ(150u, a.size());
+    ASSERT_EQ(0u, b.size());
+
+    // remove / decrease / readjust keep the count right
+    a.remove(its[10]);
+    *its[20] -= 100;
+    a.decrease(its[20]);
+    *its[30] += 100;
+    a.readjust(its[30]);
+    ASSERT_EQ(149u, a.size());
+    a.validate_tree();
+
+    a.pop();
+    ASSERT_EQ(148u, a.size());
+    EXPECT_EQ(1u, a.stats().pops);
+    EXPECT_GT(a.stats().comparisons, 0u);
+
+    // plain heaps count just as well
+    PairingHeap<int> c;
+    c.push(1);
+    c.push(2);
+    ASSERT_EQ(2u, c.size());
+    c.validate_tree();
+}
+
+// the pairing strategies, each on the same mix of operations
+template<typename _Heap>
+class Pairing2Pass : public ::testing::Test {};
+using Pairing2Passes = ::testing::Types<
+    PairingHeapEasy<int>,
+    PairingHeapEasy<int, std::less<int>, std::allocator<int>, false, NoHeapStats, PairingMultiPass>,
+    PairingHeapEasy<int, std::less<int>, std::allocator<int>, false, NoHeapStats, PairingAuxTwoPass>,
+    PairingHeapEasy<int, std::less<int>, std::allocator<int>, true,  HeapStats,   PairingAuxTwoPass>>;
+TYPED_TEST_SUITE(Pairing2Pass, Pairing2Passes);
+
+TYPED_TEST(Pairing2Pass, PushPopMerge) {
+    // push shuffled keys with pops in between, meld a second heap, then drain in order
+    TypeParam a, b;
+    std::vector<int> v(500);
+    for (int i = 0; i < 500; ++i) v[i] = i;
+    std::shuffle(v.begin(), v.end(), std::mt19937(4711));
+
+    for (int i = 0; i < 400; ++i) {
+        a.push(v[i]);
+        if (0 == i % 7) {
+            a.pop();
+            a.validate_tree();
+        }
+    }
+    for (int i = 400; i < 500; ++i) b.push(v[i]);
+    b.validate_tree();
+    a.merge(b);
+    ASSERT_TRUE(b.empty());
+    ASSERT_EQ(442u, a.size());
+    a.validate_tree();
+
+    int prev{ a.front() };
+    while (!a.empty()) {
+        ASSERT_LE(prev, a.front());
+        prev = a.front();
+        a.pop();
+    }
+}
+
+template<typename _Heap>
+class Pairing3Pass : public ::testing::Test {};
+using Pairing3Passes = ::testing::Types<
+    PairingHeap<int>,
+    PairingHeap<int, std::less<int>, std::allocator<int>, false, NoHeapStats, PairingMultiPass>,
+    PairingHeap<int, std::less<int>, std::allocator<int>, false, NoHeapStats, PairingAuxTwoPass>,
+    PairingHeap<int, std::less<int>, std::allocator<int>, true,  HeapStats,   PairingAuxTwoPass>,
+    PairingHeap<int, std::less<int>, std::allocator<int>, false, NoHeapStats, PairingBoundedPass>,
+    PairingHeap<int, std::less<int>, std::allocator<int>, true,  HeapStats,   PairingBoundedPass>>;
+TYPED_TEST_SUITE(Pairing3Pass, Pairing3Passes);
+
+TYPED_TEST(Pairing3Pass, DecreaseRemove) {
+    // iterator based operations: decrease, readjust, remove while iterating
+    TypeParam a, b;
+    std::vector<typename TypeParam::iterator> its;
+    std::vector<int> v(300);
+    for (int i = 0; i < 300; ++i) v[i] = 2 * i;
+    std::shuffle(v.begin(), v.end(), std::mt19937(815));
+
+    a.push(-2);
+    for (int x : v) its.push_back(a.push(x));
+    a.pop();                            // -2 goes, and the trees get linked for real
+    for (int x : { 3, 1, 5 }) b.push(x);
+
+    for (std::size_t i = 0; i < its.size(); i += 5) {
+        *its[i] -= 1000;
+        a.decrease(its[i]);
+        a.validate_tree();
+    }
+    for (std::size_t i = 2; i < its.size(); i += 7) {
+        *its[i] += 1001;                // odd now
+        a.readjust(its[i]);
+        a.validate_tree();
+    }
+    a.merge(b);
+    a.validate_tree();
+
+    std::size_t odd{ 0 }, cnt{ 0 };
+    for (auto it{ a.begin() }; it != a.end(); /*NOP*/) {
+        if (*it & 1) {
+            it = a.remove(it);
+            ++odd;
+        } else {
+            ++it;
+        }
+    }
+    a.validate_tree();
+    for (auto it{ a.begin() }; it != a.end(); ++it) ++cnt;
+    ASSERT_EQ(cnt, a.size());
+    ASSERT_EQ(303u, odd + cnt);
+
+    int prev{ a.front() };
+    while (!a.empty()) {
+        ASSERT_LE(prev, a.front());
+        ASSERT_EQ(0, a.front() & 1);
+        prev = a.front();
+        a.pop();
+    }
+}
+
+TEST(Pairing3, AuxFrontIsLazy) {
+    // pushes only compare against the least pending tree, nothing gets linked before 'pop()'
+    PairingHeap<int, std::less<int>, std::allocator<int>, true, HeapStats, PairingAuxTwoPass> a;
+    for (int i : { 5, 3, 8, 1, 9, 2 }) a.push(i);
+    EXPECT_EQ(1, a.front());
+    EXPECT_EQ(0u, a.stats().links);
+    EXPECT_EQ(5u, a.stats().comparisons);
+    a.validate_tree();
+
+    a.pop();
+    EXPECT_EQ(2, a.front());
+    EXPECT_EQ(5u, a.size());
+    EXPECT_GT(a.stats().links, 0u);
+    a.validate_tree();
+}
+
+namespace {
+    struct Order {
+        std::uint64_t due;
+        char          payload[200];
+    };
+    struct OrderDue {
+        std::uint64_t operator()(const Order &o) const { return o.due; }
+    };
+}
+
+TEST(Pairing3, KeyOf) {
+    // the compare key lives in the node header; the comparator orders keys
+    PairingHeap<Order, std::greater<std::uint64_t>, std::allocator<Order>, true, NoHeapStats, PairingTwoPass, OrderDue> a;
+    PairingHeapEasy<Order, std::less<std::uint64_t>, std::allocator<Order>, false, NoHeapStats, PairingTwoPass, OrderDue> b;
+    std::vector<decltype(a)::iterator> its;
+    for (std::uint64_t i = 0; i < 100; ++i) {
+        its.push_back(a.push(Order{ i, { 0 } }));
+        b.push(Order{ 99 - i, { 0 } });
+    }
+    its[5]->due = 500;                  // "decrease" for a max-heap
+    a.decrease(its[5]);
+    its[99]->due = 0;
+    a.readjust(its[99]);
+    a.validate_tree();
+    b.validate_tree();
+
+    ASSERT_EQ(500u, a.front().due);
+    a.pop();
+    for (std::uint64_t i = 98; i > 0; --i) {
+        if (5 == i) continue;
+        ASSERT_EQ(i, a.front().due);
+        a.pop();
+    }
+    for (std::uint64_t i = 0; i < 100; ++i) {
+        ASSERT_EQ(i, b.front().due);
+        b.pop();
+    }
+}
+
+namespace {
+    struct JobPairing3 : public PairingHeapHook {
+        int prio;
+    };
+    struct JobPairing3Less {
+        bool operator()(const JobPairing3 &j1, const JobPairing3 &j2) const { return j1.prio < j2.prio; }
+    };
+}
+
+TEST(Intrusive, Pairing3) {
+    std::vector<JobPairing3> jobs(100);
+    IntrusivePairingHeap<JobPairing3, JobPairing3Less> pq;
+
+    for (int i = 0; i < 100; ++i) {
+        jobs[i].prio = i;
+        pq.push(jobs[i]);
+    }
+    EXPECT_TRUE(pq.is_linked(jobs[42]));
+    pq.validate_tree();
+
+    // odd jobs go away, every 4th job gets urgent, job 10 becomes the least urgent
+    for (int i = 1; i < 100; i += 2) {
+        pq.remove(jobs[i]);
+        EXPECT_FALSE(pq.is_linked(jobs[i]));
+    }
+    for (int i = 0; i < 100; i += 4) {
+        jobs[i].prio -= 1000;
+        pq.decrease(jobs[i]);
+    }
+    jobs[10].prio = 5000;
+    pq.readjust(jobs[10]);
+    pq.validate_tree();
+
+    int cnt{ 0 }, prev{ pq.front().prio };
+    while (JobPairing3 *job = pq.pop()) {
+        ASSERT_LE(prev, job->prio);
+        ASSERT_FALSE(pq.is_linked(*job));
+        prev = job->prio;
+        ++cnt;
+    }
+    ASSERT_EQ(50, cnt);
+    ASSERT_EQ(5000, prev);              // job 10 came out last
+
+    // elements can be relinked after coming out
+    for (auto &j : jobs) pq.push(j);
+    for (auto it{ pq.begin() }; it != pq.end(); /*NOP*/) {
+        it = (it->prio & 1) ? pq.remove(it) : ++it;
+    }
+    pq.validate_tree();
+    pq.clear();
+    for (auto &j : jobs) ASSERT_FALSE(pq.is_linked(j));
+}
+
+TEST(MpscHeap, Insert) {
+    constexpr int kThreads{ 4 }, kPerThread{ 2000 };
+
+    MpscPairingHeap<int> heap;
+    std::vector<std::thread> producers;
+    for (int t{ 0 }; t < kThreads; ++t) {
+        producers.emplace_back([&heap, t]() {
+            for (int i{ 0 }; i < kPerThread; ++i) {
+                heap.push(i * kThreads + t);
+            }
+        });
+    }
+
+    // consume while the producers are running; nothing may get lost
+    std::vector<int> got;
+    int v{ 0 };
+    while (got.size() < std::size_t(kThreads * kPerThread)) {
+        if (heap.try_pop(v)) {
+            got.push_back(v);
+        }
+    }
+    for (auto &th : producers) {
+        th.join();
+    }
+    EXPECT_TRUE(heap.empty());
+
+    std::sort(got.begin(), got.end());
+    for (int i{ 0 }; i < kThreads * kPerThread; ++i) {
+        EXPECT_EQ(i, got[i]);
+    }
+
+    // single-threaded use is not disturbed by the inbox
+    MpscPairingHeap<int, std::less<int>, std::allocator<int>, true, NoHeapStats, PairingAuxTwoPass> aux;
+    for (int i{ 100 }; i > 0; --i) {
+        aux.push(i);
+        if (0 == i % 10) {
+            aux.validate_tree();
+        }
+    }
+    EXPECT_EQ(100u, aux.size());
+    for (int expect{ 1 }; expect <= 100; ++expect) {
+        EXPECT_EQ(expect, aux.front());
+        aux.pop();
+    }
+    aux.push(7);                        // left in the inbox for the destructor
+}
+
+namespace {
+    // pop_n() and drain(): values come out in order, and when the output throws, the values not
+    // yet written stay in the heap
+    struct LimitedSink {
+        using iterator_category = std::output_iterator_tag;
+        using value_type        = void;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = void;
+        using reference         = void;
+
+        std::vector<int> *v;
+        int               budget;
+
+        LimitedSink &operator*()  { return *this; }
+        LimitedSink &operator++() { return *this; }
+        LimitedSink &operator=(int x) {
+            if (0 == budget--) throw std::length_error("full");
+            v->push_back(x);
+            return *this;
+        }
+    };
+}
+
+template<typename _Heap>
+class PairingBulkPop : public ::testing::Test {};
+using PairingBulkPops = ::testing::Types<
+    PairingHeapEasy<int>,
+    PairingHeapEasy<int, std::less<int>, std::allocator<int>, true, HeapStats, PairingAuxTwoPass>,
+    PairingHeap<int>,
+    PairingHeap<int, std::less<int>, std::allocator<int>, true, HeapStats, PairingAuxTwoPass>>;
+TYPED_TEST_SUITE(PairingBulkPop, PairingBulkPops);
+
+TYPED_TEST(PairingBulkPop, PopNAndDrain) {
+    TypeParam h;
+    std::vector<int> v(1000);
+    for (int i = 0; i < 1000; ++i) v[i] = i / 2;
+    std::shuffle(v.begin(), v.end(), std::mt19937(4711));
+    for (int x : v) h.push(x);
+
+    std::vector<int> out;
+    h.pop_n(10, std::back_inserter(out));
+    ASSERT_EQ(10u, out.size());
+    EXPECT_EQ(990u, h.size());
+    h.validate_tree();
+
+    EXPECT_THROW(h.drain(LimitedSink{ &out, 20 }), std::length_error);
+    EXPECT_EQ(970u, h.size());
+    h.validate_tree();
+
+    h.drain(std::back_inserter(out));
+    EXPECT_TRUE(h.empty());
+    EXPECT_EQ(0u, h.size());
+    h.pop_n(5, std::back_inserter(out));
+    std::sort(v.begin(), v.end());
+    EXPECT_EQ(v, out);
+}
+
+TEST(Pairing3, BulkPopMoves) {
+    // values are moved out, not copied
+    struct PtrLess {
+        bool operator()(const std::unique_ptr<int> &a, const std::unique_ptr<int> &b) const { return *a < *b; }
+    };
+    PairingHeap<std::unique_ptr<int>, PtrLess> h;
+    for (int i : { 4, 2, 3, 1 }) h.push(std::make_unique<int>(i));
+    std::vector<std::unique_ptr<int>> out;
+    h.pop_n(2, std::back_inserter(out));
+    h.drain(std::back_inserter(out));
+    ASSERT_EQ(4u, out.size());
+    for (int i = 0; i < 4; ++i) EXPECT_EQ(i + 1, *out[i]);
+}
+
+namespace {
+    // counts node allocations, to check the steady state of a bounded heap
+    std::size_t g_allocs{ 0 };
+
+    template<typename T>
+    struct CountingAlloc {
+        using value_type      = T;
+        using is_always_equal = std::true_type;
+
+        CountingAlloc() = default;
+        template<typename U> CountingAlloc(const CountingAlloc<U> &) {}
+
+        T   *allocate(std::size_t n)            { ++g_allocs; return std::allocator<T>().allocate(n); }
+        void deallocate(T *p, std::size_t n)    { std::allocator<T>().deallocate(p, n); }
+
+        template<typename U> bool operator==(const CountingAlloc<U> &) const { return true; }
+        template<typename U> bool operator!=(const CountingAlloc<U> &) const { return false; }
+    };
+}
+
+TEST(Pairing2, ReplaceTop) {
+    PairingHeapEasy<int> a;
+    EXPECT_THROW(a.replace_top(1), std::invalid_argument);
+    EXPECT_EQ(5, a.push_pop(5));                // empty: straight through
+    EXPECT_TRUE(a.empty());
+
+    for (int i : { 5, 3, 8, 1 }) a.push(i);
+    EXPECT_EQ(1, a.replace_top(9));
+    EXPECT_EQ(3, a.front());
+    EXPECT_EQ(2, a.push_pop(2));                // better than the top: heap untouched
+    EXPECT_EQ(3, a.push_pop(4));
+    EXPECT_EQ(4u, a.size());
+    a.validate_tree();
+
+    // auxiliary twopass: the least node may sit in the root list
+    PairingHeapEasy<int, std::less<int>, std::allocator<int>, false, NoHeapStats, PairingAuxTwoPass> b;
+    for (int i : { 5, 3, 8, 1 }) b.push(i);
+    EXPECT_EQ(1, b.replace_top(6));
+    EXPECT_EQ(3, b.push_pop(7));
+    b.validate_tree();
+    std::vector<int> out;
+    b.drain(std::back_inserter(out));
+    EXPECT_EQ((std::vector<int>{ 5, 6, 7, 8 }), out);
+}
+
+TEST(BoundedHeap, KeepsBest) {
+    using Heap = PairingHeapEasy<int, ReverseOrder<std::less<int>>, CountingAlloc<int>>;
+    BoundedHeap<int, 10, std::less<int>, Heap> best;
+
+    std::vector<int> v(1000);
+    for (int i = 0; i < 1000; ++i) v[i] = i;
+    std::shuffle(v.begin(), v.end(), std::mt19937(4711));
+
+    g_allocs = 0;
+    std::size_t kept{ 0 };
+    for (int x : v) kept += best.offer(x);
+    EXPECT_EQ(10u, g_allocs);                   // no allocation once full
+    EXPECT_GT(kept, 10u);
+    EXPECT_TRUE(best.full());
+    EXPECT_EQ(9, best.worst());
+    EXPECT_FALSE(best.offer(9));
+
+    EXPECT_EQ((std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }), best.sorted());
+    EXPECT_TRUE(best.empty());
+}
+
+TEST(IndexedHeap, Pairing3) {
+    // Dijkstra on a random graph, checked against the O(V^2) textbook version
+    constexpr unsigned V{ 500 }, E{ 4000 }, inf{ ~0u };
+    std::mt19937 rng(15);
+    std::vector<std::vector<std::pair<unsigned, unsigned>>> adj(V);
+    for (unsigned e = 0; e < E; ++e) {
+        adj[rng() % V].emplace_back(rng() % V, rng() % 100);
+    }
+
+    std::vector<unsigned> ref(V, inf), dist(V, inf);
+    std::vector<bool>     done(V, false);
+    ref[0] = 0;
+    for (unsigned round = 0; round < V; ++round) {
+        unsigned v{ V };
+        for (unsigned w = 0; w < V; ++w) {
+            if (!done[w] && ref[w] != inf && (v == V || ref[w] < ref[v])) v = w;
+        }
+        if (v == V) break;
+        done[v] = true;
+        for (auto [w, len] : adj[v]) ref[w] = std::min(ref[w], ref[v] + len);
+    }
+
+    IndexedPairingHeap<unsigned> pq(V);
+    EXPECT_TRUE(pq.push_or_decrease(0, 0));
+    EXPECT_FALSE(pq.push_or_decrease(0, 7));
+    while (!pq.empty()) {
+        auto [v, d] = pq.top();
+        ASSERT_EQ(v, pq.pop());
+        ASSERT_FALSE(pq.contains(v));
+        dist[v] = d;
+        for (auto [w, len] : adj[v]) {
+            if (dist[w] == inf) pq.push_or_decrease(w, d + len);
+        }
+    }
+    pq.validate_tree();
+    EXPECT_EQ(ref, dist);
+
+    // erase and update in any direction
+    for (unsigned id = 0; id < 10; ++id) pq.push_or_update(id, 100 + id);
+    EXPECT_TRUE(pq.erase(3));
+    EXPECT_FALSE(pq.erase(3));
+    EXPECT_FALSE(pq.contains(3));
+    pq.push_or_update(7, 1);
+    pq.push_or_update(0, 500);
+    pq.validate_tree();
+    EXPECT_EQ(9u, pq.size());
+    EXPECT_EQ(7u, pq.pop());
+    EXPECT_EQ(1u, pq.pop());
+    pq.clear();
+    EXPECT_FALSE(pq.contains(0));
+    EXPECT_THROW(pq.pop(), std::invalid_argument);
+}
+
+TEST(CompactHeap, PushMergeCopy) {
+    static_assert(CompactPairingHeap<std::uint32_t>::node_size == 12, "two 32-bit links per node");
+
+    std::mt19937 rng(16);
+    std::vector<std::uint32_t> ref(2000);
+    for (auto &v : ref) v = rng() % 500;
+
+    CompactPairingHeap<std::uint32_t> a, b;
+    CompactPairingHeap<std::uint32_t, std::less<std::uint32_t>, std::uint32_t, PairingMultiPass> m;
+    for (std::size_t i = 0; i < ref.size(); ++i) {
+        (i & 1 ? a : b).push(ref[i]);
+        m.push(ref[i]);
+    }
+    // leave some free nodes on both sides before merging
+    for (int i = 0; i < 100; ++i) {
+        a.push(a.front()); a.pop(); a.pop();
+        b.push(b.front()); b.pop(); b.pop();
+    }
+    a.validate_tree();
+    EXPECT_EQ(900u, a.size());
+    EXPECT_EQ(1001u, a.capacity());
+
+    // nodes hold no pointers: a copy is a heap of its own
+    CompactPairingHeap<std::uint32_t> c{ a };
+    a.merge(b);
+    EXPECT_TRUE(b.empty());
+    a.validate_tree();
+    EXPECT_EQ(1800u, a.size());
+    EXPECT_EQ(2002u, a.capacity());
+    for (int i = 0; i < 200; ++i) a.push(ref[i]);
+    EXPECT_EQ(2002u, a.capacity());     // free nodes are reused
+
+    std::vector<std::uint32_t> out, mout;
+    std::uint32_t v;
+    while (a.try_pop(v)) out.push_back(v);
+    while (m.try_pop(v)) mout.push_back(v);
+    EXPECT_TRUE(std::is_sorted(out.begin(), out.end()));
+    std::sort(ref.begin(), ref.end());
+    EXPECT_EQ(ref, mout);
+    EXPECT_EQ(900u, c.size());
+    c.validate_tree();
+    EXPECT_THROW(a.pop(), std::invalid_argument);
+
+    // the index space is the limit
+    CompactPairingHeap<std::uint8_t, std::less<std::uint8_t>, std::uint8_t> tiny;
+    for (int i = 0; i < 255; ++i) tiny.push(std::uint8_t(i));
+    EXPECT_THROW(tiny.push(0), std::length_error);
+    tiny.pop();
+    tiny.push(0);
+    tiny.validate_tree();
+    EXPECT_EQ(0, tiny.front());
+}
+
+TEST(SmallHeap, Spill) {
+    using Heap = SmallPairingHeap<int, 8, std::less<int>, CountingAlloc<int>>;
+    Heap a;
+    std::vector<Heap::iterator> its;
+
+    // small: no allocation, iterators work on the root list
+    g_allocs = 0;
+    for (int i = 0; i < 8; ++i) its.push_back(a.push(100 + 10 * i));
+    EXPECT_EQ(0u, g_allocs);
+    EXPECT_FALSE(a.spilled());
+    EXPECT_EQ(8, std::distance(a.begin(), a.end()));
+    *its[5] = 5;
+    a.decrease(its[5]);
+    EXPECT_EQ(5, a.front());
+    a.validate_tree();
+
+    // spill: the nodes stay put, so do the iterators
+    for (int i = 8; i < 20; ++i) its.push_back(a.push(100 + 10 * i));
+    EXPECT_TRUE(a.spilled());
+    EXPECT_EQ(12u, g_allocs);
+    a.validate_tree();
+    *its[2] = 1;
+    a.decrease(its[2]);
+    *its[15] = 2;
+    a.decrease(its[15]);
+    *its[5] = 1000;
+    a.readjust(its[5]);
+    a.remove(its[7]);
+    a.validate_tree();
+    EXPECT_EQ(1, a.front());
+
+    std::vector<int> out;
+    a.pop_n(3, std::back_inserter(out));
+    EXPECT_EQ((std::vector<int>{ 1, 2, 100 }), out);
+
+    // inline slots freed by pops are taken before the allocator
+    g_allocs = 0;
+    for (int i = 0; i < 3; ++i) a.push(i);
+    EXPECT_EQ(0u, g_allocs);
+
+    // moving copies the inline nodes, the allocated ones change hands
+    Heap b{ std::move(a) };
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(0u, g_allocs);
+    b.validate_tree();
+    for (int i = 0; i < 5; ++i) a.push(-i);
+    b.merge(a);
+    EXPECT_TRUE(a.empty());
+    EXPECT_FALSE(a.spilled());
+    b.validate_tree();
+
+    out.clear();
+    b.drain(std::back_inserter(out));
+    EXPECT_TRUE(std::is_sorted(out.begin(), out.end()));
+    EXPECT_EQ(24u, out.size());
+    EXPECT_EQ(-4, out.front());
+    EXPECT_EQ(1000, out.back());
+    EXPECT_FALSE(b.spilled());
+
+    // running empty makes it small again
+    for (int i = 0; i < 20; ++i) b.push(i);
+    while (!b.empty()) b.pop();
+    EXPECT_FALSE(b.spilled());
+    b.push(3);
+    b.validate_tree();
+}
+
+namespace {
+    struct Hop {
+        std::int64_t dist;
+        unsigned     vertex;
+    };
+    struct HopLess { bool operator()(const Hop &a, const Hop &b) const { return a.dist < b.dist; } };
+    struct HopDist { std::int64_t operator()(const Hop &h) const { return h.dist; } };
+}
+
+// Dijkstra with decrease-key through the iterators, checked against the O(V^2) textbook version
+template<typename _Heap>
+class HandleDijkstra : public ::testing::Test {};
+using HandleDijkstraHeaps = ::testing::Types<
+    PairingHeap<Hop, HopLess>,
+    PairingHeap<Hop, HopLess, std::allocator<Hop>, false, NoHeapStats, PairingBoundedPass>,
+    SmallPairingHeap<Hop, 8, HopLess, std::allocator<Hop>, false, PairingBoundedPass>,
+    RadixHeap<Hop, HopDist>>;
+TYPED_TEST_SUITE(HandleDijkstra, HandleDijkstraHeaps);
+
+TYPED_TEST(HandleDijkstra, RandomGraph) {
+    constexpr unsigned V{ 500 }, E{ 4000 };
+    std::mt19937 rng(16);
+    std::vector<std::vector<std::pair<unsigned, unsigned>>> adj(V);
+    for (unsigned e = 0; e < E; ++e) {
+        adj[rng() % V].emplace_back(rng() % V, rng() % 100);
+    }
+
+    std::vector<std::int64_t> ref(V, -1), dist(V, -1);
+    std::vector<bool>         done(V, false);
+    ref[0] = 0;
+    for (unsigned round = 0; round < V; ++round) {
+        unsigned v{ V };
+        for (unsigned w = 0; w < V; ++w) {
+            if (!done[w] && ref[w] >= 0 && (v == V || ref[w] < ref[v])) v = w;
+        }
+        if (v == V) break;
+        done[v] = true;
+        for (auto [w, len] : adj[v]) {
+            if (ref[w] < 0 || ref[v] + len < ref[w]) ref[w] = ref[v] + len;
+        }
+    }
+
+    std::vector<typename TypeParam::iterator> where(V);
+    std::fill(done.begin(), done.end(), false);
+    TypeParam pq;
+    where[0] = pq.push(Hop{ 0, 0 });
+    dist[0] = 0;
+    while (!pq.empty()) {
+        const Hop h{ pq.front() };
+        pq.pop();
+        done[h.vertex] = true;
+        for (auto [w, len] : adj[h.vertex]) {
+            const std::int64_t d{ h.dist + len };
+            if (done[w] || (dist[w] >= 0 && dist[w] <= d)) continue;
+            if (dist[w] < 0) {
+                where[w] = pq.push(Hop{ d, w });
+            } else {
+                where[w]->dist = d;
+                pq.decrease(where[w]);
+            }
+            dist[w] = d;
+        }
+    }
+    pq.validate_tree();
+    EXPECT_EQ(ref, dist);
+}
+
+TEST(RadixHeap, Monotone) {
+    // decrease, readjust and remove while iterating, above the bound
+    RadixHeap<int> a;
+    std::vector<RadixHeap<int>::iterator> its;
+    std::vector<int> v(300);
+    for (int i = 0; i < 300; ++i) v[i] = 2 * i;
+    std::shuffle(v.begin(), v.end(), std::mt19937(815));
+
+    a.push(-2000);
+    for (int x : v) its.push_back(a.push(x));
+    a.pop();                                // bound is -2000 now
+    for (std::size_t i = 0; i < its.size(); i += 5) {
+        *its[i] -= 1000;
+        a.decrease(its[i]);
+        a.validate_tree();
+    }
+    for (std::size_t i = 2; i < its.size(); i += 7) {
+        *its[i] += 1001;                    // odd now
+        a.readjust(its[i]);
+        a.validate_tree();
+    }
+    std::size_t odd{ 0 }, cnt{ 0 };
+    for (auto it{ a.begin() }; it != a.end(); /*NOP*/) {
+        if (*it & 1) {
+            it = a.remove(it);
+            ++odd;
+        } else {
+            ++it;
+        }
+    }
+    a.validate_tree();
+    for (auto it{ a.begin() }; it != a.end(); ++it) ++cnt;
+    ASSERT_EQ(cnt, a.size());
+    ASSERT_EQ(300u, odd + cnt);
+
+    // monotone: pushing behind the last pop is refused, at the bound it is fine
+    int prev{ a.front() };
+    a.pop();
+    EXPECT_THROW(a.push(prev - 1), std::out_of_range);
+    a.push(prev);
+    *its[1] = prev - 1;
+    EXPECT_THROW(a.decrease(its[1]), std::out_of_range);
+    *its[1] = 2 * 300;                      // above the bound again
+    a.readjust(its[1]);
+    a.validate_tree();
+    ASSERT_EQ(cnt, a.size());
+    while (!a.empty()) {
+        ASSERT_LE(prev, a.front());
+        ASSERT_EQ(0, a.front() & 1);
+        prev = a.front();
+        a.pop();
+    }
+    EXPECT_THROW(a.front(), std::invalid_argument);
+    a.push(-1);                             // the bound goes with the last value
+    EXPECT_EQ(-1, a.front());
+
+    // moving keeps the handles
+    RadixHeap<std::uint8_t> b;
+    auto hb{ b.push(200) };
+    b.push(100);
+    b.pop();
+    RadixHeap<std::uint8_t> c{ std::move(b) };
+    ASSERT_TRUE(b.empty());
+    *hb = 150;
+    c.decrease(hb);
+    EXPECT_EQ(150, c.front());
+    c.clear();
+    c.push(0);
+    c.push(255);
+    c.validate_tree();
+    EXPECT_EQ(0, c.front());
+}
+
+TEST(Pairing3, ShapeStats) {
+    PairingHeap<int, std::less<int>, std::allocator<int>, true, HeapCycleStats> a;
+    EXPECT_EQ(0u, a.shape_stats().nodes);
+    for (int i = 0; i < 100; ++i) a.push(i);
+
+    // ascending pushes all end up below the first one
+    HeapShape shape{ a.shape_stats() };
+    EXPECT_EQ(100u, shape.nodes);
+    EXPECT_EQ(99u, shape.roots);
+    EXPECT_EQ(1u, shape.max_depth);
+    EXPECT_DOUBLE_EQ(0.99, shape.avg_depth);
+    EXPECT_EQ(0u, shape.pending);
+    EXPECT_EQ(0u, a.stats().builds);
+
+    a.pop();
+    shape = a.shape_stats();
+    EXPECT_EQ(99u, shape.nodes);
+    EXPECT_LT(shape.roots, 99u);
+    EXPECT_GT(shape.max_depth, 1u);
+    EXPECT_EQ(1u, a.stats().builds);
+
+    // auxiliary twopass: the pushed trees queue behind the root
+    PairingHeap<int, std::less<int>, std::allocator<int>, true, NoHeapStats, PairingAuxTwoPass> b;
+    for (int i : { 5, 3, 8, 1, 9, 2 }) b.push(i);
+    shape = b.shape_stats();
+    EXPECT_EQ(1u, shape.nodes);                 // the pending trees are not part of the walk
+    EXPECT_EQ(5u, shape.pending);
+    EXPECT_EQ(0u, shape.roots);
+    EXPECT_EQ(0u, shape.max_depth);
+    b.pop();
+    shape = b.shape_stats();
+    EXPECT_EQ(5u, shape.nodes);
+    EXPECT_EQ(0u, shape.pending);
+    // below a root with children, next to pending singletons: each node counted once
+    for (int i : { 7, 4, 6 }) b.push(i);
+    shape = b.shape_stats();
+    EXPECT_EQ(3u, shape.pending);
+    EXPECT_EQ(b.size(), shape.nodes + shape.pending);
+    EXPECT_GT(shape.roots, 0u);
+
+    PairingHeapEasy<int, std::less<int>, std::allocator<int>, false, NoHeapStats, PairingAuxTwoPass> c;
+    for (int i : { 5, 3, 8, 1, 9, 2 }) c.push(i);
+    shape = c.shape_stats();
+    EXPECT_EQ(1u, shape.nodes);
+    EXPECT_EQ(5u, shape.pending);
+    EXPECT_EQ(0u, shape.max_depth);
+    for (int i = 10; i < 100; ++i) c.push(i);
+    c.pop();
+    shape = c.shape_stats();
+    EXPECT_EQ(95u, shape.nodes);
+    EXPECT_EQ(0u, shape.pending);
+    EXPECT_GT(shape.max_depth, 1u);
+    const std::size_t max_depth{ shape.max_depth };
+    for (int i = 100; i < 110; ++i) c.push(i);
+    shape = c.shape_stats();
+    EXPECT_EQ(10u, shape.pending);
+    EXPECT_EQ(c.size(), shape.nodes + shape.pending);
+    EXPECT_EQ(max_depth, shape.max_depth);
+}
+
+TEST(Pairing3, BoundedPop) {
+    // after 2^12 pushes the classic first pop links every node; the bounded one a few dozen
+    constexpr int N{ 1 << 12 };
+    PairingHeap<int, std::less<int>, std::allocator<int>, true, HeapStats> plain;
+    PairingHeap<int, std::less<int>, std::allocator<int>, true, HeapStats, PairingBoundedPass> a;
+    for (int i = 0; i < N; ++i) {
+        plain.push(i + 1);
+        a.push(i + 1);
+    }
+    EXPECT_EQ(0u, a.shape_stats().pending);     // a single tree of rank 12
+    EXPECT_EQ(12u, a.shape_stats().roots);
+    EXPECT_EQ(1, a.front());
+    a.validate_tree();
+
+    plain.reset_stats();
+    a.reset_stats();
+    plain.pop();
+    a.pop();
+    EXPECT_EQ(std::size_t(N - 2), plain.stats().links);
+    EXPECT_LE(a.stats().links, 12u);
+    EXPECT_EQ(2, a.front());
+    a.validate_tree();
+
+    // no operation links more than two per rank, pushes included
+    std::mt19937 rng(99);
+    std::size_t worst{ 0 };
+    for (int i = 0; i < 20000; ++i) {
+        const std::size_t links{ a.stats().links };
+        if (rng() % 3) {
+            a.push(int(rng() % 100000));
+        } else if (!a.empty()) {
+            a.pop();
+        }
+        worst = std::max(worst, std::size_t(a.stats().links - links));
+    }
+    EXPECT_LE(worst, 2u * 16u);
+    a.validate_tree();
+    int prev{ a.front() };
+    while (!a.empty()) {
+        ASSERT_LE(prev, a.front());
+        prev = a.front();
+        a.pop();
+    }
+}
+
+template<typename _Heap>
+class Pairing3Stream : public ::testing::Test {};
+using Pairing3Streams = ::testing::Types<
+    PairingHeap<int>,
+    PairingHeap<int, std::less<int>, std::allocator<int>, false, NoHeapStats, PairingMultiPass>,
+    PairingHeap<int, std::less<int>, std::allocator<int>, false, NoHeapStats, PairingAuxTwoPass>,
+    PairingHeap<int, std::less<int>, std::allocator<int>, false, NoHeapStats, PairingBoundedPass>>;
+TYPED_TEST_SUITE(Pairing3Stream, Pairing3Streams);
+
+TYPED_TEST(Pairing3Stream, Validate) {
+    TypeParam heap;
+    heap.validate_stream();
+    EXPECT_EQ(0u, heap.validate_sample(4, 16, 1));
+    for (int i = 0; i < 2000; ++i) heap.push(i * 7919 % 2000);
+    heap.validate_stream();
+    for (int i = 0; i < 500; ++i) heap.pop();
+    for (int i = 0; i < 300; ++i) heap.push(i * 31 % 1000);
+    heap.validate_stream();
+    heap.validate_tree();
+
+    // the samples stay within their budget, and the whole run repeats with the seed
+    const std::size_t seen{ heap.validate_sample(16, 64, 42) };
+    EXPECT_GT(seen, 0u);
+    EXPECT_LE(seen, 16u * 64u);
+    EXPECT_EQ(seen, heap.validate_sample(16, 64, 42));
+
+    // a value changed behind the heap's back breaks the order below its parent
+    auto pos{ heap.begin() };
+    while (*pos == heap.front()) ++pos;
+    const int keep{ *pos };
+    *pos = -1;
+    EXPECT_THROW(heap.validate_stream(), std::logic_error);
+    EXPECT_THROW(heap.validate_tree(), std::logic_error);
+    *pos = keep;
+    heap.validate_stream();
+}
+
+TEST(Pairing3, StreamValidateDeep) {
+    // descending pushes make a single path as deep as the heap is large
+    PairingHeap<int> deep;
+    for (int i = 100000; i > 0; --i) deep.push(i);
+    EXPECT_EQ(100000u, deep.shape_stats().max_depth + 1);
+    deep.validate_stream();
+    const std::size_t seen{ deep.validate_sample(8, 100, 7) };
+    EXPECT_GT(seen, 0u);
+    EXPECT_LE(seen, 800u);
+}
+
+TEST(PointerMap, InsertLookup) {
+    // the set behind the 2-way validators: grows past its initial size, finds every member
+    std::vector<int> nodes(100000);
+    PointerMapT set(10);
+    const std::size_t start{ set.capacity() };
+    for (int &node : nodes) EXPECT_TRUE(set.insert(&node));
+    for (int &node : nodes) EXPECT_FALSE(set.insert(&node));
+    EXPECT_EQ(nodes.size(), set.used());
+    EXPECT_GT(set.capacity(), start);
+    EXPECT_LE(set.used(), set.limit());
+    for (int &node : nodes) EXPECT_TRUE(set.lookup(&node));
+    int other;
+    EXPECT_FALSE(set.lookup(&other));
+
+    // batched inserts count the new pointers only, duplicates within the batch included
+    PointerMapT many(0);
+    many.reserve(nodes.size());
+    const std::size_t room{ many.capacity() };
+    std::vector<const void*> ptrs;
+    for (int &node : nodes) ptrs.push_back(&node);
+    ptrs.push_back(&nodes[7]);
+    EXPECT_EQ(nodes.size(), many.insert_many(ptrs.data(), ptrs.size()));
+    EXPECT_EQ(0u, many.insert_many(ptrs.data(), 1000));
+    EXPECT_EQ(room, many.capacity());
+    EXPECT_EQ(nodes.size(), many.used());
+    for (const void *ptr : ptrs) EXPECT_TRUE(many.lookup(ptr));
+    EXPECT_FALSE(many.lookup(&other));
+}
+
+TEST(SoftHeap, Corruption) {
+    EXPECT_THROW(SoftHeap<int>(0.0), std::invalid_argument);
+    EXPECT_THROW(SoftHeap<int>(1.0), std::invalid_argument);
+
+    // with a tiny error rate, no tree of a few thousand values gets to share a list
+    SoftHeap<int> a(1e-6);
+    EXPECT_THROW(a.front(), std::invalid_argument);
+    std::vector<int> v(3000);
+    for (int i = 0; i < 3000; ++i) v[i] = i;
+    std::shuffle(v.begin(), v.end(), std::mt19937(77));
+    for (int x : v) a.push(x);
+    a.validate_tree();
+    EXPECT_EQ(0u, a.corrupted());
+    for (int i = 0; i < 3000; ++i, a.pop()) ASSERT_EQ(i, a.front());
+    EXPECT_TRUE(a.empty());
+
+    // a coarse one corrupts values, but never more than its share of the pushes, and
+    // every value comes out once
+    SoftHeap<int> b(0.1);
+    std::mt19937 rng(78);
+    std::vector<int> in, out;
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 5000; ++i) {
+            in.push_back(int(rng() % 100000));
+            b.push(in.back());
+        }
+        for (int i = 0; i < 2000; ++i, b.pop()) out.push_back(b.front());
+        b.validate_tree();
+        EXPECT_LE(double(b.corrupted()), b.epsilon() * double(b.pushes()));
+    }
+    EXPECT_GT(b.corrupted(), 0u);
+    while (!b.empty()) {
+        out.push_back(b.front());
+        b.pop();
+    }
+    std::sort(in.begin(), in.end());
+    std::sort(out.begin(), out.end());
+    EXPECT_EQ(in, out);
+
+    // moves take the error rate along, the key extractor picks the order
+    SoftHeap<Hop, std::less<std::int64_t>, std::allocator<Hop>, HopDist> c(0.25);
+    for (unsigned i = 0; i < 100; ++i) c.emplace(Hop{ std::int64_t(i % 10), 99 - i });
+    SoftHeap<Hop, std::less<std::int64_t>, std::allocator<Hop>, HopDist> d(std::move(c));
+    EXPECT_TRUE(c.empty());
+    EXPECT_EQ(100u, d.size());
+    EXPECT_DOUBLE_EQ(0.25, d.epsilon());
+    d.validate_tree();
+    EXPECT_EQ(0, d.front().dist);
+    d.clear();
+    EXPECT_TRUE(d.empty());
+    EXPECT_EQ(0u, d.pushes());
+}
+
+template<typename _Heap>
+class Pairing3Split : public ::testing::Test {};
+using Pairing3Splits = ::testing::Types<
+    PairingHeap<int>,
+    PairingHeap<int, std::less<int>, std::allocator<int>, true>,
+    PairingHeap<int, std::less<int>, std::allocator<int>, false, NoHeapStats, PairingMultiPass>,
+    PairingHeap<int, std::less<int>, std::allocator<int>, false, NoHeapStats, PairingAuxTwoPass>,
+    PairingHeap<int, std::less<int>, std::allocator<int>, false, NoHeapStats, PairingBoundedPass>>;
+TYPED_TEST_SUITE(Pairing3Split, Pairing3Splits);
+
+TYPED_TEST(Pairing3Split, SplitSteal) {
+    std::mt19937 rng(31);
+    TypeParam heap;
+    std::vector<int> all;
+    for (int i = 0; i < 20000; ++i) {
+        all.push_back(int(rng() % 100000));
+        heap.push(all.back());
+    }
+    for (int i = 0; i < 1000; ++i) heap.pop();
+    std::sort(all.begin(), all.end());
+    all.erase(all.begin(), all.begin() + 1000);
+
+    // the front stays, the subtrees taken hold at least what was asked for
+    const int best{ heap.front() };
+    TypeParam loot{ heap.split(5000) };
+    EXPECT_EQ(all.size(), heap.size() + loot.size());
+    EXPECT_LE(5000u, loot.size());
+    EXPECT_EQ(best, heap.front());
+    EXPECT_LE(best, loot.front());
+    heap.validate_tree();
+    loot.validate_tree();
+
+    // stealing goes on until the front has no children any more
+    std::vector<TypeParam> thieves;
+    std::vector<int>   popped;
+    while (heap.size() > 1) {
+        const std::size_t size{ heap.size() };
+        thieves.push_back(heap.steal_subtree());
+        ASSERT_FALSE(thieves.back().empty());
+        EXPECT_EQ(size, heap.size() + thieves.back().size());
+        EXPECT_LE(best, heap.front());
+        thieves.back().validate_tree();
+        if (0 == thieves.size() % 8) {
+            popped.push_back(heap.front());
+            heap.pop();                         // the front gets new children
+        }
+    }
+    EXPECT_TRUE(heap.split(10).empty());
+    EXPECT_TRUE(TypeParam().steal_subtree().empty());
+
+    // and nothing got lost on the way
+    for (auto &thief : thieves) {
+        heap.merge(thief);
+    }
+    heap.merge(loot);
+    heap.validate_tree();
+    std::vector<int> out;
+    heap.drain(std::back_inserter(out));
+    out.insert(out.end(), popped.begin(), popped.end());
+    std::sort(out.begin(), out.end());
+    EXPECT_EQ(all, out);
+}
+
+TEST(Pairing3, SplitDeep) {
+    // a single path below the front: the one subtree is all of it, counted without a stack
+    PairingHeap<int> deep;
+    for (int i = 100000; i > 0; --i) deep.push(i);
+    PairingHeap<int> rest{ deep.steal_subtree() };
+    EXPECT_EQ(1u, deep.size());
+    EXPECT_EQ(99999u, rest.size());
+    EXPECT_EQ(2, rest.front());
+    rest.validate_tree();
+}
+
+static_assert(std::is_same<StaticPairingHeap<int, 254>::index_type, std::uint8_t>::value, "8-bit links up to 254 nodes");
+static_assert(std::is_same<StaticPairingHeap<int, 255>::index_type, std::uint16_t>::value, "16-bit links from 255 nodes");
+static_assert(StaticPairingHeap<std::uint16_t, 200>::node_size == 4, "two 8-bit links per node");
+
+template<typename _Heap>
+class StaticHeap : public ::testing::Test {};
+using StaticHeaps = ::testing::Types<
+    StaticPairingHeap<int, 64>,
+    StaticPairingHeap<int, 64, std::less<int>, PairingMultiPass>,
+    StaticLeftistHeap<int, 64>>;
+TYPED_TEST_SUITE(StaticHeap, StaticHeaps);
+
+TYPED_TEST(StaticHeap, FillCopyDrain) {
+    // fill to the last node with single and batch pushes and pops in between, copy, drain
+    std::vector<int> v(64);
+    for (int i = 0; i < 64; ++i) v[i] = i;
+    std::shuffle(v.begin(), v.end(), std::mt19937(2024));
+
+    TypeParam a;
+    for (int i = 0; i < 40; ++i) a.push(v[i]);
+    std::vector<int> seen(v.begin(), v.begin() + 40);
+    std::sort(seen.begin(), seen.end());
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(seen[i], a.front());
+        a.pop();
+    }
+    a.validate_tree();
+    a.push(v.begin() + 40, v.end());        // 30 + 24: the popped nodes are reused
+    EXPECT_EQ(54u, a.size());
+    for (int i = 0; i < 10; ++i) EXPECT_TRUE(a.try_push(-i));
+    EXPECT_TRUE(a.full());
+    EXPECT_FALSE(a.try_push(-100));
+    EXPECT_THROW(a.push(-100), std::length_error);
+    EXPECT_THROW(a.push(v.begin(), v.begin() + 1), std::length_error);
+    EXPECT_EQ(64u, a.size());
+    a.validate_tree();
+
+    // a copy is a heap of its own
+    TypeParam c{ a };
+    for (int i = 0; i < 5; ++i) a.pop();
+    c.validate_tree();
+    EXPECT_EQ(64u, c.size());
+    EXPECT_EQ(-9, c.front());
+
+    std::vector<int> out;
+    int value;
+    while (c.try_pop(value)) out.push_back(value);
+    EXPECT_TRUE(std::is_sorted(out.begin(), out.end()));
+    EXPECT_EQ(64u, out.size());
+    EXPECT_EQ(-4, a.front());
+    EXPECT_THROW(c.pop(), std::invalid_argument);
+    EXPECT_THROW(c.front(), std::invalid_argument);
+
+    // the nodes reused after clear() come with the links of the former tree
+    a.clear();
+    EXPECT_TRUE(a.empty());
+    for (int i : { 9, 8, 12, 10, 11 }) a.push(i);
+    a.validate_tree();
+    out.clear();
+    while (a.try_pop(value)) out.push_back(value);
+    EXPECT_EQ((std::vector<int>{ 8, 9, 10, 11, 12 }), out);
+    EXPECT_EQ(0u, a.size());
+    a.push(2);
+    EXPECT_EQ(2, a.front());
+    a.validate_tree();
+
+    TypeParam b{ 3, 1, 2 };
+    b.validate_tree();
+    c = b;
+    b.pop();
+    EXPECT_EQ(2, b.front());
+    EXPECT_EQ(1, c.front());
+    c.validate_tree();
+}
+
+namespace {
+    struct Tagged {
+        int key;
+        int id;
+    };
+    struct TaggedLess {
+        bool operator()(const Tagged &t1, const Tagged &t2) const { return t1.key < t2.key; }
+    };
+}
+
+TEST(Pairing2, AuxTwoPassTies) {
+    // the node front() shows is the one pop() removes, also among equal keys
+    PairingHeapEasy<Tagged, TaggedLess, std::allocator<Tagged>, false, NoHeapStats, PairingAuxTwoPass> pq;
+    pq.push({ 6, 1 });
+    pq.push({ 5, 2 });
+    pq.push({ 5, 3 });
+    EXPECT_EQ(2, pq.front().id);
+    pq.pop();
+    EXPECT_EQ(3, pq.front().id);
+    pq.pop();
+    EXPECT_EQ(1, pq.front().id);
+    pq.pop();
+
+    std::mt19937 rng(99);
+    std::vector<bool> queued;
+    for (int i = 0; i < 300; ++i) {
+        pq.push({ int(rng() % 4), int(queued.size()) });
+        queued.push_back(true);
+    }
+    while (!pq.empty()) {
+        const int id{ pq.front().id };
+        ASSERT_TRUE(queued[id]);
+        queued[id] = false;
+        pq.pop();
+        if (queued.size() < 400 && 0 == rng() % 3) {
+            pq.push({ int(rng() % 4), int(queued.size()) });
+            queued.push_back(true);
+        }
+    }
+    pq.validate_tree(0);
+}
+
+TEST(Pairing3, AuxTwoPassTies) {
+    PairingHeap<Tagged, TaggedLess, std::allocator<Tagged>, false, NoHeapStats, PairingAuxTwoPass> pq;
+    auto it{ pq.push({ 6, 1 }) };
+    pq.push({ 5, 2 });
+    it->key = 5;
+    pq.decrease(it);
+    const int shown{ pq.front().id };
+    pq.pop();
+    ASSERT_EQ(1u, pq.size());
+    EXPECT_NE(shown, pq.front().id);
+    pq.validate_tree();
+
+    // the same once a small heap spilled into a pairing heap
+    SmallPairingHeap<Tagged, 2, TaggedLess, std::allocator<Tagged>, false, PairingAuxTwoPass> sm;
+    sm.push({ 6, 1 });
+    sm.push({ 5, 2 });
+    sm.push({ 5, 3 });
+    sm.push({ 5, 4 });
+    std::vector<int> ids;
+    while (!sm.empty()) {
+        ids.push_back(sm.front().id);
+        sm.pop();
+    }
+    std::sort(ids.begin(), ids.end());
+    EXPECT_EQ((std::vector<int>{ 1, 2, 3, 4 }), ids);
+}
+
 // --*-- that's all folks --*--